@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <sys/types.h>
 #include <zephyr/kernel.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/net/ethernet_poll.h>
 #include <ethernet/eth_stats.h>
 #include <zephyr/drivers/pcie/pcie.h>
 #include <zephyr/irq.h>
@@ -47,6 +48,7 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	_(ICR);
 	_(ICS);
 	_(IMS);
+	_(IMC);
 	_(RCTL);
 	_(TCTL);
 	_(RDBAL);
@@ -186,6 +188,38 @@ out:
 	return pkt;
 }
 
+#if defined(CONFIG_ETH_E1000_RX_POLL)
+static int e1000_rx_poll(struct net_eth_poll *poll, int budget)
+{
+	struct e1000_dev *dev = CONTAINER_OF(poll, struct e1000_dev, rx_poll);
+	struct net_pkt *pkt;
+	int done = 0;
+
+	while (done < budget && (dev->rx[dev->next_rx_desc].sta & RDESC_STA_DD)) {
+		pkt = e1000_rx(dev);
+		if (pkt != NULL && net_recv_data(get_iface(dev), pkt) < 0) {
+			net_pkt_unref(pkt);
+		}
+
+		done++;
+	}
+
+	return done;
+}
+
+static bool e1000_rx_rearm(struct net_eth_poll *poll)
+{
+	struct e1000_dev *dev = CONTAINER_OF(poll, struct e1000_dev, rx_poll);
+
+	/* Frames received while the interrupt was masked have set their
+	 * cause in ICR, so unmasking raises the interrupt right away.
+	 */
+	iow32(dev, IMS, IMS_RX);
+
+	return false;
+}
+#endif /* CONFIG_ETH_E1000_RX_POLL */
+
 static void e1000_isr(const struct device *ddev)
 {
 	struct e1000_dev *dev = ddev->data;
@@ -194,11 +228,16 @@ static void e1000_isr(const struct device *ddev)
 	icr &= ~(ICR_TXDW | ICR_TXQE);
 
 	if (icr & (ICR_RXO | ICR_RXDMT0 | ICR_RXT0)) {
+#if defined(CONFIG_ETH_E1000_RX_POLL)
+		iow32(dev, IMC, IMS_RX);
+		net_eth_poll_schedule(&dev->rx_poll);
+#else
 		struct net_pkt *pkt = NULL;
 
 		while ((pkt = e1000_rx(dev))) {
 			net_recv_data(get_iface(dev), pkt);
 		}
+#endif
 
 		icr &= ~(ICR_RXO | ICR_RXDMT0 | ICR_RXT0);
 	}
@@ -254,7 +293,7 @@ int e1000_probe(const struct device *ddev)
 	iow32(dev, RDT, CONFIG_ETH_E1000_RX_QUEUE_SIZE - 1);
 	dev->next_rx_desc = 0;
 
-	iow32(dev, IMS, IMS_RXDMT0 | IMS_RXO | IMS_RXT0);
+	iow32(dev, IMS, IMS_RX);
 
 	ral = ior32(dev, RAL);
 	rah = ior32(dev, RAH);
@@ -276,6 +315,10 @@ static void e1000_iface_init(struct net_if *iface)
 	if (dev->iface == NULL) {
 		dev->iface = iface;
 
+#if defined(CONFIG_ETH_E1000_RX_POLL)
+		net_eth_poll_init(&dev->rx_poll, e1000_rx_poll, e1000_rx_rearm);
+#endif
+
 		/* Do the phy link up only once */
 		config->config_func(dev);
 	}
@@ -26,6 +26,8 @@ extern "C" {
 #define IMS_RXO		(1 << 6) /* Receiver FIFO Overrun */
 #define IMS_RXT0	(1 << 7) /* Receiver Timer */
 
+#define IMS_RX		(IMS_RXDMT0 | IMS_RXO | IMS_RXT0)
+
 #define RCTL_MPE	(1 << 4) /* Multicast Promiscuous Enabled */
 
 #define TDESC_EOP	     (1) /* End Of Packet */
@@ -44,6 +46,7 @@ enum e1000_reg_t {
 	ITR	= 0x00C4,	/* Interrupt Throttling Rate */
 	ICS	= 0x00C8,	/* Interrupt Cause Set */
 	IMS	= 0x00D0,	/* Interrupt Mask Set */
+	IMC	= 0x00D8,	/* Interrupt Mask Clear */
 	RCTL	= 0x0100,	/* Receive Control */
 	TCTL	= 0x0400,	/* Transmit Control */
 	RDBAL	= 0x2800,	/* Rx Descriptor Base Address Low */
@@ -106,6 +109,9 @@ struct e1000_dev {
 #if defined(CONFIG_NET_STATISTICS_ETHERNET)
 	struct net_stats_eth stats;
 #endif
+#if defined(CONFIG_ETH_E1000_RX_POLL)
+	struct net_eth_poll rx_poll;
+#endif
 };
 
 struct e1000_config {
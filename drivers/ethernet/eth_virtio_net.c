@@ -6,11 +6,13 @@
 
 #include <zephyr/devicetree.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/net/ethernet_poll.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/drivers/virtio.h>
 #include <zephyr/drivers/virtio/virtqueue.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
 #include "eth.h"
 
 #define DT_DRV_COMPAT virtio_net
@@ -87,6 +89,13 @@ enum _virtio_net_hdr_gso_types {
 
 #define VIRTIO_NET_BUFLEN                                                                          \
 	(NET_ETH_MTU + sizeof(struct net_eth_hdr) + sizeof(struct _virtio_net_hdr))
+
+/* With TSO the TX buffer has to hold a whole TCP super-segment */
+#if defined(CONFIG_ETH_VIRTIO_NET_TSO)
+#define VIRTIO_NET_TX_BUFLEN (VIRTIO_NET_BUFLEN + CONFIG_NET_TCP_GSO_MAX_SIZE)
+#else
+#define VIRTIO_NET_TX_BUFLEN VIRTIO_NET_BUFLEN
+#endif
 /* virtqueue pairs are numbered from 1 upwards */
 /* convert pair number to virtqueue index */
 #define VIRTQ_RX(n) ((n - 1) * 2)
@@ -110,8 +119,20 @@ struct virtnet_data {
 	const struct _virtio_net_config *virtio_devcfg;
 	uint8_t mac[6];
 	struct _rx_cb_data rx_cb_data[CONFIG_ETH_VIRTIO_NET_RX_BUFFERS];
-	uint8_t txb[VIRTIO_NET_BUFLEN];
+	bool tso;
+	uint8_t txb[VIRTIO_NET_TX_BUFLEN];
 	uint8_t rxb[CONFIG_ETH_VIRTIO_NET_RX_BUFFERS][VIRTIO_NET_BUFLEN];
+#if defined(CONFIG_ETH_VIRTIO_NET_RX_POLL)
+	struct net_eth_poll rx_poll;
+	/* Buffers returned by the device that are waiting to be polled, in the
+	 * order the device returned them, and the length of each buffer
+	 */
+	struct k_spinlock rx_lock;
+	uint16_t rx_done[CONFIG_ETH_VIRTIO_NET_RX_BUFFERS];
+	uint16_t rx_done_head;
+	uint16_t rx_done_count;
+	uint32_t rx_len[CONFIG_ETH_VIRTIO_NET_RX_BUFFERS];
+#endif
 };
 
 static uint16_t virtnet_enum_queues_cb(uint16_t q_index, uint16_t q_size_max, void *)
@@ -125,21 +146,103 @@ static uint16_t virtnet_enum_queues_cb(uint16_t q_index, uint16_t q_size_max, vo
 
 static enum ethernet_hw_caps virtnet_get_capabilities(const struct device *dev)
 {
-	return ETHERNET_LINK_10BASE | ETHERNET_LINK_100BASE | ETHERNET_LINK_1000BASE |
-	       ETHERNET_LINK_2500BASE | ETHERNET_LINK_5000BASE;
+	struct virtnet_data *data = dev->data;
+	enum ethernet_hw_caps caps = ETHERNET_LINK_10BASE | ETHERNET_LINK_100BASE |
+				     ETHERNET_LINK_1000BASE | ETHERNET_LINK_2500BASE |
+				     ETHERNET_LINK_5000BASE;
+
+	if (data->tso) {
+		caps |= ETHERNET_HW_TSO;
+	}
+
+	return caps;
 }
 
+#if defined(CONFIG_ETH_VIRTIO_NET_TSO)
+/* Fill in the virtio header so that the device segments the TCP super-segment
+ * in frame. The device calculates the checksum of each segment starting from
+ * the partial checksum of the pseudo-header (with zero length) that is stored
+ * in the TCP checksum field.
+ */
+static int virtnet_setup_tso(struct net_pkt *pkt, uint8_t *frame, size_t len,
+			     struct _virtio_net_hdr *hdr)
+{
+	size_t l2_len = sizeof(struct net_eth_hdr);
+	size_t l3_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	const uint8_t *addr;
+	size_t addr_len;
+	uint8_t *tcp;
+	uint32_t sum = NET_IPPROTO_TCP;
+
+	if (((const struct net_eth_hdr *)frame)->type == net_htons(NET_ETH_PTYPE_VLAN)) {
+		l2_len = sizeof(struct net_eth_vlan_hdr);
+	}
+
+	if (l2_len + l3_len + sizeof(struct net_tcp_hdr) > len) {
+		return -EINVAL;
+	}
+
+	if (net_pkt_family(pkt) == NET_AF_INET) {
+		hdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+		addr = frame + l2_len + offsetof(struct net_ipv4_hdr, src);
+		addr_len = 2 * sizeof(struct net_in_addr);
+	} else if (net_pkt_family(pkt) == NET_AF_INET6) {
+		hdr->gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+		addr = frame + l2_len + offsetof(struct net_ipv6_hdr, src);
+		addr_len = 2 * sizeof(struct net_in6_addr);
+	} else {
+		return -EINVAL;
+	}
+
+	/* Source and destination addresses are adjacent in both headers */
+	for (size_t i = 0; i < addr_len; i += 2) {
+		sum += sys_get_be16(&addr[i]);
+	}
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	tcp = frame + l2_len + l3_len;
+	sys_put_be16(sum, tcp + offsetof(struct net_tcp_hdr, chksum));
+
+	hdr->flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+	hdr->hdr_len = sys_cpu_to_le16(l2_len + l3_len + (tcp[12] >> 4) * 4);
+	hdr->gso_size = sys_cpu_to_le16(net_pkt_gso_size(pkt));
+	hdr->csum_start = sys_cpu_to_le16(l2_len + l3_len);
+	hdr->csum_offset = sys_cpu_to_le16(offsetof(struct net_tcp_hdr, chksum));
+
+	return 0;
+}
+#endif /* CONFIG_ETH_VIRTIO_NET_TSO */
+
 static int virtnet_send(const struct device *dev, struct net_pkt *pkt)
 {
 	const struct virtnet_config *config = dev->config;
 	struct virtnet_data *data = dev->data;
+	struct _virtio_net_hdr *hdr = (struct _virtio_net_hdr *)data->txb;
 	size_t len = net_pkt_get_len(pkt);
 
+	if (len > sizeof(data->txb) - sizeof(struct _virtio_net_hdr)) {
+		LOG_ERR("packet too large to be sent (%zu bytes)", len);
+		return -EMSGSIZE;
+	}
+
 	if (net_pkt_read(pkt, data->txb + sizeof(struct _virtio_net_hdr), len)) {
 		LOG_ERR("could not read contents of packet to be sent");
 		return -EIO;
 	}
 
+	memset(hdr, 0, sizeof(*hdr));
+
+#if defined(CONFIG_ETH_VIRTIO_NET_TSO)
+	if (net_pkt_gso_size(pkt) > 0 &&
+	    virtnet_setup_tso(pkt, data->txb + sizeof(struct _virtio_net_hdr), len, hdr)) {
+		LOG_ERR("could not set up segmentation offload");
+		return -EINVAL;
+	}
+#endif
+
 	struct virtq *vq = virtio_get_virtqueue(config->vdev, VIRTQ_TX(1));
 	struct virtq_buf vqbuf[] = {
 		{.addr = data->txb, .len = sizeof(struct _virtio_net_hdr) + len}};
@@ -152,17 +255,20 @@ static int virtnet_send(const struct device *dev, struct net_pkt *pkt)
 	return 0;
 }
 
-void virtnet_rx_cb(void *priv, uint32_t len)
+void virtnet_rx_cb(void *priv, uint32_t len);
+
+/* Pass the frame in a receive buffer to the network stack and give the buffer
+ * back to the device. The caller notifies the device.
+ */
+static void virtnet_rx_frame(struct virtnet_data *data, uint16_t buf_no, uint32_t len,
+			     k_timeout_t timeout)
 {
-	const struct _rx_cb_data *p = priv;
-	struct virtnet_data *data = p->data;
-	uint16_t buf_no = p->buf_no;
 	const struct virtnet_config *config = data->dev->config;
 	struct virtq *vq = virtio_get_virtqueue(config->vdev, VIRTQ_RX(1));
 
 	len -= sizeof(struct _virtio_net_hdr);
 	struct net_pkt *pkt =
-		net_pkt_rx_alloc_with_buffer(data->iface, len, NET_AF_UNSPEC, 0, K_FOREVER);
+		net_pkt_rx_alloc_with_buffer(data->iface, len, NET_AF_UNSPEC, 0, timeout);
 
 	if (pkt == NULL) {
 		LOG_ERR("received packet, but could not pass it to the operating system");
@@ -177,8 +283,85 @@ void virtnet_rx_cb(void *priv, uint32_t len)
 	}
 	struct virtq_buf vqbuf[] = {{.addr = &(data->rxb[buf_no]), .len = VIRTIO_NET_BUFLEN}};
 
-	virtq_add_buffer_chain(vq, vqbuf, 1, 0, virtnet_rx_cb, priv, K_FOREVER);
+	virtq_add_buffer_chain(vq, vqbuf, 1, 0, virtnet_rx_cb, &(data->rx_cb_data[buf_no]),
+			       K_FOREVER);
+}
+
+#if defined(CONFIG_ETH_VIRTIO_NET_RX_POLL)
+static int virtnet_rx_poll(struct net_eth_poll *poll, int budget)
+{
+	struct virtnet_data *data = CONTAINER_OF(poll, struct virtnet_data, rx_poll);
+	const struct virtnet_config *config = data->dev->config;
+	struct virtq *vq = virtio_get_virtqueue(config->vdev, VIRTQ_RX(1));
+	int done = 0;
+
+	/* Fetch the buffers returned while the interrupts were suppressed */
+	virtq_process_used(vq);
+
+	while (done < budget) {
+		k_spinlock_key_t key = k_spin_lock(&data->rx_lock);
+		uint16_t buf_no;
+
+		if (data->rx_done_count == 0) {
+			k_spin_unlock(&data->rx_lock, key);
+			break;
+		}
+
+		buf_no = data->rx_done[data->rx_done_head];
+		data->rx_done_head = (data->rx_done_head + 1) % CONFIG_ETH_VIRTIO_NET_RX_BUFFERS;
+		data->rx_done_count--;
+		k_spin_unlock(&data->rx_lock, key);
+
+		virtnet_rx_frame(data, buf_no, data->rx_len[buf_no], K_NO_WAIT);
+		done++;
+	}
+
+	if (done > 0) {
+		virtio_notify_virtqueue(config->vdev, VIRTQ_RX(1));
+	}
+
+	return done;
+}
+
+static bool virtnet_rx_rearm(struct net_eth_poll *poll)
+{
+	struct virtnet_data *data = CONTAINER_OF(poll, struct virtnet_data, rx_poll);
+	const struct virtnet_config *config = data->dev->config;
+	struct virtq *vq = virtio_get_virtqueue(config->vdev, VIRTQ_RX(1));
+
+	virtq_suppress_interrupts(vq, false);
+
+	/* No interrupt comes for the buffers returned before this point */
+	if (virtq_has_used(vq)) {
+		virtq_suppress_interrupts(vq, true);
+		return true;
+	}
+
+	return false;
+}
+#endif /* CONFIG_ETH_VIRTIO_NET_RX_POLL */
+
+void virtnet_rx_cb(void *priv, uint32_t len)
+{
+	const struct _rx_cb_data *p = priv;
+	struct virtnet_data *data = p->data;
+	const struct virtnet_config *config = data->dev->config;
+
+#if defined(CONFIG_ETH_VIRTIO_NET_RX_POLL)
+	k_spinlock_key_t key = k_spin_lock(&data->rx_lock);
+
+	data->rx_len[p->buf_no] = len;
+	data->rx_done[(data->rx_done_head + data->rx_done_count) %
+		      CONFIG_ETH_VIRTIO_NET_RX_BUFFERS] = p->buf_no;
+	data->rx_done_count++;
+	k_spin_unlock(&data->rx_lock, key);
+
+	virtq_suppress_interrupts(virtio_get_virtqueue(config->vdev, VIRTQ_RX(1)), true);
+	net_eth_poll_schedule(&data->rx_poll);
+#else
+	virtnet_rx_frame(data, p->buf_no, len, K_FOREVER);
 	virtio_notify_virtqueue(config->vdev, VIRTQ_RX(1));
+#endif
 }
 
 static void virtnet_if_init(struct net_if *iface)
@@ -190,6 +373,9 @@ static void virtnet_if_init(struct net_if *iface)
 
 	data->iface = iface;
 	net_if_set_link_addr(iface, data->mac, sizeof(data->virtio_devcfg->mac), NET_LINK_ETHERNET);
+#if defined(CONFIG_ETH_VIRTIO_NET_RX_POLL)
+	net_eth_poll_init(&data->rx_poll, virtnet_rx_poll, virtnet_rx_rearm);
+#endif
 	struct virtq *vq = virtio_get_virtqueue(config->vdev, VIRTQ_RX(1));
 
 	for (int i = 0; i < CONFIG_ETH_VIRTIO_NET_RX_BUFFERS; i++) {
@@ -216,6 +402,16 @@ static int virtnet_dev_init(const struct device *dev)
 	if (data->virtio_devcfg == NULL) {
 		LOG_ERR("could not get config struct");
 	}
+
+	if (IS_ENABLED(CONFIG_ETH_VIRTIO_NET_TSO) &&
+	    virtio_read_device_feature_bit(config->vdev, VIRTIO_NET_F_CSUM) &&
+	    virtio_read_device_feature_bit(config->vdev, VIRTIO_NET_F_HOST_TSO4) &&
+	    virtio_read_device_feature_bit(config->vdev, VIRTIO_NET_F_HOST_TSO6)) {
+		(void)virtio_write_driver_feature_bit(config->vdev, VIRTIO_NET_F_CSUM, true);
+		(void)virtio_write_driver_feature_bit(config->vdev, VIRTIO_NET_F_HOST_TSO4, true);
+		(void)virtio_write_driver_feature_bit(config->vdev, VIRTIO_NET_F_HOST_TSO6, true);
+		data->tso = true;
+	}
 	if (virtio_commit_feature_bits(config->vdev)) {
 		LOG_ERR("could not commit feature bits");
 	}
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/drivers/virtio/virtqueue.h>
+#include <zephyr/drivers/virtio/virtio_config.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/__assert.h>
@@ -66,6 +67,7 @@ int virtq_create(struct virtq *v, size_t size)
 	memset(v_area, 0, v_size);
 
 	v->last_used_idx = 0;
+	v->processing_used = false;
 
 	k_stack_alloc_init(&v->free_desc_stack, size);
 	for (uint16_t i = 0; i < size; i++) {
@@ -186,3 +188,87 @@ void virtq_add_free_desc(struct virtq *v, uint16_t desc_idx)
 	k_stack_push(&v->free_desc_stack, desc_idx);
 	v->free_desc_n++;
 }
+
+void virtq_process_used(struct virtq *v)
+{
+	k_spinlock_key_t key = k_spin_lock(&v->used_lock);
+
+	if (v->processing_used) {
+		k_spin_unlock(&v->used_lock, key);
+		return;
+	}
+
+	v->processing_used = true;
+
+	while (v->last_used_idx != sys_le16_to_cpu(v->used->idx)) {
+		uint16_t idx = v->last_used_idx % v->num;
+		uint16_t idx_le = sys_cpu_to_le16(idx);
+		uint16_t chain_head_le = v->used->ring[idx_le].id;
+		uint16_t chain_head = sys_le16_to_cpu(chain_head_le);
+		uint32_t used_len = sys_le32_to_cpu(v->used->ring[idx_le].len);
+
+		/*
+		 * We are making a copy here, because chain will be
+		 * returned before invoking the callback and may be
+		 * overwritten by the time callback is called. This
+		 * is to allow callback to immediately place the
+		 * descriptors back in the avail_ring
+		 */
+		struct virtq_receive_callback_entry cbe = v->recv_cbs[chain_head];
+
+		uint16_t next = chain_head;
+		bool last = false;
+
+		/*
+		 * We are done processing the descriptor chain, and
+		 * we can add used descriptors back to the free stack.
+		 * The only thing left to do is calling the callback
+		 * associated with the chain, but it was saved above on
+		 * the stack, so other code is free to use the descriptors
+		 */
+		while (!last) {
+			uint16_t curr = next;
+			uint16_t curr_le = sys_cpu_to_le16(curr);
+
+			next = v->desc[curr_le].next;
+			last = !(v->desc[curr_le].flags & VIRTQ_DESC_F_NEXT);
+			virtq_add_free_desc(v, curr);
+		}
+
+		v->last_used_idx++;
+
+		/*
+		 * The callback may allocate memory or wait for free descriptors,
+		 * so it can't be called with the spinlock held. Other contexts
+		 * calling this function in the meantime return right away, as
+		 * processing_used is set, so the order of callbacks is kept
+		 */
+		k_spin_unlock(&v->used_lock, key);
+
+		if (cbe.cb) {
+			cbe.cb(cbe.opaque, used_len);
+		}
+
+		key = k_spin_lock(&v->used_lock);
+	}
+
+	v->processing_used = false;
+
+	k_spin_unlock(&v->used_lock, key);
+}
+
+bool virtq_has_used(struct virtq *v)
+{
+	return v->last_used_idx != sys_le16_to_cpu(v->used->idx);
+}
+
+void virtq_suppress_interrupts(struct virtq *v, bool suppress)
+{
+	v->avail->flags = sys_cpu_to_le16(suppress ? VIRTQ_AVAIL_F_NO_INTERRUPT : 0);
+
+	/*
+	 * Make sure the device sees the new flags before the driver checks the used
+	 * ring for buffers returned while interrupts were suppressed
+	 */
+	barrier_dmem_fence_full();
+}
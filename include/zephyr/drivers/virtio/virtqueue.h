@@ -191,6 +191,18 @@ struct virtq {
 	 * array with callbacks invoked after receiving buffers back from the device
 	 */
 	struct virtq_receive_callback_entry *recv_cbs;
+
+	/**
+	 * lock serializing processing of the used ring, which can be done both by
+	 * the virtio isr and by a driver polling the virtqueue
+	 */
+	struct k_spinlock used_lock;
+
+	/**
+	 * true while a context is processing the used ring, others leave the chains
+	 * they see to it so that callbacks keep being invoked in order
+	 */
+	bool processing_used;
 };
 
 
@@ -248,6 +260,41 @@ int virtq_add_buffer_chain(
 	k_timeout_t timeout
 );
 
+/**
+ * @brief processes buffer chains returned by the device
+ *
+ * Adds the descriptors of every chain in the used ring back to the free stack and
+ * invokes the callback of the chain. This is called by the virtio isr, and can also
+ * be called by a driver polling a virtqueue whose interrupts it suppressed. The
+ * callbacks are invoked without any lock held, in the order the device returned
+ * the chains, so they may block and add buffers back to the virtqueue. If another
+ * context is already processing the used ring, this function returns right away
+ * and that context also processes the chains returned in the meantime
+ *
+ * @param v virtqueue it operates on
+ */
+void virtq_process_used(struct virtq *v);
+
+/**
+ * @brief checks whether the device returned buffer chains that weren't processed yet
+ *
+ * @param v virtqueue it operates on
+ * @return true if virtq_process_used would invoke at least one callback
+ */
+bool virtq_has_used(struct virtq *v);
+
+/**
+ * @brief asks the device to not send interrupts for the virtqueue
+ *
+ * It's only a hint, the device may still send interrupts (see spec 2.7.10). After
+ * enabling interrupts back, the driver should check virtq_has_used, as the device
+ * doesn't send an interrupt for buffers it returned while they were suppressed
+ *
+ * @param v virtqueue it operates on
+ * @param suppress true to suppress interrupts, false to enable them back
+ */
+void virtq_suppress_interrupts(struct virtq *v, bool suppress);
+
 /**
  * @brief adds free descriptor back
  *
@@ -372,6 +372,342 @@ static inline void net_capture_foreach(net_capture_cb_t cb, void *user_data)
 
 /** @endcond */
 
+/**
+ * @brief Classic BPF instruction.
+ *
+ * The layout is the one of the Linux and BSD classic BPF, so a filter
+ * compiled with "tcpdump -dd <expression>" can be used as is.
+ */
+struct net_capture_bpf_insn {
+	uint16_t code; /**< Instruction class, size, mode and operation */
+	uint8_t jt;    /**< Jump offset if the condition is true */
+	uint8_t jf;    /**< Jump offset if the condition is false */
+	uint32_t k;    /**< Constant operand */
+};
+
+/** @cond INTERNAL_HIDDEN */
+
+/* Instruction classes */
+#define NET_BPF_CLASS(code) ((code) & 0x07)
+#define NET_BPF_LD   0x00
+#define NET_BPF_LDX  0x01
+#define NET_BPF_ST   0x02
+#define NET_BPF_STX  0x03
+#define NET_BPF_ALU  0x04
+#define NET_BPF_JMP  0x05
+#define NET_BPF_RET  0x06
+#define NET_BPF_MISC 0x07
+
+/* Load size */
+#define NET_BPF_SIZE(code) ((code) & 0x18)
+#define NET_BPF_W 0x00
+#define NET_BPF_H 0x08
+#define NET_BPF_B 0x10
+
+/* Load mode */
+#define NET_BPF_MODE(code) ((code) & 0xe0)
+#define NET_BPF_IMM 0x00
+#define NET_BPF_ABS 0x20
+#define NET_BPF_IND 0x40
+#define NET_BPF_MEM 0x60
+#define NET_BPF_LEN 0x80
+#define NET_BPF_MSH 0xa0
+
+/* ALU and jump operations */
+#define NET_BPF_OP(code) ((code) & 0xf0)
+#define NET_BPF_ADD  0x00
+#define NET_BPF_SUB  0x10
+#define NET_BPF_MUL  0x20
+#define NET_BPF_DIV  0x30
+#define NET_BPF_OR   0x40
+#define NET_BPF_AND  0x50
+#define NET_BPF_LSH  0x60
+#define NET_BPF_RSH  0x70
+#define NET_BPF_NEG  0x80
+#define NET_BPF_MOD  0x90
+#define NET_BPF_XOR  0xa0
+#define NET_BPF_JA   0x00
+#define NET_BPF_JEQ  0x10
+#define NET_BPF_JGT  0x20
+#define NET_BPF_JGE  0x30
+#define NET_BPF_JSET 0x40
+
+/* Operand source */
+#define NET_BPF_SRC(code) ((code) & 0x08)
+#define NET_BPF_K 0x00
+#define NET_BPF_X 0x08
+
+/* Return value */
+#define NET_BPF_RVAL(code) ((code) & 0x18)
+#define NET_BPF_A 0x10
+
+/* Miscellaneous operations */
+#define NET_BPF_MISCOP(code) ((code) & 0xf8)
+#define NET_BPF_TAX 0x00
+#define NET_BPF_TXA 0x80
+
+/* Number of scratch memory words */
+#define NET_BPF_MEMWORDS 16
+
+/** @endcond */
+
+/** Build a BPF statement */
+#define NET_BPF_STMT(_code, _k) { .code = (uint16_t)(_code), .jt = 0, .jf = 0, .k = (_k) }
+
+/** Build a BPF jump */
+#define NET_BPF_JUMP(_code, _k, _jt, _jf) \
+	{ .code = (uint16_t)(_code), .jt = (_jt), .jf = (_jf), .k = (_k) }
+
+/**
+ * @brief Check that a BPF program is valid.
+ *
+ * The program must end with a return, all the jumps must stay within the
+ * program and the scratch memory accesses within its
+ * NET_BPF_MEMWORDS words. Division by a zero constant is rejected.
+ *
+ * @param prog BPF program
+ * @param len Number of instructions in the program
+ *
+ * @return 0 if the program is valid, -EINVAL otherwise
+ */
+#if defined(CONFIG_NET_CAPTURE_FILTER)
+int net_capture_bpf_check(const struct net_capture_bpf_insn *prog, size_t len);
+#else
+static inline int net_capture_bpf_check(const struct net_capture_bpf_insn *prog, size_t len)
+{
+	ARG_UNUSED(prog);
+	ARG_UNUSED(len);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Run a BPF program over a network packet.
+ *
+ * The packet data is read from the start of the packet buffer, which
+ * contains the link layer header if the packet has one. The packet and
+ * its cursor are not modified.
+ *
+ * @param prog BPF program, checked with net_capture_bpf_check()
+ * @param len Number of instructions in the program
+ * @param pkt Network packet
+ *
+ * @return Number of bytes of the packet to capture, 0 if the packet
+ *         must not be captured.
+ */
+#if defined(CONFIG_NET_CAPTURE_FILTER)
+uint32_t net_capture_bpf_run(const struct net_capture_bpf_insn *prog, size_t len,
+			     struct net_pkt *pkt);
+#else
+static inline uint32_t net_capture_bpf_run(const struct net_capture_bpf_insn *prog,
+					   size_t len, struct net_pkt *pkt)
+{
+	ARG_UNUSED(prog);
+	ARG_UNUSED(len);
+	ARG_UNUSED(pkt);
+
+	return UINT32_MAX;
+}
+#endif
+
+/**
+ * @brief Set the packet filter of a capture device.
+ *
+ * Only the packets accepted by the filter are captured, and they are
+ * truncated to the length returned by the filter. The filter is run
+ * before the packet is copied, so packets that are not wanted cost
+ * only the filter run.
+ *
+ * @param dev Network capture device
+ * @param prog BPF program, must stay valid as long as it is set.
+ *        NULL removes the filter.
+ * @param len Number of instructions in the program
+ *
+ * @return 0 if ok, <0 if the program is not valid
+ */
+#if defined(CONFIG_NET_CAPTURE_FILTER)
+int net_capture_set_filter(const struct device *dev,
+			   const struct net_capture_bpf_insn *prog, size_t len);
+#else
+static inline int net_capture_set_filter(const struct device *dev,
+					 const struct net_capture_bpf_insn *prog,
+					 size_t len)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(prog);
+	ARG_UNUSED(len);
+
+	return -ENOTSUP;
+}
+#endif
+
+/** pcap file header, written once before the captured records */
+struct net_capture_pcap_hdr {
+	uint32_t magic;         /**< 0xa1b2c3d4 in host byte order */
+	uint16_t version_major; /**< Major version, 2 */
+	uint16_t version_minor; /**< Minor version, 4 */
+	int32_t thiszone;       /**< GMT to local correction, 0 */
+	uint32_t sigfigs;       /**< Accuracy of timestamps, 0 */
+	uint32_t snaplen;       /**< Max length of captured packets */
+	uint32_t linktype;      /**< Data link type (LINKTYPE_*) */
+} __packed;
+
+/** pcap record header, precedes the data of each captured packet */
+struct net_capture_pcap_rec_hdr {
+	uint32_t ts_sec;   /**< Timestamp seconds */
+	uint32_t ts_usec;  /**< Timestamp microseconds */
+	uint32_t incl_len; /**< Number of bytes of the packet in the record */
+	uint32_t orig_len; /**< Length of the packet */
+} __packed;
+
+/**
+ * @brief Start capturing into the pcap ring buffer.
+ *
+ * The packets of the network interface that the filter accepts are
+ * stored in pcap format in a ring buffer, without cloning them nor
+ * sending them anywhere. The application reads the records in place
+ * with net_capture_ring_get_claim() and net_capture_ring_get_finish().
+ * Packets that do not fit in the ring are dropped and counted.
+ *
+ * Only the interfaces whose packets map to a single pcap link type can be
+ * captured: Ethernet, IEEE 802.15.4 and dummy L2 interfaces.
+ *
+ * @param iface Network interface to capture
+ * @param prog BPF program, must stay valid until net_capture_ring_stop()
+ *        returns. NULL captures all the packets.
+ * @param len Number of instructions in the program
+ * @param snaplen Max number of bytes stored from each packet
+ *
+ * @return 0 if ok, -ENOTSUP if the L2 of the interface is not supported,
+ *         <0 if the capture could not be started
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_start(struct net_if *iface,
+			   const struct net_capture_bpf_insn *prog, size_t len,
+			   uint32_t snaplen);
+#else
+static inline int net_capture_ring_start(struct net_if *iface,
+					 const struct net_capture_bpf_insn *prog,
+					 size_t len, uint32_t snaplen)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(prog);
+	ARG_UNUSED(len);
+	ARG_UNUSED(snaplen);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Stop capturing into the pcap ring buffer.
+ *
+ * The records already in the ring can still be read. Waits for the
+ * packets being filtered, so it must be called from a thread.
+ *
+ * @return 0 if ok, -EALREADY if the capture was not started
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_stop(void);
+#else
+static inline int net_capture_ring_stop(void)
+{
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Fill the pcap file header matching the ring buffer records.
+ *
+ * @param hdr pcap file header
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+void net_capture_ring_pcap_header(struct net_capture_pcap_hdr *hdr);
+#else
+static inline void net_capture_ring_pcap_header(struct net_capture_pcap_hdr *hdr)
+{
+	ARG_UNUSED(hdr);
+}
+#endif
+
+/**
+ * @brief Get a pointer to the captured data in the ring buffer.
+ *
+ * The data is a stream of pcap records, a record may be split between
+ * two claims when the ring wraps around. Only one thread may read the
+ * ring.
+ *
+ * @param data Set to the start of the captured data
+ * @param size Max number of bytes to claim
+ *
+ * @return Number of bytes available at @p data
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+uint32_t net_capture_ring_get_claim(uint8_t **data, uint32_t size);
+#else
+static inline uint32_t net_capture_ring_get_claim(uint8_t **data, uint32_t size)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(size);
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief Release the captured data read from the ring buffer.
+ *
+ * @param size Number of bytes read, at most the claimed amount
+ *
+ * @return 0 if ok, -EINVAL if more than the claimed data is released
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+int net_capture_ring_get_finish(uint32_t size);
+#else
+static inline int net_capture_ring_get_finish(uint32_t size)
+{
+	ARG_UNUSED(size);
+
+	return -ENOTSUP;
+}
+#endif
+
+/** @cond INTERNAL_HIDDEN */
+
+/**
+ * @brief Store the network packet in the pcap ring buffer if it needs
+ *        to be captured.
+ *
+ * @param iface Network interface the packet is being sent or received
+ * @param pkt The network packet
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt);
+#else
+static inline void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(pkt);
+}
+#endif
+
+/** @endcond */
+
+/**
+ * @brief Get the number of packets dropped because the ring was full.
+ *
+ * @return Number of dropped packets since the capture was started
+ */
+#if defined(CONFIG_NET_CAPTURE_RING)
+uint32_t net_capture_ring_dropped(void);
+#else
+static inline uint32_t net_capture_ring_dropped(void)
+{
+	return 0;
+}
+#endif
+
 /**
  * @}
  */
@@ -41,7 +41,11 @@ struct coap_client_response_data {
 	 * @ref coap_response_code for positive.
 	 */
 	int16_t result_code;
-	/** A pointer to the response CoAP packet. NULL for error result. */
+	/**
+	 * A pointer to the response CoAP packet. NULL for error result.
+	 * With @kconfig{CONFIG_COAP_CLIENT_BLOCK_PIPELINING}, a block that was received out of
+	 * order is reported with the packet of the block that completed the sequence.
+	 */
 	const struct coap_packet *packet;
 	/** Payload offset from the beginning of a blockwise transfer. */
 	size_t offset;
@@ -142,6 +146,19 @@ struct coap_client_request {
 };
 
 /** @cond INTERNAL_HIDDEN */
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+struct coap_client_block_slot {
+	struct coap_pending pending;
+	uint32_t num;
+	uint16_t id;
+	uint16_t len;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	bool active;
+	bool received;
+	uint8_t payload[CONFIG_COAP_CLIENT_BLOCK_SIZE];
+};
+#endif
+
 struct coap_client_internal_request {
 	uint8_t request_token[COAP_TOKEN_MAX_LEN];
 	uint32_t offset;
@@ -160,6 +177,15 @@ struct coap_client_internal_request {
 	/* For GETs with observe option set */
 	bool is_observe;
 	int last_response_id;
+
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+	/* For block-wise GETs with several blocks requested at once */
+	bool pipelined;
+	uint32_t num_blocks;
+	uint32_t next_block;
+	uint32_t deliver_block;
+	struct coap_client_block_slot blocks[CONFIG_COAP_CLIENT_BLOCK_WINDOW];
+#endif
 };
 
 struct coap_client {
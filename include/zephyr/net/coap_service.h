@@ -47,6 +47,9 @@ struct coap_service_data {
 	int sock_fd;
 	struct coap_observer observers[CONFIG_COAP_SERVICE_OBSERVERS];
 	struct coap_pending pending[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+	/* Min-heap of the pending messages, ordered by retransmission time */
+	struct coap_pending *pending_heap[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+	size_t pending_count;
 };
 
 struct coap_service {
@@ -307,6 +310,25 @@ int coap_resource_send(const struct coap_resource *resource, const struct coap_p
 		       const struct net_sockaddr *addr, net_socklen_t addr_len,
 		       const struct coap_transmission_parameters *params);
 
+/**
+ * @brief Send a notification to all the observers of the provided @p resource .
+ *
+ * @note This function is suitable for a @p resource defined with @ref COAP_RESOURCE_DEFINE.
+ *
+ * The notification is encoded once, without a token, and sent to each observer with its own
+ * token and a new message ID. The options and the payload of @p cpkt , including the Observe
+ * option, are sent as is. The messages are passed to the network stack in batches of
+ * @kconfig{CONFIG_COAP_SERVER_NOTIFY_BATCH} with zsock_sendmmsg().
+ *
+ * @param resource Pointer to CoAP resource
+ * @param cpkt CoAP Packet to send, with a zero length token
+ * @param params Pointer to transmission parameters structure or NULL to use default values.
+ * @return Number of observers the notification was sent to, or negative in case of error.
+ */
+int coap_resource_send_observers(struct coap_resource *resource,
+				 const struct coap_packet *cpkt,
+				 const struct coap_transmission_parameters *params);
+
 /**
  * @brief Parse a CoAP observe request for the provided @p resource .
  *
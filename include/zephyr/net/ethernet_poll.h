@@ -0,0 +1,123 @@
+/** @file
+ * @brief Ethernet polled receive public header file
+ *
+ * Drivers using polled receive take one interrupt for a burst of received
+ * frames instead of one interrupt per frame. The interrupt handler masks
+ * the receive interrupt and schedules the poll, the Ethernet L2 then calls
+ * the driver from a work queue to process at most a budget of frames at a
+ * time, and the driver unmasks the interrupt once its receive ring is empty.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_ETHERNET_POLL_H_
+#define ZEPHYR_INCLUDE_NET_ETHERNET_POLL_H_
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ethernet polled receive API
+ * @defgroup eth_poll Ethernet polled receive API
+ * @ingroup ethernet
+ * @{
+ */
+
+struct net_eth_poll;
+
+/**
+ * @brief Driver callback processing received frames.
+ *
+ * Called from the Ethernet poll work queue with the receive interrupt
+ * masked. The driver passes at most @p budget received frames to the
+ * network stack.
+ *
+ * @param poll Poll context of the driver.
+ * @param budget Maximum number of frames to process.
+ *
+ * @return Number of frames processed. If it is less than @p budget, the
+ *         receive ring is considered empty.
+ */
+typedef int (*net_eth_poll_cb_t)(struct net_eth_poll *poll, int budget);
+
+/**
+ * @brief Driver callback unmasking the receive interrupt.
+ *
+ * Called when the poll callback has emptied the receive ring.
+ *
+ * @param poll Poll context of the driver.
+ *
+ * @return true if frames were received while the interrupt was masked and
+ *         polling must continue, in which case the driver masks the
+ *         interrupt again, false otherwise.
+ */
+typedef bool (*net_eth_poll_rearm_cb_t)(struct net_eth_poll *poll);
+
+/**
+ * @brief Polled receive context of an Ethernet driver.
+ *
+ * Typically embedded in the driver data, the driver can get back to its
+ * data with CONTAINER_OF() in the callbacks.
+ */
+struct net_eth_poll {
+	/** @cond INTERNAL_HIDDEN */
+	struct k_work work;
+	net_eth_poll_cb_t poll_cb;
+	net_eth_poll_rearm_cb_t rearm_cb;
+	/** @endcond */
+};
+
+#if defined(CONFIG_NET_L2_ETHERNET_POLL) || defined(__DOXYGEN__)
+/**
+ * @brief Initialize the polled receive context of a driver.
+ *
+ * @param poll Poll context to initialize.
+ * @param poll_cb Callback processing received frames.
+ * @param rearm_cb Callback unmasking the receive interrupt.
+ */
+void net_eth_poll_init(struct net_eth_poll *poll,
+		       net_eth_poll_cb_t poll_cb,
+		       net_eth_poll_rearm_cb_t rearm_cb);
+
+/**
+ * @brief Schedule polling of received frames.
+ *
+ * Called by the driver, typically from its interrupt handler after masking
+ * the receive interrupt. Scheduling an already scheduled poll does nothing.
+ *
+ * @param poll Poll context of the driver.
+ */
+void net_eth_poll_schedule(struct net_eth_poll *poll);
+#else
+static inline void net_eth_poll_init(struct net_eth_poll *poll,
+				     net_eth_poll_cb_t poll_cb,
+				     net_eth_poll_rearm_cb_t rearm_cb)
+{
+	ARG_UNUSED(poll);
+	ARG_UNUSED(poll_cb);
+	ARG_UNUSED(rearm_cb);
+}
+
+static inline void net_eth_poll_schedule(struct net_eth_poll *poll)
+{
+	ARG_UNUSED(poll);
+}
+#endif /* CONFIG_NET_L2_ETHERNET_POLL */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_ETHERNET_POLL_H_ */
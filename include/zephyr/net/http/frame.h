@@ -60,6 +60,10 @@ enum http2_frame_type {
 #define HTTP2_HEADERS_FRAME_PRIORITY_LEN 5
 #define HTTP2_PRIORITY_FRAME_LEN 5
 #define HTTP2_RST_STREAM_FRAME_LEN 4
+#define HTTP2_GOAWAY_FRAME_LEN 8
+
+#define HTTP2_PROTOCOL_ERROR     0x01
+#define HTTP2_FLOW_CONTROL_ERROR 0x03
 
 /** @endcond */
 
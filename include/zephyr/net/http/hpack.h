@@ -12,6 +12,7 @@
 #ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_HPACK_H_
 #define ZEPHYR_INCLUDE_NET_HTTP_SERVER_HPACK_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -104,6 +105,15 @@ enum http_hpack_static_key {
 #define HTTP_SERVER_HUFFMAN_DECODE_BUFFER_SIZE 0
 #endif
 
+#if defined(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE)
+#define HTTP_SERVER_HPACK_DYNAMIC_TABLE_SIZE CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE_SIZE
+#else
+#define HTTP_SERVER_HPACK_DYNAMIC_TABLE_SIZE 0
+#endif
+
+/* Size of a dynamic table entry on top of its name and value (RFC7541, ch 4.1). */
+#define HTTP_HPACK_ENTRY_OVERHEAD 32
+
 /** @endcond */
 
 /** HTTP2 header field with decoding buffer. */
@@ -129,6 +139,37 @@ struct http_hpack_header_buf {
 
 /** @cond INTERNAL_HIDDEN */
 
+struct http_hpack_encoder_entry {
+	uint16_t offset;
+	uint16_t name_len;
+	uint16_t value_len;
+};
+
+/** HPACK encoder dynamic table, one per HTTP2 connection. */
+struct http_hpack_encoder {
+	/** Names and values of the table entries, oldest first. */
+	uint8_t buf[HTTP_SERVER_HPACK_DYNAMIC_TABLE_SIZE];
+
+	/** Table entries, oldest first. */
+	struct http_hpack_encoder_entry
+		entries[HTTP_SERVER_HPACK_DYNAMIC_TABLE_SIZE / HTTP_HPACK_ENTRY_OVERHEAD];
+
+	/** Length of the data in the buffer. */
+	size_t used;
+
+	/** Size of the table, as defined in RFC7541. */
+	size_t size;
+
+	/** Maximum size of the table, as signaled to the decoder. */
+	size_t max_size;
+
+	/** Number of entries in the table. */
+	uint16_t count;
+
+	/** The maximum size has to be signaled in the next header block. */
+	bool size_update;
+};
+
 int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
 			      uint8_t *buf, size_t buflen);
 int http_hpack_huffman_encode(const uint8_t *str, size_t str_len,
@@ -137,6 +178,12 @@ int http_hpack_decode_header(const uint8_t *buf, size_t datalen,
 			     struct http_hpack_header_buf *header);
 int http_hpack_encode_header(uint8_t *buf, size_t buflen,
 			     struct http_hpack_header_buf *header);
+size_t http_hpack_huffman_encoded_len(const uint8_t *str, size_t str_len);
+void http_hpack_encoder_init(struct http_hpack_encoder *encoder);
+void http_hpack_encoder_reset(struct http_hpack_encoder *encoder);
+void http_hpack_encoder_set_max_size(struct http_hpack_encoder *encoder, uint32_t max_size);
+int http_hpack_encoder_encode_header(struct http_hpack_encoder *encoder, uint8_t *buf,
+				     size_t buflen, struct http_hpack_header_buf *header);
 
 /** @endcond */
 
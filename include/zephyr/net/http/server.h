@@ -366,6 +366,32 @@ struct http2_stream_ctx {
 
 	/** Flag indicating that END_STREAM flag was sent. */
 	bool end_stream_sent : 1;
+
+/** @cond INTERNAL_HIDDEN */
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+	/** Stream-level send window, i.e. flow control credit from the peer. */
+	int send_window;
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	/** Cached file waiting for the send window to open. */
+	struct http_static_fs_cache_entry *cache_entry;
+
+	/** Offset of the next byte of the cached file to send. */
+	size_t cache_offset;
+
+	/** Number of bytes of the cached file left to send. */
+	size_t cache_len;
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	/** Worker job serving the stream, NULL if served by the server thread. */
+	struct http_server_job *job;
+
+	/** The peer reset the stream while a worker was serving it. */
+	bool reset;
+#endif
+/** @endcond */
 };
 
 /** @brief HTTP/2 frame representation. */
@@ -445,6 +471,12 @@ struct http_client_ctx {
 	/** HTTP/2 header parser context. */
 	struct http_hpack_header_buf header_field;
 
+/** @cond INTERNAL_HIDDEN */
+	/** HPACK dynamic table of the HTTP/2 response headers. */
+	IF_ENABLED(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE,
+		   (struct http_hpack_encoder hpack_encoder;))
+/** @endcond */
+
 	/** HTTP/2 streams context. */
 	struct http2_stream_ctx streams[HTTP_SERVER_MAX_STREAMS];
 
@@ -495,6 +527,67 @@ struct http_client_ctx {
 	IF_ENABLED(CONFIG_HTTP_SERVER_COMPRESSION, (uint8_t supported_compression));
 /** @endcond */
 
+/** @cond INTERNAL_HIDDEN */
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	/** Entity tags from the If-None-Match request header. */
+	uint32_t if_none_match[CONFIG_HTTP_SERVER_STATIC_FS_CACHE_IF_NONE_MATCH_COUNT];
+
+	/** Number of entity tags in if_none_match. */
+	uint8_t if_none_match_count;
+
+	/** First byte position from the Range request header, or the suffix
+	 *  length if range_suffix is set.
+	 */
+	size_t range_first;
+
+	/** Last byte position from the Range request header, SIZE_MAX if
+	 *  the range is open-ended.
+	 */
+	size_t range_last;
+
+	/** If-None-Match header with "*" was present. */
+	bool if_none_match_any : 1;
+
+	/** Range header with a single byte range was present. */
+	bool has_range : 1;
+
+	/** The byte range covers the last range_first bytes. */
+	bool range_suffix : 1;
+
+	/** Flag indicating If-None-Match header is being processed. */
+	bool if_none_match_next : 1;
+
+	/** Flag indicating Range header is being processed. */
+	bool range_next : 1;
+#endif
+/** @endcond */
+
+/** @cond INTERNAL_HIDDEN */
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+	/** Connection-level send window. */
+	int send_window;
+
+	/** Initial stream-level send window, from the peer's SETTINGS. */
+	int peer_initial_window;
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	/** Serializes the frames sent by the server thread and the workers,
+	 *  and protects the flow control state.
+	 */
+	struct k_mutex tx_lock;
+
+	/** Signalled when the send window opens or a worker job finishes. */
+	struct k_condvar tx_cond;
+
+	/** Number of worker jobs in flight for the client. */
+	int jobs;
+
+	/** The connection is being closed, workers must stop sending. */
+	bool closing;
+#endif
+/** @endcond */
+
 	/** Flag indicating that HTTP2 preface was sent. */
 	bool preface_sent : 1;
 
@@ -549,6 +642,14 @@ int http_server_start(void);
  */
 int http_server_stop(void);
 
+/** @brief Drop all the static file system resources cached by the server.
+ *
+ * The cache notices the files that change size on its own, this function
+ * has to be called after updating a cached file in place.
+ * Available if @kconfig{CONFIG_HTTP_SERVER_STATIC_FS_CACHE} is enabled.
+ */
+void http_server_static_fs_cache_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
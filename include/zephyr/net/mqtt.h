@@ -864,6 +864,37 @@ struct mqtt_transport {
 #endif
 };
 
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW) || defined(__DOXYGEN__)
+/** @brief QoS 1 or QoS 2 message awaiting an acknowledgment. */
+struct mqtt_inflight {
+	/** Parameters the message was published with. */
+	struct mqtt_publish_param param;
+
+	/** Wall clock value (in milliseconds) of the last transmission. */
+	uint32_t sent;
+
+	/** PUBREC was received, PUBREL is sent instead of PUBLISH. */
+	uint8_t released : 1;
+
+	/** The message is resent regardless of the retransmission timeout. */
+	uint8_t resend : 1;
+
+	/** The entry is in use. */
+	uint8_t used : 1;
+};
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
+#if defined(CONFIG_MQTT_TOPIC_ALIAS_AUTO) || defined(__DOXYGEN__)
+/** @brief Topic alias assigned to a published topic. */
+struct mqtt_tx_topic_alias {
+	/** Aliased topic, known to the broker. */
+	struct mqtt_topic_alias topic;
+
+	/** Value of the alias clock when the topic was last published. */
+	uint32_t last_used;
+};
+#endif /* CONFIG_MQTT_TOPIC_ALIAS_AUTO */
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -890,6 +921,28 @@ struct mqtt_internal {
 	/** Internal. MQTT 5.0 disconnect reason set in case of processing errors. */
 	enum mqtt_disconnect_reason_code disconnect_reason;
 #endif /* CONFIG_MQTT_VERSION_5_0 */
+
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW) || defined(__DOXYGEN__)
+	/** Internal. QoS 1 and QoS 2 messages awaiting an acknowledgment. */
+	struct mqtt_inflight inflight[CONFIG_MQTT_INFLIGHT_MAX];
+
+	/** Internal. Number of messages in the in-flight window. */
+	uint16_t inflight_count;
+
+	/** Internal. In-flight window size agreed with the broker. */
+	uint16_t inflight_max;
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
+#if defined(CONFIG_MQTT_TOPIC_ALIAS_AUTO) || defined(__DOXYGEN__)
+	/** Internal. Topic aliases assigned to the published topics. */
+	struct mqtt_tx_topic_alias tx_topic_aliases[CONFIG_MQTT_TOPIC_ALIAS_AUTO_MAX];
+
+	/** Internal. Number of topic aliases accepted by the broker. */
+	uint16_t tx_topic_alias_max;
+
+	/** Internal. Incremented on each use of a topic alias. */
+	uint32_t tx_topic_alias_clock;
+#endif /* CONFIG_MQTT_TOPIC_ALIAS_AUTO */
 };
 
 /**
@@ -1083,10 +1136,35 @@ int mqtt_connect(struct mqtt_client *client);
  *                  Shall not be NULL.
  *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -EAGAIN is returned for QoS 1 and QoS 2 messages when the
+ *         in-flight window (@kconfig{CONFIG_MQTT_INFLIGHT_WINDOW}) is full.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+/**
+ * @brief API to publish several messages with a single transport write.
+ *
+ * The packets are encoded one after another in the client transmit buffer
+ * and sent together with their payloads, which are not copied. Messages
+ * that do not fit in the transmit buffer, the batch size or the in-flight
+ * window are not sent, the application shall publish them again later.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] params Parameters to be used for the publish messages.
+ *                   Shall not be NULL.
+ * @param[in] count Number of messages in @p params.
+ *
+ * @note At most @kconfig{CONFIG_MQTT_PUBLISH_BATCH_MAX} messages are sent
+ *       per call.
+ *
+ * @return Number of messages sent, counted from the start of @p params, or
+ *         a negative error code (errno.h) indicating reason of failure.
+ */
+int mqtt_publish_batch(struct mqtt_client *client,
+		       const struct mqtt_publish_param *params, size_t count);
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
@@ -1230,6 +1308,8 @@ int mqtt_abort(struct mqtt_client *client);
  *        makes it possible to respect the Keep Alive time agreed with the
  *        broker on connection. @ref mqtt_connect for details on Keep Alive
  *        time.
+ * @note  With @kconfig{CONFIG_MQTT_INFLIGHT_WINDOW}, the unacknowledged
+ *        messages due for retransmission are sent from this function too.
  *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
@@ -1241,9 +1321,10 @@ int mqtt_live(struct mqtt_client *client);
  *
  * @param[in] client Client instance for which the procedure is requested.
  *
- * @return Time in milliseconds until next keep alive message is expected to
+ * @return Time in milliseconds until next keep alive message, or
+ *         retransmission of an unacknowledged message, is expected to
  *         be sent. Function will return -1 if keep alive messages are
- *         not enabled.
+ *         not enabled and no retransmission is pending.
  */
 int mqtt_keepalive_time_left(const struct mqtt_client *client);
 
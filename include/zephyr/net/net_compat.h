@@ -111,6 +111,7 @@ extern "C" {
 
 #define iovec                     net_iovec
 #define msghdr                    net_msghdr
+#define mmsghdr                   net_mmsghdr
 #define cmsghdr                   net_cmsghdr
 #define ALIGN_H(x)                NET_ALIGN_H(x)
 #define ALIGN_D(x)                NET_ALIGN_D(x)
@@ -172,6 +173,8 @@ extern "C" {
 #define TLS_DTLS_HANDSHAKE_ON_CONNECT     ZSOCK_TLS_DTLS_HANDSHAKE_ON_CONNECT
 #define TLS_CERT_VERIFY_RESULT            ZSOCK_TLS_CERT_VERIFY_RESULT
 #define TLS_CERT_VERIFY_CALLBACK          ZSOCK_TLS_CERT_VERIFY_CALLBACK
+#define TLS_CORK                          ZSOCK_TLS_CORK
+#define TLS_SESSION_STATS                 ZSOCK_TLS_SESSION_STATS
 #define TLS_PEER_VERIFY_NONE              ZSOCK_TLS_PEER_VERIFY_NONE
 #define TLS_PEER_VERIFY_OPTIONAL          ZSOCK_TLS_PEER_VERIFY_OPTIONAL
 #define TLS_PEER_VERIFY_REQUIRED          ZSOCK_TLS_PEER_VERIFY_REQUIRED
@@ -190,6 +193,7 @@ extern "C" {
 #define TLS_DTLS_CID_STATUS_BIDIRECTIONAL ZSOCK_TLS_DTLS_CID_STATUS_BIDIRECTIONAL
 
 #define tls_cert_verify_cb zsock_tls_cert_verify_cb
+#define tls_session_stats zsock_tls_session_stats
 
 #define AI_PASSIVE      ZSOCK_AI_PASSIVE
 #define AI_CANONNAME    ZSOCK_AI_CANONNAME
@@ -244,6 +248,8 @@ extern "C" {
 #define MSG_TRUNC    ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 #define MSG_WAITALL  ZSOCK_MSG_WAITALL
+#define MSG_MORE     ZSOCK_MSG_MORE
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
 
 #define TCP_NODELAY    ZSOCK_TCP_NODELAY
 #define TCP_KEEPIDLE   ZSOCK_TCP_KEEPIDLE
@@ -318,6 +318,8 @@ enum net_if_oper_state {
 struct net_offload;
 #endif /* CONFIG_NET_OFFLOAD */
 
+struct net_pkt_rx_pool;
+
 /** @cond INTERNAL_HIDDEN */
 #if defined(CONFIG_NET_IPV6)
 #define NET_IF_MAX_IPV6_ADDR CONFIG_NET_IF_UNICAST_IPV6_ADDR_COUNT
@@ -714,6 +716,13 @@ struct net_if_dev {
 	 * The value is in milliseconds since boot.
 	 */
 	int64_t oper_state_change_time;
+
+#if defined(CONFIG_NET_IF_RX_POOL)
+	/** Pools used for the packets received on this interface, NULL if
+	 * the global RX pools are used.
+	 */
+	struct net_pkt_rx_pool *rx_pool;
+#endif /* CONFIG_NET_IF_RX_POOL */
 };
 
 /**
@@ -1056,6 +1065,52 @@ static inline const struct device *net_if_get_device(struct net_if *iface)
 	return iface->if_dev->dev;
 }
 
+/**
+ * @brief Set the pools used for the packets received on an interface
+ *
+ * Packets allocated with net_pkt_rx_alloc_with_buffer() or
+ * net_pkt_rx_alloc_on_iface() for this interface are then taken from
+ * the given pools instead of the global RX pools. This should be done
+ * before the interface is brought up, typically by the driver in its
+ * interface init function.
+ *
+ * @param iface Pointer to a network interface structure
+ * @param pool Pools defined with NET_PKT_RX_POOL_DEFINE(), or NULL to use
+ *        the global RX pools.
+ */
+static inline void net_if_set_rx_pool(struct net_if *iface,
+				      struct net_pkt_rx_pool *pool)
+{
+#if defined(CONFIG_NET_IF_RX_POOL)
+	iface->if_dev->rx_pool = pool;
+#else
+	ARG_UNUSED(iface);
+	ARG_UNUSED(pool);
+#endif
+}
+
+/**
+ * @brief Get the pools used for the packets received on an interface
+ *
+ * @param iface Pointer to a network interface structure
+ *
+ * @return Pools of the interface, or NULL if it uses the global RX pools.
+ */
+static inline struct net_pkt_rx_pool *net_if_get_rx_pool(struct net_if *iface)
+{
+#if defined(CONFIG_NET_IF_RX_POOL)
+	if (iface == NULL || iface->if_dev == NULL) {
+		return NULL;
+	}
+
+	return iface->if_dev->rx_pool;
+#else
+	ARG_UNUSED(iface);
+
+	return NULL;
+#endif
+}
+
 /**
  * @brief Try enqueuing a packet to the net interface TX queue
  *
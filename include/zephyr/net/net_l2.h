@@ -48,6 +48,11 @@ enum net_l2_flags {
 	 * IP address etc to network interface.
 	 */
 	NET_L2_POINT_TO_POINT			= BIT(3),
+
+	/** L2 is able to split TCP super-segments into MSS sized segments
+	 * (generic segmentation offload).
+	 */
+	NET_L2_GSO				= BIT(4),
 } __packed;
 
 /**
@@ -361,6 +361,20 @@ struct net_pkt {
 	uint8_t ipv4_pmtu : 1;
 #endif /* CONFIG_NET_IPV4_PMTU */
 
+#if defined(CONFIG_NET_TCP_GSO)
+	/* Segment size to use when splitting a TCP super-segment. Zero if the
+	 * packet does not need to be segmented by L2 or the driver.
+	 */
+	uint16_t gso_size;
+#endif /* CONFIG_NET_TCP_GSO */
+
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING)
+	/* Flow hash of a received packet, used to select the RX queue.
+	 * Zero if the driver did not provide one.
+	 */
+	uint32_t rx_hash;
+#endif /* CONFIG_NET_TC_RX_FLOW_STEERING */
+
 	/* @endcond */
 };
 
@@ -873,6 +887,59 @@ static inline void net_pkt_set_ipv4_pmtu(struct net_pkt *pkt, bool value)
 }
 #endif /* CONFIG_NET_IPV4_PMTU */
 
+#if defined(CONFIG_NET_TCP_GSO)
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	return pkt->gso_size;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, uint16_t gso_size)
+{
+	pkt->gso_size = gso_size;
+}
+#else
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, uint16_t gso_size)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(gso_size);
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING)
+static inline uint32_t net_pkt_rx_hash(struct net_pkt *pkt)
+{
+	return pkt->rx_hash;
+}
+
+/* Drivers whose hardware computes a flow hash (e.g. the Toeplitz RSS hash)
+ * can pass it here so that the stack does not need to compute one.
+ */
+static inline void net_pkt_set_rx_hash(struct net_pkt *pkt, uint32_t hash)
+{
+	pkt->rx_hash = hash;
+}
+#else
+static inline uint32_t net_pkt_rx_hash(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_rx_hash(struct net_pkt *pkt, uint32_t hash)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(hash);
+}
+#endif /* CONFIG_NET_TC_RX_FLOW_STEERING */
+
 #if defined(CONFIG_NET_IPV4_FRAGMENT)
 static inline uint16_t net_pkt_ipv4_fragment_offset(struct net_pkt *pkt)
 {
@@ -1608,6 +1675,53 @@ static inline void net_pkt_set_remote_address(struct net_pkt *pkt,
 	NET_BUF_POOL_DEFINE(name, count, CONFIG_NET_BUF_DATA_SIZE,	\
 			    0, NULL)
 
+/**
+ * @brief Pools for the packets received on a network interface
+ *
+ * Defined with @ref NET_PKT_RX_POOL_DEFINE and tied to an interface with
+ * net_if_set_rx_pool().
+ */
+struct net_pkt_rx_pool {
+	/** Slab of net_pkt */
+	struct k_mem_slab *pkt_slab;
+
+	/** Pool of data fragments */
+	struct net_buf_pool *data_pool;
+
+	/** The pool is low when it has fewer free net_pkt than this */
+	uint16_t low_threshold;
+
+	/** Lowest number of free net_pkt seen so far */
+	uint16_t pkt_min_free;
+
+	/** Number of packet allocations that failed */
+	uint32_t alloc_failed;
+};
+
+/**
+ * @brief Create the pools for the packets received on a network interface
+ *
+ * Defines a net_pkt slab, a data fragment pool and the
+ * struct net_pkt_rx_pool named @p name tying them together.
+ *
+ * @param name Name of the struct net_pkt_rx_pool.
+ * @param pkt_count Number of net_pkt in the pool.
+ * @param buf_count Number of data fragments in the pool.
+ * @param low Number of free net_pkt under which the pool is low, see
+ *        net_pkt_rx_pool_is_low().
+ */
+#define NET_PKT_RX_POOL_DEFINE(name, pkt_count, buf_count, low)		\
+	NET_PKT_SLAB_DEFINE(name##_pkts, pkt_count);			\
+	NET_BUF_POOL_DEFINE(name##_bufs, buf_count,			\
+			    CONFIG_NET_BUF_DATA_SIZE,			\
+			    CONFIG_NET_PKT_BUF_USER_DATA_SIZE, NULL);	\
+	struct net_pkt_rx_pool name = {					\
+		.pkt_slab = &name##_pkts,				\
+		.data_pool = &name##_bufs,				\
+		.low_threshold = low,					\
+		.pkt_min_free = pkt_count,				\
+	}
+
 /** @cond INTERNAL_HIDDEN */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC) || \
@@ -2042,6 +2156,20 @@ struct net_pkt *net_pkt_alloc_from_slab(struct k_mem_slab *slab,
 struct net_pkt *net_pkt_rx_alloc(k_timeout_t timeout);
 #endif
 
+/**
+ * @brief Check if the RX pool of a network interface is running low
+ *
+ * Drivers can use this to stop taking frames from the hardware and leave
+ * them in the receive ring while the network stack catches up.
+ *
+ * @param iface The network interface.
+ *
+ * @return true if the interface has its own RX pool (see
+ *         net_if_set_rx_pool()) and it has fewer free net_pkt than its low
+ *         threshold, false otherwise.
+ */
+bool net_pkt_rx_pool_is_low(struct net_if *iface);
+
 #if !defined(NET_PKT_DEBUG_ENABLED)
 /**
  * @brief Allocate a network packet for a specific network interface.
@@ -78,6 +78,12 @@ extern "C" {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_send: More data is coming, only honored by TLS stream sockets with
+ *  CONFIG_NET_SOCKETS_TLS_CORK, see @ref ZSOCK_TLS_CORK.
+ */
+#define ZSOCK_MSG_MORE 0x8000
+/** zsock_recvmmsg: Turn on ZSOCK_MSG_DONTWAIT after the first message has been received */
+#define ZSOCK_MSG_WAITFORONE 0x10000
 /** @} */
 
 /**
@@ -261,6 +267,20 @@ extern "C" {
  *  Kconfig option is enabled.
  */
 #define ZSOCK_TLS_CERT_VERIFY_CALLBACK 20
+/** Socket option to cork a TLS stream socket. While corked, the data sent is
+ *  accumulated and only encrypted and sent as a TLS record once the record
+ *  buffer is full. Uncorking the socket sends the pending data right away.
+ *  The option accepts and returns an integer, 1 to cork and 0 to uncork.
+ *
+ *  The option is only available if CONFIG_NET_SOCKETS_TLS_CORK Kconfig
+ *  option is enabled.
+ */
+#define ZSOCK_TLS_CORK 21
+/** Read-only socket option to obtain the server-side TLS session resumption
+ *  statistics. The statistics are shared by all TLS sockets, the option
+ *  returns a @ref zsock_tls_session_stats structure.
+ */
+#define ZSOCK_TLS_SESSION_STATS 22
 
 /* Valid values for @ref TLS_PEER_VERIFY option */
 #define ZSOCK_TLS_PEER_VERIFY_NONE 0     /**< Peer verification disabled. */
@@ -302,6 +322,27 @@ struct zsock_tls_cert_verify_cb {
 	/** A pointer to an opaque context passed to the callback. */
 	void *ctx;
 };
+
+/** Data structure for @ref ZSOCK_TLS_SESSION_STATS socket option. */
+struct zsock_tls_session_stats {
+	/** Number of handshakes completed by TLS/DTLS server sockets. */
+	uint32_t handshakes;
+
+	/** Number of session ID lookups in the server session cache. */
+	uint32_t cache_lookups;
+
+	/** Number of sessions found in the server session cache. */
+	uint32_t cache_hits;
+
+	/** Number of session tickets received from clients. */
+	uint32_t ticket_lookups;
+
+	/** Number of valid session tickets received from clients. */
+	uint32_t ticket_hits;
+
+	/** Number of session ticket key rotations. */
+	uint32_t ticket_key_rotations;
+};
 /** @} */ /* for @name */
 /** @} */ /* for @defgroup */
 
@@ -538,6 +579,123 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
  */
 __syscall ssize_t zsock_recvmsg(int sock, struct net_msghdr *msg, int flags);
 
+/**
+ * @brief Send multiple messages on a socket
+ *
+ * @details
+ * Send the messages in @p msgvec with a single call. The socket is locked
+ * only once for the whole batch, which makes this cheaper than calling
+ * zsock_sendmsg() in a loop for datagram sockets. On return, the msg_len
+ * field of each sent message holds the number of bytes sent.
+ * This function is also exposed as `sendmmsg()`
+ * if @kconfig{CONFIG_POSIX_API} is defined.
+ *
+ * @param sock Socket descriptor
+ * @param msgvec Array of messages to send
+ * @param vlen Number of elements in @p msgvec
+ * @param flags Same flags as for zsock_sendmsg()
+ *
+ * @return Number of messages sent, or -1 with errno set if no message
+ *         could be sent.
+ */
+__syscall int zsock_sendmmsg(int sock, struct net_mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple messages from a socket
+ *
+ * @details
+ * Receive up to @p vlen messages with a single call. The socket is locked
+ * only once for the whole batch, so a datagram server can drain its
+ * receive queue without paying a call per datagram. On return, the msg_len
+ * field of each received message holds the number of bytes received.
+ * Blocking applies to every message unless ZSOCK_MSG_DONTWAIT is set, or
+ * ZSOCK_MSG_WAITFORONE is set in which case only the first message is
+ * waited for.
+ * This function is also exposed as `recvmmsg()`
+ * if @kconfig{CONFIG_POSIX_API} is defined.
+ *
+ * @param sock Socket descriptor
+ * @param msgvec Array of messages to receive to
+ * @param vlen Number of elements in @p msgvec
+ * @param flags Same flags as for zsock_recvmsg(), and ZSOCK_MSG_WAITFORONE
+ *
+ * @return Number of messages received, or -1 with errno set if no message
+ *         could be received.
+ */
+__syscall int zsock_recvmmsg(int sock, struct net_mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+struct net_buf;
+
+/**
+ * @brief Receive data from a socket without copying it
+ *
+ * @details
+ * Instead of copying the payload into a caller supplied buffer, hand over
+ * the network buffers the data was received into. For a datagram socket
+ * one call returns one whole datagram, for a stream socket it returns the
+ * data of one received segment. The returned fragment chain starts at the
+ * first payload byte, protocol headers have already been stripped.
+ *
+ * The buffers stay allocated from the network RX pool until released with
+ * zsock_recv_buf_release(), so they should be handed back as soon as the
+ * data has been consumed or the stack may run out of RX buffers.
+ *
+ * As network buffers live in kernel memory, this function is available
+ * to supervisor threads only.
+ * Available only if @kconfig{CONFIG_NET_SOCKETS_ZEROCOPY_RX} is enabled.
+ *
+ * @param sock Socket descriptor
+ * @param frags On success, set to the received fragment chain, or to NULL
+ *              if no payload was received.
+ * @param flags Same flags as for zsock_recvfrom(), except ZSOCK_MSG_PEEK
+ *              which is not supported.
+ * @param src_addr Optional source address of the received data
+ * @param addrlen Size of @p src_addr, updated to the actual address length
+ *
+ * @return Number of bytes in @p frags, 0 on end of stream, or -1 with errno
+ *         set on error.
+ */
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct net_sockaddr *src_addr, net_socklen_t *addrlen);
+
+/**
+ * @brief Release buffers obtained from zsock_recv_buf()
+ *
+ * @param frags Fragment chain returned by zsock_recv_buf(), can be NULL.
+ */
+void zsock_recv_buf_release(struct net_buf *frags);
+
+struct fs_file_t;
+
+/**
+ * @brief Send the content of a file over a stream socket
+ *
+ * @details
+ * The file data is read directly into the network send buffers, which
+ * avoids bouncing it through an intermediate application buffer. The call
+ * blocks until @p count bytes, or the rest of the file, have been queued
+ * for transmission unless the socket is in non-blocking mode.
+ *
+ * Network buffers live in kernel memory, so this function is available
+ * to supervisor threads only.
+ * Available only if @kconfig{CONFIG_NET_SOCKETS_SENDFILE} is enabled.
+ *
+ * @param sock Socket descriptor of a connected stream socket
+ * @param file File to send, opened for reading
+ * @param offset If not NULL, the file offset to start reading from. It is
+ *               updated to point after the last byte sent. If NULL, the
+ *               data is read from the current file position.
+ * @param count Maximum number of bytes to send
+ *
+ * @return Number of bytes sent, 0 at end of file, or -1 with errno set on
+ *         error. errno is set to EOPNOTSUPP if the socket type does not
+ *         support this operation.
+ */
+ssize_t zsock_sendfile(int sock, struct fs_file_t *file, off_t *offset,
+		       size_t count);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -1241,6 +1399,10 @@ struct socket_op_vtable {
 			   net_socklen_t *addrlen);
 	int (*getsockname)(void *obj, struct net_sockaddr *addr,
 			   net_socklen_t *addrlen);
+	ssize_t (*recv_buf)(void *obj, struct net_buf **frags, int flags,
+			    struct net_sockaddr *src_addr, net_socklen_t *addrlen);
+	ssize_t (*sendfile)(void *obj, struct fs_file_t *file, off_t *offset,
+			    size_t count);
 };
 
 /** @endcond */
@@ -79,8 +79,10 @@ struct net_socket_service_desc {
 	struct net_socket_service_event *pev;
 	/** Length of the pollable socket array for this service. */
 	int pev_len;
-	/** Where are my pollfd entries in the global list */
+	/** Where are my pollfd entries in the poll list of the dispatcher thread */
 	int *idx;
+	/** Index of the dispatcher thread serving this service */
+	uint8_t thread;
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -95,7 +97,15 @@ struct net_socket_service_desc {
 #define NET_SOCKET_SERVICE_OWNER
 #endif
 
-#define __z_net_socket_service_define(_name, _cb, _count, ...) \
+#if defined(CONFIG_NET_SOCKETS_SERVICE_THREADS)
+#define __z_net_socket_svc_threads CONFIG_NET_SOCKETS_SERVICE_THREADS
+#else
+#define __z_net_socket_svc_threads 1
+#endif
+
+#define __z_net_socket_service_define(_name, _cb, _count, _thread, ...) \
+	BUILD_ASSERT((_thread) < __z_net_socket_svc_threads,		\
+		     "Invalid socket service dispatcher thread");	\
 	static int __z_net_socket_svc_get_idx(_name);			\
 	static struct net_socket_service_event				\
 			__z_net_socket_svc_get_name(_name)[_count] = {	\
@@ -110,6 +120,7 @@ struct net_socket_service_desc {
 		.pev = __z_net_socket_svc_get_name(_name),		\
 		.pev_len = (_count),					\
 		.idx = &__z_net_socket_svc_get_idx(_name),		\
+		.thread = (_thread),					\
 	}
 
 /** @endcond */
@@ -133,7 +144,7 @@ struct net_socket_service_desc {
  * @param count How many pollable sockets is needed for this service.
  */
 #define NET_SOCKET_SERVICE_SYNC_DEFINE(name, cb, count)	\
-	__z_net_socket_service_define(name, cb, count)
+	__z_net_socket_service_define(name, cb, count, 0)
 
 /**
  * @brief Statically define a network socket service in a private (static) scope.
@@ -146,7 +157,38 @@ struct net_socket_service_desc {
  * @param count How many pollable sockets is needed for this service.
  */
 #define NET_SOCKET_SERVICE_SYNC_DEFINE_STATIC(name, cb, count)	\
-	__z_net_socket_service_define(name, cb, count, static)
+	__z_net_socket_service_define(name, cb, count, 0, static)
+
+/**
+ * @brief Statically define a network socket service served by a given
+ *        dispatcher thread.
+ *
+ * Same as NET_SOCKET_SERVICE_SYNC_DEFINE(), but the sockets of the service are
+ * polled and its callback is called by dispatcher thread @p thread instead of
+ * thread 0. Services on different threads do not delay each other.
+ * See @kconfig{CONFIG_NET_SOCKETS_SERVICE_THREADS}.
+ *
+ * @param name Name of the service.
+ * @param cb Callback function that is called for socket activity.
+ * @param count How many pollable sockets is needed for this service.
+ * @param thread Dispatcher thread index, less than
+ *        @kconfig{CONFIG_NET_SOCKETS_SERVICE_THREADS}.
+ */
+#define NET_SOCKET_SERVICE_SYNC_DEFINE_THREAD(name, cb, count, thread)	\
+	__z_net_socket_service_define(name, cb, count, thread)
+
+/**
+ * @brief Statically define a network socket service served by a given
+ *        dispatcher thread in a private (static) scope.
+ *
+ * @param name Name of the service.
+ * @param cb Callback function that is called for socket activity.
+ * @param count How many pollable sockets is needed for this service.
+ * @param thread Dispatcher thread index, less than
+ *        @kconfig{CONFIG_NET_SOCKETS_SERVICE_THREADS}.
+ */
+#define NET_SOCKET_SERVICE_SYNC_DEFINE_THREAD_STATIC(name, cb, count, thread) \
+	__z_net_socket_service_define(name, cb, count, thread, static)
 
 /**
  * @brief Register pollable sockets.
@@ -22,6 +22,8 @@ LOG_MODULE_REGISTER(modem_ppp, CONFIG_MODEM_MODULES_LOG_LEVEL);
 #define MODEM_PPP_CODE_ESCAPE		(0x7D)
 #define MODEM_PPP_VALUE_ESCAPE		(0x20)
 
+#define MODEM_PPP_ESCAPE_MAP_WORDS	(256 / 32)
+
 static uint16_t modem_ppp_fcs_init(uint8_t byte)
 {
 	return crc16_ccitt(0xFFFF, &byte, 1);
@@ -51,32 +53,53 @@ static uint16_t modem_ppp_ppp_protocol(struct net_pkt *pkt)
 	return 0;
 }
 
-static bool modem_ppp_needs_escape(uint32_t async_map, uint8_t byte)
+static void modem_ppp_escape_map_init(uint32_t *escape_map, uint32_t async_map)
 {
-	uint32_t byte_bit;
+	memset(escape_map, 0, MODEM_PPP_ESCAPE_MAP_WORDS * sizeof(uint32_t));
 
-	if ((byte == MODEM_PPP_CODE_DELIMITER) || (byte == MODEM_PPP_CODE_ESCAPE)) {
-		/* Always escaped */
-		return true;
-	} else if (byte >= MODEM_PPP_VALUE_ESCAPE) {
-		/* Never escaped */
-		return false;
-	}
-	byte_bit = BIT(byte);
 	/* Escaped if required by the async control character map */
-	return byte_bit & async_map;
+	escape_map[0] = async_map;
+
+	/* Always escaped */
+	escape_map[MODEM_PPP_CODE_DELIMITER >> 5] |= BIT(MODEM_PPP_CODE_DELIMITER & 0x1F);
+	escape_map[MODEM_PPP_CODE_ESCAPE >> 5] |= BIT(MODEM_PPP_CODE_ESCAPE & 0x1F);
+}
+
+static bool modem_ppp_needs_escape(const uint32_t *escape_map, uint8_t byte)
+{
+	return (escape_map[byte >> 5] & BIT(byte & 0x1F)) != 0;
+}
+
+static size_t modem_ppp_escape_free_len(const uint32_t *escape_map, const uint8_t *data,
+					size_t length)
+{
+	size_t i;
+
+	for (i = 0; i < length; i++) {
+		if (modem_ppp_needs_escape(escape_map, data[i])) {
+			break;
+		}
+	}
+
+	return i;
 }
 
 static uint32_t modem_ppp_wrap(struct modem_ppp *ppp, uint8_t *buffer, uint32_t available)
 {
-	uint32_t async_map = ppp_peer_async_control_character_map(ppp->iface);
+	uint32_t escape_map[MODEM_PPP_ESCAPE_MAP_WORDS];
 	uint32_t offset = 0;
 	uint32_t remaining;
 	uint16_t protocol;
+	const uint8_t *data;
+	size_t length;
+	size_t run;
 	uint8_t upper;
 	uint8_t lower;
 	uint8_t byte;
 
+	modem_ppp_escape_map_init(escape_map,
+				  ppp_peer_async_control_character_map(ppp->iface));
+
 	while (offset < available) {
 		remaining = available - offset;
 
@@ -86,8 +109,9 @@ static uint32_t modem_ppp_wrap(struct modem_ppp *ppp, uint8_t *buffer, uint32_t
 				/* Insufficient space for constant header prefix */
 				goto end;
 			}
-			/* Init cursor for later phases */
+			/* Init cursor for later phases, data is only read from the packet */
 			net_pkt_cursor_init(ppp->tx_pkt);
+			net_pkt_set_overwrite(ppp->tx_pkt, true);
 			/* 3 byte common header */
 			buffer[offset++] = MODEM_PPP_CODE_DELIMITER;
 			buffer[offset++] = 0xFF;
@@ -122,12 +146,12 @@ static uint32_t modem_ppp_wrap(struct modem_ppp *ppp, uint8_t *buffer, uint32_t
 			ppp->tx_pkt_fcs = modem_ppp_fcs_update(ppp->tx_pkt_fcs, upper);
 			ppp->tx_pkt_fcs = modem_ppp_fcs_update(ppp->tx_pkt_fcs, lower);
 			/* Push protocol bytes (with required escaping) */
-			if (modem_ppp_needs_escape(async_map, upper)) {
+			if (modem_ppp_needs_escape(escape_map, upper)) {
 				buffer[offset++] = MODEM_PPP_CODE_ESCAPE;
 				upper ^= MODEM_PPP_VALUE_ESCAPE;
 			}
 			buffer[offset++] = upper;
-			if (modem_ppp_needs_escape(async_map, lower)) {
+			if (modem_ppp_needs_escape(escape_map, lower)) {
 				buffer[offset++] = MODEM_PPP_CODE_ESCAPE;
 				lower ^= MODEM_PPP_VALUE_ESCAPE;
 			}
@@ -142,12 +166,25 @@ static uint32_t modem_ppp_wrap(struct modem_ppp *ppp, uint8_t *buffer, uint32_t
 				if (remaining < 2) {
 					goto end;
 				}
+				/* Copy bytes which need no escaping straight from the fragment */
+				length = MIN(net_pkt_get_contiguous_len(ppp->tx_pkt), remaining);
+				data = net_pkt_cursor_get_pos(ppp->tx_pkt);
+				run = modem_ppp_escape_free_len(escape_map, data, length);
+				if (run > 0) {
+					memcpy(&buffer[offset], data, run);
+					/* FCS is computed over the whole run at once */
+					ppp->tx_pkt_fcs = crc16_ccitt(ppp->tx_pkt_fcs, data, run);
+					(void)net_pkt_skip(ppp->tx_pkt, run);
+					offset += run;
+					remaining -= run;
+					continue;
+				}
 				/* Pull next byte we're sending */
 				(void)net_pkt_read_u8(ppp->tx_pkt, &byte);
 				/* FCS is computed without the escape/modification */
 				ppp->tx_pkt_fcs = modem_ppp_fcs_update(ppp->tx_pkt_fcs, byte);
 				/* Push encoded bytes into buffer*/
-				if (modem_ppp_needs_escape(async_map, byte)) {
+				if (modem_ppp_needs_escape(escape_map, byte)) {
 					buffer[offset++] = MODEM_PPP_CODE_ESCAPE;
 					byte ^= MODEM_PPP_VALUE_ESCAPE;
 					remaining--;
@@ -156,6 +193,7 @@ static uint32_t modem_ppp_wrap(struct modem_ppp *ppp, uint8_t *buffer, uint32_t
 				remaining--;
 			}
 			/* Data phase finished */
+			net_pkt_set_overwrite(ppp->tx_pkt, false);
 			ppp->transmit_state = MODEM_PPP_TRANSMIT_STATE_EOF;
 			break;
 		case MODEM_PPP_TRANSMIT_STATE_EOF:
@@ -168,12 +206,12 @@ static uint32_t modem_ppp_wrap(struct modem_ppp *ppp, uint8_t *buffer, uint32_t
 			ppp->tx_pkt_fcs = modem_ppp_fcs_final(ppp->tx_pkt_fcs);
 			lower = (ppp->tx_pkt_fcs >> 0) & 0xFF;
 			upper = (ppp->tx_pkt_fcs >> 8) & 0xFF;
-			if (modem_ppp_needs_escape(async_map, lower)) {
+			if (modem_ppp_needs_escape(escape_map, lower)) {
 				buffer[offset++] = MODEM_PPP_CODE_ESCAPE;
 				lower ^= MODEM_PPP_VALUE_ESCAPE;
 			}
 			buffer[offset++] = lower;
-			if (modem_ppp_needs_escape(async_map, upper)) {
+			if (modem_ppp_needs_escape(escape_map, upper)) {
 				buffer[offset++] = MODEM_PPP_CODE_ESCAPE;
 				upper ^= MODEM_PPP_VALUE_ESCAPE;
 			}
@@ -313,6 +351,80 @@ static void modem_ppp_process_received_byte(struct modem_ppp *ppp, uint8_t byte)
 	}
 }
 
+static size_t modem_ppp_unescaped_len(const uint8_t *data, size_t length)
+{
+	size_t i;
+
+	for (i = 0; i < length; i++) {
+		if ((data[i] == MODEM_PPP_CODE_DELIMITER) || (data[i] == MODEM_PPP_CODE_ESCAPE)) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+static int modem_ppp_write_received(struct modem_ppp *ppp, const uint8_t *data, size_t length)
+{
+	size_t available;
+	size_t chunk;
+
+	while (length > 0) {
+		available = net_pkt_available_buffer(ppp->rx_pkt);
+		if (available < 2) {
+			if (net_pkt_alloc_buffer(ppp->rx_pkt, CONFIG_MODEM_PPP_NET_BUF_FRAG_SIZE,
+						 NET_AF_INET, K_NO_WAIT) < 0) {
+				LOG_WRN("Failed to alloc buffer");
+				return -ENOMEM;
+			}
+
+			continue;
+		}
+
+		/* Keep one byte of space, like the single byte path does */
+		chunk = MIN(length, available - 1);
+		if (net_pkt_write(ppp->rx_pkt, data, chunk) < 0) {
+			LOG_WRN("Dropped PPP frame");
+#if defined(CONFIG_NET_STATISTICS_PPP)
+			ppp->stats.drop++;
+#endif
+			return -ENOBUFS;
+		}
+
+		data += chunk;
+		length -= chunk;
+	}
+
+	return 0;
+}
+
+static void modem_ppp_process_received_data(struct modem_ppp *ppp, const uint8_t *data,
+					    size_t length)
+{
+	size_t offset = 0;
+	size_t run;
+
+	while (offset < length) {
+		if (ppp->receive_state == MODEM_PPP_RECEIVE_STATE_WRITING) {
+			/* Write bytes which need no unescaping to the packet at once */
+			run = modem_ppp_unescaped_len(&data[offset], length - offset);
+			if (run > 0) {
+				if (modem_ppp_write_received(ppp, &data[offset], run) < 0) {
+					net_pkt_unref(ppp->rx_pkt);
+					ppp->rx_pkt = NULL;
+					ppp->receive_state = MODEM_PPP_RECEIVE_STATE_HDR_SOF;
+				}
+
+				offset += run;
+				continue;
+			}
+		}
+
+		modem_ppp_process_received_byte(ppp, data[offset]);
+		offset++;
+	}
+}
+
 #if CONFIG_MODEM_STATS
 static uint32_t get_transmit_buf_length(struct modem_ppp *ppp)
 {
@@ -424,9 +536,7 @@ static void modem_ppp_process_handler(struct k_work *item)
 	advertise_receive_buf_stats(ppp, ret);
 #endif
 
-	for (int i = 0; i < ret; i++) {
-		modem_ppp_process_received_byte(ppp, ppp->receive_buf[i]);
-	}
+	modem_ppp_process_received_data(ppp, ppp->receive_buf, ret);
 
 	modem_work_submit(&ppp->process_work);
 }
@@ -157,6 +157,104 @@ static inline bool net_6lo_maddr_48_bit_compressible(const uint8_t *addr)
 		(addr[10] == 0x00));
 }
 
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+/* Longest compressed IPv6 header, without the next header compression:
+ * IPHC(2) + TF(4) + NH(1) + HLIM(1) + SA(16) + DA(16). The CID byte is
+ * only present when one of the addresses is compressed with a context.
+ */
+#define NET_6LO_IPHC_MAX_LEN 40
+
+struct net_6lo_iphc_cache {
+	/* IPv6 header of the flow, the payload length is not compared */
+	struct net_ipv6_hdr ipv6;
+	struct net_linkaddr lladdr_src;
+	struct net_linkaddr lladdr_dst;
+	struct net_if *iface;
+	uint8_t hdr[NET_6LO_IPHC_MAX_LEN];
+	uint8_t len;
+};
+
+static struct net_6lo_iphc_cache iphc_cache[CONFIG_NET_6LO_IPHC_CACHE_SIZE];
+static uint8_t iphc_cache_next;
+static K_MUTEX_DEFINE(iphc_cache_lock);
+
+static bool iphc_cache_match(struct net_6lo_iphc_cache *entry,
+			     struct net_pkt *pkt,
+			     struct net_ipv6_hdr *ipv6)
+{
+	return entry->iface == net_pkt_iface(pkt) &&
+	       net_linkaddr_cmp(&entry->lladdr_dst, net_pkt_lladdr_dst(pkt)) &&
+	       net_linkaddr_cmp(&entry->lladdr_src, net_pkt_lladdr_src(pkt)) &&
+	       !memcmp(&entry->ipv6, ipv6,
+		       offsetof(struct net_ipv6_hdr, len)) &&
+	       !memcmp(&entry->ipv6.nexthdr, &ipv6->nexthdr,
+		       sizeof(*ipv6) - offsetof(struct net_ipv6_hdr, nexthdr));
+}
+
+/* Copy the compressed IPv6 header of a known flow in front of inline_ptr.
+ * Returns the start of the compressed header or NULL if the flow is not
+ * cached.
+ */
+static uint8_t *iphc_cache_get(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			       uint8_t *inline_ptr)
+{
+	uint8_t *hdr = NULL;
+	int i;
+
+	k_mutex_lock(&iphc_cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(iphc_cache); i++) {
+		if (!iphc_cache_match(&iphc_cache[i], pkt, ipv6)) {
+			continue;
+		}
+
+		/* The cached header was compressed from an identical IPv6
+		 * header, so it takes the same room as the first time.
+		 */
+		hdr = inline_ptr - iphc_cache[i].len;
+		memcpy(hdr, iphc_cache[i].hdr, iphc_cache[i].len);
+		break;
+	}
+
+	k_mutex_unlock(&iphc_cache_lock);
+
+	return hdr;
+}
+
+static void iphc_cache_add(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			   uint8_t *hdr, size_t len)
+{
+	struct net_6lo_iphc_cache *entry;
+
+	if (len > NET_6LO_IPHC_MAX_LEN) {
+		return;
+	}
+
+	k_mutex_lock(&iphc_cache_lock, K_FOREVER);
+
+	entry = &iphc_cache[iphc_cache_next];
+	iphc_cache_next = (iphc_cache_next + 1U) % ARRAY_SIZE(iphc_cache);
+
+	entry->ipv6 = *ipv6;
+	entry->lladdr_src = *net_pkt_lladdr_src(pkt);
+	entry->lladdr_dst = *net_pkt_lladdr_dst(pkt);
+	entry->iface = net_pkt_iface(pkt);
+	memcpy(entry->hdr, hdr, len);
+	entry->len = len;
+
+	k_mutex_unlock(&iphc_cache_lock);
+}
+
+#if defined(CONFIG_NET_6LO_CONTEXT)
+static void iphc_cache_flush(void)
+{
+	k_mutex_lock(&iphc_cache_lock, K_FOREVER);
+	memset(iphc_cache, 0, sizeof(iphc_cache));
+	k_mutex_unlock(&iphc_cache_lock);
+}
+#endif
+#endif /* CONFIG_NET_6LO_IPHC_CACHE */
+
 #if defined(CONFIG_NET_6LO_CONTEXT)
 /* RFC 6775, 4.2, 5.4.2, 5.4.3 and 7.2*/
 static inline void set_6lo_context(struct net_if *iface, uint8_t index,
@@ -180,6 +278,11 @@ void net_6lo_set_context(struct net_if *iface,
 	int unused = -1;
 	uint8_t i;
 
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+	/* The cached headers might have been compressed with the old context */
+	iphc_cache_flush();
+#endif
+
 	/* If the context information already exists, update or remove
 	 * as per data.
 	 */
@@ -722,6 +825,11 @@ static inline int compress_IPHC_header(struct net_pkt *pkt)
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	struct net_6lo_context *src_ctx = NULL;
 	struct net_6lo_context *dst_ctx = NULL;
+#endif
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+	struct net_ipv6_hdr orig_ipv6;
+	uint8_t *hdr_end;
+	uint8_t *cached;
 #endif
 	uint8_t compressed = 0;
 	uint16_t iphc = (NET_6LO_DISPATCH_IPHC << 8);
@@ -751,6 +859,20 @@ static inline int compress_IPHC_header(struct net_pkt *pkt)
 		inline_pos = compress_nh_udp(udp, inline_pos, false);
 	}
 
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+	cached = iphc_cache_get(pkt, ipv6, inline_pos);
+	if (cached) {
+		inline_pos = cached;
+		goto iphc_end;
+	}
+
+	/* The header gets overwritten by the compressed one, keep a copy of
+	 * it for the cache.
+	 */
+	orig_ipv6 = *ipv6;
+	hdr_end = inline_pos;
+#endif
+
 	if (net_6lo_ll_prefix_padded_with_zeros(ipv6->dst)) {
 		inline_pos = compress_da(ipv6, pkt, inline_pos, &iphc);
 		goto da_end;
@@ -822,6 +944,11 @@ sa_end:
 	iphc = net_htons(iphc);
 	memmove(inline_pos, &iphc, sizeof(iphc));
 
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+	iphc_cache_add(pkt, &orig_ipv6, inline_pos, hdr_end - inline_pos);
+
+iphc_end:
+#endif
 	compressed = inline_pos - pkt->buffer->data;
 
 	net_pkt_cursor_init(pkt);
@@ -1338,15 +1465,19 @@ static inline void uncompress_cid(struct net_pkt *pkt, uint8_t cid,
 
 static bool uncompress_IPHC_header(struct net_pkt *pkt)
 {
+	struct {
+		struct net_ipv6_hdr ipv6;
+		struct net_udp_hdr udp;
+	} __packed hdr = { 0 };
+	struct net_ipv6_hdr *ipv6 = &hdr.ipv6;
 	struct net_udp_hdr *udp = NULL;
 	struct net_buf *frag = NULL;
 	uint8_t nhc = 0;
 	int nhc_inline_size = 0;
-	struct net_ipv6_hdr *ipv6;
 	uint16_t len;
 	uint16_t iphc;
 	int inline_size, compressed_hdr_size;
-	size_t diff;
+	size_t hdr_len = NET_IPV6H_LEN;
 	uint8_t *cursor;
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	struct net_6lo_context *src = NULL;
@@ -1361,7 +1492,6 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 	}
 
 	compressed_hdr_size = sizeof(iphc) + inline_size;
-	diff = sizeof(struct net_ipv6_hdr) - compressed_hdr_size;
 
 	if (iphc & NET_6LO_IPHC_NH_MASK) {
 		nhc = *(pkt->buffer->data + sizeof(iphc) + inline_size);
@@ -1372,8 +1502,7 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 
 		nhc_inline_size = get_udp_nhc_inlined_size(nhc);
 		compressed_hdr_size += sizeof(uint8_t) + nhc_inline_size;
-		diff += sizeof(struct net_udp_hdr) - sizeof(uint8_t) -
-			nhc_inline_size;
+		hdr_len = NET_IPV6UDPH_LEN;
 	}
 
 	if (pkt->buffer->len < compressed_hdr_size) {
@@ -1381,29 +1510,22 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 		return false;
 	}
 
-	if (net_buf_tailroom(pkt->buffer) >= diff) {
-		NET_DBG("Enough tailroom. Uncompress inplace");
-		frag = pkt->buffer;
-		net_buf_add(frag, diff);
-		cursor = frag->data + diff;
-		memmove(cursor, frag->data, frag->len - diff);
-	} else {
-		size_t frag_len = nhc ? NET_IPV6UDPH_LEN : NET_IPV6H_LEN;
-
-		NET_DBG("Not enough tailroom. Get new fragment");
-		cursor =  pkt->buffer->data;
-		frag = net_pkt_get_frag(pkt, frag_len, NET_6LO_RX_PKT_TIMEOUT);
+	/* The headers are uncompressed in a single pass into a local buffer,
+	 * which then replaces the compressed headers. That goes to the
+	 * headroom of the buffer if there is enough of it, for instance
+	 * when the packet was compressed locally, otherwise to a new
+	 * fragment. Either way the payload is not moved.
+	 */
+	if (net_buf_headroom(pkt->buffer) + compressed_hdr_size < hdr_len) {
+		NET_DBG("Not enough headroom. Get new fragment");
+		frag = net_pkt_get_frag(pkt, hdr_len, NET_6LO_RX_PKT_TIMEOUT);
 		if (!frag) {
 			NET_ERR("Can't get frag for uncompression");
 			return false;
 		}
-
-		net_buf_pull(pkt->buffer, compressed_hdr_size);
-		net_buf_add(frag, frag_len);
 	}
 
-	ipv6 = (struct net_ipv6_hdr *)(frag->data);
-	cursor += sizeof(iphc);
+	cursor = pkt->buffer->data + sizeof(iphc);
 
 	if (iphc & NET_6LO_IPHC_CID_1) {
 #if defined(CONFIG_NET_6LO_CONTEXT)
@@ -1411,7 +1533,7 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 		cursor++;
 #else
 		NET_ERR("Context based uncompression not enabled");
-		return false;
+		goto fail;
 #endif
 	}
 
@@ -1486,17 +1608,30 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 
 	if (iphc & NET_6LO_IPHC_NH_MASK) {
 		ipv6->nexthdr = NET_IPPROTO_UDP;
-		udp = (struct net_udp_hdr *)(frag->data + NET_IPV6H_LEN);
 		/* skip nhc */
 		cursor++;
-		cursor = uncompress_nh_udp(nhc, cursor, udp);
+		cursor = uncompress_nh_udp(nhc, cursor, &hdr.udp);
 	}
 
-	if (frag != pkt->buffer) {
+	/* Replace the compressed headers with the uncompressed ones */
+	net_buf_pull(pkt->buffer, compressed_hdr_size);
+
+	if (!frag) {
+		NET_DBG("Enough headroom. Uncompress inplace");
+		frag = pkt->buffer;
+		memcpy(net_buf_push(frag, hdr_len), &hdr, hdr_len);
+	} else {
+		memcpy(net_buf_add(frag, hdr_len), &hdr, hdr_len);
+
 		/* Insert the fragment (this one holds uncompressed headers) */
 		net_pkt_frag_insert(pkt, frag);
 	}
 
+	ipv6 = (struct net_ipv6_hdr *)frag->data;
+	if (iphc & NET_6LO_IPHC_NH_MASK) {
+		udp = (struct net_udp_hdr *)(frag->data + NET_IPV6H_LEN);
+	}
+
 	/* Set IPv6 header and UDP (if next header is) length */
 	len = net_pkt_get_len(pkt) - NET_IPV6H_LEN;
 	ipv6->len = net_htons(len);
@@ -1514,7 +1649,7 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 	return true;
 
 fail:
-	if (frag != pkt->buffer) {
+	if (frag) {
 		net_pkt_frag_unref(frag);
 	}
 
@@ -337,24 +337,45 @@ static inline void net_ipv4_set_ecn(uint8_t *tos, uint8_t ecn)
 #if defined(CONFIG_NET_IPV4_FRAGMENT)
 /** Store pending IPv4 fragment information that is needed for reassembly. */
 struct net_ipv4_reassembly {
+	/** Node in the reassembly hash bucket */
+	sys_snode_t node;
+
 	/** IPv4 source address of the fragment */
 	struct net_in_addr src;
 
 	/** IPv4 destination address of the fragment */
 	struct net_in_addr dst;
 
-	/**
-	 * Timeout for cancelling the reassembly. The timer is used
-	 * also to detect if this reassembly slot is used or not.
-	 */
+	/** Timeout for cancelling the reassembly. */
 	struct k_work_delayable timer;
 
-	/** Pointers to pending fragments */
+	/** Pointers to pending fragments, sorted by fragment offset */
 	struct net_pkt *pkt[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT];
 
+	/** Payload end offset of each pending fragment */
+	uint16_t end[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT];
+
+	/** Hash of the source, destination and identification */
+	uint32_t hash;
+
+	/** Number of payload bytes received so far */
+	uint16_t received;
+
+	/** Payload length of the whole packet, known once the last fragment is received */
+	uint16_t total;
+
 	/** IPv4 fragment identification */
 	uint16_t id;
 	uint8_t protocol;
+
+	/** Number of pending fragments */
+	uint8_t count;
+
+	/** Is the fragment with the More Fragments bit cleared received */
+	bool last;
+
+	/** Is this reassembly slot in use */
+	bool used;
 };
 #else
 struct net_ipv4_reassembly;
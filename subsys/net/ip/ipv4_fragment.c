@@ -32,83 +32,167 @@ static void reassembly_timeout(struct k_work *work);
 
 static struct net_ipv4_reassembly reassembly[CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
 
-static struct net_ipv4_reassembly *reassembly_get(uint16_t id, const uint8_t *src,
-						  const uint8_t *dst, uint8_t protocol)
+/* Pending reassemblies hashed by their source, destination and identification */
+static sys_slist_t reassembly_buckets[CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
+
+/* Payload bytes held by all the pending reassemblies */
+static size_t reassembly_mem;
+
+static K_MUTEX_DEFINE(reassembly_lock);
+
+static uint32_t reassembly_hash(uint16_t id, const uint8_t *src, const uint8_t *dst,
+				uint8_t protocol)
 {
-	int i, avail = -1;
+	uint32_t hash;
 
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		if (k_work_delayable_remaining_get(&reassembly[i].timer) &&
-		    reassembly[i].id == id &&
-		    net_ipv4_addr_cmp_raw(src, reassembly[i].src.s4_addr) &&
-		    net_ipv4_addr_cmp_raw(dst, reassembly[i].dst.s4_addr) &&
-		    reassembly[i].protocol == protocol) {
-			return &reassembly[i];
-		}
+	hash = UNALIGNED_GET((const uint32_t *)src) ^ UNALIGNED_GET((const uint32_t *)dst) ^
+	       ((uint32_t)id << 8 | protocol);
+
+	/* Fibonacci hashing, the upper bits are used to select the bucket */
+	return hash * 2654435761U;
+}
+
+static inline sys_slist_t *reassembly_bucket(uint32_t hash)
+{
+	return &reassembly_buckets[(hash >> 16) % CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
+}
+
+static bool reassembly_cancel(struct net_ipv4_reassembly *reass)
+{
+	int32_t remaining;
+	int i;
+
+	if (!reass->used) {
+		return false;
+	}
+
+	LOG_DBG("Cancel 0x%x", reass->id);
+
+	remaining = k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&reass->timer));
+	k_work_cancel_delayable(&reass->timer);
 
-		if (k_work_delayable_remaining_get(&reassembly[i].timer)) {
+	LOG_DBG("IPv4 reassembly id 0x%x remaining %d ms", reass->id, remaining);
+
+	sys_slist_find_and_remove(reassembly_bucket(reass->hash), &reass->node);
+	reassembly_mem -= reass->received;
+
+	for (i = 0; i < reass->count; i++) {
+		if (!reass->pkt[i]) {
 			continue;
 		}
 
-		if (avail < 0) {
-			avail = i;
-		}
-	}
+		LOG_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data", i, reass->pkt[i],
+			net_pkt_get_len(reass->pkt[i]));
 
-	if (avail < 0) {
-		return NULL;
+		net_pkt_unref(reass->pkt[i]);
+		reass->pkt[i] = NULL;
 	}
 
-	k_work_reschedule(&reassembly[avail].timer, K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT));
+	reass->id = 0U;
+	reass->count = 0U;
+	reass->received = 0U;
+	reass->total = 0U;
+	reass->last = false;
+	reass->used = false;
+
+	return true;
+}
+
+/* Return the reassembly that expires first, i.e. the one that was started first. */
+static struct net_ipv4_reassembly *reassembly_oldest(struct net_ipv4_reassembly *skip)
+{
+	struct net_ipv4_reassembly *oldest = NULL;
+	k_ticks_t oldest_remaining = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		k_ticks_t remaining;
 
-	net_ipv4_addr_copy_raw(reassembly[avail].src.s4_addr, src);
-	net_ipv4_addr_copy_raw(reassembly[avail].dst.s4_addr, dst);
+		if (!reassembly[i].used || &reassembly[i] == skip) {
+			continue;
+		}
 
-	reassembly[avail].protocol = protocol;
-	reassembly[avail].id = id;
+		remaining = k_work_delayable_remaining_get(&reassembly[i].timer);
+		if (oldest == NULL || remaining < oldest_remaining) {
+			oldest = &reassembly[i];
+			oldest_remaining = remaining;
+		}
+	}
 
-	return &reassembly[avail];
+	return oldest;
 }
 
-static bool reassembly_cancel(uint32_t id, struct net_in_addr *src, struct net_in_addr *dst)
+static struct net_ipv4_reassembly *reassembly_get(uint16_t id, const uint8_t *src,
+						  const uint8_t *dst, uint8_t protocol)
 {
-	int i, j;
+	uint32_t hash = reassembly_hash(id, src, dst, protocol);
+	struct net_ipv4_reassembly *reass;
+	int i;
 
-	LOG_DBG("Cancel 0x%x", id);
+	SYS_SLIST_FOR_EACH_CONTAINER(reassembly_bucket(hash), reass, node) {
+		if (reass->hash == hash && reass->id == id &&
+		    net_ipv4_addr_cmp_raw(src, reass->src.s4_addr) &&
+		    net_ipv4_addr_cmp_raw(dst, reass->dst.s4_addr) &&
+		    reass->protocol == protocol) {
+			return reass;
+		}
+	}
 
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		int32_t remaining;
+	for (i = 0, reass = NULL; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		if (!reassembly[i].used) {
+			reass = &reassembly[i];
+			break;
+		}
+	}
 
-		if (reassembly[i].id != id ||
-		    !net_ipv4_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv4_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
+	if (reass == NULL) {
+		/* All the slots are in use, make room by dropping the oldest reassembly */
+		reass = reassembly_oldest(NULL);
+		if (reass == NULL) {
+			return NULL;
 		}
 
-		remaining = k_ticks_to_ms_ceil32(
-			k_work_delayable_remaining_get(&reassembly[i].timer));
-		k_work_cancel_delayable(&reassembly[i].timer);
+		LOG_DBG("Evicting IPv4 reassembly id 0x%x", reass->id);
+		reassembly_cancel(reass);
+	}
+
+	k_work_reschedule(&reass->timer, K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT));
 
-		LOG_DBG("IPv4 reassembly id 0x%x remaining %d ms", reassembly[i].id, remaining);
+	net_ipv4_addr_copy_raw(reass->src.s4_addr, src);
+	net_ipv4_addr_copy_raw(reass->dst.s4_addr, dst);
 
-		reassembly[i].id = 0U;
+	reass->protocol = protocol;
+	reass->id = id;
+	reass->hash = hash;
+	reass->used = true;
 
-		for (j = 0; j < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
+	sys_slist_prepend(reassembly_bucket(hash), &reass->node);
+
+	return reass;
+}
 
-			LOG_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data", j,
-				reassembly[i].pkt[j], net_pkt_get_len(reassembly[i].pkt[j]));
+/* Make sure that the new fragment fits into the memory budget, dropping the
+ * oldest other reassemblies if needed.
+ */
+static int reassembly_reserve(struct net_ipv4_reassembly *reass, size_t len)
+{
+	struct net_ipv4_reassembly *oldest;
+
+	if (CONFIG_NET_IPV4_FRAGMENT_MAX_MEM == 0) {
+		return 0;
+	}
 
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
+	while (reassembly_mem + len > CONFIG_NET_IPV4_FRAGMENT_MAX_MEM) {
+		oldest = reassembly_oldest(reass);
+		if (oldest == NULL) {
+			return -ENOMEM;
 		}
 
-		return true;
+		LOG_DBG("Evicting IPv4 reassembly id 0x%x", oldest->id);
+		reassembly_cancel(oldest);
 	}
 
-	return false;
+	return 0;
 }
 
 static void reassembly_info(char *str, struct net_ipv4_reassembly *reass)
@@ -126,6 +210,16 @@ static void reassembly_timeout(struct k_work *work)
 	struct net_ipv4_reassembly *reass =
 		CONTAINER_OF(dwork, struct net_ipv4_reassembly, timer);
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The slot might have been released, or even reused, while we were
+	 * waiting for the lock.
+	 */
+	if (!reass->used ||
+	    (k_work_delayable_busy_get(dwork) & (K_WORK_DELAYED | K_WORK_QUEUED))) {
+		goto out;
+	}
+
 	reassembly_info("Reassembly cancelled", reass);
 
 	/* Send a ICMPv4 Time Exceeded only if we received the first fragment */
@@ -134,7 +228,10 @@ static void reassembly_timeout(struct k_work *work)
 				      NET_ICMPV4_TIME_EXCEEDED_FRAGMENT_REASSEMBLY_TIME);
 	}
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 }
 
 static void reassemble_packet(struct net_ipv4_reassembly *reass)
@@ -145,25 +242,20 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 	struct net_buf *last;
 	int i;
 
-	k_work_cancel_delayable(&reass->timer);
-
 	NET_ASSERT(reass->pkt[0]);
 
 	last = net_buf_frag_last(reass->pkt[0]->buffer);
 
 	/* We start from 2nd packet which is then appended to the first one */
-	for (i = 1; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
+	for (i = 1; i < reass->count; i++) {
 		pkt = reass->pkt[i];
-		if (!pkt) {
-			break;
-		}
 
 		net_pkt_cursor_init(pkt);
 
 		/* Get rid of IPv4 header which is at the beginning of the fragment. */
 		ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
 		if (!ipv4_hdr) {
-			goto error;
+			goto cancel;
 		}
 
 		LOG_DBG("Removing %d bytes from start of pkt %p", net_pkt_ip_hdr_len(pkt),
@@ -171,8 +263,7 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 
 		if (net_pkt_pull(pkt, net_pkt_ip_hdr_len(pkt))) {
 			LOG_ERR("Failed to pull headers");
-			reassembly_cancel(reass->id, &reass->src, &reass->dst);
-			return;
+			goto cancel;
 		}
 
 		/* Attach the data to the previous packet */
@@ -188,6 +279,9 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 	pkt = reass->pkt[0];
 	reass->pkt[0] = NULL;
 
+	/* All the fragments are now in the first packet, release the slot */
+	reassembly_cancel(reass);
+
 	/* Update the header details for the packet */
 	net_pkt_cursor_init(pkt);
 
@@ -220,204 +314,181 @@ static void reassemble_packet(struct net_ipv4_reassembly *reass)
 
 error:
 	net_pkt_unref(pkt);
+	return;
+
+cancel:
+	/* The already attached fragments are released together with the first one */
+	reassembly_cancel(reass);
 }
 
 void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
 {
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
-		if (!k_work_delayable_remaining_get(&reassembly[i].timer)) {
+		if (!reassembly[i].used) {
 			continue;
 		}
 
 		cb(&reassembly[i], user_data);
 	}
+
+	k_mutex_unlock(&reassembly_lock);
 }
 
-/* Verify that we have all the fragments received and in correct order.
+/* Insert the fragment into the reassembly and check if we have all the fragments.
  * Return:
  * - a negative value if the fragments are erroneous and must be dropped
  * - zero if we are expecting more fragments
  * - a positive value if we can proceed with the reassembly
  */
-static int fragments_are_ready(struct net_ipv4_reassembly *reass)
+static int fragment_insert(struct net_ipv4_reassembly *reass, struct net_pkt *pkt,
+			   uint16_t payload_len)
 {
-	unsigned int expected_offset = 0;
-	bool more = true;
-	int i;
+	unsigned int offset = net_pkt_ipv4_fragment_offset(pkt);
+	unsigned int end = offset + payload_len;
+	int low = 0;
+	int high = reass->count;
+
+	if (end > UINT16_MAX) {
+		return -EBADMSG;
+	}
 
 	/* Fragments can arrive in any order, for example in reverse order:
 	 *   1 -> Fragment3(M=0, offset=x2)
 	 *   2 -> Fragment2(M=1, offset=x1)
 	 *   3 -> Fragment1(M=1, offset=0)
-	 * We have to test several requirements before proceeding with the reassembly:
-	 * - We received the first fragment (Fragment Offset is 0)
-	 * - All intermediate fragments are contiguous
-	 * - The More bit of the last fragment is 0
+	 * The pending fragments are kept sorted by offset, so find the place of
+	 * this one with a binary search.
 	 */
-	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		struct net_pkt *pkt = reass->pkt[i];
-		unsigned int offset;
-		int payload_len;
-
-		if (!pkt) {
-			break;
-		}
-
-		offset = net_pkt_ipv4_fragment_offset(pkt);
+	while (low < high) {
+		int mid = (low + high) / 2;
 
-		if (offset < expected_offset) {
-			/* Overlapping or duplicated, drop it */
-			return -EBADMSG;
-		} else if (offset != expected_offset) {
-			/* Not contiguous, let's wait for fragments */
-			return 0;
+		if (net_pkt_ipv4_fragment_offset(reass->pkt[mid]) < offset) {
+			low = mid + 1;
+		} else {
+			high = mid;
 		}
+	}
 
-		payload_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt);
+	/* Overlapping or duplicated, drop it */
+	if ((low > 0 && reass->end[low - 1] > offset) ||
+	    (low < reass->count && net_pkt_ipv4_fragment_offset(reass->pkt[low]) < end)) {
+		return -EBADMSG;
+	}
 
-		if (payload_len < 0) {
+	/* Nothing can be beyond the fragment that has the More bit cleared */
+	if (!net_pkt_ipv4_fragment_more(pkt)) {
+		if (reass->last || (reass->count > 0 && reass->end[reass->count - 1] > end)) {
 			return -EBADMSG;
 		}
 
-		expected_offset += payload_len;
-		more = net_pkt_ipv4_fragment_more(pkt);
+		reass->last = true;
+		reass->total = end;
+	} else if (reass->last && end > reass->total) {
+		return -EBADMSG;
 	}
 
-	if (more) {
-		return 0;
+	if (reass->count == CONFIG_NET_IPV4_FRAGMENT_MAX_PKT) {
+		/* We do not have free space left in the array */
+		return -ENOMEM;
 	}
 
-	return 1;
-}
-
-static int shift_packets(struct net_ipv4_reassembly *reass, int pos)
-{
-	int i;
-
-	for (i = pos + 1; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		if (!reass->pkt[i]) {
-			LOG_DBG("Moving [%d] %p (offset 0x%x) to [%d]", pos, reass->pkt[pos],
-				net_pkt_ipv4_fragment_offset(reass->pkt[pos]), pos + 1);
-
-			/* pkt[i] is free, so shift everything between [pos] and [i - 1] by one
-			 * element
-			 */
-			memmove(&reass->pkt[pos + 1], &reass->pkt[pos],
-				sizeof(void *) * (i - pos));
+	LOG_DBG("Storing pkt %p to slot %d offset %d", pkt, low, offset);
 
-			/* pkt[pos] is now free */
-			reass->pkt[pos] = NULL;
+	memmove(&reass->pkt[low + 1], &reass->pkt[low],
+		sizeof(reass->pkt[0]) * (reass->count - low));
+	memmove(&reass->end[low + 1], &reass->end[low],
+		sizeof(reass->end[0]) * (reass->count - low));
 
-			return 0;
-		}
-	}
+	reass->pkt[low] = pkt;
+	reass->end[low] = end;
+	reass->count++;
+	reass->received += payload_len;
+	reassembly_mem += payload_len;
 
-	/* We do not have free space left in the array */
-	return -ENOMEM;
+	/* As the fragments do not overlap and none of them is past the last one,
+	 * they cover the whole packet when their lengths add up to its length.
+	 */
+	return reass->last && reass->received == reass->total;
 }
 
 enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt, struct net_ipv4_hdr *hdr)
 {
 	struct net_ipv4_reassembly *reass = NULL;
+	enum net_verdict verdict = NET_OK;
+	uint16_t payload_len;
 	uint16_t flag;
-	bool found;
 	uint8_t more;
 	uint16_t id;
 	int ret;
-	int i;
 
 	flag = net_ntohs(*((uint16_t *)&hdr->offset));
 	id = net_ntohs(*((uint16_t *)&hdr->id));
 
-	reass = reassembly_get(id, hdr->src, hdr->dst, hdr->proto);
-	if (!reass) {
-		LOG_ERR("Cannot get reassembly slot, dropping pkt %p", pkt);
-		goto drop;
-	}
-
 	more = (flag & NET_IPV4_MORE_FRAG_MASK) ? true : false;
 	net_pkt_set_ipv4_fragment_flags(pkt, flag);
 
-	if (more && (net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt)) % 8) {
+	payload_len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt);
+
+	if (more && payload_len % 8) {
 		/* Fragment length is not multiple of 8, discard the packet and send bad IP
 		 * header error.
 		 */
 		net_icmpv4_send_error(pkt, NET_ICMPV4_BAD_IP_HEADER,
 				      NET_ICMPV4_BAD_IP_HEADER_LENGTH);
-		goto drop;
+		return NET_DROP;
 	}
 
-	/* The fragments might come in wrong order so place them in the reassembly chain in the
-	 * correct order.
-	 */
-	for (i = 0, found = false; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT; i++) {
-		if (reass->pkt[i]) {
-			if (net_pkt_ipv4_fragment_offset(reass->pkt[i]) <
-			    net_pkt_ipv4_fragment_offset(pkt)) {
-				continue;
-			}
-
-			/* Make room for this fragment. If there is no room then it will discard
-			 * the whole reassembly.
-			 */
-			if (shift_packets(reass, i)) {
-				break;
-			}
-		}
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
 
-		LOG_DBG("Storing pkt %p to slot %d offset %d", pkt, i,
-			net_pkt_ipv4_fragment_offset(pkt));
-		reass->pkt[i] = pkt;
-		found = true;
+	reass = reassembly_get(id, hdr->src, hdr->dst, hdr->proto);
+	if (!reass) {
+		LOG_ERR("Cannot get reassembly slot, dropping pkt %p", pkt);
+		verdict = NET_DROP;
+		goto out;
+	}
 
-		break;
+	if (reassembly_reserve(reass, payload_len) < 0) {
+		LOG_ERR("No memory available for 0x%x", reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
 	}
 
-	if (!found) {
+	ret = fragment_insert(reass, pkt, payload_len);
+	if (ret == -ENOMEM) {
 		/* We could not add this fragment into our saved fragment list. The whole packet
 		 * must be discarded at this point.
 		 */
 		LOG_ERR("No slots available for 0x%x", reass->id);
 		net_pkt_unref(pkt);
 		goto drop;
-	}
-
-	ret = fragments_are_ready(reass);
-	if (ret < 0) {
+	} else if (ret < 0) {
 		LOG_ERR("Reassembled IPv4 verify failed, dropping id %u", reass->id);
-
-		/* Let the caller release the already inserted pkt */
-		if (i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
-
 		net_pkt_unref(pkt);
 		goto drop;
 	} else if (ret == 0) {
 		reassembly_info("Reassembly nth pkt", reass);
 
 		LOG_DBG("More fragments to be received");
-		goto accept;
+		goto out;
 	}
 
 	reassembly_info("Reassembly last pkt", reass);
 
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
-
-accept:
-	return NET_OK;
+	goto out;
 
 drop:
-	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
-	}
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 
-	return NET_DROP;
+	return verdict;
 }
 
 static int send_ipv4_fragment(struct net_pkt *pkt, uint16_t rand_id, uint16_t fit_len,
@@ -647,7 +718,8 @@ use_interface_mtu:
 			mtu = MAX(NET_IPV4_MTU, mtu);
 		}
 
-		if (pkt_len > mtu) {
+		/* TCP super-segments are split by L2 or the driver instead */
+		if (pkt_len > mtu && net_pkt_gso_size(pkt) == 0U) {
 			ret = net_ipv4_send_fragmented_pkt(net_pkt_iface(pkt), pkt, pkt_len, mtu);
 
 			if (ret < 0) {
@@ -427,23 +427,44 @@ static inline void net_ipv6_nbr_set_reachable_timer(struct net_if *iface,
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 /** Store pending IPv6 fragment information that is needed for reassembly. */
 struct net_ipv6_reassembly {
+	/** Node in the reassembly hash bucket */
+	sys_snode_t node;
+
 	/** IPv6 source address of the fragment */
 	struct net_in6_addr src;
 
 	/** IPv6 destination address of the fragment */
 	struct net_in6_addr dst;
 
-	/**
-	 * Timeout for cancelling the reassembly. The timer is used
-	 * also to detect if this reassembly slot is used or not.
-	 */
+	/** Timeout for cancelling the reassembly. */
 	struct k_work_delayable timer;
 
-	/** Pointers to pending fragments */
+	/** Pointers to pending fragments, sorted by fragment offset */
 	struct net_pkt *pkt[CONFIG_NET_IPV6_FRAGMENT_MAX_PKT];
 
+	/** Payload end offset of each pending fragment */
+	uint16_t end[CONFIG_NET_IPV6_FRAGMENT_MAX_PKT];
+
+	/** Hash of the source, destination and identification */
+	uint32_t hash;
+
+	/** Number of payload bytes received so far */
+	uint16_t received;
+
+	/** Payload length of the whole packet, known once the last fragment is received */
+	uint16_t total;
+
 	/** IPv6 fragment identification */
 	uint32_t id;
+
+	/** Number of pending fragments */
+	uint8_t count;
+
+	/** Is the fragment with the More Fragments bit cleared received */
+	bool last;
+
+	/** Is this reassembly slot in use */
+	bool used;
 };
 #else
 struct net_ipv6_reassembly;
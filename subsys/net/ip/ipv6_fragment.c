@@ -46,6 +46,16 @@ static bool reassembly_init_done;
 static struct net_ipv6_reassembly
 reassembly[CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT];
 
+/* Pending reassemblies hashed by their source, destination and
+ * identification.
+ */
+static sys_slist_t reassembly_buckets[CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT];
+
+/* Payload bytes held by all the pending reassemblies */
+static size_t reassembly_mem;
+
+static K_MUTEX_DEFINE(reassembly_lock);
+
 int net_ipv6_find_last_ext_hdr(struct net_pkt *pkt, uint16_t *next_hdr_off,
 			       uint16_t *last_hdr_off)
 {
@@ -120,86 +130,169 @@ fail:
 	return -EINVAL;
 }
 
-static struct net_ipv6_reassembly *reassembly_get(uint32_t id,
-						  const uint8_t *src,
-						  const uint8_t *dst)
+static uint32_t reassembly_hash(uint32_t id, const uint8_t *src,
+				const uint8_t *dst)
 {
-	int i, avail = -1;
+	uint32_t hash = id;
+	int i;
 
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		if (k_work_delayable_remaining_get(&reassembly[i].timer) &&
-		    reassembly[i].id == id &&
-		    net_ipv6_addr_cmp_raw(src, reassembly[i].src.s6_addr) &&
-		    net_ipv6_addr_cmp_raw(dst, reassembly[i].dst.s6_addr)) {
-			return &reassembly[i];
-		}
+	for (i = 0; i < sizeof(struct net_in6_addr); i += sizeof(uint32_t)) {
+		hash ^= UNALIGNED_GET((const uint32_t *)(src + i)) ^
+			UNALIGNED_GET((const uint32_t *)(dst + i));
+	}
+
+	/* Fibonacci hashing, the upper bits are used to select the bucket */
+	return hash * 2654435761U;
+}
 
-		if (k_work_delayable_remaining_get(&reassembly[i].timer)) {
+static inline sys_slist_t *reassembly_bucket(uint32_t hash)
+{
+	return &reassembly_buckets[(hash >> 16) %
+				   CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT];
+}
+
+static bool reassembly_cancel(struct net_ipv6_reassembly *reass)
+{
+	int32_t remaining;
+	int i;
+
+	if (!reass->used) {
+		return false;
+	}
+
+	NET_DBG("Cancel 0x%x", reass->id);
+
+	remaining = k_ticks_to_ms_ceil32(
+		k_work_delayable_remaining_get(&reass->timer));
+	k_work_cancel_delayable(&reass->timer);
+
+	NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
+		reass->id, remaining);
+
+	sys_slist_find_and_remove(reassembly_bucket(reass->hash), &reass->node);
+	reassembly_mem -= reass->received;
+
+	for (i = 0; i < reass->count; i++) {
+		if (!reass->pkt[i]) {
 			continue;
 		}
 
-		if (avail < 0) {
-			avail = i;
-		}
-	}
+		NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
+			i, reass->pkt[i], net_pkt_get_len(reass->pkt[i]));
 
-	if (avail < 0) {
-		return NULL;
+		net_pkt_unref(reass->pkt[i]);
+		reass->pkt[i] = NULL;
 	}
 
-	k_work_reschedule(&reassembly[avail].timer, IPV6_REASSEMBLY_TIMEOUT);
+	reass->id = 0U;
+	reass->count = 0U;
+	reass->received = 0U;
+	reass->total = 0U;
+	reass->last = false;
+	reass->used = false;
+
+	return true;
+}
+
+/* Return the reassembly that expires first, i.e. the one that was
+ * started first.
+ */
+static struct net_ipv6_reassembly *
+reassembly_oldest(struct net_ipv6_reassembly *skip)
+{
+	struct net_ipv6_reassembly *oldest = NULL;
+	k_ticks_t oldest_remaining = 0;
+	int i;
 
-	net_ipv6_addr_copy_raw(reassembly[avail].src.s6_addr, src);
-	net_ipv6_addr_copy_raw(reassembly[avail].dst.s6_addr, dst);
+	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
+		k_ticks_t remaining;
 
-	reassembly[avail].id = id;
+		if (!reassembly[i].used || &reassembly[i] == skip) {
+			continue;
+		}
+
+		remaining = k_work_delayable_remaining_get(&reassembly[i].timer);
+		if (oldest == NULL || remaining < oldest_remaining) {
+			oldest = &reassembly[i];
+			oldest_remaining = remaining;
+		}
+	}
 
-	return &reassembly[avail];
+	return oldest;
 }
 
-static bool reassembly_cancel(uint32_t id,
-			      struct net_in6_addr *src,
-			      struct net_in6_addr *dst)
+static struct net_ipv6_reassembly *reassembly_get(uint32_t id,
+						  const uint8_t *src,
+						  const uint8_t *dst)
 {
-	int i, j;
+	uint32_t hash = reassembly_hash(id, src, dst);
+	struct net_ipv6_reassembly *reass;
+	int i;
 
-	NET_DBG("Cancel 0x%x", id);
+	SYS_SLIST_FOR_EACH_CONTAINER(reassembly_bucket(hash), reass, node) {
+		if (reass->hash == hash && reass->id == id &&
+		    net_ipv6_addr_cmp_raw(src, reass->src.s6_addr) &&
+		    net_ipv6_addr_cmp_raw(dst, reass->dst.s6_addr)) {
+			return reass;
+		}
+	}
 
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		int32_t remaining;
+	for (i = 0, reass = NULL; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
+		if (!reassembly[i].used) {
+			reass = &reassembly[i];
+			break;
+		}
+	}
 
-		if (reassembly[i].id != id ||
-		    !net_ipv6_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv6_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
+	if (reass == NULL) {
+		/* All the slots are in use, make room by dropping
+		 * the oldest reassembly.
+		 */
+		reass = reassembly_oldest(NULL);
+		if (reass == NULL) {
+			return NULL;
 		}
 
-		remaining = k_ticks_to_ms_ceil32(
-			k_work_delayable_remaining_get(&reassembly[i].timer));
-		k_work_cancel_delayable(&reassembly[i].timer);
+		NET_DBG("Evicting IPv6 reassembly id 0x%x", reass->id);
+		reassembly_cancel(reass);
+	}
+
+	k_work_reschedule(&reass->timer, IPV6_REASSEMBLY_TIMEOUT);
 
-		NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
-			reassembly[i].id, remaining);
+	net_ipv6_addr_copy_raw(reass->src.s6_addr, src);
+	net_ipv6_addr_copy_raw(reass->dst.s6_addr, dst);
 
-		reassembly[i].id = 0U;
+	reass->id = id;
+	reass->hash = hash;
+	reass->used = true;
 
-		for (j = 0; j < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
+	sys_slist_prepend(reassembly_bucket(hash), &reass->node);
 
-			NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
-				j, reassembly[i].pkt[j],
-				net_pkt_get_len(reassembly[i].pkt[j]));
+	return reass;
+}
+
+/* Make sure that the new fragment fits into the memory budget, dropping
+ * the oldest other reassemblies if needed.
+ */
+static int reassembly_reserve(struct net_ipv6_reassembly *reass, size_t len)
+{
+	struct net_ipv6_reassembly *oldest;
 
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
+	if (CONFIG_NET_IPV6_FRAGMENT_MAX_MEM == 0) {
+		return 0;
+	}
+
+	while (reassembly_mem + len > CONFIG_NET_IPV6_FRAGMENT_MAX_MEM) {
+		oldest = reassembly_oldest(reass);
+		if (oldest == NULL) {
+			return -ENOMEM;
 		}
 
-		return true;
+		NET_DBG("Evicting IPv6 reassembly id 0x%x", oldest->id);
+		reassembly_cancel(oldest);
 	}
 
-	return false;
+	return 0;
 }
 
 static void reassembly_info(char *str, struct net_ipv6_reassembly *reass)
@@ -217,6 +310,16 @@ static void reassembly_timeout(struct k_work *work)
 	struct net_ipv6_reassembly *reass =
 		CONTAINER_OF(dwork, struct net_ipv6_reassembly, timer);
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
+	/* The slot might have been released, or even reused, while we were
+	 * waiting for the lock.
+	 */
+	if (!reass->used ||
+	    (k_work_delayable_busy_get(dwork) & (K_WORK_DELAYED | K_WORK_QUEUED))) {
+		goto out;
+	}
+
 	reassembly_info("Reassembly cancelled", reass);
 
 	/* Send a ICMPv6 Time Exceeded only if we received the first fragment (RFC 2460 Sec. 5) */
@@ -224,7 +327,10 @@ static void reassembly_timeout(struct k_work *work)
 		net_icmpv6_send_error(reass->pkt[0], NET_ICMPV6_TIME_EXCEEDED, 1, 0);
 	}
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 }
 
 static void reassemble_packet(struct net_ipv6_reassembly *reass)
@@ -241,8 +347,6 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	uint8_t next_hdr;
 	int i, len;
 
-	k_work_cancel_delayable(&reass->timer);
-
 	NET_ASSERT(reass->pkt[0]);
 
 	last = net_buf_frag_last(reass->pkt[0]->buffer);
@@ -250,13 +354,10 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	/* We start from 2nd packet which is then appended to
 	 * the first one.
 	 */
-	for (i = 1; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
+	for (i = 1; i < reass->count; i++) {
 		int removed_len;
 
 		pkt = reass->pkt[i];
-		if (!pkt) {
-			break;
-		}
 
 		net_pkt_cursor_init(pkt);
 
@@ -271,7 +372,10 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 
 		if (net_pkt_pull(pkt, removed_len)) {
 			NET_ERR("Failed to pull headers");
-			reassembly_cancel(reass->id, &reass->src, &reass->dst);
+			/* The already attached fragments are released
+			 * together with the first one.
+			 */
+			reassembly_cancel(reass);
 			return;
 		}
 
@@ -288,6 +392,9 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	pkt = reass->pkt[0];
 	reass->pkt[0] = NULL;
 
+	/* All the fragments are now in the first packet, release the slot */
+	reassembly_cancel(reass);
+
 	/* Next we need to strip away the fragment header from the first packet
 	 * and set the various pointers and values in packet.
 	 */
@@ -360,101 +467,101 @@ void net_ipv6_frag_foreach(net_ipv6_frag_cb_t cb, void *user_data)
 {
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	for (i = 0; reassembly_init_done &&
 		     i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		if (!k_work_delayable_remaining_get(&reassembly[i].timer)) {
+		if (!reassembly[i].used) {
 			continue;
 		}
 
 		cb(&reassembly[i], user_data);
 	}
+
+	k_mutex_unlock(&reassembly_lock);
 }
 
-/* Verify that we have all the fragments received and in correct order.
+/* Insert the fragment into the reassembly and check if we have all the
+ * fragments.
  * Return:
  * - a negative value if the fragments are erroneous and must be dropped
  * - zero if we are expecting more fragments
  * - a positive value if we can proceed with the reassembly
  */
-static int fragments_are_ready(struct net_ipv6_reassembly *reass)
+static int fragment_insert(struct net_ipv6_reassembly *reass,
+			   struct net_pkt *pkt, uint16_t payload_len)
 {
-	unsigned int expected_offset = 0;
-	bool more = true;
-	int i;
+	unsigned int offset = net_pkt_ipv6_fragment_offset(pkt);
+	unsigned int end = offset + payload_len;
+	int low = 0;
+	int high = reass->count;
+
+	if (end > UINT16_MAX) {
+		return -EBADMSG;
+	}
 
 	/* Fragments can arrive in any order, for example in reverse order:
 	 *   1 -> Fragment3(M=0, offset=x2)
 	 *   2 -> Fragment2(M=1, offset=x1)
 	 *   3 -> Fragment1(M=1, offset=0)
-	 * We have to test several requirements before proceeding with the reassembly:
-	 * - We received the first fragment (Fragment Offset is 0)
-	 * - All intermediate fragments are contiguous
-	 * - The More bit of the last fragment is 0
+	 * The pending fragments are kept sorted by offset, so find the
+	 * place of this one with a binary search.
 	 */
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		struct net_pkt *pkt = reass->pkt[i];
-		unsigned int offset;
-		int payload_len;
+	while (low < high) {
+		int mid = (low + high) / 2;
 
-		if (!pkt) {
-			break;
+		if (net_pkt_ipv6_fragment_offset(reass->pkt[mid]) < offset) {
+			low = mid + 1;
+		} else {
+			high = mid;
 		}
+	}
 
-		offset = net_pkt_ipv6_fragment_offset(pkt);
-
-		if (offset < expected_offset) {
-			/* Overlapping or duplicated
-			 * According to RFC8200 we can drop it
-			 */
-			return -EBADMSG;
-		} else if (offset != expected_offset) {
-			/* Not contiguous, let's wait for fragments */
-			return 0;
-		}
+	/* Overlapping or duplicated
+	 * According to RFC8200 we can drop it
+	 */
+	if ((low > 0 && reass->end[low - 1] > offset) ||
+	    (low < reass->count &&
+	     net_pkt_ipv6_fragment_offset(reass->pkt[low]) < end)) {
+		return -EBADMSG;
+	}
 
-		payload_len = net_pkt_get_len(pkt) - net_pkt_ipv6_fragment_start(pkt);
-		payload_len -= sizeof(struct net_ipv6_frag_hdr);
-		if (payload_len < 0) {
+	/* Nothing can be beyond the fragment that has the More bit cleared */
+	if (!net_pkt_ipv6_fragment_more(pkt)) {
+		if (reass->last ||
+		    (reass->count > 0 && reass->end[reass->count - 1] > end)) {
 			return -EBADMSG;
 		}
 
-		expected_offset += payload_len;
-		more = net_pkt_ipv6_fragment_more(pkt);
+		reass->last = true;
+		reass->total = end;
+	} else if (reass->last && end > reass->total) {
+		return -EBADMSG;
 	}
 
-	if (more) {
-		return 0;
+	if (reass->count == CONFIG_NET_IPV6_FRAGMENT_MAX_PKT) {
+		/* We do not have free space left in the array */
+		return -ENOMEM;
 	}
 
-	return 1;
-}
-
-static int shift_packets(struct net_ipv6_reassembly *reass, int pos)
-{
-	int i;
+	NET_DBG("Storing pkt %p to slot %d offset %d", pkt, low, offset);
 
-	for (i = pos + 1; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		if (!reass->pkt[i]) {
-			NET_DBG("Moving [%d] %p (offset 0x%x) to [%d]",
-				pos, reass->pkt[pos],
-				net_pkt_ipv6_fragment_offset(reass->pkt[pos]),
-				pos + 1);
+	memmove(&reass->pkt[low + 1], &reass->pkt[low],
+		sizeof(reass->pkt[0]) * (reass->count - low));
+	memmove(&reass->end[low + 1], &reass->end[low],
+		sizeof(reass->end[0]) * (reass->count - low));
 
-			/* pkt[i] is free, so shift everything between
-			 * [pos] and [i - 1] by one element
-			 */
-			memmove(&reass->pkt[pos + 1], &reass->pkt[pos],
-				sizeof(void *) * (i - pos));
+	reass->pkt[low] = pkt;
+	reass->end[low] = end;
+	reass->count++;
+	reass->received += payload_len;
+	reassembly_mem += payload_len;
 
-			/* pkt[pos] is now free */
-			reass->pkt[pos] = NULL;
-
-			return 0;
-		}
-	}
-
-	/* We do not have free space left in the array */
-	return -ENOMEM;
+	/* As the fragments do not overlap and none of them is past the last
+	 * one, they cover the whole packet when their lengths add up to its
+	 * length.
+	 */
+	return reass->last && reass->received == reass->total;
 }
 
 enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
@@ -462,13 +569,16 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 					      uint8_t nexthdr)
 {
 	struct net_ipv6_reassembly *reass = NULL;
+	enum net_verdict verdict = NET_OK;
+	int payload_len;
 	uint16_t flag;
-	bool found;
 	uint8_t more;
 	uint32_t id;
 	int ret;
 	int i;
 
+	k_mutex_lock(&reassembly_lock, K_FOREVER);
+
 	if (!reassembly_init_done) {
 		/* Static initializing does not work here because of the array
 		 * so we must do it at runtime.
@@ -489,7 +599,8 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 	if (net_pkt_skip(pkt, 1) || /* reserved */
 	    net_pkt_read_be16(pkt, &flag) ||
 	    net_pkt_read_be32(pkt, &id)) {
-		goto drop;
+		verdict = NET_DROP;
+		goto out;
 	}
 
 	more = flag & 0x01;
@@ -502,85 +613,63 @@ enum net_verdict net_ipv6_handle_fragment_hdr(struct net_pkt *pkt,
 		 */
 		net_icmpv6_send_error(pkt, NET_ICMPV6_PARAM_PROBLEM,
 				      NET_ICMPV6_PARAM_PROB_HEADER, NET_IPV6H_LENGTH_OFFSET);
-		goto drop;
+		verdict = NET_DROP;
+		goto out;
+	}
+
+	payload_len = net_pkt_get_len(pkt) - net_pkt_ipv6_fragment_start(pkt) -
+		      sizeof(struct net_ipv6_frag_hdr);
+	if (payload_len < 0) {
+		verdict = NET_DROP;
+		goto out;
 	}
 
 	reass = reassembly_get(id, hdr->src, hdr->dst);
 	if (reass == NULL) {
 		NET_DBG("Cannot get reassembly slot, dropping pkt %p", pkt);
-		goto drop;
+		verdict = NET_DROP;
+		goto out;
 	}
 
-	/* The fragments might come in wrong order so place them
-	 * in reassembly chain in correct order.
-	 */
-	for (i = 0, found = false; i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT; i++) {
-		if (reass->pkt[i]) {
-			if (net_pkt_ipv6_fragment_offset(reass->pkt[i]) <
-			    net_pkt_ipv6_fragment_offset(pkt)) {
-				continue;
-			}
-
-			/* Make room for this fragment. If there is no room,
-			 * then it will discard the whole reassembly.
-			 */
-			if (shift_packets(reass, i)) {
-				break;
-			}
-		}
-
-		NET_DBG("Storing pkt %p to slot %d offset %d",
-			pkt, i, net_pkt_ipv6_fragment_offset(pkt));
-		reass->pkt[i] = pkt;
-		found = true;
-
-		break;
+	if (reassembly_reserve(reass, payload_len) < 0) {
+		NET_DBG("No memory available for 0x%x", reass->id);
+		net_pkt_unref(pkt);
+		goto drop;
 	}
 
-	if (!found) {
+	ret = fragment_insert(reass, pkt, payload_len);
+	if (ret == -ENOMEM) {
 		/* We could not add this fragment into our saved fragment
 		 * list. We must discard the whole packet at this point.
 		 */
 		NET_DBG("No slots available for 0x%x", reass->id);
 		net_pkt_unref(pkt);
 		goto drop;
-	}
-
-	ret = fragments_are_ready(reass);
-	if (ret < 0) {
+	} else if (ret < 0) {
 		NET_DBG("Reassembled IPv6 verify failed, dropping id %u",
 			reass->id);
-
-		/* Let the caller release the already inserted pkt */
-		if (i < CONFIG_NET_IPV6_FRAGMENT_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
-
 		net_pkt_unref(pkt);
 		goto drop;
 	} else if (ret == 0) {
 		reassembly_info("Reassembly nth pkt", reass);
 
 		NET_DBG("More fragments to be received");
-		goto accept;
+		goto out;
 	}
 
 	reassembly_info("Reassembly last pkt", reass);
 
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
-
-accept:
-	return NET_OK;
+	goto out;
 
 drop:
-	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
-	}
+	reassembly_cancel(reass);
+
+out:
+	k_mutex_unlock(&reassembly_lock);
 
-	return NET_DROP;
+	return verdict;
 }
 
 #define BUF_ALLOC_TIMEOUT K_MSEC(100)
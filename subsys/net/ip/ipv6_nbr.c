@@ -880,7 +880,8 @@ use_interface_mtu:
 			mtu = MAX(NET_IPV6_MTU, mtu);
 		}
 
-		if (mtu < pkt_len) {
+		/* TCP super-segments are split by L2 or the driver instead */
+		if (mtu < pkt_len && net_pkt_gso_size(pkt) == 0U) {
 			ret = net_ipv6_send_fragmented_pkt(net_pkt_iface(pkt),
 							   pkt, pkt_len, mtu);
 			if (ret < 0) {
@@ -150,6 +150,67 @@ NET_BUF_POOL_VAR_ALIGN_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
 
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
+#if defined(CONFIG_NET_IF_RX_POOL)
+static inline struct k_mem_slab *get_rx_slab(struct net_if *iface)
+{
+	struct net_pkt_rx_pool *pool = net_if_get_rx_pool(iface);
+
+	return pool != NULL ? pool->pkt_slab : &rx_pkts;
+}
+
+/* Data pool of a RX packet, the packet might have been allocated from the
+ * pool of an interface other than its current one.
+ */
+static inline struct net_buf_pool *get_rx_data_pool(struct net_pkt *pkt)
+{
+	struct net_pkt_rx_pool *pool = net_if_get_rx_pool(pkt->iface);
+
+	if (pool != NULL && pool->pkt_slab == pkt->slab) {
+		return pool->data_pool;
+	}
+
+	return &rx_bufs;
+}
+
+/* Called after allocating a packet from the RX pool of an interface */
+static void rx_pool_alloc_done(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_pkt_rx_pool *pool = net_if_get_rx_pool(iface);
+	uint32_t free;
+
+	if (pool == NULL) {
+		return;
+	}
+
+	if (pkt == NULL) {
+		pool->alloc_failed++;
+		return;
+	}
+
+#if defined(CONFIG_NET_RX_DEFAULT_PRIORITY)
+	/* pkt_alloc() only knows the default priority of the global slabs */
+	net_pkt_set_priority(pkt, CONFIG_NET_RX_DEFAULT_PRIORITY);
+#endif
+
+	free = k_mem_slab_num_free_get(pool->pkt_slab);
+	if (free < pool->pkt_min_free) {
+		pool->pkt_min_free = free;
+	}
+}
+#else
+#define get_rx_slab(iface) (&rx_pkts)
+#define get_rx_data_pool(pkt) (&rx_bufs)
+#define rx_pool_alloc_done(iface, pkt)
+#endif /* CONFIG_NET_IF_RX_POOL */
+
+bool net_pkt_rx_pool_is_low(struct net_if *iface)
+{
+	struct net_pkt_rx_pool *pool = net_if_get_rx_pool(iface);
+
+	return pool != NULL &&
+	       k_mem_slab_num_free_get(pool->pkt_slab) < pool->low_threshold;
+}
+
 /* Allocation tracking is only available if separately enabled */
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 struct net_pkt_alloc {
@@ -451,6 +512,19 @@ struct net_buf *net_pkt_get_frag(struct net_pkt *pkt, size_t min_len,
 	}
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
+#if defined(CONFIG_NET_IF_RX_POOL)
+	if (get_rx_data_pool(pkt) != &rx_bufs) {
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		return net_pkt_get_reserve_data_debug(get_rx_data_pool(pkt),
+						      min_len, timeout,
+						      caller, line);
+#else
+		return net_pkt_get_reserve_data(get_rx_data_pool(pkt), min_len,
+						timeout);
+#endif /* NET_LOG_LEVEL >= LOG_LEVEL_DBG */
+	}
+#endif /* CONFIG_NET_IF_RX_POOL */
+
 	if (pkt->slab == &rx_pkts) {
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 		return net_pkt_get_reserve_rx_data_debug(min_len, timeout,
@@ -1302,7 +1376,7 @@ int net_pkt_alloc_buffer_with_reserve(struct net_pkt *pkt,
 	}
 
 	if (!pool) {
-		pool = pkt->slab == &tx_pkts ? &tx_bufs : &rx_bufs;
+		pool = pkt->slab == &tx_pkts ? &tx_bufs : get_rx_data_pool(pkt);
 	}
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
@@ -1430,7 +1504,7 @@ int net_pkt_alloc_buffer_raw(struct net_pkt *pkt, size_t size,
 	}
 
 	if (!pool) {
-		pool = pkt->slab == &tx_pkts ? &tx_bufs : &rx_bufs;
+		pool = pkt->slab == &tx_pkts ? &tx_bufs : get_rx_data_pool(pkt);
 	}
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
@@ -1637,11 +1711,17 @@ struct net_pkt *net_pkt_rx_alloc_on_iface(struct net_if *iface,
 					  k_timeout_t timeout)
 #endif
 {
+	struct net_pkt *pkt;
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
-	return pkt_alloc_on_iface(&rx_pkts, iface, timeout, caller, line);
+	pkt = pkt_alloc_on_iface(get_rx_slab(iface), iface, timeout, caller, line);
 #else
-	return pkt_alloc_on_iface(&rx_pkts, iface, timeout);
+	pkt = pkt_alloc_on_iface(get_rx_slab(iface), iface, timeout);
 #endif
+
+	rx_pool_alloc_done(iface, pkt);
+
+	return pkt;
 }
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
@@ -1744,13 +1824,19 @@ struct net_pkt *net_pkt_rx_alloc_with_buffer(struct net_if *iface,
 					     k_timeout_t timeout)
 #endif
 {
+	struct net_pkt *pkt;
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
-	return pkt_alloc_with_buffer(&rx_pkts, iface, size, family,
-					proto, timeout, caller, line);
+	pkt = pkt_alloc_with_buffer(get_rx_slab(iface), iface, size, family,
+				    proto, timeout, caller, line);
 #else
-	return pkt_alloc_with_buffer(&rx_pkts, iface, size, family,
-					proto, timeout);
+	pkt = pkt_alloc_with_buffer(get_rx_slab(iface), iface, size, family,
+				    proto, timeout);
 #endif
+
+	rx_pool_alloc_done(iface, pkt);
+
+	return pkt;
 }
 
 void net_pkt_append_buffer(struct net_pkt *pkt, struct net_buf *buffer)
@@ -2091,6 +2177,8 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_l2_bridged(clone_pkt, net_pkt_is_l2_bridged(pkt));
 	net_pkt_set_l2_processed(clone_pkt, net_pkt_is_l2_processed(pkt));
 	net_pkt_set_ll_proto_type(clone_pkt, net_pkt_ll_proto_type(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
+	net_pkt_set_rx_hash(clone_pkt, net_pkt_rx_hash(pkt));
 
 #if defined(CONFIG_NET_OFFLOAD) || defined(CONFIG_NET_L2_IPIP)
 	net_pkt_set_remote_address(clone_pkt, net_pkt_remote_address(pkt),
@@ -2124,6 +2212,13 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	clone_pkt_cb(pkt, clone_pkt);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+void net_pkt_copy_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
+{
+	clone_pkt_attributes(pkt, clone_pkt);
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 static struct net_pkt *net_pkt_clone_internal(struct net_pkt *pkt,
 					      struct k_mem_slab *slab,
 					      k_timeout_t timeout)
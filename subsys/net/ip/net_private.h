@@ -231,6 +231,10 @@ static inline bool net_tc_rx_is_immediate(int tc, int prio)
 }
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
+#if defined(CONFIG_NET_TCP_GSO)
+extern void net_pkt_copy_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt);
+#endif /* CONFIG_NET_TCP_GSO */
+
 char *net_sprint_addr(net_sa_family_t af, const void *addr);
 
 #define net_sprint_ipv4_addr(_addr) net_sprint_addr(NET_AF_INET, _addr)
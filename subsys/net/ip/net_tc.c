@@ -13,13 +13,24 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_stats.h>
+#include <zephyr/net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
 
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING)
+#define NET_TC_RX_FLOW_QUEUES CONFIG_NET_TC_RX_FLOW_QUEUES
+#else
+#define NET_TC_RX_FLOW_QUEUES 1
+#endif
+
+/* Each RX traffic class has NET_TC_RX_FLOW_QUEUES queues */
+#define NET_TC_RX_QUEUE_COUNT (NET_TC_RX_COUNT * NET_TC_RX_FLOW_QUEUES)
+
 #if NET_TC_RX_EFFECTIVE_COUNT > 1
-#define NET_TC_RX_SLOTS (CONFIG_NET_PKT_RX_COUNT / NET_TC_RX_EFFECTIVE_COUNT)
+#define NET_TC_RX_SLOTS (CONFIG_NET_PKT_RX_COUNT /			\
+			 (NET_TC_RX_EFFECTIVE_COUNT * NET_TC_RX_FLOW_QUEUES))
 BUILD_ASSERT(NET_TC_RX_SLOTS > 0,
 		"Misconfiguration: There are more traffic classes then packets, "
 		"either increase CONFIG_NET_PKT_RX_COUNT or decrease "
@@ -44,12 +55,17 @@ BUILD_ASSERT(NET_TC_TX_SLOTS > 0,
  */
 #define MAX_NAME_LEN sizeof("xx_q[y]")
 
+/* With flow steering the RX thread name is "rx_q[y.z]" where z is the flow
+ * queue within the traffic class.
+ */
+#define MAX_RX_NAME_LEN sizeof("rx_q[y.z]")
+
 /* Stacks for TX work queue */
 K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_QUEUE_COUNT,
 			    CONFIG_NET_RX_STACK_SIZE);
 
 #if NET_TC_TX_COUNT > 0
@@ -57,7 +73,170 @@ static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_QUEUE_COUNT];
+#endif
+
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING)
+/* Ethernet header with a VLAN tag, IPv6 header and the transport ports */
+#define FLOW_HDR_MAX_LEN (sizeof(struct net_eth_vlan_hdr) +		\
+			  sizeof(struct net_ipv6_hdr) + 2 * sizeof(uint16_t))
+
+static inline uint32_t rotl32(uint32_t val, uint8_t shift)
+{
+	return (val << shift) | (val >> (32U - shift));
+}
+
+/* Mixing step of the 32-bit MurmurHash3 */
+static inline uint32_t flow_hash_mix(uint32_t hash, uint32_t val)
+{
+	val *= 0xcc9e2d51U;
+	val = rotl32(val, 15U);
+	val *= 0x1b873593U;
+
+	hash ^= val;
+	hash = rotl32(hash, 13U);
+
+	return hash * 5U + 0xe6546b64U;
+}
+
+static uint32_t flow_hash_data(uint32_t hash, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = flow_hash_mix(hash, UNALIGNED_GET((const uint32_t *)&data[i]));
+	}
+
+	return hash;
+}
+
+/* Hash the flow of a received packet from its addresses, protocol and,
+ * for unfragmented TCP and UDP packets, ports. Packets that cannot be
+ * parsed, including all the packets of L2s whose frames do not start with
+ * an Ethernet or IP header, get hash 0 so they keep their relative order.
+ */
+static uint32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	const struct net_l2 *l2 = net_if_l2(net_pkt_iface(pkt));
+	uint8_t hdr[FLOW_HDR_MAX_LEN];
+	size_t len, off = 0U;
+	bool ports = false;
+	uint32_t hash = 0U;
+	uint8_t proto;
+
+	len = net_buf_linearize(hdr, sizeof(hdr), pkt->buffer, 0, sizeof(hdr));
+
+	if (IS_ENABLED(CONFIG_NET_L2_ETHERNET) && l2 == &NET_L2_GET_NAME(ETHERNET)) {
+		struct net_eth_hdr *eth = (struct net_eth_hdr *)hdr;
+		uint16_t type;
+
+		if (len < sizeof(struct net_eth_hdr)) {
+			return 0U;
+		}
+
+		type = net_ntohs(eth->type);
+		off = sizeof(struct net_eth_hdr);
+
+		if (type == NET_ETH_PTYPE_VLAN) {
+			if (len < sizeof(struct net_eth_vlan_hdr)) {
+				return 0U;
+			}
+
+			type = net_ntohs(((struct net_eth_vlan_hdr *)hdr)->type);
+			off = sizeof(struct net_eth_vlan_hdr);
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return 0U;
+		}
+	} else if (!(IS_ENABLED(CONFIG_NET_L2_DUMMY) && l2 == &NET_L2_GET_NAME(DUMMY))) {
+		/* Only the dummy L2 hands over bare IP packets, the frames of
+		 * the other L2s are not parsed.
+		 */
+		return 0U;
+	}
+
+	if (len <= off) {
+		return 0U;
+	}
+
+	switch (hdr[off] & 0xf0) {
+	case 0x40: {
+		struct net_ipv4_hdr *ipv4 = (struct net_ipv4_hdr *)&hdr[off];
+		uint16_t frag;
+
+		if (len < off + sizeof(struct net_ipv4_hdr)) {
+			return 0U;
+		}
+
+		proto = ipv4->proto;
+		frag = UNALIGNED_GET((uint16_t *)ipv4->offset);
+		ports = (net_ntohs(frag) & (NET_IPV4_FRAGH_OFFSET_MASK |
+					    NET_IPV4_MORE_FRAG_MASK)) == 0U;
+
+		hash = flow_hash_data(hash, ipv4->src, 2 * NET_IPV4_ADDR_SIZE);
+		off += (ipv4->vhl & 0x0f) * 4U;
+		break;
+	}
+	case 0x60: {
+		struct net_ipv6_hdr *ipv6 = (struct net_ipv6_hdr *)&hdr[off];
+
+		if (len < off + sizeof(struct net_ipv6_hdr)) {
+			return 0U;
+		}
+
+		/* Ports are only looked at if there are no extension
+		 * headers, so fragments of a packet hash the same way.
+		 */
+		proto = ipv6->nexthdr;
+		ports = true;
+
+		hash = flow_hash_data(hash, ipv6->src, 2 * NET_IPV6_ADDR_SIZE);
+		off += sizeof(struct net_ipv6_hdr);
+		break;
+	}
+	default:
+		return 0U;
+	}
+
+	if (ports && (proto == NET_IPPROTO_TCP || proto == NET_IPPROTO_UDP) &&
+	    len >= off + 2 * sizeof(uint16_t)) {
+		hash = flow_hash_data(hash, &hdr[off], 2 * sizeof(uint16_t));
+	}
+
+	hash = flow_hash_mix(hash, proto);
+
+	/* Final avalanche so that the low bits depend on all the input */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+#endif /* CONFIG_NET_TC_RX_FLOW_STEERING */
+
+#if NET_TC_RX_COUNT > 0
+/* Select the RX queue of the traffic class. Packets of the same flow
+ * always go to the same queue so they are processed in order.
+ */
+static inline struct net_traffic_class *rx_queue_get(uint8_t tc,
+						      struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING)
+	uint32_t hash = net_pkt_rx_hash(pkt);
+
+	if (hash == 0U) {
+		hash = rx_flow_hash(pkt);
+		net_pkt_set_rx_hash(pkt, hash);
+	}
+
+	return &rx_classes[tc * NET_TC_RX_FLOW_QUEUES + hash % NET_TC_RX_FLOW_QUEUES];
+#else
+	ARG_UNUSED(pkt);
+
+	return &rx_classes[tc];
+#endif
+}
 #endif
 
 enum net_verdict net_tc_try_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt,
@@ -84,13 +263,14 @@ enum net_verdict net_tc_try_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt,
 enum net_verdict net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_RX_COUNT > 0
+	struct net_traffic_class *rx_class = rx_queue_get(tc, pkt);
 #if NET_TC_RX_EFFECTIVE_COUNT > 1
 	uint8_t retry_cnt = NET_TC_RETRY_CNT;
 #endif
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 #if NET_TC_RX_EFFECTIVE_COUNT > 1
-	while (k_sem_take(&rx_classes[tc].fifo_slot, K_NO_WAIT) != 0) {
+	while (k_sem_take(&rx_class->fifo_slot, K_NO_WAIT) != 0) {
 		if (k_is_in_isr() || retry_cnt == 0) {
 			return NET_DROP;
 		}
@@ -103,7 +283,7 @@ enum net_verdict net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 	}
 #endif
 
-	k_fifo_put(&rx_classes[tc].fifo, pkt);
+	k_fifo_put(&rx_class->fifo, pkt);
 	return NET_OK;
 #else
 	ARG_UNUSED(tc);
@@ -382,10 +562,9 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_QUEUE_COUNT; i++) {
 		k_tid_t tid;
-		int priority = net_tc_rx_thread_priority(i);
-
+		int priority = net_tc_rx_thread_priority(i / NET_TC_RX_FLOW_QUEUES);
 
 		NET_DBG("[%d] Starting RX handler %p stack size %zd prio %d", i,
 			&rx_classes[i].handler,
@@ -415,12 +594,25 @@ void net_tc_rx_init(void)
 		}
 
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
-			char name[MAX_NAME_LEN];
+			char name[MAX_RX_NAME_LEN];
+
+			if (IS_ENABLED(CONFIG_NET_TC_RX_FLOW_STEERING)) {
+				snprintk(name, sizeof(name), "rx_q[%d.%d]",
+					 i / NET_TC_RX_FLOW_QUEUES,
+					 i % NET_TC_RX_FLOW_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "rx_q[%d]", i);
+			}
 
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
 			k_thread_name_set(tid, name);
 		}
 
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING) && defined(CONFIG_SCHED_CPU_MASK)
+		/* Spread the flow queues of a traffic class over the CPUs */
+		(void)k_thread_cpu_pin(tid, (i % NET_TC_RX_FLOW_QUEUES) %
+					    arch_num_cpus());
+#endif
+
 		k_thread_start(tid);
 	}
 #endif
@@ -15,6 +15,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
 
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/net_timeout.h>
@@ -47,7 +48,7 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
@@ -68,6 +69,14 @@ struct net_route_entry {
 
 	/** Is the route valid forever */
 	uint8_t is_infinite : 1;
+
+#if defined(CONFIG_NET_ROUTE_LPM)
+	/** Node in the list of routes sharing the same prefix */
+	sys_snode_t lpm_node;
+
+	/** Prefix trie node holding this route */
+	void *lpm;
+#endif
 };
 
 /* Route preference values, as defined in RFC 4191 */
@@ -339,6 +348,18 @@ int net_route_packet(struct net_pkt *pkt, struct net_in6_addr *nexthop);
  */
 int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface);
 
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* Longest prefix match trie of the unicast routes, see route_lpm.c */
+int net_route_lpm_add(struct net_route_entry *route);
+void net_route_lpm_del(struct net_route_entry *route);
+struct net_route_entry *net_route_lpm_lookup(struct net_if *iface,
+					     const struct net_in6_addr *dst);
+struct net_route_entry *net_route_lpm_find(struct net_if *iface,
+					   const struct net_in6_addr *prefix,
+					   uint8_t prefix_len);
+void net_route_lpm_init(void);
+#endif
+
 #if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_NATIVE)
 void net_route_init(void);
 #else
@@ -0,0 +1,371 @@
+/** @file
+ * @brief Longest prefix match lookup for IPv6 routes.
+ *
+ * The routes are kept in a path compressed binary trie (Patricia trie)
+ * keyed by the route prefix, so a lookup only visits the nodes along the
+ * destination address bits instead of every route in the table. Each node
+ * holds the routes having exactly its prefix, there can be several of them
+ * when the same prefix is routed via different network interfaces.
+ *
+ * A node that has no routes always has two children, so the trie never
+ * needs more than 2 * CONFIG_NET_MAX_ROUTES - 1 nodes.
+ *
+ * Callers must hold the IPv6 neighbor lock.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/sys/slist.h>
+
+#include <zephyr/net/net_ip.h>
+
+#include "net_private.h"
+#include "route.h"
+
+struct route_lpm_node {
+	/** Parent node, NULL for the root */
+	struct route_lpm_node *parent;
+
+	/** Child nodes, indexed by the first bit after the prefix */
+	struct route_lpm_node *child[2];
+
+	/** Routes that have exactly this prefix */
+	sys_slist_t routes;
+
+	/** Prefix of the node, bits after prefix_len are zero */
+	struct net_in6_addr prefix;
+
+	/** Prefix length in bits */
+	uint8_t prefix_len;
+
+	/** Is the node allocated */
+	bool in_use;
+};
+
+static struct route_lpm_node lpm_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_lpm_node *lpm_root;
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Small direct mapped cache of recent lookups. Any change in the routes
+ * flushes it, so the cached entries are always valid.
+ */
+struct route_cache_entry {
+	struct net_in6_addr dst;
+	struct net_if *iface;
+	struct net_route_entry *route;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+
+static inline struct route_cache_entry *route_cache_slot(const struct net_in6_addr *dst)
+{
+	uint32_t hash = UNALIGNED_GET(&dst->s6_addr32[2]) ^
+			UNALIGNED_GET(&dst->s6_addr32[3]);
+
+	hash ^= hash >> 16;
+
+	return &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+}
+
+static void route_cache_flush(void)
+{
+	memset(route_cache, 0, sizeof(route_cache));
+}
+#else
+#define route_cache_flush(...)
+#endif /* CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
+
+static inline uint8_t addr_bit(const struct net_in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7U - (pos % 8U))) & 0x01;
+}
+
+/* Number of leading bits that a and b have in common, at most max_len */
+static uint8_t common_prefix_len(const struct net_in6_addr *a,
+				 const struct net_in6_addr *b,
+				 uint8_t max_len)
+{
+	uint8_t len = 0U;
+
+	for (int i = 0; i < NET_IPV6_ADDR_SIZE && len < max_len; i++) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff == 0U) {
+			len += 8U;
+			continue;
+		}
+
+		while ((diff & 0x80) == 0U) {
+			diff <<= 1;
+			len++;
+		}
+
+		break;
+	}
+
+	return MIN(len, max_len);
+}
+
+static struct route_lpm_node *node_alloc(const struct net_in6_addr *prefix,
+					 uint8_t prefix_len)
+{
+	for (int i = 0; i < ARRAY_SIZE(lpm_nodes); i++) {
+		struct route_lpm_node *node = &lpm_nodes[i];
+
+		if (node->in_use) {
+			continue;
+		}
+
+		memset(node, 0, sizeof(*node));
+		node->in_use = true;
+		node->prefix_len = prefix_len;
+
+		/* Store the prefix with host bits cleared */
+		for (uint8_t bit = 0U; bit < prefix_len; bit += 8U) {
+			uint8_t remain = prefix_len - bit;
+			uint8_t mask = remain >= 8U ? 0xff : (uint8_t)(0xff << (8U - remain));
+
+			node->prefix.s6_addr[bit / 8U] = prefix->s6_addr[bit / 8U] & mask;
+		}
+
+		return node;
+	}
+
+	return NULL;
+}
+
+static inline struct route_lpm_node **node_link(struct route_lpm_node *node)
+{
+	if (node->parent == NULL) {
+		return &lpm_root;
+	}
+
+	return &node->parent->child[addr_bit(&node->prefix, node->parent->prefix_len)];
+}
+
+static inline void node_set_child(struct route_lpm_node *parent,
+				  struct route_lpm_node *child)
+{
+	parent->child[addr_bit(&child->prefix, parent->prefix_len)] = child;
+	child->parent = parent;
+}
+
+/* Find or create the node for the given prefix */
+static struct route_lpm_node *node_get(const struct net_in6_addr *prefix,
+				       uint8_t prefix_len)
+{
+	struct route_lpm_node *parent = NULL;
+	struct route_lpm_node **link = &lpm_root;
+	struct route_lpm_node *node, *leaf, *split;
+	uint8_t common;
+
+	while (*link != NULL) {
+		node = *link;
+
+		common = common_prefix_len(&node->prefix, prefix,
+					   MIN(node->prefix_len, prefix_len));
+
+		if (common == node->prefix_len) {
+			if (node->prefix_len == prefix_len) {
+				return node;
+			}
+
+			/* The new prefix is below this node */
+			parent = node;
+			link = &node->child[addr_bit(prefix, node->prefix_len)];
+			continue;
+		}
+
+		/* The new prefix diverges from the node, or is above it */
+		leaf = node_alloc(prefix, prefix_len);
+		if (leaf == NULL) {
+			return NULL;
+		}
+
+		if (common == prefix_len) {
+			leaf->parent = parent;
+			*link = leaf;
+			node_set_child(leaf, node);
+
+			return leaf;
+		}
+
+		split = node_alloc(prefix, common);
+		if (split == NULL) {
+			leaf->in_use = false;
+			return NULL;
+		}
+
+		split->parent = parent;
+		*link = split;
+		node_set_child(split, node);
+		node_set_child(split, leaf);
+
+		return leaf;
+	}
+
+	leaf = node_alloc(prefix, prefix_len);
+	if (leaf == NULL) {
+		return NULL;
+	}
+
+	leaf->parent = parent;
+	*link = leaf;
+
+	return leaf;
+}
+
+/* Drop nodes that no longer carry routes nor branch the trie */
+static void node_prune(struct route_lpm_node *node)
+{
+	while (node != NULL && sys_slist_is_empty(&node->routes)) {
+		struct route_lpm_node *parent = node->parent;
+		struct route_lpm_node *child;
+
+		if (node->child[0] != NULL && node->child[1] != NULL) {
+			break;
+		}
+
+		child = node->child[0] != NULL ? node->child[0] : node->child[1];
+
+		*node_link(node) = child;
+		if (child != NULL) {
+			child->parent = parent;
+		}
+
+		node->in_use = false;
+		node = parent;
+	}
+}
+
+int net_route_lpm_add(struct net_route_entry *route)
+{
+	struct route_lpm_node *node;
+
+	node = node_get(&route->addr, route->prefix_len);
+	if (node == NULL) {
+		NET_ERR("No free route trie node");
+		return -ENOMEM;
+	}
+
+	sys_slist_prepend(&node->routes, &route->lpm_node);
+	route->lpm = node;
+
+	route_cache_flush();
+
+	return 0;
+}
+
+void net_route_lpm_del(struct net_route_entry *route)
+{
+	struct route_lpm_node *node = route->lpm;
+
+	if (node == NULL) {
+		return;
+	}
+
+	sys_slist_find_and_remove(&node->routes, &route->lpm_node);
+	route->lpm = NULL;
+
+	node_prune(node);
+
+	route_cache_flush();
+}
+
+static struct net_route_entry *node_route(struct route_lpm_node *node,
+					  struct net_if *iface)
+{
+	struct net_route_entry *route;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, lpm_node) {
+		if (iface == NULL || route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+struct net_route_entry *net_route_lpm_lookup(struct net_if *iface,
+					     const struct net_in6_addr *dst)
+{
+	struct route_lpm_node *node = lpm_root;
+	struct net_route_entry *found = NULL;
+	struct net_route_entry *route;
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	struct route_cache_entry *slot = route_cache_slot(dst);
+
+	if (slot->route != NULL && slot->iface == iface &&
+	    net_ipv6_addr_cmp(&slot->dst, dst)) {
+		return slot->route;
+	}
+#endif
+
+	while (node != NULL) {
+		if (!net_ipv6_is_prefix(dst->s6_addr, node->prefix.s6_addr,
+					node->prefix_len)) {
+			break;
+		}
+
+		route = node_route(node, iface);
+		if (route != NULL) {
+			found = route;
+		}
+
+		if (node->prefix_len >= 128U) {
+			break;
+		}
+
+		node = node->child[addr_bit(dst, node->prefix_len)];
+	}
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	if (found != NULL) {
+		net_ipaddr_copy(&slot->dst, dst);
+		slot->iface = iface;
+		slot->route = found;
+	}
+#endif
+
+	return found;
+}
+
+struct net_route_entry *net_route_lpm_find(struct net_if *iface,
+					   const struct net_in6_addr *prefix,
+					   uint8_t prefix_len)
+{
+	struct route_lpm_node *node = lpm_root;
+
+	while (node != NULL && node->prefix_len <= prefix_len) {
+		if (!net_ipv6_is_prefix(prefix->s6_addr, node->prefix.s6_addr,
+					node->prefix_len)) {
+			break;
+		}
+
+		if (node->prefix_len == prefix_len) {
+			return node_route(node, iface);
+		}
+
+		node = node->child[addr_bit(prefix, node->prefix_len)];
+	}
+
+	return NULL;
+}
+
+void net_route_lpm_init(void)
+{
+	memset(lpm_nodes, 0, sizeof(lpm_nodes));
+	lpm_root = NULL;
+
+	route_cache_flush();
+}
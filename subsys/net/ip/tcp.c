@@ -1575,6 +1575,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		/* Append the data buffer to the pkt */
 		net_pkt_append_buffer(pkt, data->buffer);
 		data->buffer = NULL;
+		net_pkt_set_gso_size(pkt, net_pkt_gso_size(data));
 	}
 
 	ret = ip_header_add(conn, pkt);
@@ -1718,11 +1719,15 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
-static int tcp_pkt_append(struct net_pkt *pkt, const uint8_t *data, size_t len)
+/* Make sure pkt has room for len more bytes, return the first buffer with
+ * tailroom in *first.
+ */
+static int tcp_pkt_reserve(struct net_pkt *pkt, size_t len,
+			   struct net_buf **first)
 {
 	size_t alloc_len = len;
 	struct net_buf *buf = NULL;
-	int ret = 0;
+	int ret;
 
 	if (pkt->buffer) {
 		buf = net_buf_frag_last(pkt->buffer);
@@ -1746,6 +1751,21 @@ static int tcp_pkt_append(struct net_pkt *pkt, const uint8_t *data, size_t len)
 		buf = pkt->buffer;
 	}
 
+	*first = buf;
+
+	return 0;
+}
+
+static int tcp_pkt_append(struct net_pkt *pkt, const uint8_t *data, size_t len)
+{
+	struct net_buf *buf;
+	int ret;
+
+	ret = tcp_pkt_reserve(pkt, len, &buf);
+	if (ret < 0) {
+		return ret;
+	}
+
 	while (buf != NULL && len > 0) {
 		size_t write_len = MIN(len, net_buf_tailroom(buf));
 
@@ -1761,6 +1781,52 @@ static int tcp_pkt_append(struct net_pkt *pkt, const uint8_t *data, size_t len)
 	return ret;
 }
 
+#if defined(CONFIG_NET_TCP_QUEUE_FILL)
+/* Like tcp_pkt_append() but let the data source write straight into the
+ * packet buffers. Returns the number of bytes appended, which is less than
+ * len if the source ran dry.
+ */
+static int tcp_pkt_append_fill(struct net_pkt *pkt, size_t len,
+			       net_tcp_fill_cb_t cb, void *user_data)
+{
+	struct net_buf *buf;
+	size_t filled = 0;
+	int ret;
+
+	ret = tcp_pkt_reserve(pkt, len, &buf);
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (buf != NULL && filled < len) {
+		size_t fill_len = MIN(len - filled, net_buf_tailroom(buf));
+
+		ret = cb(net_buf_tail(buf), fill_len, user_data);
+		if (ret < 0) {
+			break;
+		}
+
+		net_buf_add(buf, ret);
+		filled += ret;
+
+		if ((size_t)ret < fill_len) {
+			break;
+		}
+
+		buf = buf->frags;
+	}
+
+	/* Drop the buffers reserved for data that never came */
+	net_pkt_trim_buffer(pkt);
+
+	if (ret < 0 && filled == 0) {
+		return ret;
+	}
+
+	return filled;
+}
+#endif /* CONFIG_NET_TCP_QUEUE_FILL */
+
 static bool tcp_window_full(struct tcp *conn)
 {
 	bool window_full = (conn->send_data_total >= conn->send_win);
@@ -1814,13 +1880,49 @@ static void tcp_setup_retransmission(struct tcp *conn)
 	k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer, K_MSEC(TCP_RTO_MS));
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+/* Check if the L2 of the connection interface is able to split TCP
+ * super-segments, in which case more than one MSS worth of data can be
+ * passed down in one packet.
+ */
+static bool tcp_gso_supported(struct tcp *conn)
+{
+	const struct net_l2 *l2;
+
+	if (conn->iface == NULL) {
+		return false;
+	}
+
+	l2 = net_if_l2(conn->iface);
+	if (l2 == NULL || l2->get_flags == NULL) {
+		return false;
+	}
+
+	return (l2->get_flags(conn->iface) & NET_L2_GSO) != 0;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+static int tcp_send_max_len(struct tcp *conn)
+{
+	int mss = conn_mss(conn);
+
+#if defined(CONFIG_NET_TCP_GSO)
+	if (tcp_gso_supported(conn) && mss < CONFIG_NET_TCP_GSO_MAX_SIZE) {
+		return (CONFIG_NET_TCP_GSO_MAX_SIZE / mss) * mss;
+	}
+#endif
+
+	return mss;
+}
+
 static int tcp_send_data(struct tcp *conn)
 {
 	int ret = 0;
 	int len;
+	int mss = conn_mss(conn);
 	struct net_pkt *pkt;
 
-	len = MIN(tcp_unsent_len(conn), conn_mss(conn));
+	len = MIN(tcp_unsent_len(conn), tcp_send_max_len(conn));
 	if (len < 0) {
 		ret = len;
 		goto out;
@@ -1831,13 +1933,35 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
+	/* Only full sized segments are put into a super-segment, the
+	 * remainder is sent separately so that Nagle's algorithm still
+	 * applies to it.
+	 */
+	if (len > mss) {
+		len -= len % mss;
+	}
+
 	pkt = tcp_pkt_alloc(conn, len);
+	if (!pkt && len > mss) {
+		/* Not enough buffers for a super-segment, fall back to
+		 * sending a single segment.
+		 */
+		NET_DBG("[%p] super-segment allocation failed, len=%d",
+			conn, len);
+		len = MIN(len, mss);
+		pkt = tcp_pkt_alloc(conn, len);
+	}
+
 	if (!pkt) {
 		NET_ERR("[%p] packet allocation failed, len=%d", conn, len);
 		ret = -ENOBUFS;
 		goto out;
 	}
 
+	if (len > mss) {
+		net_pkt_set_gso_size(pkt, mss);
+	}
+
 	ret = tcp_pkt_peek(pkt, &conn->send_data, conn->unacked_len, len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
@@ -3803,6 +3927,32 @@ int net_tcp_update_recv_wnd(struct net_context *context, int32_t delta)
 	return ret;
 }
 
+/* Account freshly queued data and push out what the window allows.
+ * Called with the connection lock held.
+ */
+static int tcp_queue_commit(struct tcp *conn, size_t queued_len)
+{
+	int ret;
+
+	conn->send_data_total += queued_len;
+
+	/* Successfully queued data for transmission. Even if there's a transmit
+	 * failure now (out-of-buf case), it can be ignored for now, retransmit
+	 * timer will take care of queued data retransmission.
+	 */
+	ret = tcp_send_queued_data(conn);
+	if (ret < 0 && ret != -ENOBUFS) {
+		tcp_conn_close(conn, ret);
+		return ret;
+	}
+
+	if (tcp_window_full(conn)) {
+		(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
+	}
+
+	return queued_len;
+}
+
 int net_tcp_queue(struct net_context *context, const void *data, size_t len,
 		  const struct net_msghdr *msg)
 {
@@ -3871,28 +4021,72 @@ int net_tcp_queue(struct net_context *context, const void *data, size_t len,
 		queued_len = len;
 	}
 
-	conn->send_data_total += queued_len;
+	ret = tcp_queue_commit(conn, queued_len);
+out:
+	k_mutex_unlock(&conn->lock);
 
-	/* Successfully queued data for transmission. Even if there's a transmit
-	 * failure now (out-of-buf case), it can be ignored for now, retransmit
-	 * timer will take care of queued data retransmission.
+	return ret;
+}
+
+#if defined(CONFIG_NET_TCP_QUEUE_FILL)
+int net_tcp_queue_fill(struct net_context *context, size_t len,
+		       net_tcp_fill_cb_t cb, void *user_data)
+{
+	struct tcp *conn = context->tcp;
+	struct net_pkt stage;
+	int ret;
+
+	if (!conn || conn->state != TCP_ESTABLISHED) {
+		return -ENOTCONN;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (tcp_window_full(conn)) {
+		k_mutex_unlock(&conn->lock);
+		return -EAGAIN;
+	}
+
+	len = MIN(conn->send_win - conn->send_data_total, len);
+
+	k_mutex_unlock(&conn->lock);
+
+	/* The data source may block, e.g. on a file system read, so the data
+	 * is staged in buffers of its own without holding the connection
+	 * lock. The buffers are then queued as they are, without a copy.
 	 */
-	ret = tcp_send_queued_data(conn);
-	if (ret < 0 && ret != -ENOBUFS) {
-		tcp_conn_close(conn, ret);
+	net_pkt_tx_init(&stage);
+
+	ret = tcp_pkt_append_fill(&stage, len, cb, user_data);
+	if (ret <= 0) {
 		goto out;
 	}
 
-	if (tcp_window_full(conn)) {
-		(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	/* The connection might have been closed meanwhile. If the window
+	 * shrank instead, the data waits in the queue for it to open again.
+	 */
+	if (conn->state != TCP_ESTABLISHED) {
+		k_mutex_unlock(&conn->lock);
+		ret = -ENOTCONN;
+		goto out;
 	}
 
-	ret = queued_len;
-out:
+	net_pkt_append_buffer(&conn->send_data, stage.buffer);
+	stage.buffer = NULL;
+
+	ret = tcp_queue_commit(conn, ret);
+
 	k_mutex_unlock(&conn->lock);
+out:
+	if (stage.buffer != NULL) {
+		net_pkt_frag_unref(stage.buffer);
+	}
 
 	return ret;
 }
+#endif /* CONFIG_NET_TCP_QUEUE_FILL */
 
 /* net context is about to send out queued data - inform caller only */
 int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
@@ -4217,6 +4411,13 @@ int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 
 	tcp_hdr->chksum = 0U;
 
+	/* The checksum of a super-segment is calculated per segment when it
+	 * is split, so there is no need to calculate it here.
+	 */
+	if (net_pkt_gso_size(pkt) > 0 && !force_chksum) {
+		return net_pkt_set_data(pkt, &tcp_access);
+	}
+
 	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt), type) || force_chksum) {
 		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
 		net_pkt_set_chksum_done(pkt, true);
@@ -4225,6 +4426,178 @@ int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 	return net_pkt_set_data(pkt, &tcp_access);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+/* Copy part of a payload buffer that cannot be moved as a whole. */
+static int tcp_gso_copy_payload(struct net_pkt *seg, const uint8_t *data,
+				size_t len)
+{
+	while (len > 0) {
+		struct net_buf *frag;
+		size_t chunk;
+
+		frag = net_pkt_get_frag(seg, len, TCP_PKT_ALLOC_TIMEOUT);
+		if (frag == NULL) {
+			return -ENOBUFS;
+		}
+
+		chunk = MIN(len, net_buf_tailroom(frag));
+		net_buf_add_mem(frag, data, chunk);
+		net_pkt_frag_add(seg, frag);
+
+		data += chunk;
+		len -= chunk;
+	}
+
+	return 0;
+}
+
+int net_tcp_gso_segment(struct net_pkt *pkt, net_tcp_gso_cb_t cb,
+			void *user_data)
+{
+	size_t ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	uint16_t mss = net_pkt_gso_size(pkt);
+	size_t hdr_len, payload_len, offset, off;
+	struct net_buf *buf, *prev = NULL;
+	struct net_pkt *seg;
+	struct tcphdr *th;
+	uint32_t seq_nbr;
+	uint8_t flags;
+	int ret = 0;
+
+	if (mss == 0U) {
+		return -EINVAL;
+	}
+
+	th = th_get(pkt);
+	if (th == NULL) {
+		return -EINVAL;
+	}
+
+	hdr_len = ip_len + th_off(th) * 4U;
+	seq_nbr = th_seq(th);
+	flags = th_flags(th);
+
+	if (net_pkt_get_len(pkt) <= hdr_len) {
+		return -EINVAL;
+	}
+
+	payload_len = net_pkt_get_len(pkt) - hdr_len;
+
+	/* Find the buffer holding the first payload byte */
+	buf = pkt->buffer;
+	off = hdr_len;
+
+	while (buf != NULL && off >= buf->len) {
+		off -= buf->len;
+		prev = buf;
+		buf = buf->frags;
+	}
+
+	for (offset = 0; offset < payload_len; offset += mss) {
+		size_t seg_len = MIN(mss, payload_len - offset);
+		size_t left = seg_len;
+
+		seg = net_pkt_alloc_with_buffer(net_pkt_iface(pkt), hdr_len,
+						NET_AF_UNSPEC, 0,
+						TCP_PKT_ALLOC_TIMEOUT);
+		if (seg == NULL) {
+			ret = -ENOBUFS;
+			break;
+		}
+
+		net_pkt_copy_attributes(pkt, seg);
+		net_pkt_set_gso_size(seg, 0U);
+
+		net_pkt_set_overwrite(pkt, true);
+		net_pkt_cursor_init(pkt);
+
+		if (net_pkt_copy(seg, pkt, hdr_len) < 0) {
+			net_pkt_unref(seg);
+			ret = -ENOBUFS;
+			break;
+		}
+
+		/* Payload buffers that fall entirely within this segment are
+		 * unlinked from the super-segment and handed over as they
+		 * are, only the pieces straddling a segment boundary (or
+		 * sharing a buffer with the headers) are copied.
+		 */
+		while (left > 0 && buf != NULL) {
+			struct net_buf *next = buf->frags;
+			size_t chunk;
+
+			if (off == 0U && prev != NULL && buf->len <= left &&
+			    buf->ref == 1U) {
+				prev->frags = next;
+				buf->frags = NULL;
+
+				left -= buf->len;
+				net_pkt_frag_add(seg, buf);
+				buf = next;
+				continue;
+			}
+
+			chunk = MIN(buf->len - off, left);
+
+			ret = tcp_gso_copy_payload(seg, buf->data + off, chunk);
+			if (ret < 0) {
+				break;
+			}
+
+			off += chunk;
+			left -= chunk;
+
+			if (off == buf->len) {
+				prev = buf;
+				buf = next;
+				off = 0U;
+			}
+		}
+
+		if (ret < 0 || left > 0) {
+			net_pkt_unref(seg);
+			ret = -ENOBUFS;
+			break;
+		}
+
+		th = th_get(seg);
+		if (th == NULL) {
+			net_pkt_unref(seg);
+			ret = -ENOBUFS;
+			break;
+		}
+
+		UNALIGNED_PUT(net_htonl(seq_nbr + offset),
+			      UNALIGNED_MEMBER_ADDR(th, th_seq));
+
+		/* PSH and FIN belong to the last segment only */
+		if (offset + seg_len < payload_len) {
+			UNALIGNED_PUT(flags & ~(PSH | FIN), &th->th_flags);
+		}
+
+		ret = tcp_finalize_pkt(seg);
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			break;
+		}
+
+		net_pkt_cursor_init(seg);
+
+		ret = cb(seg, user_data);
+
+		net_pkt_unref(seg);
+
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 				  struct net_pkt_data_access *tcp_access)
 {
@@ -278,6 +278,50 @@ static inline int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 }
 #endif
 
+/**
+ * @typedef net_tcp_gso_cb_t
+ * @brief Callback used to send a segment of a TCP super-segment
+ *
+ * @param seg Segment to send. The callee must take a reference if it needs
+ *        to keep the packet after returning.
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+typedef int (*net_tcp_gso_cb_t)(struct net_pkt *seg, void *user_data);
+
+/**
+ * @brief Split a TCP super-segment into MSS sized segments
+ *
+ * The packet must start with the IP header and have its GSO size set.
+ * Each segment gets a copy of the IP and TCP headers with the sequence
+ * number, flags, lengths and checksums updated, and is passed to the
+ * callback one at a time. Payload buffers that fit entirely in a
+ * segment are moved from @p pkt to the segment instead of being copied,
+ * so @p pkt must not be transmitted again afterwards.
+ *
+ * @param pkt TCP super-segment
+ * @param cb Callback called for each segment
+ * @param user_data User data passed to the callback
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+#if defined(CONFIG_NET_TCP_GSO)
+int net_tcp_gso_segment(struct net_pkt *pkt, net_tcp_gso_cb_t cb,
+			void *user_data);
+#else
+static inline int net_tcp_gso_segment(struct net_pkt *pkt,
+				      net_tcp_gso_cb_t cb,
+				      void *user_data)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
 /**
  * @brief Return struct net_tcp_hdr pointer
  *
@@ -327,6 +371,48 @@ static inline int net_tcp_queue(struct net_context *context, const void *data,
 }
 #endif
 
+/**
+ * @brief Callback that writes data to be sent directly into TCP buffers
+ *
+ * @param dst Where to write the data
+ * @param len Maximum number of bytes to write
+ * @param user_data User data given to net_tcp_queue_fill()
+ *
+ * @return Number of bytes written, less than @p len if the source has no
+ *         more data, or < 0 on error.
+ */
+typedef int (*net_tcp_fill_cb_t)(void *dst, size_t len, void *user_data);
+
+/**
+ * @brief Enqueue data for transmission, produced by a callback
+ *
+ * Works like net_tcp_queue() except that the data is not copied from a
+ * caller buffer, instead @p cb writes it straight into the send buffers.
+ * @p cb is called without the connection lock held, so it may block.
+ *
+ * @param context	Network context
+ * @param len		Maximum number of bytes to queue
+ * @param cb		Callback producing the data
+ * @param user_data	User data passed to @p cb
+ *
+ * @return Number of bytes queued, 0 if @p cb had no data, < 0 if error
+ */
+#if defined(CONFIG_NET_TCP_QUEUE_FILL)
+int net_tcp_queue_fill(struct net_context *context, size_t len,
+		       net_tcp_fill_cb_t cb, void *user_data);
+#else
+static inline int net_tcp_queue_fill(struct net_context *context, size_t len,
+				     net_tcp_fill_cb_t cb, void *user_data)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(len);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
 /**
  * @brief Update TCP receive window
  *
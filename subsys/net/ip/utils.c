@@ -569,6 +569,50 @@ static uint16_t offset_based_swap8(const uint8_t *data)
 	}
 }
 
+#if defined(CONFIG_64BIT)
+/* Sum 64-bit words on CPUs that have them, halving the number of loads and
+ * adds compared to the 32-bit loop. The accumulator can overflow, so the
+ * carries are counted separately and added back when folding the sum, which
+ * is correct as 2^64 is congruent to 1 modulo 0xffff.
+ */
+static uint64_t chksum_words64(uint64_t sum, const uint8_t **data, size_t *pending)
+{
+	const uint64_t *p = (const uint64_t *)*data;
+	uint64_t carry = 0;
+
+	while (*pending >= sizeof(uint64_t) * 4) {
+		uint64_t w0 = p[0];
+		uint64_t w1 = p[1];
+		uint64_t w2 = p[2];
+		uint64_t w3 = p[3];
+
+		sum += w0;
+		carry += (sum < w0);
+		sum += w1;
+		carry += (sum < w1);
+		sum += w2;
+		carry += (sum < w2);
+		sum += w3;
+		carry += (sum < w3);
+
+		p += 4;
+		*pending -= sizeof(uint64_t) * 4;
+	}
+
+	while (*pending >= sizeof(uint64_t)) {
+		sum += *p;
+		carry += (sum < *p);
+
+		p++;
+		*pending -= sizeof(uint64_t);
+	}
+
+	*data = (const uint8_t *)p;
+
+	return (sum & 0xffffffff) + (sum >> 32) + carry;
+}
+#endif /* CONFIG_64BIT */
+
 /* Word based checksum calculation based on:
  * https://blogs.igalia.com/dpino/2018/06/14/fast-checksum-computation/
  * It’s not necessary to add octets as 16-bit words. Due to the associative property of addition,
@@ -604,6 +648,17 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 		sum = sum + *((uint16_t *)data);
 		data += sizeof(uint16_t);
 	}
+
+#if defined(CONFIG_64BIT)
+	if ((((uintptr_t)data & 0x04) != 0) && (pending >= sizeof(uint32_t))) {
+		pending -= sizeof(uint32_t);
+		sum = sum + *((uint32_t *)data);
+		data += sizeof(uint32_t);
+	}
+
+	sum = chksum_words64(sum, &data, &pending);
+#endif /* CONFIG_64BIT */
+
 	p = (uint32_t *)data;
 
 	/* Do loop unrolling for the very large data sets */
@@ -33,6 +33,10 @@ LOG_MODULE_REGISTER(net_ethernet, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
 #include "ipv6.h"
 #include "ipv4.h"
 
+#if defined(CONFIG_NET_TCP_GSO)
+#include "tcp_internal.h"
+#endif
+
 #define NET_BUF_TIMEOUT K_MSEC(100)
 
 static const struct net_eth_addr multicast_eth_addr __unused = {
@@ -679,6 +683,69 @@ static void ethernet_update_tx_stats(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+struct ethernet_gso_ctx {
+	struct ethernet_context *ctx;
+	struct net_if *iface;
+	const struct ethernet_api *api;
+	uint16_t ptype;
+	int sent;
+};
+
+static int ethernet_send_segment(struct net_pkt *seg, void *user_data)
+{
+	struct ethernet_gso_ctx *gso = user_data;
+	int ret;
+
+	if (!ethernet_fill_header(gso->ctx, gso->iface, seg, gso->ptype)) {
+		return -ENOMEM;
+	}
+
+	net_pkt_cursor_init(seg);
+
+	ret = net_l2_send(gso->api->send, net_if_get_device(gso->iface),
+			  gso->iface, seg);
+	if (ret != 0) {
+		eth_stats_update_errors_tx(gso->iface);
+		return ret;
+	}
+
+	ethernet_update_tx_stats(gso->iface, seg);
+	gso->sent += net_pkt_get_len(seg);
+
+	return 0;
+}
+
+/* Split a TCP super-segment into MSS sized frames for drivers that
+ * cannot do the segmentation themselves.
+ */
+static int ethernet_send_gso(struct ethernet_context *ctx,
+			     struct net_if *iface,
+			     const struct ethernet_api *api,
+			     struct net_pkt *pkt, uint16_t ptype)
+{
+	struct ethernet_gso_ctx gso = {
+		.ctx = ctx,
+		.iface = iface,
+		.api = api,
+		.ptype = ptype,
+	};
+	int ret;
+
+	ret = net_tcp_gso_segment(pkt, ethernet_send_segment, &gso);
+	if (ret < 0 && gso.sent == 0) {
+		return ret;
+	}
+
+	/* If only part of the segments could be sent, TCP retransmission
+	 * will take care of the rest.
+	 */
+	net_pkt_unref(pkt);
+
+	return gso.sent;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 {
 	const struct ethernet_api *api = net_if_get_device(iface)->api;
@@ -764,6 +831,14 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 				       sizeof(struct net_eth_addr));
 	}
 
+#if defined(CONFIG_NET_TCP_GSO)
+	if (net_pkt_gso_size(pkt) > 0 &&
+	    !(net_eth_get_hw_capabilities(iface) & ETHERNET_HW_TSO)) {
+		ret = ethernet_send_gso(ctx, iface, api, pkt, ptype);
+		goto error;
+	}
+#endif
+
 	/* Then set the ethernet header. Note that the iface parameter tells
 	 * where we are actually sending the packet. The interface in net_pkt
 	 * is used to determine if the VLAN header is added to Ethernet frame.
@@ -1084,6 +1159,11 @@ void ethernet_init(struct net_if *iface)
 
 	ctx->ethernet_l2_flags = NET_L2_MULTICAST;
 	ctx->iface = iface;
+
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO)) {
+		ctx->ethernet_l2_flags |= NET_L2_GSO;
+	}
+
 	k_work_init(&ctx->carrier_work, carrier_on_off);
 
 	if (net_eth_get_hw_capabilities(iface) & ETHERNET_PROMISC_MODE) {
@@ -0,0 +1,70 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/net/ethernet_poll.h>
+
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define THREAD_PRIORITY K_PRIO_COOP(CONFIG_NET_L2_ETHERNET_POLL_PRIO)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NET_L2_ETHERNET_POLL_PRIO)
+#endif
+
+static struct k_work_q eth_poll_work_q;
+K_KERNEL_STACK_DEFINE(eth_poll_stack, CONFIG_NET_L2_ETHERNET_POLL_STACK_SIZE);
+
+static void eth_poll_handler(struct k_work *work)
+{
+	struct net_eth_poll *poll = CONTAINER_OF(work, struct net_eth_poll, work);
+	int done;
+
+	done = poll->poll_cb(poll, CONFIG_NET_L2_ETHERNET_POLL_BUDGET);
+
+	/* If the budget was used up there are probably more frames waiting.
+	 * Resubmit instead of looping here so that the other devices get
+	 * their turn.
+	 */
+	if (done >= CONFIG_NET_L2_ETHERNET_POLL_BUDGET || poll->rearm_cb(poll)) {
+		(void)k_work_submit_to_queue(&eth_poll_work_q, work);
+	}
+}
+
+void net_eth_poll_init(struct net_eth_poll *poll,
+		       net_eth_poll_cb_t poll_cb,
+		       net_eth_poll_rearm_cb_t rearm_cb)
+{
+	__ASSERT_NO_MSG(poll_cb != NULL && rearm_cb != NULL);
+
+	k_work_init(&poll->work, eth_poll_handler);
+	poll->poll_cb = poll_cb;
+	poll->rearm_cb = rearm_cb;
+}
+
+void net_eth_poll_schedule(struct net_eth_poll *poll)
+{
+	(void)k_work_submit_to_queue(&eth_poll_work_q, &poll->work);
+}
+
+static int eth_poll_work_q_init(void)
+{
+	struct k_work_queue_config q_cfg = {
+		.name = "eth_poll",
+		.no_yield = false,
+	};
+
+	/* Started before the Ethernet drivers so that they can schedule
+	 * polls as soon as their interrupts are enabled.
+	 */
+	k_work_queue_init(&eth_poll_work_q);
+	k_work_queue_start(&eth_poll_work_q, eth_poll_stack,
+			   K_KERNEL_STACK_SIZEOF(eth_poll_stack), THREAD_PRIORITY,
+			   &q_cfg);
+
+	return 0;
+}
+
+SYS_INIT(eth_poll_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -84,6 +84,18 @@ struct net_capture {
 	 */
 	struct net_sockaddr local;
 
+#if defined(CONFIG_NET_CAPTURE_FILTER)
+	/**
+	 * Packet filter, NULL if all the packets are captured.
+	 */
+	const struct net_capture_bpf_insn *filter;
+
+	/**
+	 * Number of instructions in the filter.
+	 */
+	size_t filter_len;
+#endif
+
 	/**
 	 * Is this context setup already
 	 */
@@ -457,6 +469,11 @@ static int capture_cleanup(const struct device *dev)
 
 	(void)cleanup_iface(ctx->tunnel_iface, &ctx->local);
 
+#if defined(CONFIG_NET_CAPTURE_FILTER)
+	ctx->filter = NULL;
+	ctx->filter_len = 0;
+#endif
+
 	ctx->tunnel_iface = NULL;
 	ctx->in_use = false;
 
@@ -510,12 +527,115 @@ static int capture_disable(const struct device *dev)
 	return 0;
 }
 
-int net_capture_pkt_with_status(struct net_if *iface, struct net_pkt *pkt)
+#if defined(CONFIG_NET_CAPTURE_FILTER)
+int net_capture_set_filter(const struct device *dev,
+			   const struct net_capture_bpf_insn *prog, size_t len)
+{
+	struct net_capture *ctx = dev->data;
+	int ret;
+
+	if (prog != NULL) {
+		ret = net_capture_bpf_check(prog, len);
+		if (ret < 0) {
+			NET_DBG("Invalid filter (%d)", ret);
+			return ret;
+		}
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	ctx->filter = prog;
+	ctx->filter_len = prog != NULL ? len : 0;
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+/* Returns how many bytes of the packet to capture, 0 to skip it */
+static size_t capture_filter(struct net_capture *ctx, struct net_pkt *pkt)
+{
+	size_t len = net_pkt_get_len(pkt);
+
+	if (ctx->filter == NULL) {
+		return len;
+	}
+
+	return MIN(len, net_capture_bpf_run(ctx->filter, ctx->filter_len, pkt));
+}
+#else
+static inline size_t capture_filter(struct net_capture *ctx, struct net_pkt *pkt)
+{
+	ARG_UNUSED(ctx);
+
+	return net_pkt_get_len(pkt);
+}
+#endif /* CONFIG_NET_CAPTURE_FILTER */
+
+static struct net_pkt *capture_clone(struct net_capture *ctx, struct net_pkt *pkt,
+				     size_t snaplen)
 {
 	struct k_mem_slab *orig_slab;
+	struct net_pkt_cursor backup;
+	struct net_pkt *captured;
+	bool overwrite;
+	int ret;
+
+	if (snaplen >= net_pkt_get_len(pkt)) {
+		orig_slab = pkt->slab;
+		pkt->slab = get_net_pkt();
+
+		captured = net_pkt_clone(pkt, K_NO_WAIT);
+
+		pkt->slab = orig_slab;
+
+		return captured;
+	}
+
+	/* Copy only the snap length, the tunnel does not need the
+	 * packet metadata that net_pkt_clone() would copy.
+	 */
+	captured = net_pkt_alloc_from_slab(get_net_pkt(), K_NO_WAIT);
+	if (captured == NULL) {
+		return NULL;
+	}
+
+	net_pkt_set_context(captured, ctx->context);
+
+	ret = net_pkt_alloc_buffer_raw(captured, snaplen, K_NO_WAIT);
+	if (ret < 0) {
+		net_pkt_unref(captured);
+		return NULL;
+	}
+
+	overwrite = net_pkt_is_being_overwritten(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	net_pkt_cursor_init(captured);
+
+	ret = net_pkt_copy(captured, pkt, snaplen);
+
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	if (ret < 0) {
+		net_pkt_unref(captured);
+		return NULL;
+	}
+
+	net_pkt_set_family(captured, net_pkt_family(pkt));
+	net_pkt_cursor_init(captured);
+
+	return captured;
+}
+
+int net_capture_pkt_with_status(struct net_if *iface, struct net_pkt *pkt)
+{
 	struct net_pkt *captured;
 	sys_snode_t *sn, *sns;
 	bool skip_clone = false;
+	size_t snaplen;
 	int ret = -ENOENT;
 
 	/* We must prevent to capture network packet that is already captured
@@ -525,6 +645,8 @@ int net_capture_pkt_with_status(struct net_if *iface, struct net_pkt *pkt)
 		return -EALREADY;
 	}
 
+	net_capture_ring_pkt(iface, pkt);
+
 	k_mutex_lock(&lock, K_FOREVER);
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&net_capture_devlist, sn, sns) {
@@ -536,6 +658,14 @@ int net_capture_pkt_with_status(struct net_if *iface, struct net_pkt *pkt)
 			continue;
 		}
 
+		/* Filtered out packets cost no copy, another capture
+		 * device might still want them.
+		 */
+		snaplen = capture_filter(ctx, pkt);
+		if (snaplen == 0) {
+			continue;
+		}
+
 		/* If the packet is marked as "cooked", then it means that the
 		 * packet was directed here by "any" interface and was already
 		 * cooked mode captured. So no need to clone it here.
@@ -547,13 +677,7 @@ int net_capture_pkt_with_status(struct net_if *iface, struct net_pkt *pkt)
 		if (skip_clone) {
 			captured = pkt;
 		} else {
-			orig_slab = pkt->slab;
-			pkt->slab = get_net_pkt();
-
-			captured = net_pkt_clone(pkt, K_NO_WAIT);
-
-			pkt->slab = orig_slab;
-
+			captured = capture_clone(ctx, pkt, snaplen);
 			if (captured == NULL) {
 				NET_DBG("Captured pkt %s", "dropped");
 				net_stats_update_processing_error(ctx->tunnel_iface);
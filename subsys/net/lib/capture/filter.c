@@ -0,0 +1,394 @@
+/** @file
+ * @brief Classic BPF packet filter for network packet capture.
+ *
+ * The filter runs over the packet buffers in place, so that packets that
+ * are not wanted are rejected before anything is copied.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_capture, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/capture.h>
+
+/* Same limit as in Linux */
+#define BPF_MAX_INSNS 4096
+
+static bool bpf_load_check(uint16_t code)
+{
+	switch (NET_BPF_MODE(code)) {
+	case NET_BPF_ABS:
+	case NET_BPF_IND:
+		return NET_BPF_SIZE(code) != 0x18;
+	case NET_BPF_IMM:
+	case NET_BPF_MEM:
+	case NET_BPF_LEN:
+		return NET_BPF_SIZE(code) == NET_BPF_W;
+	default:
+		return false;
+	}
+}
+
+int net_capture_bpf_check(const struct net_capture_bpf_insn *prog, size_t len)
+{
+	if (prog == NULL || len == 0 || len > BPF_MAX_INSNS) {
+		return -EINVAL;
+	}
+
+	for (size_t pc = 0; pc < len; pc++) {
+		const struct net_capture_bpf_insn *insn = &prog[pc];
+		uint16_t code = insn->code;
+
+		switch (NET_BPF_CLASS(code)) {
+		case NET_BPF_LD:
+			if (!bpf_load_check(code)) {
+				return -EINVAL;
+			}
+
+			if (NET_BPF_MODE(code) == NET_BPF_MEM && insn->k >= NET_BPF_MEMWORDS) {
+				return -EINVAL;
+			}
+
+			break;
+
+		case NET_BPF_LDX:
+			if (code == (NET_BPF_LDX | NET_BPF_B | NET_BPF_MSH)) {
+				break;
+			}
+
+			if (NET_BPF_SIZE(code) != NET_BPF_W) {
+				return -EINVAL;
+			}
+
+			if (NET_BPF_MODE(code) == NET_BPF_MEM) {
+				if (insn->k >= NET_BPF_MEMWORDS) {
+					return -EINVAL;
+				}
+			} else if (NET_BPF_MODE(code) != NET_BPF_IMM &&
+				   NET_BPF_MODE(code) != NET_BPF_LEN) {
+				return -EINVAL;
+			}
+
+			break;
+
+		case NET_BPF_ST:
+		case NET_BPF_STX:
+			if (insn->k >= NET_BPF_MEMWORDS) {
+				return -EINVAL;
+			}
+
+			break;
+
+		case NET_BPF_ALU:
+			switch (NET_BPF_OP(code)) {
+			case NET_BPF_DIV:
+			case NET_BPF_MOD:
+				if (NET_BPF_SRC(code) == NET_BPF_K && insn->k == 0U) {
+					return -EINVAL;
+				}
+
+				break;
+			case NET_BPF_ADD:
+			case NET_BPF_SUB:
+			case NET_BPF_MUL:
+			case NET_BPF_OR:
+			case NET_BPF_AND:
+			case NET_BPF_LSH:
+			case NET_BPF_RSH:
+			case NET_BPF_NEG:
+			case NET_BPF_XOR:
+				break;
+			default:
+				return -EINVAL;
+			}
+
+			break;
+
+		case NET_BPF_JMP:
+			/* Jumps are forward only, so the program always ends */
+			if (NET_BPF_OP(code) == NET_BPF_JA) {
+				if (insn->k >= len - pc - 1) {
+					return -EINVAL;
+				}
+
+				break;
+			}
+
+			if (NET_BPF_OP(code) != NET_BPF_JEQ && NET_BPF_OP(code) != NET_BPF_JGT &&
+			    NET_BPF_OP(code) != NET_BPF_JGE && NET_BPF_OP(code) != NET_BPF_JSET) {
+				return -EINVAL;
+			}
+
+			if (insn->jt >= len - pc - 1 || insn->jf >= len - pc - 1) {
+				return -EINVAL;
+			}
+
+			break;
+
+		case NET_BPF_RET:
+			if (NET_BPF_RVAL(code) != NET_BPF_K && NET_BPF_RVAL(code) != NET_BPF_A) {
+				return -EINVAL;
+			}
+
+			break;
+
+		case NET_BPF_MISC:
+			if (NET_BPF_MISCOP(code) != NET_BPF_TAX &&
+			    NET_BPF_MISCOP(code) != NET_BPF_TXA) {
+				return -EINVAL;
+			}
+
+			break;
+		}
+	}
+
+	if (NET_BPF_CLASS(prog[len - 1].code) != NET_BPF_RET) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Get a pointer to len bytes of packet data at offset. The data is read
+ * from the buffers directly unless it spans several of them, in which
+ * case it is gathered into tmp.
+ */
+static const uint8_t *bpf_pkt_data(struct net_pkt *pkt, uint32_t offset,
+				   uint32_t len, uint8_t *tmp)
+{
+	struct net_buf *buf = pkt->buffer;
+	uint32_t copied = 0U;
+
+	while (buf != NULL && offset >= buf->len) {
+		offset -= buf->len;
+		buf = buf->frags;
+	}
+
+	if (buf == NULL) {
+		return NULL;
+	}
+
+	if (offset + len <= buf->len) {
+		return buf->data + offset;
+	}
+
+	while (buf != NULL && copied < len) {
+		uint32_t count = MIN(len - copied, buf->len - offset);
+
+		memcpy(tmp + copied, buf->data + offset, count);
+		copied += count;
+		offset = 0U;
+		buf = buf->frags;
+	}
+
+	return copied == len ? tmp : NULL;
+}
+
+static bool bpf_load(struct net_pkt *pkt, uint16_t code, uint32_t offset, uint32_t *val)
+{
+	uint8_t tmp[sizeof(uint32_t)];
+	const uint8_t *ptr;
+
+	if (offset > UINT32_MAX - sizeof(uint32_t)) {
+		return false;
+	}
+
+	switch (NET_BPF_SIZE(code)) {
+	case NET_BPF_W:
+		ptr = bpf_pkt_data(pkt, offset, sizeof(uint32_t), tmp);
+		if (ptr == NULL) {
+			return false;
+		}
+
+		*val = sys_get_be32(ptr);
+		break;
+	case NET_BPF_H:
+		ptr = bpf_pkt_data(pkt, offset, sizeof(uint16_t), tmp);
+		if (ptr == NULL) {
+			return false;
+		}
+
+		*val = sys_get_be16(ptr);
+		break;
+	default:
+		ptr = bpf_pkt_data(pkt, offset, sizeof(uint8_t), tmp);
+		if (ptr == NULL) {
+			return false;
+		}
+
+		*val = *ptr;
+		break;
+	}
+
+	return true;
+}
+
+static uint32_t bpf_alu(uint16_t code, uint32_t a, uint32_t operand)
+{
+	switch (NET_BPF_OP(code)) {
+	case NET_BPF_ADD:
+		return a + operand;
+	case NET_BPF_SUB:
+		return a - operand;
+	case NET_BPF_MUL:
+		return a * operand;
+	case NET_BPF_DIV:
+		return a / operand;
+	case NET_BPF_MOD:
+		return a % operand;
+	case NET_BPF_OR:
+		return a | operand;
+	case NET_BPF_AND:
+		return a & operand;
+	case NET_BPF_LSH:
+		return operand < 32U ? a << operand : 0U;
+	case NET_BPF_RSH:
+		return operand < 32U ? a >> operand : 0U;
+	case NET_BPF_NEG:
+		return -a;
+	case NET_BPF_XOR:
+		return a ^ operand;
+	default:
+		CODE_UNREACHABLE;
+	}
+}
+
+static bool bpf_jump_taken(uint16_t code, uint32_t a, uint32_t operand)
+{
+	switch (NET_BPF_OP(code)) {
+	case NET_BPF_JEQ:
+		return a == operand;
+	case NET_BPF_JGT:
+		return a > operand;
+	case NET_BPF_JGE:
+		return a >= operand;
+	case NET_BPF_JSET:
+		return (a & operand) != 0U;
+	default:
+		CODE_UNREACHABLE;
+	}
+}
+
+uint32_t net_capture_bpf_run(const struct net_capture_bpf_insn *prog, size_t len,
+			     struct net_pkt *pkt)
+{
+	uint32_t mem[NET_BPF_MEMWORDS] = { 0 };
+	uint32_t pkt_len = net_pkt_get_len(pkt);
+	uint32_t a = 0U;
+	uint32_t x = 0U;
+	uint32_t val;
+
+	for (size_t pc = 0; pc < len; pc++) {
+		const struct net_capture_bpf_insn *insn = &prog[pc];
+		uint16_t code = insn->code;
+
+		switch (NET_BPF_CLASS(code)) {
+		case NET_BPF_LD:
+			switch (NET_BPF_MODE(code)) {
+			case NET_BPF_ABS:
+			case NET_BPF_IND:
+				val = insn->k;
+				if (NET_BPF_MODE(code) == NET_BPF_IND) {
+					val += x;
+					if (val < x) {
+						return 0U;
+					}
+				}
+
+				/* Out of bounds load rejects the packet */
+				if (!bpf_load(pkt, code, val, &a)) {
+					return 0U;
+				}
+
+				break;
+			case NET_BPF_IMM:
+				a = insn->k;
+				break;
+			case NET_BPF_MEM:
+				a = mem[insn->k];
+				break;
+			default:
+				a = pkt_len;
+				break;
+			}
+
+			break;
+
+		case NET_BPF_LDX:
+			switch (NET_BPF_MODE(code)) {
+			case NET_BPF_MSH:
+				/* IPv4 header length */
+				if (!bpf_load(pkt, NET_BPF_B, insn->k, &val)) {
+					return 0U;
+				}
+
+				x = (val & 0x0f) << 2;
+				break;
+			case NET_BPF_IMM:
+				x = insn->k;
+				break;
+			case NET_BPF_MEM:
+				x = mem[insn->k];
+				break;
+			default:
+				x = pkt_len;
+				break;
+			}
+
+			break;
+
+		case NET_BPF_ST:
+			mem[insn->k] = a;
+			break;
+
+		case NET_BPF_STX:
+			mem[insn->k] = x;
+			break;
+
+		case NET_BPF_ALU:
+			val = NET_BPF_SRC(code) == NET_BPF_X ? x : insn->k;
+
+			if ((NET_BPF_OP(code) == NET_BPF_DIV || NET_BPF_OP(code) == NET_BPF_MOD) &&
+			    val == 0U) {
+				return 0U;
+			}
+
+			a = bpf_alu(code, a, val);
+			break;
+
+		case NET_BPF_JMP:
+			if (NET_BPF_OP(code) == NET_BPF_JA) {
+				pc += insn->k;
+				break;
+			}
+
+			val = NET_BPF_SRC(code) == NET_BPF_X ? x : insn->k;
+			pc += bpf_jump_taken(code, a, val) ? insn->jt : insn->jf;
+			break;
+
+		case NET_BPF_RET:
+			return NET_BPF_RVAL(code) == NET_BPF_A ? a : insn->k;
+
+		case NET_BPF_MISC:
+			if (NET_BPF_MISCOP(code) == NET_BPF_TAX) {
+				x = a;
+			} else {
+				a = x;
+			}
+
+			break;
+		}
+	}
+
+	/* Not reached with a checked program */
+	return 0U;
+}
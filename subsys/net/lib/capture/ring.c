@@ -0,0 +1,274 @@
+/** @file
+ * @brief pcap ring buffer for network packet capture.
+ *
+ * The captured packets are copied from their buffers straight into a
+ * ring buffer as pcap records, truncated to the snap length. Nothing is
+ * allocated nor sent per packet, the application reads the records in
+ * place from the ring.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_capture, CONFIG_NET_CAPTURE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/capture.h>
+
+#define PCAP_MAGIC         0xa1b2c3d4
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+
+#define LINKTYPE_ETHERNET           1
+#define LINKTYPE_RAW                101
+#define LINKTYPE_IEEE802_15_4_NOFCS 230
+
+RING_BUF_DECLARE(capture_ring, CONFIG_NET_CAPTURE_RING_SIZE);
+
+static struct k_spinlock ring_lock;
+
+static struct {
+	struct net_if *iface;
+	const struct net_capture_bpf_insn *filter;
+	size_t filter_len;
+	uint32_t snaplen;
+	uint32_t linktype;
+	uint32_t dropped;
+	/* Bumped on each start, so that packets filtered while the capture
+	 * was restarted are not stored.
+	 */
+	uint32_t generation;
+	/* Number of filter runs in progress, outside of the lock */
+	uint32_t filter_users;
+} ring_ctx;
+
+/* The captured packets are stored as they are at the capture point, which
+ * depends on the L2. Interfaces whose packets do not have a single pcap
+ * link type cannot be captured.
+ */
+static int ring_linktype(struct net_if *iface)
+{
+	const struct net_l2 *l2 = net_if_l2(iface);
+
+	if (IS_ENABLED(CONFIG_NET_L2_ETHERNET) && l2 == &NET_L2_GET_NAME(ETHERNET)) {
+		return LINKTYPE_ETHERNET;
+	}
+
+	/* Raw 802.15.4 frames, the radio drivers strip their FCS */
+	if (IS_ENABLED(CONFIG_NET_L2_IEEE802154) && l2 == &NET_L2_GET_NAME(IEEE802154)) {
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	}
+
+	/* Bare IP packets, e.g. from the loopback interface */
+	if (IS_ENABLED(CONFIG_NET_L2_DUMMY) && l2 == &NET_L2_GET_NAME(DUMMY)) {
+		return LINKTYPE_RAW;
+	}
+
+	return -ENOTSUP;
+}
+
+int net_capture_ring_start(struct net_if *iface,
+			   const struct net_capture_bpf_insn *prog, size_t len,
+			   uint32_t snaplen)
+{
+	k_spinlock_key_t key;
+	int linktype;
+	int ret = 0;
+
+	if (iface == NULL || snaplen == 0U) {
+		return -EINVAL;
+	}
+
+	linktype = ring_linktype(iface);
+	if (linktype < 0) {
+		NET_DBG("Unsupported L2 of interface %d", net_if_get_by_iface(iface));
+		return linktype;
+	}
+
+	if (prog != NULL) {
+		ret = net_capture_bpf_check(prog, len);
+		if (ret < 0) {
+			NET_DBG("Invalid filter (%d)", ret);
+			return ret;
+		}
+	}
+
+	key = k_spin_lock(&ring_lock);
+
+	if (ring_ctx.iface != NULL) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	ring_ctx.filter = prog;
+	ring_ctx.filter_len = len;
+	ring_ctx.snaplen = snaplen;
+	ring_ctx.linktype = linktype;
+	ring_ctx.dropped = 0U;
+	ring_ctx.generation++;
+	ring_ctx.iface = iface;
+
+out:
+	k_spin_unlock(&ring_lock, key);
+
+	return ret;
+}
+
+int net_capture_ring_stop(void)
+{
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&ring_lock);
+
+	if (ring_ctx.iface == NULL) {
+		ret = -EALREADY;
+	}
+
+	ring_ctx.iface = NULL;
+
+	/* The filter may be released once the capture is stopped, wait for
+	 * the packets still being filtered.
+	 */
+	while (ring_ctx.filter_users > 0U) {
+		k_spin_unlock(&ring_lock, key);
+		k_msleep(1);
+		key = k_spin_lock(&ring_lock);
+	}
+
+	ring_ctx.filter = NULL;
+
+	k_spin_unlock(&ring_lock, key);
+
+	return ret;
+}
+
+void net_capture_ring_pcap_header(struct net_capture_pcap_hdr *hdr)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ring_lock);
+	hdr->snaplen = ring_ctx.snaplen;
+	hdr->linktype = ring_ctx.linktype;
+	k_spin_unlock(&ring_lock, key);
+
+	hdr->magic = PCAP_MAGIC;
+	hdr->version_major = PCAP_VERSION_MAJOR;
+	hdr->version_minor = PCAP_VERSION_MINOR;
+	hdr->thiszone = 0;
+	hdr->sigfigs = 0U;
+}
+
+uint32_t net_capture_ring_get_claim(uint8_t **data, uint32_t size)
+{
+	return ring_buf_get_claim(&capture_ring, data, size);
+}
+
+int net_capture_ring_get_finish(uint32_t size)
+{
+	return ring_buf_get_finish(&capture_ring, size);
+}
+
+uint32_t net_capture_ring_dropped(void)
+{
+	k_spinlock_key_t key;
+	uint32_t dropped;
+
+	key = k_spin_lock(&ring_lock);
+	dropped = ring_ctx.dropped;
+	k_spin_unlock(&ring_lock, key);
+
+	return dropped;
+}
+
+void net_capture_ring_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	const struct net_capture_bpf_insn *filter;
+	struct net_capture_pcap_rec_hdr rec;
+	uint32_t pkt_len, remaining;
+	uint32_t generation;
+	k_spinlock_key_t key;
+	struct net_buf *buf;
+	size_t filter_len;
+	uint64_t now;
+
+	/* Cheap check without the lock for the common case of the interface
+	 * not being captured, everything is checked again under the lock.
+	 */
+	if (ring_ctx.iface != iface || net_pkt_is_captured(pkt)) {
+		return;
+	}
+
+	pkt_len = net_pkt_get_len(pkt);
+	now = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	key = k_spin_lock(&ring_lock);
+
+	/* The capture might have been stopped meanwhile */
+	if (ring_ctx.iface != iface) {
+		k_spin_unlock(&ring_lock, key);
+		return;
+	}
+
+	filter = ring_ctx.filter;
+	filter_len = ring_ctx.filter_len;
+	generation = ring_ctx.generation;
+	remaining = MIN(pkt_len, ring_ctx.snaplen);
+
+	if (filter != NULL) {
+		ring_ctx.filter_users++;
+	}
+
+	k_spin_unlock(&ring_lock, key);
+
+	/* The filter can be long, it is run without the lock and kept set
+	 * until it is done, see net_capture_ring_stop().
+	 */
+	if (filter != NULL) {
+		remaining = MIN(remaining, net_capture_bpf_run(filter, filter_len, pkt));
+	}
+
+	key = k_spin_lock(&ring_lock);
+
+	if (filter != NULL) {
+		ring_ctx.filter_users--;
+	}
+
+	/* The capture might have been stopped, or restarted with another
+	 * filter, while the filter was run.
+	 */
+	if (remaining == 0U || ring_ctx.iface != iface || ring_ctx.generation != generation) {
+		goto out;
+	}
+
+	rec.ts_sec = (uint32_t)(now / USEC_PER_SEC);
+	rec.ts_usec = (uint32_t)(now % USEC_PER_SEC);
+	rec.incl_len = remaining;
+	rec.orig_len = pkt_len;
+
+	/* Records are stored whole or not at all */
+	if (ring_buf_space_get(&capture_ring) < sizeof(rec) + remaining) {
+		ring_ctx.dropped++;
+		goto out;
+	}
+
+	(void)ring_buf_put(&capture_ring, (const uint8_t *)&rec, sizeof(rec));
+
+	for (buf = pkt->buffer; buf != NULL && remaining > 0U; buf = buf->frags) {
+		uint32_t count = MIN(remaining, buf->len);
+
+		(void)ring_buf_put(&capture_ring, buf->data, count);
+		remaining -= count;
+	}
+
+out:
+	k_spin_unlock(&ring_lock, key);
+}
@@ -35,6 +35,11 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 			   bool response_truncated);
 static struct coap_client_internal_request *get_request_with_mid(struct coap_client *client,
 								 uint16_t mid);
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+static bool block_window_expired(struct coap_client_internal_request *internal_req);
+static int block_window_resend(struct coap_client *client,
+			       struct coap_client_internal_request *internal_req);
+#endif
 
 static int send_request(int sock, const void *buf, size_t len, int flags,
 			const struct net_sockaddr *dest_addr, net_socklen_t addrlen)
@@ -146,6 +151,11 @@ static bool has_timeout_expired(struct coap_client *client)
 		if (timeout_expired(&client->requests[i])) {
 			return true;
 		}
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+		if (block_window_expired(&client->requests[i])) {
+			return true;
+		}
+#endif
 	}
 	return false;
 }
@@ -195,6 +205,18 @@ static enum coap_block_size coap_client_default_block_size(void)
 	return COAP_BLOCK_256;
 }
 
+/** Use a new message ID and token for the next request built with
+ * coap_client_init_request().
+ */
+static void coap_client_new_exchange(struct coap_client_internal_request *internal_req)
+{
+	uint8_t *token = coap_next_token();
+
+	internal_req->last_id = coap_next_id();
+	internal_req->request_tkl = COAP_TOKEN_MAX_LEN & 0xf;
+	memcpy(internal_req->request_token, token, internal_req->request_tkl);
+}
+
 static int coap_client_init_request(struct coap_client *client, struct coap_client_request *req,
 				    struct coap_client_internal_request *internal_req)
 {
@@ -204,12 +226,6 @@ static int coap_client_init_request(struct coap_client *client, struct coap_clie
 
 	memset(internal_req->send_buf, 0, sizeof(internal_req->send_buf));
 
-	uint8_t *token = coap_next_token();
-
-	internal_req->last_id = coap_next_id();
-	internal_req->request_tkl = COAP_TOKEN_MAX_LEN & 0xf;
-	memcpy(internal_req->request_token, token, internal_req->request_tkl);
-
 	ret = coap_packet_init(&internal_req->request, internal_req->send_buf, MAX_COAP_MSG_LEN,
 			       1, req->confirmable ? COAP_TYPE_CON : COAP_TYPE_NON_CON,
 			       COAP_TOKEN_MAX_LEN, internal_req->request_token, req->method,
@@ -250,6 +266,19 @@ static int coap_client_init_request(struct coap_client *client, struct coap_clie
 		}
 	}
 
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+	/* Ask for the size of the resource, needed to request blocks ahead */
+	if (!block2 && req->method == COAP_METHOD_GET && req->payload == NULL &&
+	    req->payload_cb == NULL) {
+		ret = coap_append_option_int(&internal_req->request, COAP_OPTION_SIZE2, 0);
+
+		if (ret < 0) {
+			LOG_ERR("Failed to append size 2 option");
+			goto out;
+		}
+	}
+#endif
+
 	/* Add extra options if any */
 	for (i = 0; i < req->num_options; i++) {
 		if (COAP_OPTION_BLOCK2 == req->options[i].code && block2) {
@@ -467,6 +496,7 @@ int coap_client_req(struct coap_client *client, int sock, const struct net_socka
 	}
 
 	reset_internal_request(internal_req);
+	coap_client_new_exchange(internal_req);
 
 	ret = coap_client_init_request(client, req, internal_req);
 	if (ret < 0) {
@@ -604,6 +634,16 @@ static void coap_client_resend_handler(struct coap_client *client)
 				release_internal_request(&client->requests[i]);
 			}
 		}
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+		if (block_window_expired(&client->requests[i])) {
+			ret = block_window_resend(client, &client->requests[i]);
+			if (ret < 0) {
+				client->requests[i].pipelined = false;
+				report_callback_error(&client->requests[i], ret);
+				release_internal_request(&client->requests[i]);
+			}
+		}
+#endif
 	}
 
 	k_mutex_unlock(&client->lock);
@@ -828,6 +868,402 @@ static bool find_echo_option(const struct coap_packet *response, struct coap_opt
 	return coap_find_options(response, COAP_OPTION_ECHO, option, 1);
 }
 
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+static size_t block_window_block_len(struct coap_client_internal_request *internal_req)
+{
+	return coap_block_size_to_bytes(internal_req->recv_blk_ctx.block_size);
+}
+
+static bool block_window_possible(struct coap_client_internal_request *internal_req)
+{
+	const struct coap_client_request *req = &internal_req->coap_request;
+
+	return !internal_req->is_observe && req->payload == NULL && req->payload_cb == NULL &&
+	       internal_req->send_blk_ctx.total_size == 0 &&
+	       internal_req->recv_blk_ctx.total_size > 0;
+}
+
+static bool block_window_expired(struct coap_client_internal_request *internal_req)
+{
+	int64_t now;
+
+	if (!internal_req->pipelined || !internal_req->request_ongoing) {
+		return false;
+	}
+
+	now = k_uptime_get();
+
+	for (int i = 0; i < ARRAY_SIZE(internal_req->blocks); i++) {
+		struct coap_client_block_slot *slot = &internal_req->blocks[i];
+
+		if (slot->active && slot->pending.timeout != 0 &&
+		    slot->pending.timeout <= (now - slot->pending.t0)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Build and send the request for the block of the slot. A resent request keeps
+ * the message ID and token of the slot, so the server can detect the duplicate.
+ */
+static int block_window_send(struct coap_client *client,
+			     struct coap_client_internal_request *internal_req,
+			     struct coap_client_block_slot *slot)
+{
+	int ret;
+
+	internal_req->last_id = slot->id;
+	internal_req->request_tkl = COAP_TOKEN_MAX_LEN;
+	memcpy(internal_req->request_token, slot->token, COAP_TOKEN_MAX_LEN);
+	internal_req->recv_blk_ctx.current = slot->num * block_window_block_len(internal_req);
+
+	ret = coap_client_init_request(client, &internal_req->coap_request, internal_req);
+	if (ret < 0) {
+		LOG_ERR("Error creating a CoAP request");
+		return ret;
+	}
+
+	ret = send_request(client->fd, internal_req->request.data, internal_req->request.offset, 0,
+			   &client->address, client->socklen);
+
+	return ret < 0 ? ret : 0;
+}
+
+static int block_window_request(struct coap_client *client,
+				struct coap_client_internal_request *internal_req,
+				struct coap_client_block_slot *slot, uint32_t num)
+{
+	struct coap_transmission_parameters params = internal_req->pending.params;
+	int ret;
+
+	slot->num = num;
+	slot->id = coap_next_id();
+	memcpy(slot->token, coap_next_token(), COAP_TOKEN_MAX_LEN);
+
+	ret = block_window_send(client, internal_req, slot);
+	if (ret < 0 && ret != -EAGAIN) {
+		LOG_ERR("Error sending a CoAP request");
+		return ret;
+	}
+
+	/* A request that could not be sent yet is sent again on the first timeout */
+	ret = coap_pending_init(&slot->pending, &internal_req->request, &client->address,
+				&params);
+	if (ret < 0) {
+		LOG_ERR("Error creating pending");
+		return ret;
+	}
+
+	if (!internal_req->coap_request.confirmable) {
+		slot->pending.retries = 0;
+	}
+
+	coap_pending_cycle(&slot->pending);
+	slot->active = true;
+
+	return 0;
+}
+
+/* Request blocks ahead until the window is full or all blocks are requested */
+static int block_window_fill(struct coap_client *client,
+			     struct coap_client_internal_request *internal_req)
+{
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(internal_req->blocks); i++) {
+		struct coap_client_block_slot *slot = &internal_req->blocks[i];
+
+		if (internal_req->next_block >= internal_req->num_blocks) {
+			break;
+		}
+
+		if (slot->active || slot->received) {
+			continue;
+		}
+
+		ret = block_window_request(client, internal_req, slot, internal_req->next_block);
+		if (ret < 0) {
+			return ret;
+		}
+
+		internal_req->next_block++;
+	}
+
+	return 0;
+}
+
+/* Called once the first block was delivered, with the size of the resource known */
+static int block_window_start(struct coap_client *client,
+			      struct coap_client_internal_request *internal_req)
+{
+	size_t block_len = block_window_block_len(internal_req);
+
+	internal_req->num_blocks = DIV_ROUND_UP(internal_req->recv_blk_ctx.total_size, block_len);
+	if (internal_req->num_blocks < 2) {
+		/* Size2 contradicts the more flag, request blocks one by one */
+		internal_req->num_blocks = 2;
+	}
+
+	internal_req->next_block = 1;
+	internal_req->deliver_block = 1;
+	internal_req->pipelined = true;
+
+	LOG_DBG("Pipelining %u blocks of %zu bytes", internal_req->num_blocks, block_len);
+
+	return block_window_fill(client, internal_req);
+}
+
+static int block_window_resend(struct coap_client *client,
+			       struct coap_client_internal_request *internal_req)
+{
+	int64_t now = k_uptime_get();
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(internal_req->blocks); i++) {
+		struct coap_client_block_slot *slot = &internal_req->blocks[i];
+		struct coap_pending tmp = slot->pending;
+
+		if (!slot->active || slot->pending.timeout == 0 ||
+		    slot->pending.timeout > (now - slot->pending.t0)) {
+			continue;
+		}
+
+		if (!coap_pending_cycle(&slot->pending)) {
+			LOG_ERR("Timeout, no more retries left for block %u", slot->num);
+			return -ETIMEDOUT;
+		}
+
+		LOG_ERR("Timeout, retrying block %u", slot->num);
+
+		ret = block_window_send(client, internal_req, slot);
+		if (ret == -EAGAIN) {
+			/* Restore the pending structure, retry later */
+			slot->pending = tmp;
+		} else if (ret < 0) {
+			LOG_ERR("Failed to resend request, %d", ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static void block_window_finish(struct coap_client_internal_request *internal_req, int error)
+{
+	internal_req->pipelined = false;
+
+	if (error < 0) {
+		report_callback_error(internal_req, error);
+	}
+
+	release_internal_request(internal_req);
+}
+
+static int block_window_deliver(struct coap_client_internal_request *internal_req,
+				const struct coap_packet *response, uint32_t num,
+				const uint8_t *payload, size_t payload_len)
+{
+	if (internal_req->coap_request.cb != NULL &&
+	    !atomic_set(&internal_req->in_callback, 1)) {
+		const struct coap_client_response_data resp_data = {
+			.result_code = coap_header_get_code(response),
+			.packet = response,
+			.offset = num * block_window_block_len(internal_req),
+			.payload = payload,
+			.payload_len = payload_len,
+			.last_block = num + 1 >= internal_req->num_blocks,
+		};
+
+		internal_req->coap_request.cb(&resp_data, internal_req->coap_request.user_data);
+		atomic_clear(&internal_req->in_callback);
+	}
+
+	if (!internal_req->request_ongoing) {
+		/* User callback must have canceled the request */
+		return -ECANCELED;
+	}
+
+	internal_req->deliver_block++;
+
+	return 0;
+}
+
+static int block_window_receive(struct coap_client *client,
+				struct coap_client_internal_request *internal_req,
+				struct coap_client_block_slot *slot,
+				const struct coap_packet *response)
+{
+	uint8_t response_code = coap_header_get_code(response);
+	int block_option = coap_get_option_int(response, COAP_OPTION_BLOCK2);
+	size_t block_len = block_window_block_len(internal_req);
+	uint32_t num = slot->num;
+	const uint8_t *payload;
+	uint16_t payload_len;
+	bool found;
+	int ret;
+
+	payload = coap_packet_get_payload(response, &payload_len);
+
+	coap_pending_clear(&slot->pending);
+	slot->active = false;
+
+	if ((response_code >> 5) != 2) {
+		/* Report the failure and stop, the remaining blocks are of no use */
+		internal_req->num_blocks = num + 1;
+		(void)block_window_deliver(internal_req, response, num, payload, payload_len);
+		block_window_finish(internal_req, 0);
+		return 0;
+	}
+
+	if (block_option < 0 || GET_BLOCK_NUM(block_option) != num ||
+	    GET_BLOCK_SIZE(block_option) != internal_req->recv_blk_ctx.block_size) {
+		LOG_ERR("Unexpected block option in response to block %u", num);
+		block_window_finish(internal_req, -EBADMSG);
+		return -EBADMSG;
+	}
+
+	if (!GET_MORE(block_option)) {
+		internal_req->num_blocks = num + 1;
+	} else if (num + 1 >= internal_req->num_blocks) {
+		/* The resource grew since the first block */
+		internal_req->num_blocks = num + 2;
+	}
+
+	if (payload_len > block_len || (GET_MORE(block_option) && payload_len != block_len)) {
+		LOG_ERR("Invalid payload size %u for block %u", payload_len, num);
+		block_window_finish(internal_req, -EBADMSG);
+		return -EBADMSG;
+	}
+
+	if (num == internal_req->deliver_block) {
+		ret = block_window_deliver(internal_req, response, num, payload, payload_len);
+		if (ret < 0) {
+			internal_req->pipelined = false;
+			return 0;
+		}
+	} else if (num > internal_req->deliver_block && num < internal_req->num_blocks) {
+		/* Hold back until the blocks before it are delivered */
+		memcpy(slot->payload, payload, payload_len);
+		slot->len = payload_len;
+		slot->received = true;
+	}
+
+	/* Deliver the blocks that were waiting for this one */
+	do {
+		found = false;
+
+		for (int i = 0; i < ARRAY_SIZE(internal_req->blocks); i++) {
+			struct coap_client_block_slot *held = &internal_req->blocks[i];
+
+			if (!held->received || held->num != internal_req->deliver_block) {
+				continue;
+			}
+
+			held->received = false;
+			found = true;
+
+			ret = block_window_deliver(internal_req, response, held->num,
+						   held->payload, held->len);
+			if (ret < 0) {
+				internal_req->pipelined = false;
+				return 0;
+			}
+		}
+	} while (found);
+
+	if (internal_req->deliver_block >= internal_req->num_blocks) {
+		block_window_finish(internal_req, 0);
+		return 0;
+	}
+
+	ret = block_window_fill(client, internal_req);
+	if (ret < 0) {
+		block_window_finish(internal_req, ret);
+		return ret;
+	}
+
+	return 1;
+}
+
+/* Handle a message belonging to a pipelined transfer.
+ * Return -ENOENT if the message is not part of one.
+ */
+static int handle_block_window_response(struct coap_client *client,
+					const struct coap_packet *response)
+{
+	uint8_t response_type = coap_header_get_type(response);
+	uint8_t response_code = coap_header_get_code(response);
+	uint16_t response_id = coap_header_get_id(response);
+	uint8_t response_token[COAP_TOKEN_MAX_LEN];
+	uint8_t response_tkl;
+	int ret;
+
+	response_tkl = coap_header_get_token(response, response_token);
+
+	for (int i = 0; i < CONFIG_COAP_CLIENT_MAX_REQUESTS; i++) {
+		struct coap_client_internal_request *internal_req = &client->requests[i];
+
+		if (!internal_req->pipelined || !internal_req->request_ongoing) {
+			continue;
+		}
+
+		for (int j = 0; j < ARRAY_SIZE(internal_req->blocks); j++) {
+			struct coap_client_block_slot *slot = &internal_req->blocks[j];
+
+			if (!slot->active) {
+				continue;
+			}
+
+			if (response_code == COAP_CODE_EMPTY) {
+				if (slot->id != response_id) {
+					continue;
+				}
+
+				if (response_type == COAP_TYPE_RESET) {
+					block_window_finish(internal_req, -ECONNRESET);
+					return 0;
+				}
+
+				/* Separate response coming */
+				slot->pending.t0 = k_uptime_get();
+				slot->pending.timeout = COAP_SEPARATE_TIMEOUT;
+				slot->pending.retries = 0;
+				return 1;
+			}
+
+			if (response_tkl != COAP_TOKEN_MAX_LEN ||
+			    memcmp(slot->token, response_token, response_tkl) != 0) {
+				continue;
+			}
+
+			if (response_type == COAP_TYPE_CON) {
+				ret = send_ack(client, response, COAP_CODE_EMPTY);
+				if (ret < 0) {
+					block_window_finish(internal_req, ret);
+					return ret;
+				}
+			}
+
+			return block_window_receive(client, internal_req, slot, response);
+		}
+
+		/* Late duplicate of a block already received. Drop it here, as it
+		 * would otherwise match the request built last.
+		 */
+		if (response_id == internal_req->last_id ||
+		    (response_tkl == internal_req->request_tkl &&
+		     memcmp(internal_req->request_token, response_token, response_tkl) == 0)) {
+			LOG_DBG("Drop response, block already handled");
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+#endif /* CONFIG_COAP_CLIENT_BLOCK_PIPELINING */
+
 static int handle_response(struct coap_client *client, const struct coap_packet *response,
 			   bool response_truncated)
 {
@@ -852,6 +1288,15 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 	uint16_t response_id = coap_header_get_id(response);
 	const uint8_t *payload = coap_packet_get_payload(response, &payload_len);
 
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+	ret = handle_block_window_response(client, response);
+	if (ret != -ENOENT) {
+		return ret;
+	}
+
+	ret = 0;
+#endif
+
 	if (response_type == COAP_TYPE_RESET) {
 		internal_req = get_request_with_mid(client, response_id);
 		if (!internal_req) {
@@ -891,6 +1336,7 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 	if (find_echo_option(response, &client->echo_option)) {
 		 /* Resend request with echo option */
 		if (response_code == COAP_RESPONSE_CODE_UNAUTHORIZED) {
+			coap_client_new_exchange(internal_req);
 			ret = coap_client_init_request(client, &internal_req->coap_request,
 						       internal_req);
 
@@ -1045,8 +1491,23 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 		}
 	}
 
+#if defined(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)
+	/* First block of a response with known size, request the next ones at once */
+	if (blockwise_transfer && !last_block && block_option > 0 &&
+	    GET_BLOCK_NUM(block_option) == 0 && block_window_possible(internal_req)) {
+		ret = block_window_start(client, internal_req);
+		if (ret < 0) {
+			internal_req->pipelined = false;
+			goto fail;
+		}
+
+		return 1;
+	}
+#endif
+
 	/* If this wasn't last block, send the next request */
 	if (blockwise_transfer && !last_block) {
+		coap_client_new_exchange(internal_req);
 		ret = coap_client_init_request(client, &internal_req->coap_request, internal_req);
 
 		if (ret < 0) {
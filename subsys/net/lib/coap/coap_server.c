@@ -35,6 +35,10 @@ LOG_MODULE_DECLARE(net_coap, CONFIG_COAP_LOG_LEVEL);
 #define MAX_PENDINGS   CONFIG_COAP_SERVICE_PENDING_MESSAGES
 #define MAX_OBSERVERS  CONFIG_COAP_SERVICE_OBSERVERS
 #define MAX_POLL_FD    CONFIG_ZVFS_POLL_MAX
+#define MAX_BATCH      CONFIG_COAP_SERVER_NOTIFY_BATCH
+
+/* Fixed header and the longest token */
+#define MAX_HEADER_LEN (COAP_TOKEN_MAX_LEN + 4U)
 
 BUILD_ASSERT(CONFIG_ZVFS_POLL_MAX > 0, "CONFIG_ZVFS_POLL_MAX can't be 0");
 
@@ -82,6 +86,91 @@ static inline void coap_server_free(void *ptr)
 #endif
 }
 
+static inline int64_t coap_pending_expiry(const struct coap_pending *pending)
+{
+	return pending->t0 + pending->timeout;
+}
+
+static void coap_pending_heap_swap(struct coap_service_data *data, size_t a, size_t b)
+{
+	struct coap_pending *tmp = data->pending_heap[a];
+
+	data->pending_heap[a] = data->pending_heap[b];
+	data->pending_heap[b] = tmp;
+}
+
+static void coap_pending_heap_up(struct coap_service_data *data, size_t idx)
+{
+	while (idx > 0) {
+		size_t parent = (idx - 1) / 2;
+
+		if (coap_pending_expiry(data->pending_heap[parent]) <=
+		    coap_pending_expiry(data->pending_heap[idx])) {
+			break;
+		}
+
+		coap_pending_heap_swap(data, parent, idx);
+		idx = parent;
+	}
+}
+
+static void coap_pending_heap_down(struct coap_service_data *data, size_t idx)
+{
+	while (true) {
+		size_t left = 2 * idx + 1;
+		size_t right = left + 1;
+		size_t next = idx;
+
+		if (left < data->pending_count &&
+		    coap_pending_expiry(data->pending_heap[left]) <
+		    coap_pending_expiry(data->pending_heap[next])) {
+			next = left;
+		}
+
+		if (right < data->pending_count &&
+		    coap_pending_expiry(data->pending_heap[right]) <
+		    coap_pending_expiry(data->pending_heap[next])) {
+			next = right;
+		}
+
+		if (next == idx) {
+			break;
+		}
+
+		coap_pending_heap_swap(data, idx, next);
+		idx = next;
+	}
+}
+
+static void coap_server_pending_add(struct coap_service_data *data, struct coap_pending *pending)
+{
+	__ASSERT_NO_MSG(data->pending_count < MAX_PENDINGS);
+
+	data->pending_heap[data->pending_count] = pending;
+	coap_pending_heap_up(data, data->pending_count++);
+}
+
+static void coap_server_pending_release(struct coap_service_data *data,
+					struct coap_pending *pending)
+{
+	for (size_t i = 0; i < data->pending_count; i++) {
+		if (data->pending_heap[i] != pending) {
+			continue;
+		}
+
+		data->pending_heap[i] = data->pending_heap[--data->pending_count];
+		if (i < data->pending_count) {
+			coap_pending_heap_down(data, i);
+			coap_pending_heap_up(data, i);
+		}
+
+		break;
+	}
+
+	coap_server_free(pending->data);
+	coap_pending_clear(pending);
+}
+
 static int coap_service_remove_observer(const struct coap_service *service,
 					struct coap_resource *resource,
 					const struct net_sockaddr *addr,
@@ -122,38 +211,42 @@ static int coap_service_remove_observer(const struct coap_service *service,
 	return 0;
 }
 
-static int coap_server_process(int sock_fd)
+static ssize_t coap_server_recv(int sock_fd, uint8_t *buf, size_t buf_size,
+				struct net_sockaddr *client_addr, net_socklen_t *client_addr_len)
 {
-	static uint8_t buf[CONFIG_COAP_SERVER_MESSAGE_SIZE];
-
-	struct net_sockaddr client_addr;
-	net_socklen_t client_addr_len = sizeof(client_addr);
-	struct coap_service *service = NULL;
-	struct coap_packet request;
-	struct coap_pending *pending;
-	struct coap_option options[MAX_OPTIONS] = { 0 };
-	uint8_t opt_num = MAX_OPTIONS;
-	uint8_t type;
 	ssize_t received;
-	int ret;
 	int flags = ZSOCK_MSG_DONTWAIT;
 
 	if (IS_ENABLED(CONFIG_COAP_SERVER_TRUNCATE_MSGS)) {
 		flags |= ZSOCK_MSG_TRUNC;
 	}
 
-	received = zsock_recvfrom(sock_fd, buf, sizeof(buf), flags, &client_addr, &client_addr_len);
+	received = zsock_recvfrom(sock_fd, buf, buf_size, flags, client_addr, client_addr_len);
 
 	if (received < 0) {
 		if (errno == EWOULDBLOCK) {
-			return 0;
+			return -EAGAIN;
 		}
 
 		LOG_ERR("Failed to process client request (%d)", -errno);
 		return -errno;
 	}
 
-	ret = coap_packet_parse(&request, buf, MIN(received, sizeof(buf)), options, opt_num);
+	return received;
+}
+
+static int coap_server_handle(int sock_fd, uint8_t *buf, size_t buf_size, ssize_t received,
+			      struct net_sockaddr *client_addr, net_socklen_t client_addr_len)
+{
+	struct coap_service *service = NULL;
+	struct coap_packet request;
+	struct coap_pending *pending;
+	struct coap_option options[MAX_OPTIONS] = { 0 };
+	uint8_t opt_num = MAX_OPTIONS;
+	uint8_t type;
+	int ret;
+
+	ret = coap_packet_parse(&request, buf, MIN(received, buf_size), options, opt_num);
 	if (ret < 0) {
 		LOG_ERR("Failed To parse coap message (%d)", ret);
 		return ret;
@@ -174,7 +267,7 @@ static int coap_server_process(int sock_fd)
 
 	type = coap_header_get_type(&request);
 
-	if (received > sizeof(buf)) {
+	if (received > buf_size) {
 		/* The message was truncated and can't be processed further */
 		struct coap_packet response;
 		uint8_t token[COAP_TOKEN_MAX_LEN];
@@ -187,7 +280,7 @@ static int coap_server_process(int sock_fd)
 			type = COAP_TYPE_NON_CON;
 		}
 
-		ret = coap_packet_init(&response, buf, sizeof(buf), COAP_VERSION_1, type, tkl,
+		ret = coap_packet_init(&response, buf, buf_size, COAP_VERSION_1, type, tkl,
 				       token, COAP_RESPONSE_CODE_REQUEST_TOO_LARGE, id);
 		if (ret < 0) {
 			LOG_ERR("Failed to init response (%d)", ret);
@@ -201,7 +294,7 @@ static int coap_server_process(int sock_fd)
 			goto unlock;
 		}
 
-		ret = coap_service_send(service, &response, &client_addr, client_addr_len, NULL);
+		ret = coap_service_send(service, &response, client_addr, client_addr_len, NULL);
 		if (ret < 0) {
 			LOG_ERR("Failed to reply \"Request Entity Too Large\" (%d)", ret);
 			goto unlock;
@@ -218,11 +311,10 @@ static int coap_server_process(int sock_fd)
 		switch (type) {
 		case COAP_TYPE_RESET:
 			tkl = coap_header_get_token(&request, token);
-			coap_service_remove_observer(service, NULL, &client_addr, token, tkl);
+			coap_service_remove_observer(service, NULL, client_addr, token, tkl);
 			__fallthrough;
 		case COAP_TYPE_ACK:
-			coap_server_free(pending->data);
-			coap_pending_clear(pending);
+			coap_server_pending_release(service->data, pending);
 			break;
 		default:
 			LOG_WRN("Unexpected pending type %d", type);
@@ -252,11 +344,27 @@ static int coap_server_process(int sock_fd)
 			goto unlock;
 		}
 
-		ret = coap_service_send(service, &response, &client_addr, client_addr_len, NULL);
+		ret = coap_service_send(service, &response, client_addr, client_addr_len, NULL);
 	} else {
+		/* The resource handlers take the lock themselves where needed, don't hold
+		 * back the other threads meanwhile.
+		 */
+		(void)k_mutex_unlock(&lock);
+
 		ret = coap_handle_request_len(&request, service->res_begin,
 					      COAP_SERVICE_RESOURCE_COUNT(service),
-					      options, opt_num, &client_addr, client_addr_len);
+					      options, opt_num, client_addr, client_addr_len);
+
+		(void)k_mutex_lock(&lock, K_FOREVER);
+
+		/* The service may have been stopped, or restarted with a new socket, while
+		 * the handler ran. Don't reply through a socket that is no longer ours.
+		 */
+		if (service->data->sock_fd != sock_fd) {
+			LOG_DBG("Service %s socket changed, dropping reply", service->name);
+			ret = -ENOTCONN;
+			goto unlock;
+		}
 
 		/* Translate errors to response codes */
 		switch (ret) {
@@ -283,7 +391,7 @@ static int coap_server_process(int sock_fd)
 				goto unlock;
 			}
 
-			ret = coap_service_send(service, &ack, &client_addr, client_addr_len, NULL);
+			ret = coap_service_send(service, &ack, client_addr, client_addr_len, NULL);
 		}
 	}
 
@@ -293,6 +401,120 @@ unlock:
 	return ret;
 }
 
+static void coap_server_update_services(void);
+
+#if defined(CONFIG_COAP_SERVER_WORKERS)
+struct coap_server_job {
+	struct k_work work;
+	int sock_fd;
+	struct net_sockaddr addr;
+	net_socklen_t addr_len;
+	ssize_t received;
+	uint8_t buf[CONFIG_COAP_SERVER_MESSAGE_SIZE];
+};
+
+K_MEM_SLAB_DEFINE_STATIC(coap_job_slab, sizeof(struct coap_server_job),
+			 CONFIG_COAP_SERVER_WORKER_JOB_COUNT, sizeof(void *));
+
+static struct k_work_q coap_workers[CONFIG_COAP_SERVER_WORKER_COUNT];
+static K_KERNEL_STACK_ARRAY_DEFINE(coap_worker_stacks, CONFIG_COAP_SERVER_WORKER_COUNT,
+				   CONFIG_COAP_SERVER_WORKER_STACK_SIZE);
+
+static void coap_server_job_handler(struct k_work *work)
+{
+	struct coap_server_job *job = CONTAINER_OF(work, struct coap_server_job, work);
+	bool exhausted;
+
+	(void)coap_server_handle(job->sock_fd, job->buf, sizeof(job->buf), job->received,
+				 &job->addr, job->addr_len);
+
+	exhausted = k_mem_slab_num_free_get(&coap_job_slab) == 0;
+	k_mem_slab_free(&coap_job_slab, job);
+
+	/* The server thread stops polling the sockets while no job is available */
+	if (exhausted) {
+		coap_server_update_services();
+	}
+}
+
+static bool coap_server_jobs_available(void)
+{
+	return k_mem_slab_num_free_get(&coap_job_slab) > 0;
+}
+
+static void coap_server_dispatch(int sock_fd)
+{
+	struct coap_server_job *job;
+
+	if (k_mem_slab_alloc(&coap_job_slab, (void **)&job, K_NO_WAIT) < 0) {
+		return;
+	}
+
+	job->addr_len = sizeof(job->addr);
+	job->received = coap_server_recv(sock_fd, job->buf, sizeof(job->buf), &job->addr,
+					 &job->addr_len);
+	if (job->received < 0) {
+		k_mem_slab_free(&coap_job_slab, job);
+		return;
+	}
+
+	job->sock_fd = sock_fd;
+
+	/* Pick the worker by socket, so that the requests of a service are processed in
+	 * order and its handlers are never called concurrently.
+	 */
+	k_work_init(&job->work, coap_server_job_handler);
+	(void)k_work_submit_to_queue(&coap_workers[sock_fd % ARRAY_SIZE(coap_workers)],
+				     &job->work);
+}
+
+static int coap_server_workers_init(void)
+{
+	struct k_work_queue_config q_cfg = {
+		.name = "coap_worker",
+		.no_yield = false,
+	};
+
+	ARRAY_FOR_EACH(coap_workers, i) {
+		k_work_queue_init(&coap_workers[i]);
+		k_work_queue_start(&coap_workers[i], coap_worker_stacks[i],
+				   K_KERNEL_STACK_SIZEOF(coap_worker_stacks[i]),
+				   THREAD_PRIORITY, &q_cfg);
+	}
+
+	return 0;
+}
+
+SYS_INIT(coap_server_workers_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#else
+static int coap_server_process(int sock_fd)
+{
+	static uint8_t buf[CONFIG_COAP_SERVER_MESSAGE_SIZE];
+
+	struct net_sockaddr client_addr;
+	net_socklen_t client_addr_len = sizeof(client_addr);
+	ssize_t received;
+
+	received = coap_server_recv(sock_fd, buf, sizeof(buf), &client_addr, &client_addr_len);
+	if (received < 0) {
+		return (received == -EAGAIN) ? 0 : received;
+	}
+
+	return coap_server_handle(sock_fd, buf, sizeof(buf), received, &client_addr,
+				  client_addr_len);
+}
+
+static inline bool coap_server_jobs_available(void)
+{
+	return true;
+}
+
+static inline void coap_server_dispatch(int sock_fd)
+{
+	(void)coap_server_process(sock_fd);
+}
+#endif /* CONFIG_COAP_SERVER_WORKERS */
+
 static void coap_server_retransmit(void)
 {
 	struct coap_pending *pending;
@@ -303,36 +525,38 @@ static void coap_server_retransmit(void)
 	(void)k_mutex_lock(&lock, K_FOREVER);
 
 	COAP_SERVICE_FOREACH(service) {
-		if (service->data->sock_fd < 0) {
-			continue;
-		}
+		struct coap_service_data *data = service->data;
 
-		pending = coap_pending_next_to_expire(service->data->pending, MAX_PENDINGS);
-		if (pending == NULL) {
-			/* No work to be done */
+		if (data->sock_fd < 0) {
 			continue;
 		}
 
-		/* Check if the pending request has expired */
-		remaining = pending->t0 + pending->timeout - now;
-		if (remaining > 0) {
-			continue;
-		}
+		while (data->pending_count > 0) {
+			pending = data->pending_heap[0];
 
-		if (coap_pending_cycle(pending)) {
-			ret = zsock_sendto(service->data->sock_fd, pending->data, pending->len, 0,
-					   &pending->addr, ADDRLEN(&pending->addr));
-			if (ret < 0) {
-				LOG_ERR("Failed to send pending retransmission for %s (%d)",
-					service->name, ret);
+			/* Check if the next pending request has expired */
+			remaining = coap_pending_expiry(pending) - now;
+			if (remaining > 0) {
+				break;
 			}
-			__ASSERT_NO_MSG(ret == pending->len);
-		} else {
-			LOG_WRN("Packet retransmission failed for %s", service->name);
 
-			coap_service_remove_observer(service, NULL, &pending->addr, NULL, 0U);
-			coap_server_free(pending->data);
-			coap_pending_clear(pending);
+			if (coap_pending_cycle(pending)) {
+				ret = zsock_sendto(data->sock_fd, pending->data, pending->len, 0,
+						   &pending->addr, ADDRLEN(&pending->addr));
+				if (ret < 0) {
+					LOG_ERR("Failed to send pending retransmission for %s (%d)",
+						service->name, ret);
+				}
+				__ASSERT_NO_MSG(ret == pending->len);
+
+				coap_pending_heap_down(data, 0);
+			} else {
+				LOG_WRN("Packet retransmission failed for %s", service->name);
+
+				coap_service_remove_observer(service, NULL, &pending->addr, NULL,
+							     0U);
+				coap_server_pending_release(data, pending);
+			}
 		}
 	}
 
@@ -341,27 +565,25 @@ static void coap_server_retransmit(void)
 
 static int coap_server_poll_timeout(void)
 {
-	struct coap_pending *pending;
 	int64_t result = INT64_MAX;
 	int64_t remaining;
 	int64_t now = k_uptime_get();
 
-	COAP_SERVICE_FOREACH(svc) {
-		if (svc->data->sock_fd < -1) {
-			continue;
-		}
+	(void)k_mutex_lock(&lock, K_FOREVER);
 
-		pending = coap_pending_next_to_expire(svc->data->pending, MAX_PENDINGS);
-		if (pending == NULL) {
+	COAP_SERVICE_FOREACH(svc) {
+		if (svc->data->sock_fd < 0 || svc->data->pending_count == 0) {
 			continue;
 		}
 
-		remaining = pending->t0 + pending->timeout - now;
+		remaining = coap_pending_expiry(svc->data->pending_heap[0]) - now;
 		if (result > remaining) {
 			result = remaining;
 		}
 	}
 
+	(void)k_mutex_unlock(&lock);
+
 	if (result == INT64_MAX) {
 		return -1;
 	}
@@ -634,6 +856,7 @@ int coap_service_send(const struct coap_service *service, const struct coap_pack
 		memcpy(pending->data, cpkt->data, pending->len);
 
 		coap_pending_cycle(pending);
+		coap_server_pending_add(service->data, pending);
 
 		/* Trigger event in receive loop to schedule retransmit */
 		coap_server_update_services();
@@ -666,6 +889,191 @@ int coap_resource_send(const struct coap_resource *resource, const struct coap_p
 	return -ENOENT;
 }
 
+static int coap_server_send_batch(const struct coap_service *service, struct net_mmsghdr *msgs,
+				  unsigned int count)
+{
+	int ret;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	ret = zsock_sendmmsg(service->data->sock_fd, msgs, count, 0);
+	if (ret < 0) {
+		ret = -errno;
+		LOG_ERR("Failed to send notifications for %s (%d)", service->name, ret);
+		return ret;
+	}
+
+	if (ret < count) {
+		LOG_WRN("Sent %d out of %u notifications for %s", ret, count, service->name);
+	}
+
+	return ret;
+}
+
+/* Confirmable notifications are tracked as pending messages, which hold a copy of the whole
+ * message. Returns NULL if the message can't be tracked, it is sent anyway.
+ */
+static struct coap_pending *coap_server_notify_pending(const struct coap_service *service,
+						       const struct coap_packet *hdr,
+						       const struct coap_packet *cpkt,
+						       const struct net_sockaddr *addr,
+						       const struct coap_transmission_parameters *params)
+{
+	struct coap_pending *pending;
+	struct coap_packet msg = { 0 };
+	uint16_t body_len = cpkt->offset - cpkt->hdr_len;
+	uint8_t *data;
+
+	pending = coap_pending_next_unused(service->data->pending, MAX_PENDINGS);
+	if (pending == NULL) {
+		LOG_WRN("No pending message available for %s", service->name);
+		return NULL;
+	}
+
+	data = coap_server_alloc(hdr->offset + body_len);
+	if (data == NULL) {
+		LOG_WRN("Failed to allocate pending message data for %s", service->name);
+		return NULL;
+	}
+
+	memcpy(data, hdr->data, hdr->offset);
+	memcpy(data + hdr->offset, cpkt->data + cpkt->hdr_len, body_len);
+
+	msg.data = data;
+	msg.offset = hdr->offset + body_len;
+	msg.max_len = msg.offset;
+
+	(void)coap_pending_init(pending, &msg, addr, params);
+	coap_pending_cycle(pending);
+	coap_server_pending_add(service->data, pending);
+
+	return pending;
+}
+
+int coap_resource_send_observers(struct coap_resource *resource,
+				 const struct coap_packet *cpkt,
+				 const struct coap_transmission_parameters *params)
+{
+	struct net_mmsghdr msgs[MAX_BATCH];
+	struct net_iovec iovs[MAX_BATCH][2];
+	uint8_t hdr_bufs[MAX_BATCH][MAX_HEADER_LEN];
+	const struct coap_service *service = NULL;
+	struct coap_observer *observer;
+	struct coap_pending *pending;
+	struct coap_packet hdr;
+	unsigned int count = 0;
+	bool linearize = false;
+	bool has_pending = false;
+	uint8_t type;
+	uint8_t code;
+	int sent = 0;
+	int ret = 0;
+
+	/* Find owning service */
+	COAP_SERVICE_FOREACH(svc) {
+		if (COAP_SERVICE_HAS_RESOURCE(svc, resource)) {
+			service = svc;
+			break;
+		}
+	}
+
+	if (service == NULL) {
+		return -ENOENT;
+	}
+
+	if (coap_header_get_token(cpkt, hdr_bufs[0]) != 0) {
+		return -EINVAL;
+	}
+
+	type = coap_header_get_type(cpkt);
+	code = coap_header_get_code(cpkt);
+
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+	/* Without an intermediate buffer, DTLS sockets only send single buffer messages */
+	linearize = service->sec_tag_list != NULL && CONFIG_NET_SOCKETS_DTLS_SENDMSG_BUF_SIZE == 0;
+#endif
+
+	(void)k_mutex_lock(&lock, K_FOREVER);
+
+	if (service->data->sock_fd < 0) {
+		ret = -EBADF;
+		goto unlock;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&resource->observers, observer, list) {
+		ret = coap_packet_init(&hdr, hdr_bufs[count], sizeof(hdr_bufs[count]),
+				       COAP_VERSION_1, type, observer->tkl, observer->token, code,
+				       coap_next_id());
+		if (ret < 0) {
+			LOG_ERR("Failed to init notification header (%d)", ret);
+			goto unlock;
+		}
+
+		pending = NULL;
+		if (type == COAP_TYPE_CON) {
+			pending = coap_server_notify_pending(service, &hdr, cpkt, &observer->addr,
+							     params);
+			has_pending |= (pending != NULL);
+		}
+
+		if (pending != NULL) {
+			/* Send the tracked copy */
+			iovs[count][0].iov_base = pending->data;
+			iovs[count][0].iov_len = pending->len;
+			msgs[count].msg_hdr.msg_iovlen = 1;
+		} else if (linearize) {
+			LOG_WRN("Notification for %s can't be sent without a DTLS sendmsg buffer",
+				service->name);
+			continue;
+		} else {
+			iovs[count][0].iov_base = hdr.data;
+			iovs[count][0].iov_len = hdr.offset;
+			iovs[count][1].iov_base = cpkt->data + cpkt->hdr_len;
+			iovs[count][1].iov_len = cpkt->offset - cpkt->hdr_len;
+			msgs[count].msg_hdr.msg_iovlen = 2;
+		}
+
+		msgs[count].msg_hdr.msg_name = &observer->addr;
+		msgs[count].msg_hdr.msg_namelen = ADDRLEN(&observer->addr);
+		msgs[count].msg_hdr.msg_iov = iovs[count];
+		msgs[count].msg_hdr.msg_control = NULL;
+		msgs[count].msg_hdr.msg_controllen = 0;
+		msgs[count].msg_hdr.msg_flags = 0;
+		count++;
+
+		if (count == ARRAY_SIZE(msgs)) {
+			ret = coap_server_send_batch(service, msgs, count);
+			if (ret < 0) {
+				goto unlock;
+			}
+
+			sent += ret;
+			count = 0;
+		}
+	}
+
+	ret = coap_server_send_batch(service, msgs, count);
+	if (ret >= 0) {
+		sent += ret;
+	}
+
+unlock:
+	(void)k_mutex_unlock(&lock);
+
+	if (has_pending) {
+		/* Trigger event in receive loop to schedule retransmit */
+		coap_server_update_services();
+	}
+
+	if (ret < 0 && sent == 0) {
+		return ret;
+	}
+
+	return sent;
+}
+
 int coap_resource_parse_observe(struct coap_resource *resource, const struct coap_packet *request,
 				const struct net_sockaddr *addr)
 {
@@ -816,7 +1224,7 @@ static void coap_server_thread(void *p1, void *p2, void *p3)
 	while (true) {
 		sock_nfds = 0;
 		COAP_SERVICE_FOREACH(svc) {
-			if (svc->data->sock_fd < 0) {
+			if (svc->data->sock_fd < 0 || !coap_server_jobs_available()) {
 				continue;
 			}
 			if (sock_nfds >= MAX_POLL_FD) {
@@ -860,7 +1268,7 @@ static void coap_server_thread(void *p1, void *p2, void *p3)
 
 			/* Check if socket can receive/was closed first */
 			if (sock_fds[i].revents & ZSOCK_POLLIN) {
-				coap_server_process(sock_fds[i].fd);
+				coap_server_dispatch(sock_fds[i].fd);
 				continue;
 			}
 
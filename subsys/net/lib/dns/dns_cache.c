@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <ctype.h>
+#include <strings.h>
 #include <zephyr/net/dns_resolve.h>
 #include <zephyr/net/net_ip.h>
 #include "dns_cache.h"
@@ -12,28 +14,47 @@ LOG_MODULE_REGISTER(net_dns_cache, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 
 static void dns_cache_clean(struct dns_cache const *cache);
 
-int dns_cache_flush(struct dns_cache *cache)
+/* DNS names are case insensitive, so is the hash (FNV-1a) */
+static uint32_t dns_cache_hash(const char *query)
 {
-	k_mutex_lock(cache->lock, K_FOREVER);
-	for (size_t i = 0; i < cache->size; i++) {
-		cache->entries[i].in_use = false;
+	uint32_t hash = 2166136261U;
+
+	while (*query != '\0') {
+		hash ^= (uint8_t)tolower((unsigned char)*query++);
+		hash *= 16777619U;
 	}
-	k_mutex_unlock(cache->lock);
 
-	return 0;
+	return hash;
 }
 
-int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinfo const *addrinfo,
-		  uint32_t ttl)
+static inline uint16_t *dns_cache_bucket(struct dns_cache const *cache, uint32_t hash)
 {
-	k_timepoint_t closest_to_expiry = sys_timepoint_calc(K_FOREVER);
-	size_t index_to_replace = 0;
-	bool found_empty = false;
+	return &cache->buckets[hash % cache->bucket_count];
+}
 
-	if (cache == NULL || query == NULL || addrinfo == NULL || ttl == 0) {
-		return -EINVAL;
+static inline bool entry_matches(const struct dns_cache_entry *entry, uint32_t hash,
+				 const char *query)
+{
+	return entry->hash == hash &&
+	       strncasecmp(entry->query, query, CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) == 0;
+}
+
+/* Needs to be called when lock is already acquired */
+static void entry_release(struct dns_cache const *cache, size_t index)
+{
+	struct dns_cache_entry *entry = &cache->entries[index];
+	uint16_t *link = dns_cache_bucket(cache, entry->hash);
+
+	while (*link != index + 1) {
+		link = &cache->entries[*link - 1].next;
 	}
 
+	*link = entry->next;
+	entry->in_use = false;
+}
+
+static int check_query_len(const char *query)
+{
 	if (strlen(query) >= CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) {
 		NET_WARN("Query string to big to be processed %u >= "
 			 "CONFIG_DNS_RESOLVER_MAX_QUERY_LEN",
@@ -41,12 +62,73 @@ int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinf
 		return -EINVAL;
 	}
 
+	return 0;
+}
+
+static int query_type_to_family(enum dns_query_type type, net_sa_family_t *family)
+{
+	if (type == DNS_QUERY_TYPE_A) {
+		*family = NET_AF_INET;
+	} else if (type == DNS_QUERY_TYPE_AAAA) {
+		*family = NET_AF_INET6;
+	} else {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Does the new entry make the cached one obsolete */
+static bool entry_superseded(const struct dns_cache_entry *entry, enum dns_cache_entry_type type,
+			     uint8_t family)
+{
+	if (type == DNS_CACHE_ENTRY_CNAME) {
+		/* There is only one CNAME record per name */
+		return entry->type == DNS_CACHE_ENTRY_CNAME;
+	}
+
+	if (entry->type == DNS_CACHE_ENTRY_CNAME || entry->data.ai_family != family) {
+		return false;
+	}
+
+	/* Negative entries replace all the addresses and the other way around,
+	 * new addresses also replace the ones being refreshed.
+	 */
+	return type == DNS_CACHE_ENTRY_NEGATIVE || entry->type == DNS_CACHE_ENTRY_NEGATIVE ||
+	       entry->refreshing;
+}
+
+static int dns_cache_store(struct dns_cache *cache, char const *query,
+			   enum dns_cache_entry_type type, struct dns_addrinfo const *data,
+			   uint32_t ttl)
+{
+	k_timepoint_t closest_to_expiry = sys_timepoint_calc(K_FOREVER);
+	size_t index_to_replace = 0;
+	bool found_empty = false;
+	struct dns_cache_entry *entry;
+	uint32_t hash;
+	uint16_t *link;
+	uint16_t next;
+
+	hash = dns_cache_hash(query);
+
 	k_mutex_lock(cache->lock, K_FOREVER);
 
 	NET_DBG("Add \"%s\" with TTL %" PRIu32, query, ttl);
 
 	dns_cache_clean(cache);
 
+	for (uint16_t idx = *dns_cache_bucket(cache, hash); idx != 0; idx = next) {
+		entry = &cache->entries[idx - 1];
+		next = entry->next;
+
+		if (entry_matches(entry, hash, query) &&
+		    entry_superseded(entry, type, data->ai_family)) {
+			NET_DBG("Replace \"%s\"", entry->query);
+			entry_release(cache, idx - 1);
+		}
+	}
+
 	for (size_t i = 0; i < cache->size; i++) {
 		if (!cache->entries[i].in_use) {
 			index_to_replace = i;
@@ -58,42 +140,138 @@ int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinf
 		}
 	}
 
+	entry = &cache->entries[index_to_replace];
+
 	if (!found_empty) {
-		NET_DBG("Overwrite \"%s\"", cache->entries[index_to_replace].query);
+		NET_DBG("Overwrite \"%s\"", entry->query);
+		entry_release(cache, index_to_replace);
 	}
 
-	strncpy(cache->entries[index_to_replace].query, query,
-		CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1);
-	cache->entries[index_to_replace].data = *addrinfo;
-	cache->entries[index_to_replace].expiry = sys_timepoint_calc(K_SECONDS(ttl));
-	cache->entries[index_to_replace].in_use = true;
+	strncpy(entry->query, query, CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1);
+	entry->query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1] = '\0';
+	entry->data = *data;
+	entry->expiry = sys_timepoint_calc(K_SECONDS(ttl));
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	entry->refresh = sys_timepoint_calc(
+		K_MSEC((uint64_t)ttl * MSEC_PER_SEC *
+		       (100 - CONFIG_DNS_RESOLVER_CACHE_PREFETCH_PERCENT) / 100));
+#endif
+	entry->hash = hash;
+	entry->type = type;
+	entry->refreshing = false;
+	entry->in_use = true;
+
+	link = dns_cache_bucket(cache, hash);
+	entry->next = *link;
+	*link = index_to_replace + 1;
 
 	k_mutex_unlock(cache->lock);
 
 	return 0;
 }
 
+int dns_cache_flush(struct dns_cache *cache)
+{
+	k_mutex_lock(cache->lock, K_FOREVER);
+	for (size_t i = 0; i < cache->size; i++) {
+		cache->entries[i].in_use = false;
+	}
+	memset(cache->buckets, 0, cache->bucket_count * sizeof(cache->buckets[0]));
+	k_mutex_unlock(cache->lock);
+
+	return 0;
+}
+
+int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinfo const *addrinfo,
+		  uint32_t ttl)
+{
+	if (cache == NULL || query == NULL || addrinfo == NULL || ttl == 0) {
+		return -EINVAL;
+	}
+
+	if (check_query_len(query) < 0) {
+		return -EINVAL;
+	}
+
+	return dns_cache_store(cache, query, DNS_CACHE_ENTRY_DATA, addrinfo, ttl);
+}
+
+int dns_cache_add_negative(struct dns_cache *cache, char const *query,
+			   enum dns_query_type type, uint32_t ttl)
+{
+	struct dns_addrinfo data = {0};
+	net_sa_family_t family;
+
+	if (cache == NULL || query == NULL) {
+		return -EINVAL;
+	}
+
+	if (query_type_to_family(type, &family) < 0 || check_query_len(query) < 0) {
+		return -EINVAL;
+	}
+
+	ttl = MIN(ttl, CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL_MAX);
+	if (ttl == 0) {
+		return -EINVAL;
+	}
+
+	data.ai_family = family;
+
+	return dns_cache_store(cache, query, DNS_CACHE_ENTRY_NEGATIVE, &data, ttl);
+}
+
+int dns_cache_add_cname(struct dns_cache *cache, char const *alias, char const *target,
+			uint32_t ttl)
+{
+	struct dns_addrinfo data = {0};
+	size_t len;
+
+	if (cache == NULL || alias == NULL || target == NULL || ttl == 0) {
+		return -EINVAL;
+	}
+
+	if (check_query_len(alias) < 0 || check_query_len(target) < 0) {
+		return -EINVAL;
+	}
+
+	len = strlen(target);
+	if (len > DNS_MAX_NAME_SIZE) {
+		return -EINVAL;
+	}
+
+	data.ai_family = NET_AF_LOCAL;
+	data.ai_addrlen = len;
+	memcpy(data.ai_canonname, target, len);
+	data.ai_canonname[len] = '\0';
+
+	return dns_cache_store(cache, alias, DNS_CACHE_ENTRY_CNAME, &data, ttl);
+}
+
 int dns_cache_remove(struct dns_cache *cache, char const *query)
 {
+	uint32_t hash;
+	uint16_t next;
+
 	if (cache == NULL || query == NULL) {
 		return -EINVAL;
 	}
 
 	NET_DBG("Remove all entries with query \"%s\"", query);
-	if (strlen(query) >= CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) {
-		NET_WARN("Query string to big to be processed %u >= "
-			 "CONFIG_DNS_RESOLVER_MAX_QUERY_LEN",
-			 strlen(query));
+	if (check_query_len(query) < 0) {
 		return -EINVAL;
 	}
 
+	hash = dns_cache_hash(query);
+
 	k_mutex_lock(cache->lock, K_FOREVER);
 
 	dns_cache_clean(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (cache->entries[i].in_use && strcmp(cache->entries[i].query, query) == 0) {
-			cache->entries[i].in_use = false;
+	for (uint16_t idx = *dns_cache_bucket(cache, hash); idx != 0; idx = next) {
+		next = cache->entries[idx - 1].next;
+
+		if (entry_matches(&cache->entries[idx - 1], hash, query)) {
+			entry_release(cache, idx - 1);
 		}
 	}
 
@@ -102,53 +280,123 @@ int dns_cache_remove(struct dns_cache *cache, char const *query)
 	return 0;
 }
 
-int dns_cache_find(struct dns_cache const *cache, const char *query, enum dns_query_type type,
-		   struct dns_addrinfo *addrinfo, size_t addrinfo_array_len)
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+/* Needs to be called when lock is already acquired */
+static void mark_refreshing(struct dns_cache const *cache, const char *query, uint8_t family)
+{
+	uint32_t hash = dns_cache_hash(query);
+
+	for (uint16_t idx = *dns_cache_bucket(cache, hash); idx != 0;
+	     idx = cache->entries[idx - 1].next) {
+		struct dns_cache_entry *entry = &cache->entries[idx - 1];
+
+		if (entry_matches(entry, hash, query) &&
+		    (entry->type == DNS_CACHE_ENTRY_CNAME || entry->data.ai_family == family)) {
+			entry->refreshing = true;
+		}
+	}
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
+int dns_cache_lookup(struct dns_cache const *cache, const char *query, enum dns_query_type type,
+		     struct dns_addrinfo *addrinfo, size_t addrinfo_array_len, bool *refresh)
 {
+	const char *names[CONFIG_DNS_RESOLVER_CACHE_CNAME_DEPTH + 1];
+	size_t name_count = 0;
 	size_t found = 0;
+	bool negative = false;
+	bool due = false;
 	net_sa_family_t family;
 
 	NET_DBG("Find \"%s\"", query);
 	if (cache == NULL || query == NULL || addrinfo == NULL || addrinfo_array_len <= 0) {
 		return -EINVAL;
 	}
-	if (type == DNS_QUERY_TYPE_A) {
-		family = NET_AF_INET;
-	} else if (type == DNS_QUERY_TYPE_AAAA) {
-		family = NET_AF_INET6;
-	} else {
+	if (query_type_to_family(type, &family) < 0) {
 		return -EINVAL;
 	}
-	if (strlen(query) >= CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) {
-		NET_WARN("Query string to big to be processed %u >= "
-			 "CONFIG_DNS_RESOLVER_MAX_QUERY_LEN",
-			 strlen(query));
+	if (check_query_len(query) < 0) {
 		return -EINVAL;
 	}
 
-	k_mutex_lock(cache->lock, K_FOREVER);
+	if (refresh != NULL) {
+		*refresh = false;
+	}
 
-	dns_cache_clean(cache);
+	k_mutex_lock(cache->lock, K_FOREVER);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
-			continue;
+	/* The names stay valid while the lock is held even if their
+	 * entries expire on the way, released entries are not cleared.
+	 */
+	names[0] = query;
+
+	while (name_count < ARRAY_SIZE(names)) {
+		const char *name = names[name_count++];
+		const char *cname = NULL;
+		uint32_t hash = dns_cache_hash(name);
+		uint16_t next;
+
+		for (uint16_t idx = *dns_cache_bucket(cache, hash); idx != 0; idx = next) {
+			struct dns_cache_entry *entry = &cache->entries[idx - 1];
+
+			next = entry->next;
+
+			if (sys_timepoint_expired(entry->expiry)) {
+				NET_DBG("Remove \"%s\"", entry->query);
+				entry_release(cache, idx - 1);
+				continue;
+			}
+
+			if (!entry_matches(entry, hash, name)) {
+				continue;
+			}
+
+			if (entry->type == DNS_CACHE_ENTRY_CNAME) {
+				cname = entry->data.ai_canonname;
+			} else if (entry->data.ai_family != family) {
+				continue;
+			} else if (entry->type == DNS_CACHE_ENTRY_NEGATIVE) {
+				negative = true;
+				continue;
+			} else if (found >= addrinfo_array_len) {
+				NET_WARN("Found \"%s\" but not enough space in provided buffer.",
+					 query);
+				found++;
+			} else {
+				addrinfo[found] = entry->data;
+				found++;
+				NET_DBG("Found \"%s\"", query);
+			}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+			if (!entry->refreshing && sys_timepoint_expired(entry->refresh)) {
+				due = true;
+			}
+#endif
 		}
-		if (strcmp(cache->entries[i].query, query) != 0) {
-			continue;
+
+		if (found > 0 || negative || cname == NULL) {
+			break;
 		}
-		if (cache->entries[i].data.ai_family != family) {
-			continue;
+
+		NET_DBG("\"%s\" is an alias of \"%s\"", name, cname);
+
+		if (name_count < ARRAY_SIZE(names)) {
+			names[name_count] = cname;
 		}
-		if (found >= addrinfo_array_len) {
-			NET_WARN("Found \"%s\" but not enough space in provided buffer.", query);
-			found++;
-		} else {
-			addrinfo[found] = cache->entries[i].data;
-			found++;
-			NET_DBG("Found \"%s\"", query);
+	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	if (due && found > 0 && refresh != NULL) {
+		for (size_t i = 0; i < name_count; i++) {
+			mark_refreshing(cache, names[i], family);
 		}
+
+		*refresh = true;
 	}
+#else
+	ARG_UNUSED(due);
+#endif
 
 	k_mutex_unlock(cache->lock);
 
@@ -157,11 +405,22 @@ int dns_cache_find(struct dns_cache const *cache, const char *query, enum dns_qu
 	}
 
 	if (found == 0) {
+		if (negative) {
+			NET_DBG("\"%s\" has no addresses", query);
+			return -ENODATA;
+		}
+
 		NET_DBG("Could not find \"%s\"", query);
 	}
 	return found;
 }
 
+int dns_cache_find(struct dns_cache const *cache, const char *query, enum dns_query_type type,
+		   struct dns_addrinfo *addrinfo, size_t addrinfo_array_len)
+{
+	return dns_cache_lookup(cache, query, type, addrinfo, addrinfo_array_len, NULL);
+}
+
 /* Needs to be called when lock is already acquired */
 static void dns_cache_clean(struct dns_cache const *cache)
 {
@@ -172,7 +431,7 @@ static void dns_cache_clean(struct dns_cache const *cache)
 
 		if (sys_timepoint_expired(cache->entries[i].expiry)) {
 			NET_DBG("Remove \"%s\"", cache->entries[i].query);
-			cache->entries[i].in_use = false;
+			entry_release(cache, i);
 		}
 	}
 }
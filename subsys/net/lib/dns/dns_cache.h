@@ -14,20 +14,42 @@
 #define ZEPHYR_INCLUDE_NET_DNS_CACHE_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <zephyr/net/dns_resolve.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys_clock.h>
 
+/** Kind of data held by a cache entry */
+enum dns_cache_entry_type {
+	/** Record data returned to the application */
+	DNS_CACHE_ENTRY_DATA,
+	/** The name has no records of the address family (RFC 2308) */
+	DNS_CACHE_ENTRY_NEGATIVE,
+	/** The name is an alias, data.ai_canonname holds the target */
+	DNS_CACHE_ENTRY_CNAME,
+};
+
 struct dns_cache_entry {
 	char query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN];
 	struct dns_addrinfo data;
 	k_timepoint_t expiry;
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	k_timepoint_t refresh;
+#endif
+	uint32_t hash;
+	/* Next entry in the same hash bucket, index + 1 or 0 at the end */
+	uint16_t next;
+	uint8_t type;
+	bool refreshing;
 	bool in_use;
 };
 
 struct dns_cache {
 	size_t size;
+	size_t bucket_count;
 	struct dns_cache_entry *entries;
+	/* First entry of each hash bucket, index + 1 or 0 if empty */
+	uint16_t *buckets;
 	struct k_mutex *lock;
 };
 
@@ -41,10 +63,14 @@ struct dns_cache {
  * @param name Name of the cache.
  */
 #define DNS_CACHE_DEFINE(name, cache_size)                                                         \
+	BUILD_ASSERT((cache_size) > 0 && (cache_size) < UINT16_MAX);                               \
 	static K_MUTEX_DEFINE(name##_mutex);                                                       \
 	static struct dns_cache_entry name##_entries[cache_size];                                  \
+	static uint16_t name##_buckets[cache_size];                                                \
 	static struct dns_cache name = {                                                           \
-		.entries = name##_entries, .size = cache_size, .lock = &name##_mutex};
+		.entries = name##_entries, .size = cache_size,                                     \
+		.buckets = name##_buckets, .bucket_count = cache_size,                             \
+		.lock = &name##_mutex};
 
 /**
  * @brief Flushes the dns cache removing all its entries.
@@ -81,9 +107,46 @@ int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinf
  */
 int dns_cache_remove(struct dns_cache *cache, char const *query);
 
+/**
+ * @brief Adds a negative entry to the dns cache.
+ *
+ * A negative entry records that the query has no addresses of the given
+ * type, as told by a NXDOMAIN or NODATA answer (RFC 2308). It replaces the
+ * cached addresses of that type.
+ *
+ * @param cache Cache where the entry should be added.
+ * @param query Query which should be persisted in the cache.
+ * @param type Query type which got the negative answer.
+ * @param ttl Time to live for the entry in seconds, capped to
+ * CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL_MAX.
+ * @retval 0 on success
+ * @retval On error, a negative value is returned.
+ */
+int dns_cache_add_negative(struct dns_cache *cache, char const *query,
+			   enum dns_query_type type, uint32_t ttl);
+
+/**
+ * @brief Adds a CNAME entry to the dns cache.
+ *
+ * Lookups of @p alias continue with @p target, so the addresses of a name
+ * are cached once and shared by all of its aliases.
+ *
+ * @param cache Cache where the entry should be added.
+ * @param alias Name of the CNAME record.
+ * @param target Canonical name the alias points to.
+ * @param ttl Time to live for the entry in seconds.
+ * @retval 0 on success
+ * @retval On error, a negative value is returned.
+ */
+int dns_cache_add_cname(struct dns_cache *cache, char const *alias, char const *target,
+			uint32_t ttl);
+
 /**
  * @brief Tries to find the specified query entry within the cache.
  *
+ * CNAME entries are followed, at most CONFIG_DNS_RESOLVER_CACHE_CNAME_DEPTH
+ * of them.
+ *
  * @param cache Cache where the entry should be searched.
  * @param query Query which should be searched for.
  * @param type Query type which will control the types of addresses that will be found.
@@ -94,8 +157,30 @@ int dns_cache_remove(struct dns_cache *cache, char const *query);
  * @retval On error a negative value is returned.
  * -ENOSR means there was not enough space in the addrinfo array to accommodate all cache hits the
  * array will however be filled with valid data.
+ * -ENODATA means a negative entry was found, the query is known to have no
+ * addresses of the given type.
  */
 int dns_cache_find(struct dns_cache const *cache, const char *query, enum dns_query_type type,
 		   struct dns_addrinfo *addrinfo, size_t addrinfo_array_len);
 
+/**
+ * @brief Tries to find the specified query entry and tells if it should be refreshed.
+ *
+ * Same as dns_cache_find(), but @p refresh is set to true when the found
+ * entries are close to expiry (CONFIG_DNS_RESOLVER_CACHE_PREFETCH_PERCENT of
+ * their TTL left). The entries are then marked as being refreshed so that
+ * only one caller is told to do it, and the entries added by the refresh
+ * replace them.
+ *
+ * @param cache Cache where the entry should be searched.
+ * @param query Query which should be searched for.
+ * @param type Query type which will control the types of addresses that will be found.
+ * @param addrinfo dns_addrinfo array which will be written if the query was found.
+ * @param addrinfo_array_len Array size of the dns_addrinfo array
+ * @param refresh Set to true if the caller should query @p query again.
+ * @return Same as dns_cache_find().
+ */
+int dns_cache_lookup(struct dns_cache const *cache, const char *query, enum dns_query_type type,
+		     struct dns_addrinfo *addrinfo, size_t addrinfo_array_len, bool *refresh);
+
 #endif /* ZEPHYR_INCLUDE_NET_DNS_CACHE_H_ */
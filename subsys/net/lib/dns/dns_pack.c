@@ -191,6 +191,58 @@ int dns_unpack_answer(struct dns_msg_t *dns_msg, int dname_ptr, uint32_t *ttl,
 	return 0;
 }
 
+int dns_unpack_negative_ttl(struct dns_msg_t *dns_msg, uint32_t *ttl)
+{
+	uint16_t offset = dns_msg->answer_offset;
+	uint32_t minimum;
+	uint8_t *rr;
+	int dname_len;
+	int rdlength;
+
+	for (int i = 0; i < dns_header_nscount(dns_msg->msg); i++) {
+		if (offset >= dns_msg->msg_size) {
+			return -EINVAL;
+		}
+
+		rr = dns_msg->msg + offset;
+
+		dname_len = skip_fqdn(rr, dns_msg->msg_size - offset);
+		if (dname_len < 0) {
+			return dname_len;
+		}
+
+		/* type + class + ttl + rdlength, see dns_unpack_answer() */
+		if (dns_msg->msg_size - offset - dname_len < 2 + 2 + 4 + 2) {
+			return -EINVAL;
+		}
+
+		rdlength = dns_answer_rdlength(dname_len, rr);
+		offset += dname_len + DNS_COMMON_UINT_SIZE + DNS_COMMON_UINT_SIZE +
+			  DNS_TTL_LEN + DNS_RDLENGTH_LEN;
+
+		if (offset + rdlength > dns_msg->msg_size) {
+			return -EINVAL;
+		}
+
+		if (dns_answer_type(dname_len, rr) == DNS_RR_TYPE_SOA) {
+			/* MINIMUM is the last field of the SOA RDATA */
+			if (rdlength < DNS_TTL_LEN) {
+				return -EINVAL;
+			}
+
+			minimum = net_ntohl(UNALIGNED_GET((uint32_t *)(dns_msg->msg + offset +
+								       rdlength - DNS_TTL_LEN)));
+			*ttl = MIN((uint32_t)dns_answer_ttl(dname_len, rr), minimum);
+
+			return 0;
+		}
+
+		offset += rdlength;
+	}
+
+	return -ENOENT;
+}
+
 int dns_unpack_response_header(struct dns_msg_t *msg, int src_id)
 {
 	uint8_t *dns_header;
@@ -89,6 +89,7 @@ enum dns_rr_type {
 	DNS_RR_TYPE_INVALID = 0,
 	DNS_RR_TYPE_A	= 1,		/* IPv4  */
 	DNS_RR_TYPE_CNAME = 5,		/* CNAME */
+	DNS_RR_TYPE_SOA = 6,		/* SOA   */
 	DNS_RR_TYPE_PTR = 12,		/* PTR   */
 	DNS_RR_TYPE_TXT = 16,		/* TXT   */
 	DNS_RR_TYPE_AAAA = 28,		/* IPv6  */
@@ -367,6 +368,22 @@ int dns_msg_pack_qname(uint16_t *len, uint8_t *buf, uint16_t size,
 int dns_unpack_answer(struct dns_msg_t *dns_msg, int dname_ptr, uint32_t *ttl,
 		      enum dns_rr_type *type);
 
+/**
+ * @brief Gets the negative caching TTL of a response having no answers
+ *
+ * Searches the authority section for the SOA record, the TTL is the
+ * smaller of the SOA record TTL and its MINIMUM field (RFC 2308, 5).
+ * The answer section of the response must be empty.
+ *
+ * @param dns_msg Structure, the answer_offset must point to the
+ *        authority section.
+ * @param ttl Negative caching TTL.
+ * @retval 0 on success
+ * @retval -ENOENT if there is no SOA record in the authority section
+ * @retval -EINVAL if the message is malformed
+ */
+int dns_unpack_negative_ttl(struct dns_msg_t *dns_msg, uint32_t *ttl);
+
 /**
  * @brief Unpacks the header's response.
  *
@@ -18,6 +18,7 @@ LOG_MODULE_REGISTER(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #include <zephyr/types.h>
 #include <zephyr/random/random.h>
 #include <string.h>
+#include <strings.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <ctype.h>
@@ -80,8 +81,23 @@ NET_BUF_POOL_DEFINE(dns_qname_pool, DNS_RESOLVER_BUF_CTR,
 
 #ifdef CONFIG_DNS_RESOLVER_CACHE
 DNS_CACHE_DEFINE(dns_cache, CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES);
+
+/* Names of the CNAME chain being cached while a response is processed */
+NET_BUF_POOL_DEFINE(dns_cache_name_pool, 2,
+		    CONFIG_DNS_RESOLVER_MAX_QUERY_LEN,
+		    0, NULL);
 #endif /* CONFIG_DNS_RESOLVER_CACHE */
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+#define DNS_PREFETCH_TIMEOUT_MS (5 * MSEC_PER_SEC)
+
+/* One cache entry is refreshed at a time. The query only keeps a pointer
+ * to its name so the name is copied here.
+ */
+static char dns_prefetch_query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN];
+static atomic_t dns_prefetch_busy;
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
 static K_MUTEX_DEFINE(lock);
 static struct dns_resolve_context dns_default_ctx;
 
@@ -1263,6 +1279,100 @@ static int dns_validate_record(struct dns_resolve_context *ctx, struct dns_msg_t
 	return 0;
 }
 
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+/* Cache a NXDOMAIN or NODATA answer (RFC 2308), must be called for
+ * responses having an empty answer section.
+ */
+static void cache_negative_answer(struct dns_resolve_context *ctx,
+				  struct dns_msg_t *dns_msg,
+				  uint16_t dns_id, int query_idx,
+				  uint16_t query_hash)
+{
+	int rcode = dns_header_rcode(dns_msg->msg);
+	enum dns_query_type type;
+	uint32_t ttl;
+
+	if (rcode != DNS_HEADER_NOERROR && rcode != DNS_HEADER_NAMEERROR) {
+		return;
+	}
+
+	if (dns_unpack_response_query(dns_msg) < 0) {
+		return;
+	}
+
+	if (query_idx < 0 &&
+	    update_query_idx(ctx, dns_msg, &dns_id, &query_idx, &query_hash) < 0) {
+		return;
+	}
+
+	type = ctx->queries[query_idx].query_type;
+	if (type != DNS_QUERY_TYPE_A && type != DNS_QUERY_TYPE_AAAA) {
+		return;
+	}
+
+	/* Answers without SOA record are not cached, RFC 2308 chapter 5 */
+	if (dns_unpack_negative_ttl(dns_msg, &ttl) < 0) {
+		return;
+	}
+
+	NET_DBG("No %s records for \"%s\", TTL %" PRIu32,
+		type == DNS_QUERY_TYPE_A ? "A" : "AAAA",
+		ctx->queries[query_idx].query, ttl);
+
+	(void)dns_cache_add_negative(&dns_cache, ctx->queries[query_idx].query,
+				     type, ttl);
+}
+
+/* Cache the CNAME record at rr_offset if it continues the alias chain
+ * ending at cache_name. The records following it are then cached under
+ * the canonical name, which is kept in the target buffer.
+ */
+static void cache_cname(struct dns_resolve_context *ctx,
+			struct dns_msg_t *dns_msg,
+			uint16_t rr_offset, uint32_t ttl,
+			const char **cache_name,
+			struct net_buf **target)
+{
+	struct net_buf *name;
+	int ret;
+
+	name = net_buf_alloc(&dns_cache_name_pool, ctx->buf_timeout);
+	if (name == NULL) {
+		return;
+	}
+
+	ret = dns_unpack_name(dns_msg->msg, dns_msg->msg_size,
+			      dns_msg->msg + rr_offset, name, NULL);
+	if (ret < 0 || strncasecmp((char *)name->data, *cache_name,
+				   CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) != 0) {
+		goto out;
+	}
+
+	net_buf_reset(name);
+
+	ret = dns_unpack_name(dns_msg->msg, dns_msg->msg_size,
+			      dns_msg->msg + dns_msg->response_position,
+			      name, NULL);
+	if (ret < 0) {
+		goto out;
+	}
+
+	(void)dns_cache_add_cname(&dns_cache, *cache_name, (char *)name->data, ttl);
+
+	if (*target != NULL) {
+		net_buf_unref(*target);
+	}
+
+	*target = name;
+	*cache_name = (char *)name->data;
+
+	return;
+
+out:
+	net_buf_unref(name);
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /* Unit test needs to be able to call this function */
 #if !defined(CONFIG_NET_TEST)
 static
@@ -1279,6 +1389,10 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 	int items;
 	int server_idx;
 	int ret = 0;
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+	const char *cache_name;
+	struct net_buf *cache_target = NULL;
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
 
 	/* Make sure that we can read DNS id, flags and rcode */
 	if (dns_msg->msg_size < (sizeof(*dns_id) + sizeof(uint16_t))) {
@@ -1325,6 +1439,10 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 	if (dns_header_ancount(dns_msg->msg) < 1) {
 		/* there are no useful records in this message */
 		if (*dns_id > 0) {
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+			cache_negative_answer(ctx, dns_msg, *dns_id, *query_idx,
+					      *query_hash);
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
 			ret = DNS_EAI_FAIL;
 			goto quit;
 		}
@@ -1377,7 +1495,15 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		}
 	}
 
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+	cache_name = ctx->queries[*query_idx].query;
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 	for (server_idx = 0; server_idx < dns_header_ancount(dns_msg->msg); server_idx++) {
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+		uint16_t rr_offset = dns_msg->answer_offset;
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 		ret = dns_validate_record(ctx, dns_msg, &info, &answer_type, &ttl);
 		if (ret < 0) {
 			goto quit;
@@ -1405,6 +1531,10 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 
 
 		if (answer_type == DNS_RR_TYPE_CNAME) {
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+			cache_cname(ctx, dns_msg, rr_offset, ttl, &cache_name,
+				    &cache_target);
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
 			/* Don't report CNAME records to the application, they're used internally
 			 * for query redirection.
 			 */
@@ -1418,8 +1548,7 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		case DNS_RESPONSE_SRV:
 		case DNS_RESPONSE_DATA:
 #ifdef CONFIG_DNS_RESOLVER_CACHE
-			dns_cache_add(&dns_cache,
-				ctx->queries[*query_idx].query, &info, ttl);
+			dns_cache_add(&dns_cache, cache_name, &info, ttl);
 #endif /* CONFIG_DNS_RESOLVER_CACHE */
 			items++;
 			break;
@@ -1479,6 +1608,12 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 	}
 
 quit:
+#ifdef CONFIG_DNS_RESOLVER_CACHE
+	if (cache_target != NULL) {
+		net_buf_unref(cache_target);
+	}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 	return ret;
 }
 
@@ -1831,6 +1966,59 @@ static void query_timeout(struct k_work *work)
 	k_mutex_unlock(&pending_query->ctx->lock);
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+static void dns_prefetch_cb(enum dns_resolve_status status,
+			    struct dns_addrinfo *info,
+			    void *user_data)
+{
+	ARG_UNUSED(info);
+	ARG_UNUSED(user_data);
+
+	/* The answers were added to the cache when they were received */
+	if (status != DNS_EAI_INPROGRESS) {
+		atomic_clear(&dns_prefetch_busy);
+	}
+}
+
+static inline bool dns_prefetch_idle(void)
+{
+	return !atomic_get(&dns_prefetch_busy);
+}
+
+/* Refresh a cache entry in the background */
+static void dns_prefetch(struct dns_resolve_context *ctx, const char *query,
+			 enum dns_query_type type, int32_t timeout)
+{
+	int ret;
+
+	if (!atomic_cas(&dns_prefetch_busy, 0, 1)) {
+		return;
+	}
+
+	strncpy(dns_prefetch_query, query, sizeof(dns_prefetch_query) - 1);
+
+	if (timeout == SYS_FOREVER_MS) {
+		timeout = DNS_PREFETCH_TIMEOUT_MS;
+	}
+
+	NET_DBG("Refresh \"%s\"", dns_prefetch_query);
+
+	ret = dns_resolve_name_internal(ctx, dns_prefetch_query, type, NULL,
+					dns_prefetch_cb, NULL, timeout, false);
+	if (ret < 0) {
+		NET_DBG("Cannot refresh \"%s\" (%d)", dns_prefetch_query, ret);
+		atomic_clear(&dns_prefetch_busy);
+	}
+}
+#else
+static inline bool dns_prefetch_idle(void)
+{
+	return false;
+}
+
+#define dns_prefetch(...)
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
 int dns_resolve_name_internal(struct dns_resolve_context *ctx,
 			      const char *query,
 			      enum dns_query_type type,
@@ -1914,8 +2102,11 @@ int dns_resolve_name_internal(struct dns_resolve_context *ctx,
 try_resolve:
 #ifdef CONFIG_DNS_RESOLVER_CACHE
 	if (use_cache) {
-		ret = dns_cache_find(&dns_cache, query, type, cached_info,
-				     ARRAY_SIZE(cached_info));
+		bool refresh = false;
+
+		ret = dns_cache_lookup(&dns_cache, query, type, cached_info,
+				       ARRAY_SIZE(cached_info),
+				       dns_prefetch_idle() ? &refresh : NULL);
 		if (ret > 0) {
 			/* The query was cached, no
 			 * need to continue further.
@@ -1926,6 +2117,19 @@ try_resolve:
 
 			cb(DNS_EAI_ALLDONE, NULL, user_data);
 
+			if (refresh) {
+				dns_prefetch(ctx, query, type, timeout);
+			}
+
+			return 0;
+		}
+
+		if (ret == -ENODATA) {
+			/* Cached negative answer, reported like the
+			 * answer received from the server.
+			 */
+			cb(DNS_EAI_FAIL, NULL, user_data);
+
 			return 0;
 		}
 	}
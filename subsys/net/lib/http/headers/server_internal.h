@@ -44,10 +44,72 @@ const char *http_compression_text(enum http_compression compression);
 int http_compression_from_text(enum http_compression *compression, const char *text);
 bool compression_value_is_valid(enum http_compression compression);
 
+/* Default initial window size of HTTP/2 flow control */
+#define HTTP2_DEFAULT_WINDOW_SIZE 65535
+
+/* Worker threads */
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+struct http_server_job {
+	struct k_work work;
+	struct http_client_ctx *client;
+	struct http2_stream_ctx *stream;
+	struct http_resource_detail_dynamic *detail;
+
+	/* Used for encoding the response headers, the one in the client
+	 * context belongs to the server thread.
+	 */
+	struct http_hpack_header_buf header_field;
+
+	IF_ENABLED(CONFIG_HTTP_SERVER_CAPTURE_HEADERS,
+		   (struct http_header_capture_ctx header_capture_ctx;))
+
+	size_t params_len;
+	uint8_t params[HTTP_SERVER_MAX_URL_LENGTH];
+};
+
+void http_server_workers_client_init(struct http_client_ctx *client);
+bool http_server_workers_client_release(struct http_client_ctx *client);
+void http_server_workers_client_wait(struct http_client_ctx *client);
+bool http_server_workers_client_busy(struct http_client_ctx *client);
+struct http_server_job *http_server_job_alloc(struct http_client_ctx *client);
+void http_server_job_submit(struct http_server_job *job, k_work_handler_t handler);
+void http_server_job_free(struct http_server_job *job);
+void http_server_wakeup(void);
+#endif /* CONFIG_HTTP_SERVER_WORKERS */
+
+/* Static file system resource cache */
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+/* ETag in the form of "0123abcd", with the quotes */
+#define HTTP_SERVER_ETAG_LEN 10
+
+struct http_static_fs_cache_entry {
+	char fname[HTTP_SERVER_MAX_URL_LENGTH];
+	uint8_t *data;
+	size_t size;
+	uint32_t etag;
+	uint32_t last_used;
+	/* Number of responses being sent from the entry */
+	int users;
+};
+
+struct http_static_fs_cache_entry *http_server_cache_get(const char *fname, size_t file_size);
+void http_server_cache_put(struct http_static_fs_cache_entry *entry);
+void http_server_cache_reset_request(struct http_client_ctx *client);
+void http_server_cache_parse_if_none_match(struct http_client_ctx *client, const char *value,
+					   size_t len);
+void http_server_cache_parse_range(struct http_client_ctx *client, const char *value, size_t len);
+bool http_server_cache_not_modified(const struct http_client_ctx *client,
+				    const struct http_static_fs_cache_entry *entry);
+int http_server_cache_range(const struct http_client_ctx *client, size_t size, size_t *offset,
+			    size_t *len);
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS_CACHE */
+
 /* Others */
 struct http_resource_detail *get_resource_detail(const struct http_service_desc *service,
 						 const char *path, int *len, bool is_ws);
 int http_server_sendall(struct http_client_ctx *client, const void *buf, size_t len);
+struct fs_file_t;
+int http_server_sendfile(struct http_client_ctx *client, struct fs_file_t *file, size_t len);
 void http_server_get_content_type_from_extension(char *url, char *content_type,
 						 size_t content_type_size);
 int http_server_find_file(char *fname, size_t fname_size, size_t *file_size,
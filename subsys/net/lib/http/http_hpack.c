@@ -465,7 +465,7 @@ static int hpack_integer_encode(uint8_t *buf, size_t buflen, int value,
 			return -ENOBUFS;
 		}
 
-		*buf = (uint8_t)((value % 128) + 128);
+		*buf++ = (uint8_t)((value % 128) + 128);
 		len++;
 		value /= 128;
 	}
@@ -487,6 +487,7 @@ static int hpack_string_encode(uint8_t *buf, size_t buflen,
 	int ret, len = 0;
 	const char *str;
 	size_t str_len;
+	size_t encoded_len;
 	uint8_t prefix = 0;
 
 	if (type == HPACK_HEADER_NAME) {
@@ -497,18 +498,16 @@ static int hpack_string_encode(uint8_t *buf, size_t buflen,
 		str_len = header->value_len;
 	}
 
-	/* Try to encode string into intermediate buffer. */
-	ret = http_hpack_huffman_encode(str, str_len, header->buf,
-					sizeof(header->buf));
-	if (ret > 0 && ret < str_len) {
-		/* Use Huffman encoded string only if smaller than the original. */
-		str = header->buf;
-		str_len = ret;
+	/* Use Huffman encoded string only if smaller than the original. */
+	encoded_len = http_hpack_huffman_encoded_len(str, str_len);
+	if (encoded_len < str_len) {
 		prefix = HPACK_STRING_HUFFMAN_FLAG;
+	} else {
+		encoded_len = str_len;
 	}
 
 	/* Encode string length. */
-	ret = hpack_integer_encode(buf, buflen, str_len, prefix,
+	ret = hpack_integer_encode(buf, buflen, encoded_len, prefix,
 				   HPACK_STRING_PREFIX_LEN);
 	if (ret < 0) {
 		return ret;
@@ -518,25 +517,32 @@ static int hpack_string_encode(uint8_t *buf, size_t buflen,
 	buflen -= ret;
 	len += ret;
 
-	/* Copy string. */
-	if (str_len > buflen) {
+	if (encoded_len > buflen) {
 		return -ENOBUFS;
 	}
 
-	memcpy(buf, str, str_len);
-	len += str_len;
+	/* Encode straight into the output buffer, the length is known. */
+	if (prefix == HPACK_STRING_HUFFMAN_FLAG) {
+		ret = http_hpack_huffman_encode(str, str_len, buf, buflen);
+		if (ret < 0) {
+			return ret;
+		}
+	} else {
+		memcpy(buf, str, str_len);
+	}
+
+	len += encoded_len;
 
 	return len;
 }
 
-static int hpack_encode_literal(uint8_t *buf, size_t buflen,
+static int hpack_encode_literal(uint8_t *buf, size_t buflen, int index,
+				uint8_t prefix, uint8_t prefix_len,
 				struct http_hpack_header_buf *header)
 {
 	int ret, len = 0;
 
-	ret = hpack_integer_encode(buf, buflen, 0,
-				   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
-				   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED);
+	ret = hpack_integer_encode(buf, buflen, index, prefix, prefix_len);
 	if (ret < 0) {
 		return ret;
 	}
@@ -545,14 +551,17 @@ static int hpack_encode_literal(uint8_t *buf, size_t buflen,
 	buflen -= ret;
 	len += ret;
 
-	ret = hpack_string_encode(buf, buflen, HPACK_HEADER_NAME, header);
-	if (ret < 0) {
-		return ret;
-	}
+	if (index == 0) {
+		/* Literal name. */
+		ret = hpack_string_encode(buf, buflen, HPACK_HEADER_NAME, header);
+		if (ret < 0) {
+			return ret;
+		}
 
-	buf += ret;
-	buflen -= ret;
-	len += ret;
+		buf += ret;
+		buflen -= ret;
+		len += ret;
+	}
 
 	ret = hpack_string_encode(buf, buflen, HPACK_HEADER_VALUE, header);
 	if (ret < 0) {
@@ -564,43 +573,170 @@ static int hpack_encode_literal(uint8_t *buf, size_t buflen,
 	return len;
 }
 
-static int hpack_encode_literal_value(uint8_t *buf, size_t buflen, int index,
-				      struct http_hpack_header_buf *header)
+static int hpack_encode_indexed(uint8_t *buf, size_t buflen, int index)
 {
-	int ret, len = 0;
+	return hpack_integer_encode(buf, buflen, index, HPACK_PREFIX_INDEXED,
+				    HPACK_PREFIX_LEN_INDEXED);
+}
 
-	ret = hpack_integer_encode(buf, buflen, index,
-				   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
-				   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED);
-	if (ret < 0) {
-		return ret;
+#define HPACK_DYNAMIC_TABLE_FIRST_INDEX (HTTP_SERVER_HPACK_WWW_AUTHENTICATE + 1)
+
+void http_hpack_encoder_init(struct http_hpack_encoder *encoder)
+{
+	encoder->used = 0;
+	encoder->size = 0;
+	encoder->count = 0;
+	encoder->size_update = false;
+
+	/* Start with the peer's default of 4096 bytes, or less. Using less
+	 * than the decoder allows needs no signaling.
+	 */
+	encoder->max_size = sizeof(encoder->buf);
+}
+
+void http_hpack_encoder_reset(struct http_hpack_encoder *encoder)
+{
+	/* Forgetting the entries is always safe, the decoder keeps them
+	 * until they are evicted, but they are no longer referred to.
+	 * The header block that failed might have carried the size update.
+	 */
+	encoder->used = 0;
+	encoder->size = 0;
+	encoder->count = 0;
+	encoder->size_update = true;
+}
+
+static void hpack_dynamic_evict(struct http_hpack_encoder *encoder)
+{
+	struct http_hpack_encoder_entry *oldest = &encoder->entries[0];
+	size_t len = oldest->name_len + oldest->value_len;
+
+	encoder->size -= len + HTTP_HPACK_ENTRY_OVERHEAD;
+	encoder->used -= len;
+	encoder->count--;
+
+	memmove(encoder->buf, encoder->buf + len, encoder->used);
+	memmove(&encoder->entries[0], &encoder->entries[1],
+		encoder->count * sizeof(encoder->entries[0]));
+
+	for (int i = 0; i < encoder->count; i++) {
+		encoder->entries[i].offset -= len;
 	}
+}
 
-	buf += ret;
-	buflen -= ret;
-	len += ret;
+void http_hpack_encoder_set_max_size(struct http_hpack_encoder *encoder, uint32_t max_size)
+{
+	max_size = MIN(max_size, sizeof(encoder->buf));
+	if (max_size == encoder->max_size) {
+		return;
+	}
 
-	ret = hpack_string_encode(buf, buflen, HPACK_HEADER_VALUE, header);
-	if (ret < 0) {
-		return ret;
+	encoder->max_size = max_size;
+	encoder->size_update = true;
+
+	while (encoder->size > encoder->max_size) {
+		hpack_dynamic_evict(encoder);
 	}
+}
 
-	len += ret;
+static void hpack_dynamic_insert(struct http_hpack_encoder *encoder,
+				 struct http_hpack_header_buf *header)
+{
+	size_t len = header->name_len + header->value_len;
+	struct http_hpack_encoder_entry *entry;
 
-	return len;
+	/* Based on RFC7541, ch 4.4. */
+	while (encoder->count > 0 &&
+	       encoder->size + len + HTTP_HPACK_ENTRY_OVERHEAD > encoder->max_size) {
+		hpack_dynamic_evict(encoder);
+	}
+
+	entry = &encoder->entries[encoder->count++];
+	entry->offset = encoder->used;
+	entry->name_len = header->name_len;
+	entry->value_len = header->value_len;
+
+	memcpy(encoder->buf + encoder->used, header->name, header->name_len);
+	encoder->used += header->name_len;
+	memcpy(encoder->buf + encoder->used, header->value, header->value_len);
+	encoder->used += header->value_len;
+	encoder->size += len + HTTP_HPACK_ENTRY_OVERHEAD;
 }
 
-static int hpack_encode_indexed(uint8_t *buf, size_t buflen, int index)
+static int hpack_dynamic_find_index(struct http_hpack_encoder *encoder,
+				    struct http_hpack_header_buf *header,
+				    bool *name_only)
 {
-	return hpack_integer_encode(buf, buflen, index, HPACK_PREFIX_INDEXED,
-				    HPACK_PREFIX_LEN_INDEXED);
+	const struct http_hpack_encoder_entry *entry;
+	int candidate = -1;
+
+	/* The newest entry has the lowest index. */
+	for (int i = encoder->count - 1; i >= 0; i--) {
+		int index = HPACK_DYNAMIC_TABLE_FIRST_INDEX + encoder->count - 1 - i;
+
+		entry = &encoder->entries[i];
+
+		if (entry->name_len != header->name_len ||
+		    memcmp(encoder->buf + entry->offset, header->name,
+			   header->name_len) != 0) {
+			continue;
+		}
+
+		if (entry->value_len == header->value_len &&
+		    memcmp(encoder->buf + entry->offset + entry->name_len,
+			   header->value, header->value_len) == 0) {
+			*name_only = false;
+			return index;
+		}
+
+		if (candidate < 0) {
+			candidate = index;
+		}
+	}
+
+	if (candidate > 0) {
+		*name_only = true;
+		return candidate;
+	}
+
+	return -ENOENT;
 }
 
-int http_hpack_encode_header(uint8_t *buf, size_t buflen,
-			     struct http_hpack_header_buf *header)
+static bool hpack_header_indexable(struct http_hpack_encoder *encoder, int index,
+				   struct http_hpack_header_buf *header)
+{
+	if (header->name_len + header->value_len + HTTP_HPACK_ENTRY_OVERHEAD >
+	    encoder->max_size) {
+		return false;
+	}
+
+	/* Values that change with every response would only push the
+	 * reusable entries out of the table, and the credentials must not
+	 * be indexed at all.
+	 */
+	switch (index) {
+	case HTTP_SERVER_HPACK_AGE:
+	case HTTP_SERVER_HPACK_AUTHORIZATION:
+	case HTTP_SERVER_HPACK_CONTENT_LENGTH:
+	case HTTP_SERVER_HPACK_CONTENT_RANGE:
+	case HTTP_SERVER_HPACK_DATE:
+	case HTTP_SERVER_HPACK_ETAG:
+	case HTTP_SERVER_HPACK_EXPIRES:
+	case HTTP_SERVER_HPACK_LAST_MODIFIED:
+	case HTTP_SERVER_HPACK_PROXY_AUTHORIZATION:
+	case HTTP_SERVER_HPACK_SET_COOKIE:
+		return false;
+	default:
+		return true;
+	}
+}
+
+int http_hpack_encoder_encode_header(struct http_hpack_encoder *encoder, uint8_t *buf,
+				     size_t buflen, struct http_hpack_header_buf *header)
 {
 	int ret, len = 0;
 	bool name_only;
+	int index;
 
 	if (buf == NULL || header == NULL ||
 	    header->name == NULL || header->name_len == 0 ||
@@ -612,17 +748,71 @@ int http_hpack_encode_header(uint8_t *buf, size_t buflen,
 		return -ENOBUFS;
 	}
 
-	ret = http_hpack_find_index(header, &name_only);
-	if (ret < 0) {
-		/* All literal */
-		len = hpack_encode_literal(buf, buflen, header);
-	} else if (name_only) {
-		/* Literal value */
-		len = hpack_encode_literal_value(buf, buflen, ret, header);
-	} else {
+	if (encoder != NULL && encoder->size_update) {
+		/* Based on RFC7541, ch 6.3, must start the header block. */
+		ret = hpack_integer_encode(buf, buflen, encoder->max_size,
+					   HPACK_PREFIX_DYNAMIC_TABLE_SIZE_UPDATE,
+					   HPACK_PREFIX_LEN_DYNAMIC_TABLE_SIZE_UPDATE);
+		if (ret < 0) {
+			return ret;
+		}
+
+		buf += ret;
+		buflen -= ret;
+		len += ret;
+		encoder->size_update = false;
+	}
+
+	index = http_hpack_find_index(header, &name_only);
+	if (index > 0 && !name_only) {
 		/* Indexed */
-		len = hpack_encode_indexed(buf, buflen, ret);
+		ret = hpack_encode_indexed(buf, buflen, index);
+		goto out;
 	}
 
-	return len;
+	if (encoder != NULL) {
+		bool dynamic_name_only;
+		int dynamic_index;
+
+		dynamic_index = hpack_dynamic_find_index(encoder, header, &dynamic_name_only);
+		if (dynamic_index > 0 && !dynamic_name_only) {
+			/* Indexed from the dynamic table */
+			ret = hpack_encode_indexed(buf, buflen, dynamic_index);
+			goto out;
+		}
+
+		if (index < 0) {
+			index = dynamic_index;
+		}
+
+		if (hpack_header_indexable(encoder, index, header)) {
+			/* Literal with incremental indexing */
+			ret = hpack_encode_literal(buf, buflen, MAX(index, 0),
+						   HPACK_PREFIX_LITERAL_INDEXING,
+						   HPACK_PREFIX_LEN_LITERAL_INDEXING, header);
+			if (ret >= 0) {
+				hpack_dynamic_insert(encoder, header);
+			}
+
+			goto out;
+		}
+	}
+
+	/* Literal value, or all literal */
+	ret = hpack_encode_literal(buf, buflen, MAX(index, 0),
+				   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
+				   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED, header);
+
+out:
+	if (ret < 0) {
+		return ret;
+	}
+
+	return len + ret;
+}
+
+int http_hpack_encode_header(uint8_t *buf, size_t buflen,
+			     struct http_hpack_header_buf *header)
+{
+	return http_hpack_encoder_encode_header(NULL, buf, buflen, header);
 }
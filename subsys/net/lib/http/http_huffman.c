@@ -9,6 +9,7 @@
 
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
 
 LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
 
@@ -277,6 +278,81 @@ static const struct decode_elem decode_table[] = {
 	{ 30,  22, { 0b11111111, 0b11111111, 0b11111111, 0b11111000 } },
 };
 
+struct encode_elem {
+	uint32_t code;
+	uint8_t bitlen;
+};
+
+/* Huffman codes from RFC7541 Appendix B, indexed by symbol. */
+static const struct encode_elem encode_table[] = {
+	{     0x1ff8, 13 }, {   0x7fffd8, 23 }, {  0xfffffe2, 28 }, {  0xfffffe3, 28 },
+	{  0xfffffe4, 28 }, {  0xfffffe5, 28 }, {  0xfffffe6, 28 }, {  0xfffffe7, 28 },
+	{  0xfffffe8, 28 }, {   0xffffea, 24 }, { 0x3ffffffc, 30 }, {  0xfffffe9, 28 },
+	{  0xfffffea, 28 }, { 0x3ffffffd, 30 }, {  0xfffffeb, 28 }, {  0xfffffec, 28 },
+	{  0xfffffed, 28 }, {  0xfffffee, 28 }, {  0xfffffef, 28 }, {  0xffffff0, 28 },
+	{  0xffffff1, 28 }, {  0xffffff2, 28 }, { 0x3ffffffe, 30 }, {  0xffffff3, 28 },
+	{  0xffffff4, 28 }, {  0xffffff5, 28 }, {  0xffffff6, 28 }, {  0xffffff7, 28 },
+	{  0xffffff8, 28 }, {  0xffffff9, 28 }, {  0xffffffa, 28 }, {  0xffffffb, 28 },
+	{       0x14,  6 }, {      0x3f8, 10 }, {      0x3f9, 10 }, {      0xffa, 12 },
+	{     0x1ff9, 13 }, {       0x15,  6 }, {       0xf8,  8 }, {      0x7fa, 11 },
+	{      0x3fa, 10 }, {      0x3fb, 10 }, {       0xf9,  8 }, {      0x7fb, 11 },
+	{       0xfa,  8 }, {       0x16,  6 }, {       0x17,  6 }, {       0x18,  6 },
+	{        0x0,  5 }, {        0x1,  5 }, {        0x2,  5 }, {       0x19,  6 },
+	{       0x1a,  6 }, {       0x1b,  6 }, {       0x1c,  6 }, {       0x1d,  6 },
+	{       0x1e,  6 }, {       0x1f,  6 }, {       0x5c,  7 }, {       0xfb,  8 },
+	{     0x7ffc, 15 }, {       0x20,  6 }, {      0xffb, 12 }, {      0x3fc, 10 },
+	{     0x1ffa, 13 }, {       0x21,  6 }, {       0x5d,  7 }, {       0x5e,  7 },
+	{       0x5f,  7 }, {       0x60,  7 }, {       0x61,  7 }, {       0x62,  7 },
+	{       0x63,  7 }, {       0x64,  7 }, {       0x65,  7 }, {       0x66,  7 },
+	{       0x67,  7 }, {       0x68,  7 }, {       0x69,  7 }, {       0x6a,  7 },
+	{       0x6b,  7 }, {       0x6c,  7 }, {       0x6d,  7 }, {       0x6e,  7 },
+	{       0x6f,  7 }, {       0x70,  7 }, {       0x71,  7 }, {       0x72,  7 },
+	{       0xfc,  8 }, {       0x73,  7 }, {       0xfd,  8 }, {     0x1ffb, 13 },
+	{    0x7fff0, 19 }, {     0x1ffc, 13 }, {     0x3ffc, 14 }, {       0x22,  6 },
+	{     0x7ffd, 15 }, {        0x3,  5 }, {       0x23,  6 }, {        0x4,  5 },
+	{       0x24,  6 }, {        0x5,  5 }, {       0x25,  6 }, {       0x26,  6 },
+	{       0x27,  6 }, {        0x6,  5 }, {       0x74,  7 }, {       0x75,  7 },
+	{       0x28,  6 }, {       0x29,  6 }, {       0x2a,  6 }, {        0x7,  5 },
+	{       0x2b,  6 }, {       0x76,  7 }, {       0x2c,  6 }, {        0x8,  5 },
+	{        0x9,  5 }, {       0x2d,  6 }, {       0x77,  7 }, {       0x78,  7 },
+	{       0x79,  7 }, {       0x7a,  7 }, {       0x7b,  7 }, {     0x7ffe, 15 },
+	{      0x7fc, 11 }, {     0x3ffd, 14 }, {     0x1ffd, 13 }, {  0xffffffc, 28 },
+	{    0xfffe6, 20 }, {   0x3fffd2, 22 }, {    0xfffe7, 20 }, {    0xfffe8, 20 },
+	{   0x3fffd3, 22 }, {   0x3fffd4, 22 }, {   0x3fffd5, 22 }, {   0x7fffd9, 23 },
+	{   0x3fffd6, 22 }, {   0x7fffda, 23 }, {   0x7fffdb, 23 }, {   0x7fffdc, 23 },
+	{   0x7fffdd, 23 }, {   0x7fffde, 23 }, {   0xffffeb, 24 }, {   0x7fffdf, 23 },
+	{   0xffffec, 24 }, {   0xffffed, 24 }, {   0x3fffd7, 22 }, {   0x7fffe0, 23 },
+	{   0xffffee, 24 }, {   0x7fffe1, 23 }, {   0x7fffe2, 23 }, {   0x7fffe3, 23 },
+	{   0x7fffe4, 23 }, {   0x1fffdc, 21 }, {   0x3fffd8, 22 }, {   0x7fffe5, 23 },
+	{   0x3fffd9, 22 }, {   0x7fffe6, 23 }, {   0x7fffe7, 23 }, {   0xffffef, 24 },
+	{   0x3fffda, 22 }, {   0x1fffdd, 21 }, {    0xfffe9, 20 }, {   0x3fffdb, 22 },
+	{   0x3fffdc, 22 }, {   0x7fffe8, 23 }, {   0x7fffe9, 23 }, {   0x1fffde, 21 },
+	{   0x7fffea, 23 }, {   0x3fffdd, 22 }, {   0x3fffde, 22 }, {   0xfffff0, 24 },
+	{   0x1fffdf, 21 }, {   0x3fffdf, 22 }, {   0x7fffeb, 23 }, {   0x7fffec, 23 },
+	{   0x1fffe0, 21 }, {   0x1fffe1, 21 }, {   0x3fffe0, 22 }, {   0x1fffe2, 21 },
+	{   0x7fffed, 23 }, {   0x3fffe1, 22 }, {   0x7fffee, 23 }, {   0x7fffef, 23 },
+	{    0xfffea, 20 }, {   0x3fffe2, 22 }, {   0x3fffe3, 22 }, {   0x3fffe4, 22 },
+	{   0x7ffff0, 23 }, {   0x3fffe5, 22 }, {   0x3fffe6, 22 }, {   0x7ffff1, 23 },
+	{  0x3ffffe0, 26 }, {  0x3ffffe1, 26 }, {    0xfffeb, 20 }, {    0x7fff1, 19 },
+	{   0x3fffe7, 22 }, {   0x7ffff2, 23 }, {   0x3fffe8, 22 }, {  0x1ffffec, 25 },
+	{  0x3ffffe2, 26 }, {  0x3ffffe3, 26 }, {  0x3ffffe4, 26 }, {  0x7ffffde, 27 },
+	{  0x7ffffdf, 27 }, {  0x3ffffe5, 26 }, {   0xfffff1, 24 }, {  0x1ffffed, 25 },
+	{    0x7fff2, 19 }, {   0x1fffe3, 21 }, {  0x3ffffe6, 26 }, {  0x7ffffe0, 27 },
+	{  0x7ffffe1, 27 }, {  0x3ffffe7, 26 }, {  0x7ffffe2, 27 }, {   0xfffff2, 24 },
+	{   0x1fffe4, 21 }, {   0x1fffe5, 21 }, {  0x3ffffe8, 26 }, {  0x3ffffe9, 26 },
+	{  0xffffffd, 28 }, {  0x7ffffe3, 27 }, {  0x7ffffe4, 27 }, {  0x7ffffe5, 27 },
+	{    0xfffec, 20 }, {   0xfffff3, 24 }, {    0xfffed, 20 }, {   0x1fffe6, 21 },
+	{   0x3fffe9, 22 }, {   0x1fffe7, 21 }, {   0x1fffe8, 21 }, {   0x7ffff3, 23 },
+	{   0x3fffea, 22 }, {   0x3fffeb, 22 }, {  0x1ffffee, 25 }, {  0x1ffffef, 25 },
+	{   0xfffff4, 24 }, {   0xfffff5, 24 }, {  0x3ffffea, 26 }, {   0x7ffff4, 23 },
+	{  0x3ffffeb, 26 }, {  0x7ffffe6, 27 }, {  0x3ffffec, 26 }, {  0x3ffffed, 26 },
+	{  0x7ffffe7, 27 }, {  0x7ffffe8, 27 }, {  0x7ffffe9, 27 }, {  0x7ffffea, 27 },
+	{  0x7ffffeb, 27 }, {  0xffffffe, 28 }, {  0x7ffffec, 27 }, {  0x7ffffed, 27 },
+	{  0x7ffffee, 27 }, {  0x7ffffef, 27 }, {  0x7fffff0, 27 }, {  0x3ffffee, 26 },
+};
+
+BUILD_ASSERT(ARRAY_SIZE(encode_table) == 256);
+
 static const struct decode_elem eos = {
 	30,   0, { 0b11111111, 0b11111111, 0b11111111, 0b11111100 }
 };
@@ -313,17 +389,6 @@ static const struct decode_elem *huffman_decode_bits(uint32_t bits)
 	return NULL;
 }
 
-static const struct decode_elem *huffman_find_entry(uint8_t symbol)
-{
-	for (int i = 0; i < ARRAY_SIZE(decode_table); i++) {
-		if (decode_table[i].symbol == symbol) {
-			return &decode_table[i];
-		}
-	}
-
-	return NULL;
-}
-
 #define MAX_PADDING_LEN 7
 
 int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
@@ -415,12 +480,23 @@ int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
 	return decoded_len;
 }
 
+size_t http_hpack_huffman_encoded_len(const uint8_t *str, size_t str_len)
+{
+	size_t bits = 0;
+
+	for (size_t i = 0; i < str_len; i++) {
+		bits += encode_table[str[i]].bitlen;
+	}
+
+	return DIV_ROUND_UP(bits, 8);
+}
+
 int http_hpack_huffman_encode(const uint8_t *str, size_t str_len,
 			      uint8_t *buf, size_t buflen)
 {
-	const struct decode_elem *entry;
-	size_t buflen_bits = buflen * 8;
-	uint8_t bit_offset = 0;
+	const struct encode_elem *entry;
+	uint8_t bits_len = 0;
+	uint64_t bits = 0;
 	int len = 0;
 
 	if (str == NULL || buf == NULL || str_len == 0) {
@@ -428,52 +504,34 @@ int http_hpack_huffman_encode(const uint8_t *str, size_t str_len,
 	}
 
 	while (str_len > 0) {
-		uint32_t code;
-		uint8_t bitlen;
-
-		entry = huffman_find_entry(*str);
-		if (entry == NULL) {
-			return -EINVAL;
-		}
-
-		if (entry->bitlen > buflen_bits) {
-			return -ENOBUFS;
-		}
-
-		bitlen = entry->bitlen;
-		code = sys_get_be32(entry->code);
+		entry = &encode_table[*str];
 
-		while (bitlen > 0) {
-			uint8_t to_copy = MIN(8 - bit_offset, bitlen);
-			uint8_t byte = (uint8_t)((code & MSB_MASK(to_copy)) >>
-						 (24 + bit_offset));
+		/* At most 7 bits are left over from the previous symbol, so
+		 * the longest code still fits.
+		 */
+		bits = (bits << entry->bitlen) | entry->code;
+		bits_len += entry->bitlen;
 
-			/* This is way suboptimal */
-			if (bit_offset == 0) {
-				*buf = byte;
-			} else {
-				*buf |= byte;
+		while (bits_len >= 8) {
+			if (len >= buflen) {
+				return -ENOBUFS;
 			}
 
-			code <<= to_copy;
-			bitlen -= to_copy;
-			bit_offset  = (bit_offset + to_copy) % 8;
-
-			if (bit_offset == 0) {
-				buf++;
-				len++;
-			}
+			bits_len -= 8;
+			buf[len++] = (uint8_t)(bits >> bits_len);
 		}
 
-		buflen_bits -= entry->bitlen;
 		str_len--;
 		str++;
 	}
 
 	/* Pad with ones. */
-	if (bit_offset > 0) {
-		*buf |= LSB_MASK((8 - bit_offset));
-		len++;
+	if (bits_len > 0) {
+		if (len >= buflen) {
+			return -ENOBUFS;
+		}
+
+		buf[len++] = (uint8_t)(bits << (8 - bits_len)) | LSB_MASK((8 - bits_len));
 	}
 
 	return len;
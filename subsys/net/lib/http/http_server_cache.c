@@ -0,0 +1,458 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include "headers/server_internal.h"
+
+#define FNV1A_32_OFFSET_BASIS 0x811c9dc5U
+#define FNV1A_32_PRIME        0x01000193U
+
+K_HEAP_DEFINE(static_fs_cache_heap, CONFIG_HTTP_SERVER_STATIC_FS_CACHE_SIZE);
+
+static K_MUTEX_DEFINE(static_fs_cache_lock);
+
+static struct http_static_fs_cache_entry
+	static_fs_cache[CONFIG_HTTP_SERVER_STATIC_FS_CACHE_ENTRIES];
+static uint32_t static_fs_cache_clock;
+
+/* Largest file the heap can hold, some of the heap memory is taken by the
+ * allocator for its own bookkeeping.
+ */
+static size_t static_fs_cache_max_size;
+
+static uint32_t cache_etag(const uint8_t *data, size_t len)
+{
+	uint32_t hash = FNV1A_32_OFFSET_BASIS;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= data[i];
+		hash *= FNV1A_32_PRIME;
+	}
+
+	return hash;
+}
+
+static void cache_evict(struct http_static_fs_cache_entry *entry)
+{
+	LOG_DBG("Evicting %s from cache", entry->fname);
+
+	k_heap_free(&static_fs_cache_heap, entry->data);
+	entry->data = NULL;
+	entry->fname[0] = '\0';
+}
+
+/* The entries still being sent are only hidden, they are evicted once the
+ * last user puts them back.
+ */
+static void cache_drop(struct http_static_fs_cache_entry *entry)
+{
+	if (entry->users > 0) {
+		entry->fname[0] = '\0';
+		return;
+	}
+
+	cache_evict(entry);
+}
+
+static struct http_static_fs_cache_entry *cache_lru(void)
+{
+	struct http_static_fs_cache_entry *lru = NULL;
+
+	ARRAY_FOR_EACH_PTR(static_fs_cache, entry) {
+		if (entry->data == NULL || entry->users > 0) {
+			continue;
+		}
+
+		if (lru == NULL || (int32_t)(entry->last_used - lru->last_used) < 0) {
+			lru = entry;
+		}
+	}
+
+	return lru;
+}
+
+static struct http_static_fs_cache_entry *cache_find(const char *fname)
+{
+	ARRAY_FOR_EACH_PTR(static_fs_cache, entry) {
+		if (entry->data != NULL && strcmp(entry->fname, fname) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static struct http_static_fs_cache_entry *cache_alloc(size_t size)
+{
+	struct http_static_fs_cache_entry *entry = NULL;
+	struct http_static_fs_cache_entry *lru;
+	void *data;
+
+	ARRAY_FOR_EACH_PTR(static_fs_cache, e) {
+		if (e->data == NULL) {
+			entry = e;
+			break;
+		}
+	}
+
+	if (entry == NULL) {
+		entry = cache_lru();
+		if (entry == NULL) {
+			return NULL;
+		}
+
+		cache_evict(entry);
+	}
+
+	/* Empty files are cached too, for the sake of their ETag */
+	while ((data = k_heap_alloc(&static_fs_cache_heap, MAX(size, 1), K_NO_WAIT)) == NULL) {
+		lru = cache_lru();
+		if (lru == NULL) {
+			return NULL;
+		}
+
+		cache_evict(lru);
+	}
+
+	entry->data = data;
+
+	return entry;
+}
+
+static int cache_read(const char *fname, uint8_t *data, size_t size)
+{
+	struct fs_file_t file;
+	size_t offset = 0;
+	ssize_t len;
+	int ret;
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, fname, FS_O_READ);
+	if (ret < 0) {
+		LOG_ERR("fs_open %s: %d", fname, ret);
+		return ret;
+	}
+
+	while (offset < size) {
+		len = fs_read(&file, data + offset, size - offset);
+		if (len < 0) {
+			LOG_ERR("Filesystem read error (%d)", (int)len);
+			ret = len;
+			break;
+		}
+
+		if (len == 0) {
+			/* The file was truncated meanwhile */
+			ret = -EIO;
+			break;
+		}
+
+		offset += len;
+	}
+
+	fs_close(&file);
+
+	return ret;
+}
+
+struct http_static_fs_cache_entry *http_server_cache_get(const char *fname, size_t file_size)
+{
+	struct http_static_fs_cache_entry *entry;
+
+	/* Do not empty the cache for a file that would not fit anyway */
+	if (MAX(file_size, 1) > static_fs_cache_max_size ||
+	    strlen(fname) >= sizeof(entry->fname)) {
+		return NULL;
+	}
+
+	(void)k_mutex_lock(&static_fs_cache_lock, K_FOREVER);
+
+	entry = cache_find(fname);
+	if (entry != NULL && entry->size != file_size) {
+		/* The file has changed, load it again */
+		cache_drop(entry);
+		entry = NULL;
+	}
+
+	if (entry == NULL) {
+		entry = cache_alloc(file_size);
+		if (entry == NULL) {
+			goto fail;
+		}
+
+		if (cache_read(fname, entry->data, file_size) < 0) {
+			cache_evict(entry);
+			goto fail;
+		}
+
+		strcpy(entry->fname, fname);
+		entry->size = file_size;
+		entry->etag = cache_etag(entry->data, file_size);
+
+		LOG_DBG("Cached %s, size %zu, etag %08x", fname, file_size, entry->etag);
+	}
+
+	entry->last_used = static_fs_cache_clock++;
+	entry->users++;
+
+	k_mutex_unlock(&static_fs_cache_lock);
+
+	return entry;
+
+fail:
+	k_mutex_unlock(&static_fs_cache_lock);
+
+	return NULL;
+}
+
+void http_server_cache_put(struct http_static_fs_cache_entry *entry)
+{
+	(void)k_mutex_lock(&static_fs_cache_lock, K_FOREVER);
+
+	__ASSERT_NO_MSG(entry->users > 0);
+
+	entry->users--;
+	if (entry->users == 0 && entry->fname[0] == '\0') {
+		cache_evict(entry);
+	}
+
+	k_mutex_unlock(&static_fs_cache_lock);
+}
+
+void http_server_static_fs_cache_flush(void)
+{
+	(void)k_mutex_lock(&static_fs_cache_lock, K_FOREVER);
+
+	ARRAY_FOR_EACH_PTR(static_fs_cache, entry) {
+		if (entry->data != NULL) {
+			cache_drop(entry);
+		}
+	}
+
+	k_mutex_unlock(&static_fs_cache_lock);
+}
+
+void http_server_cache_reset_request(struct http_client_ctx *client)
+{
+	client->if_none_match_count = 0;
+	client->if_none_match_any = false;
+	client->has_range = false;
+	client->range_suffix = false;
+	client->if_none_match_next = false;
+	client->range_next = false;
+}
+
+static const char *skip_spaces(const char *pos, const char *end)
+{
+	while (pos < end && (*pos == ' ' || *pos == '\t')) {
+		pos++;
+	}
+
+	return pos;
+}
+
+void http_server_cache_parse_if_none_match(struct http_client_ctx *client, const char *value,
+					   size_t len)
+{
+	const char *end = value + len;
+	const char *pos = value;
+	uint8_t etag[sizeof(uint32_t)];
+
+	pos = skip_spaces(pos, end);
+	if (pos < end && *pos == '*') {
+		client->if_none_match_any = true;
+		return;
+	}
+
+	while (pos < end) {
+		/* Weak comparison applies to If-None-Match, so the weakness
+		 * indicator is ignored.
+		 */
+		if (end - pos >= 2 && strncmp(pos, "W/", 2) == 0) {
+			pos += 2;
+		}
+
+		if (end - pos >= HTTP_SERVER_ETAG_LEN && pos[0] == '"' &&
+		    pos[HTTP_SERVER_ETAG_LEN - 1] == '"' &&
+		    hex2bin(pos + 1, HTTP_SERVER_ETAG_LEN - 2, etag, sizeof(etag)) == sizeof(etag) &&
+		    client->if_none_match_count < ARRAY_SIZE(client->if_none_match)) {
+			client->if_none_match[client->if_none_match_count++] = sys_get_be32(etag);
+		}
+
+		/* Skip to the next entity tag of the list, the ones not
+		 * generated by the server may contain commas.
+		 */
+		if (pos < end && *pos == '"') {
+			pos = memchr(pos + 1, '"', end - pos - 1);
+			if (pos == NULL) {
+				return;
+			}
+		}
+
+		pos = memchr(pos, ',', end - pos);
+		if (pos == NULL) {
+			return;
+		}
+
+		pos = skip_spaces(pos + 1, end);
+	}
+}
+
+static const char *parse_range_pos(const char *pos, const char *end, size_t *val)
+{
+	const char *start = pos;
+	size_t result = 0;
+
+	while (pos < end && isdigit((unsigned char)*pos)) {
+		if (result > (SIZE_MAX - 9) / 10) {
+			return NULL;
+		}
+
+		result = result * 10 + (*pos - '0');
+		pos++;
+	}
+
+	if (pos == start) {
+		return NULL;
+	}
+
+	*val = result;
+
+	return pos;
+}
+
+void http_server_cache_parse_range(struct http_client_ctx *client, const char *value, size_t len)
+{
+	static const char unit[] = "bytes=";
+	const char *end = value + len;
+	const char *pos = skip_spaces(value, end);
+	size_t first = 0;
+	size_t last = SIZE_MAX;
+	bool suffix = false;
+
+	if (end - pos < sizeof(unit) - 1 || strncasecmp(pos, unit, sizeof(unit) - 1) != 0) {
+		return;
+	}
+
+	pos += sizeof(unit) - 1;
+
+	if (pos < end && *pos == '-') {
+		suffix = true;
+		pos = parse_range_pos(pos + 1, end, &first);
+	} else {
+		pos = parse_range_pos(pos, end, &first);
+		if (pos == NULL || pos == end || *pos != '-') {
+			return;
+		}
+
+		pos++;
+		if (pos < end && isdigit((unsigned char)*pos)) {
+			pos = parse_range_pos(pos, end, &last);
+		}
+	}
+
+	/* Multiple ranges are not supported, the whole file is sent instead,
+	 * as is done for the invalid ranges.
+	 */
+	if (pos == NULL || skip_spaces(pos, end) != end || first > last) {
+		return;
+	}
+
+	client->range_first = first;
+	client->range_last = last;
+	client->range_suffix = suffix;
+	client->has_range = true;
+}
+
+bool http_server_cache_not_modified(const struct http_client_ctx *client,
+				    const struct http_static_fs_cache_entry *entry)
+{
+	if (client->if_none_match_any) {
+		return true;
+	}
+
+	for (size_t i = 0; i < client->if_none_match_count; i++) {
+		if (client->if_none_match[i] == entry->etag) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int http_server_cache_range(const struct http_client_ctx *client, size_t size, size_t *offset,
+			    size_t *len)
+{
+	if (!client->has_range) {
+		*offset = 0;
+		*len = size;
+		return 0;
+	}
+
+	if (client->range_suffix) {
+		if (client->range_first == 0 || size == 0) {
+			return -ERANGE;
+		}
+
+		*len = MIN(client->range_first, size);
+		*offset = size - *len;
+		return 1;
+	}
+
+	if (client->range_first >= size) {
+		return -ERANGE;
+	}
+
+	*offset = client->range_first;
+	*len = MIN(client->range_last, size - 1) - client->range_first + 1;
+
+	return 1;
+}
+
+static int static_fs_cache_init(void)
+{
+	size_t low = 0;
+	size_t high = CONFIG_HTTP_SERVER_STATIC_FS_CACHE_SIZE;
+	size_t mid;
+	void *data;
+
+	/* Look for the largest block the empty heap can hold */
+	while (low < high) {
+		mid = high - (high - low) / 2;
+
+		data = k_heap_alloc(&static_fs_cache_heap, mid, K_NO_WAIT);
+		if (data == NULL) {
+			high = mid - 1;
+			continue;
+		}
+
+		k_heap_free(&static_fs_cache_heap, data);
+		low = mid;
+	}
+
+	static_fs_cache_max_size = low;
+
+	LOG_DBG("Files up to %zu bytes are cached", static_fs_cache_max_size);
+
+	return 0;
+}
+
+SYS_INIT(static_fs_cache_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
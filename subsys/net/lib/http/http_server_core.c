@@ -37,6 +37,8 @@ LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
 #endif
 
 #define INVALID_SOCK -1
+/* Slot of a client waiting for its worker jobs before being closed */
+#define CLOSING_SOCK -2
 #define INACTIVITY_TIMEOUT K_SECONDS(CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT)
 
 #define HTTP_SERVER_MAX_SERVICES CONFIG_HTTP_SERVER_NUM_SERVICES
@@ -290,6 +292,19 @@ static void close_all_sockets(struct http_server_ctx *ctx)
 	ctx->fds[0].fd = -1;
 
 	for (int i = 1; i < ARRAY_SIZE(ctx->fds); i++) {
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+		if (i >= ctx->listen_fds && ctx->fds[i].fd != INVALID_SOCK) {
+			struct http_client_ctx *client =
+				&server_ctx.clients[i - ctx->listen_fds];
+
+			/* Nothing is served anymore, so the workers can be
+			 * waited for before clearing the client contexts.
+			 */
+			ctx->fds[i].fd = client->fd;
+			http_server_workers_client_wait(client);
+		}
+#endif
+
 		if (ctx->fds[i].fd < 0) {
 			continue;
 		}
@@ -348,6 +363,16 @@ static void client_release_resources(struct http_client_ctx *client)
 					   &response_ctx, dynamic_detail->user_data);
 		}
 	}
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	/* Cached files still waiting for the send window */
+	ARRAY_FOR_EACH_PTR(client->streams, stream) {
+		if (stream->cache_entry != NULL) {
+			http_server_cache_put(stream->cache_entry);
+			stream->cache_entry = NULL;
+		}
+	}
+#endif
 }
 
 void http_server_release_client(struct http_client_ctx *client)
@@ -384,6 +409,20 @@ static void close_client_connection(struct http_client_ctx *client)
 	int fd = client->fd;
 
 	if (fd >= 0) {
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+		if (http_server_workers_client_release(client)) {
+			int i = server_ctx.listen_fds + ARRAY_INDEX(server_ctx.clients, client);
+
+			/* A worker is still running a resource callback for
+			 * the client. Stop polling the socket, the connection
+			 * is closed once the last job is freed.
+			 */
+			LOG_DBG("Client %p closing deferred", client);
+			server_ctx.fds[i].fd = CLOSING_SOCK;
+			return;
+		}
+#endif
+
 		http_server_release_client(client);
 
 		(void)zsock_close(fd);
@@ -438,6 +477,19 @@ static void init_client_ctx(struct http_client_ctx *client, const struct http_se
 	k_work_init_delayable(&client->inactivity_timer, client_timeout);
 	http_client_timer_restart(client);
 
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+	client->send_window = HTTP2_DEFAULT_WINDOW_SIZE;
+	client->peer_initial_window = HTTP2_DEFAULT_WINDOW_SIZE;
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	http_server_workers_client_init(client);
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE)
+	http_hpack_encoder_init(&client->hpack_encoder);
+#endif
+
 	ARRAY_FOR_EACH(client->streams, i) {
 		client->streams[i].stream_state = HTTP2_STREAM_IDLE;
 		client->streams[i].stream_id = 0;
@@ -551,6 +603,37 @@ static int handle_http_request(struct http_client_ctx *client)
 	return 0;
 }
 
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+void http_server_wakeup(void)
+{
+	int fd = server_ctx.fds[0].fd;
+
+	if (fd >= 0) {
+		zvfs_eventfd_write(fd, 1);
+	}
+}
+
+static void update_client_events(struct http_server_ctx *ctx)
+{
+	for (int i = ctx->listen_fds; i < ARRAY_SIZE(ctx->fds); i++) {
+		struct http_client_ctx *client = &ctx->clients[i - ctx->listen_fds];
+
+		if (ctx->fds[i].fd == CLOSING_SOCK) {
+			/* Try again, the jobs of the client might be done */
+			ctx->fds[i].fd = client->fd;
+			close_client_connection(client);
+			continue;
+		}
+
+		if (ctx->fds[i].fd < 0) {
+			continue;
+		}
+
+		ctx->fds[i].events = http_server_workers_client_busy(client) ? 0 : ZSOCK_POLLIN;
+	}
+}
+#endif /* CONFIG_HTTP_SERVER_WORKERS */
+
 static int http_server_run(struct http_server_ctx *ctx)
 {
 	struct http_client_ctx *client;
@@ -565,6 +648,10 @@ static int http_server_run(struct http_server_ctx *ctx)
 	value = 0;
 
 	while (1) {
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+		update_client_events(ctx);
+#endif
+
 		ret = zsock_poll(ctx->fds, HTTP_SERVER_SOCK_COUNT, -1);
 		if (ret < 0) {
 			ret = -errno;
@@ -577,7 +664,13 @@ static int http_server_run(struct http_server_ctx *ctx)
 			break;
 		}
 
-		if (ret == 1 && ctx->fds[0].revents) {
+		if (IS_ENABLED(CONFIG_HTTP_SERVER_WORKERS) && ctx->fds[0].revents &&
+		    server_running) {
+			/* Woken up by a worker, the client events are updated
+			 * before polling again.
+			 */
+			zvfs_eventfd_read(ctx->fds[0].fd, &value);
+		} else if (ret == 1 && ctx->fds[0].revents) {
 			zvfs_eventfd_read(ctx->fds[0].fd, &value);
 			LOG_DBG("Received stop event. exiting ..");
 			ret = 0;
@@ -915,6 +1008,30 @@ int http_server_sendall(struct http_client_ctx *client, const void *buf, size_t
 	return 0;
 }
 
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+int http_server_sendfile(struct http_client_ctx *client, struct fs_file_t *file, size_t len)
+{
+	while (len) {
+		ssize_t out_len = zsock_sendfile(client->fd, file, NULL, len);
+
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		if (out_len == 0) {
+			/* File is shorter than it was when stat'ed */
+			return -EIO;
+		}
+
+		len -= out_len;
+
+		http_client_timer_restart(client);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_SENDFILE */
+
 bool http_response_is_final(struct http_response_ctx *rsp, enum http_transaction_status status)
 {
 	if (status != HTTP_SERVER_REQUEST_DATA_FINAL) {
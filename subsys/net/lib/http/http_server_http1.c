@@ -548,6 +548,91 @@ static int dynamic_post_put_req(struct http_resource_detail_dynamic *dynamic_det
 
 #if defined(CONFIG_FILE_SYSTEM)
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+#define CACHED_RESPONSE_HEADERS                                                                    \
+	"Content-Length: %zu\r\n"                                                                   \
+	"Content-Type: %s%s%s\r\n"                                                                  \
+	"ETag: \"%08x\"\r\n"                                                                         \
+	"Accept-Ranges: bytes\r\n"
+#define CACHED_RESPONSE_SIZE                                                                       \
+	(sizeof("HTTP/1.1 206 Partial Content\r\n") + sizeof(CACHED_RESPONSE_HEADERS) +            \
+	 sizeof("Content-Range: bytes 01234567890123456789-01234567890123456789/"                   \
+		"01234567890123456789\r\n\r\n") +                                                    \
+	 sizeof("01234567890123456789") + HTTP_SERVER_MAX_CONTENT_TYPE_LEN +                       \
+	 sizeof("\r\nContent-Encoding: ") + HTTP_COMPRESSION_MAX_STRING_LEN)
+
+/* Serve the file from RAM, which also makes it cheap to answer the
+ * conditional and range requests.
+ */
+static int handle_http1_static_fs_cached(struct http_client_ctx *client,
+					 const struct http_static_fs_cache_entry *entry,
+					 const char *content_type,
+					 enum http_compression compression)
+{
+	const char *encoding_header = "";
+	const char *encoding = "";
+	char http_response[CACHED_RESPONSE_SIZE];
+	size_t offset;
+	size_t len;
+	int hdr_len;
+	int ret;
+
+	if (http_server_cache_not_modified(client, entry)) {
+		hdr_len = snprintk(http_response, sizeof(http_response),
+				   "HTTP/1.1 304 Not Modified\r\n"
+				   "ETag: \"%08x\"\r\n\r\n",
+				   entry->etag);
+
+		return http_server_sendall(client, http_response, hdr_len);
+	}
+
+	ret = http_server_cache_range(client, entry->size, &offset, &len);
+	if (ret == -ERANGE) {
+		hdr_len = snprintk(http_response, sizeof(http_response),
+				   "HTTP/1.1 416 Range Not Satisfiable\r\n"
+				   "Content-Length: 0\r\n"
+				   "Content-Range: bytes */%zu\r\n\r\n",
+				   entry->size);
+
+		return http_server_sendall(client, http_response, hdr_len);
+	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SERVER_COMPRESSION) && http_compression_text(compression)[0] != 0) {
+		encoding_header = "\r\nContent-Encoding: ";
+		encoding = http_compression_text(compression);
+	}
+
+	if (ret > 0) {
+		hdr_len = snprintk(http_response, sizeof(http_response),
+				   "HTTP/1.1 206 Partial Content\r\n"
+				   CACHED_RESPONSE_HEADERS
+				   "Content-Range: bytes %zu-%zu/%zu\r\n\r\n",
+				   len, content_type, encoding_header, encoding, entry->etag,
+				   offset, offset + len - 1, entry->size);
+	} else {
+		hdr_len = snprintk(http_response, sizeof(http_response),
+				   "HTTP/1.1 200 OK\r\n"
+				   CACHED_RESPONSE_HEADERS "\r\n",
+				   len, content_type, encoding_header, encoding, entry->etag);
+	}
+
+	ret = http_server_sendall(client, http_response, hdr_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	client->http1_headers_sent = true;
+
+	ret = http_server_sendall(client, entry->data + offset, len);
+	if (ret < 0 || offset > 0 || len < entry->size) {
+		return ret;
+	}
+
+	/* Same as for the files sent from the file system */
+	return http_server_sendall(client, "\r\n\r\n", 4);
+}
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS_CACHE */
+
 int handle_http1_static_fs_resource(struct http_resource_detail_static_fs *static_fs_detail,
 				    struct http_client_ctx *client)
 {
@@ -587,6 +672,9 @@ BUILD_ASSERT(CONFIG_HTTP_SERVER_STATIC_FS_RESPONSE_SIZE >= STATIC_FS_RESPONSE_SI
 	char fname[HTTP_SERVER_MAX_URL_LENGTH];
 	char content_type[HTTP_SERVER_MAX_CONTENT_TYPE_LEN] = "text/html";
 	char http_response[STATIC_FS_RESPONSE_SIZE];
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	struct http_static_fs_cache_entry *entry;
+#endif
 
 	if (client->method != HTTP_GET) {
 		return send_http1_405(client);
@@ -615,6 +703,20 @@ BUILD_ASSERT(CONFIG_HTTP_SERVER_STATIC_FS_RESPONSE_SIZE >= STATIC_FS_RESPONSE_SI
 		LOG_ERR("fs_stat %s: %d", fname, ret);
 		return send_http1_404(client);
 	}
+
+	LOG_DBG("found %s, file size: %zu", fname, file_size);
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	entry = http_server_cache_get(fname, file_size);
+	if (entry != NULL) {
+		ret = handle_http1_static_fs_cached(client, entry, content_type,
+						    chosen_compression);
+		http_server_cache_put(entry);
+
+		return ret;
+	}
+#endif
+
 	fs_file_t_init(&file);
 	ret = fs_open(&file, fname, FS_O_READ);
 	if (ret < 0) {
@@ -624,8 +726,6 @@ BUILD_ASSERT(CONFIG_HTTP_SERVER_STATIC_FS_RESPONSE_SIZE >= STATIC_FS_RESPONSE_SI
 		}
 	}
 
-	LOG_DBG("found %s, file size: %zu", fname, file_size);
-
 	/* send HTTP header */
 	if (IS_ENABLED(CONFIG_HTTP_SERVER_COMPRESSION) &&
 	    http_compression_text(chosen_compression)[0] != 0) {
@@ -645,6 +745,20 @@ BUILD_ASSERT(CONFIG_HTTP_SERVER_STATIC_FS_RESPONSE_SIZE >= STATIC_FS_RESPONSE_SI
 
 	/* read and send file */
 	remaining = file_size;
+
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+	/* Let the stack read the file straight into its send buffers, fall
+	 * back to the copy loop below for sockets that cannot do that, like
+	 * TLS ones.
+	 */
+	ret = http_server_sendfile(client, &file, remaining);
+	if (ret == 0) {
+		remaining = 0;
+	} else if (ret != -EOPNOTSUPP) {
+		goto close;
+	}
+#endif
+
 	while (remaining > 0) {
 		len = fs_read(&file, http_response, sizeof(http_response));
 		if (len < 0) {
@@ -816,6 +930,12 @@ static int on_header_field(struct http_parser *parser, const char *at,
 			}
 #endif /* CONFIG_HTTP_SERVER_COMPRESSION */
 
+#ifdef CONFIG_HTTP_SERVER_STATIC_FS_CACHE
+			ctx->if_none_match_next =
+				(strcasecmp(ctx->header_buffer, "If-None-Match") == 0);
+			ctx->range_next = (strcasecmp(ctx->header_buffer, "Range") == 0);
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS_CACHE */
+
 			ctx->header_buffer[0] = '\0';
 		}
 	}
@@ -907,6 +1027,16 @@ static int on_header_value(struct http_parser *parser,
 				ctx->accept_encoding_next = false;
 			}
 #endif /* CONFIG_HTTP_SERVER_COMPRESSION */
+#ifdef CONFIG_HTTP_SERVER_STATIC_FS_CACHE
+			if (ctx->if_none_match_next) {
+				http_server_cache_parse_if_none_match(ctx, ctx->header_buffer,
+								      offset);
+				ctx->if_none_match_next = false;
+			} else if (ctx->range_next) {
+				http_server_cache_parse_range(ctx, ctx->header_buffer, offset);
+				ctx->range_next = false;
+			}
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS_CACHE */
 
 			ctx->header_buffer[0] = '\0';
 		}
@@ -991,6 +1121,10 @@ int enter_http1_request(struct http_client_ctx *client)
 		client->header_capture_ctx.store_next_value = false;
 	}
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	http_server_cache_reset_request(client);
+#endif
+
 	memset(client->header_buffer, 0, sizeof(client->header_buffer));
 	memset(client->url_buffer, 0, sizeof(client->url_buffer));
 
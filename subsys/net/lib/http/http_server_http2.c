@@ -18,6 +18,7 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/net/http/service.h>
 #include <zephyr/net/http/server.h>
+#include <zephyr/net/socket.h>
 
 LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
 
@@ -39,6 +40,27 @@ static void clear_header_flag(uint8_t *flags, uint8_t mask)
 	*flags &= ~mask;
 }
 
+/* With worker threads, frames are sent from several threads, so each frame
+ * is written to the socket as a whole under the client TX lock.
+ */
+static void http2_tx_lock(struct http_client_ctx *client)
+{
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	(void)k_mutex_lock(&client->tx_lock, K_FOREVER);
+#else
+	ARG_UNUSED(client);
+#endif
+}
+
+static void http2_tx_unlock(struct http_client_ctx *client)
+{
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	k_mutex_unlock(&client->tx_lock);
+#else
+	ARG_UNUSED(client);
+#endif
+}
+
 static void print_http_frames(struct http_client_ctx *client)
 {
 #if defined(PRINT_COLOR)
@@ -79,45 +101,83 @@ static struct http2_stream_ctx *find_http_stream_context(
 static struct http2_stream_ctx *allocate_http_stream_context(
 			struct http_client_ctx *client, uint32_t stream_id)
 {
+	struct http2_stream_ctx *stream = NULL;
+
+	http2_tx_lock(client);
+
 	ARRAY_FOR_EACH(client->streams, i) {
 		if (client->streams[i].stream_state == HTTP2_STREAM_IDLE) {
-			client->streams[i].stream_id = stream_id;
-			client->streams[i].stream_state = HTTP2_STREAM_OPEN;
-			client->streams[i].window_size =
-				HTTP_SERVER_INITIAL_WINDOW_SIZE;
-			client->streams[i].headers_sent = false;
-			client->streams[i].end_stream_sent = false;
-			return &client->streams[i];
+			stream = &client->streams[i];
+			stream->stream_id = stream_id;
+			stream->stream_state = HTTP2_STREAM_OPEN;
+			stream->window_size = HTTP_SERVER_INITIAL_WINDOW_SIZE;
+			stream->headers_sent = false;
+			stream->end_stream_sent = false;
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+			stream->send_window = client->peer_initial_window;
+#endif
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+			stream->cache_entry = NULL;
+#endif
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+			stream->job = NULL;
+			stream->reset = false;
+#endif
+			break;
 		}
 	}
 
-	return NULL;
+	http2_tx_unlock(client);
+
+	return stream;
+}
+
+static void clear_http_stream_context(struct http2_stream_ctx *stream)
+{
+	stream->stream_id = 0;
+	stream->stream_state = HTTP2_STREAM_IDLE;
+	stream->current_detail = NULL;
 }
 
 static void release_http_stream_context(struct http_client_ctx *client,
 					uint32_t stream_id)
 {
+	http2_tx_lock(client);
+
 	ARRAY_FOR_EACH(client->streams, i) {
 		if (client->streams[i].stream_id == stream_id) {
-			client->streams[i].stream_id = 0;
-			client->streams[i].stream_state = HTTP2_STREAM_IDLE;
-			client->streams[i].current_detail = NULL;
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+			/* The worker releases the stream once done with it */
+			if (client->streams[i].job != NULL) {
+				break;
+			}
+#endif
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+			/* Released once the rest of the cached file is sent */
+			if (client->streams[i].cache_entry != NULL) {
+				break;
+			}
+#endif
+			clear_http_stream_context(&client->streams[i]);
 			break;
 		}
 	}
+
+	http2_tx_unlock(client);
 }
 
-static int add_header_field(struct http_client_ctx *client, uint8_t **buf,
+static int add_header_field(struct http_hpack_encoder *encoder,
+			    struct http_hpack_header_buf *header_field, uint8_t **buf,
 			    size_t *buflen, const char *name, const char *value)
 {
 	int ret;
 
-	client->header_field.name = name;
-	client->header_field.name_len = strlen(name);
-	client->header_field.value = value;
-	client->header_field.value_len = strlen(value);
+	header_field->name = name;
+	header_field->name_len = strlen(name);
+	header_field->value = value;
+	header_field->value_len = strlen(value);
 
-	ret = http_hpack_encode_header(*buf, *buflen, &client->header_field);
+	ret = http_hpack_encoder_encode_header(encoder, *buf, *buflen, header_field);
 	if (ret < 0) {
 		LOG_DBG("Failed to encode header, err %d", ret);
 		return ret;
@@ -140,10 +200,13 @@ static void encode_frame_header(uint8_t *buf, uint32_t payload_len,
 }
 
 static int send_headers_frame(struct http_client_ctx *client, enum http_status status,
-			      uint32_t stream_id, struct http_resource_detail *detail_common,
+			      struct http2_stream_ctx *stream,
+			      struct http_resource_detail *detail_common,
 			      uint8_t flags, const struct http_header *extra_headers,
 			      size_t extra_headers_count)
 {
+	struct http_hpack_header_buf *header_field = &client->header_field;
+	struct http_hpack_encoder *encoder = NULL;
 	uint8_t headers_frame[CONFIG_HTTP_SERVER_HTTP2_MAX_HEADER_FRAME_LEN];
 	uint8_t status_str[4];
 	uint8_t *buf = headers_frame + HTTP2_FRAME_HEADER_SIZE;
@@ -153,14 +216,29 @@ static int send_headers_frame(struct http_client_ctx *client, enum http_status s
 	size_t payload_len;
 	int ret;
 
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	if (stream->job != NULL) {
+		header_field = &stream->job->header_field;
+	}
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE)
+	encoder = &client->hpack_encoder;
+#endif
+
 	ret = snprintf(status_str, sizeof(status_str), "%d", status);
 	if (ret > sizeof(status_str) - 1) {
 		return -EINVAL;
 	}
 
-	ret = add_header_field(client, &buf, &buflen, ":status", status_str);
+	/* The header blocks must reach the peer in the order they were
+	 * encoded in, as they update the dynamic table.
+	 */
+	http2_tx_lock(client);
+
+	ret = add_header_field(encoder, header_field, &buf, &buflen, ":status", status_str);
 	if (ret < 0) {
-		return ret;
+		goto encode_fail;
 	}
 
 	for (size_t i = 0; i < extra_headers_count; i++) {
@@ -174,25 +252,26 @@ static int send_headers_frame(struct http_client_ctx *client, enum http_status s
 			content_type_sent = true;
 		}
 
-		ret = add_header_field(client, &buf, &buflen, hdr->name, hdr->value);
+		ret = add_header_field(encoder, header_field, &buf, &buflen, hdr->name,
+				       hdr->value);
 		if (ret < 0) {
-			return ret;
+			goto encode_fail;
 		}
 	}
 
 	if (!content_encoding_sent && detail_common && detail_common->content_encoding != NULL) {
-		ret = add_header_field(client, &buf, &buflen, "content-encoding",
+		ret = add_header_field(encoder, header_field, &buf, &buflen, "content-encoding",
 				       detail_common->content_encoding);
 		if (ret < 0) {
-			return ret;
+			goto encode_fail;
 		}
 	}
 
 	if (!content_type_sent && detail_common && detail_common->content_type != NULL) {
-		ret = add_header_field(client, &buf, &buflen, "content-type",
+		ret = add_header_field(encoder, header_field, &buf, &buflen, "content-type",
 				       detail_common->content_type);
 		if (ret < 0) {
-			return ret;
+			goto encode_fail;
 		}
 	}
 
@@ -200,18 +279,32 @@ static int send_headers_frame(struct http_client_ctx *client, enum http_status s
 	flags |= HTTP2_FLAG_END_HEADERS;
 
 	encode_frame_header(headers_frame, payload_len, HTTP2_HEADERS_FRAME,
-			    flags, stream_id);
+			    flags, stream->stream_id);
 
 	ret = http_server_sendall(client, headers_frame,
 				  payload_len + HTTP2_FRAME_HEADER_SIZE);
+	if (ret == 0) {
+		stream->headers_sent = true;
+	}
+
+	http2_tx_unlock(client);
+
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
 		return ret;
 	}
 
-	client->current_stream->headers_sent = true;
-
 	return 0;
+
+encode_fail:
+	/* The entries added for this header block never reach the peer */
+	if (encoder != NULL) {
+		http_hpack_encoder_reset(encoder);
+	}
+
+	http2_tx_unlock(client);
+
+	return ret;
 }
 
 static int send_data_frame(struct http_client_ctx *client, const char *payload,
@@ -225,6 +318,8 @@ static int send_data_frame(struct http_client_ctx *client, const char *payload,
 			    HTTP2_FLAG_END_STREAM : 0,
 			    stream_id);
 
+	http2_tx_lock(client);
+
 	ret = http_server_sendall(client, frame_header, sizeof(frame_header));
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
@@ -237,9 +332,104 @@ static int send_data_frame(struct http_client_ctx *client, const char *payload,
 		}
 	}
 
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+	/* Most of the responses are sent without waiting for the send
+	 * window, but they still count against it.
+	 */
+	if (ret == 0) {
+		struct http2_stream_ctx *stream = find_http_stream_context(client, stream_id);
+
+		if (stream != NULL) {
+			stream->send_window -= length;
+		}
+
+		client->send_window -= length;
+	}
+#endif
+
+	http2_tx_unlock(client);
+
 	return ret;
 }
 
+#define HTTP2_DEFAULT_MAX_FRAME_SIZE 16384
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+#define SEND_WINDOW_TIMEOUT K_SECONDS(CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT)
+
+/* Send the response data from a worker, in chunks that fit in both the
+ * stream and the connection send windows. The worker waits for the peer to
+ * open the windows, the server thread keeps processing WINDOW_UPDATE frames
+ * meanwhile.
+ */
+static int send_job_data(struct http_client_ctx *client, struct http2_stream_ctx *stream,
+			 const char *payload, size_t length, uint8_t flags)
+{
+	k_timepoint_t end = sys_timepoint_calc(SEND_WINDOW_TIMEOUT);
+	size_t chunk;
+	int window;
+	int ret;
+
+	(void)k_mutex_lock(&client->tx_lock, K_FOREVER);
+
+	while (true) {
+		if (client->closing) {
+			ret = -ECONNABORTED;
+			break;
+		}
+
+		if (stream->reset) {
+			ret = -ECONNRESET;
+			break;
+		}
+
+		window = MIN(stream->send_window, client->send_window);
+		if (length > 0 && window <= 0) {
+			ret = k_condvar_wait(&client->tx_cond, &client->tx_lock,
+					     sys_timepoint_timeout(end));
+			if (ret < 0) {
+				LOG_DBG("Stream %d send window closed", stream->stream_id);
+				ret = -ETIMEDOUT;
+				break;
+			}
+
+			continue;
+		}
+
+		chunk = MIN(length, HTTP2_DEFAULT_MAX_FRAME_SIZE);
+		if (length > 0) {
+			chunk = MIN(chunk, (size_t)window);
+		}
+
+		ret = send_data_frame(client, payload, chunk, stream->stream_id,
+				      chunk == length ? flags : 0);
+		if (ret < 0 || chunk == length) {
+			break;
+		}
+
+		payload += chunk;
+		length -= chunk;
+	}
+
+	k_mutex_unlock(&client->tx_lock);
+
+	return ret;
+}
+#endif /* CONFIG_HTTP_SERVER_WORKERS */
+
+static int send_stream_data_frame(struct http_client_ctx *client,
+				  struct http2_stream_ctx *stream,
+				  const char *payload, size_t length, uint8_t flags)
+{
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	if (stream->job != NULL) {
+		return send_job_data(client, stream, payload, length, flags);
+	}
+#endif
+
+	return send_data_frame(client, payload, length, stream->stream_id, flags);
+}
+
 int send_settings_frame(struct http_client_ctx *client, bool ack)
 {
 	uint8_t settings_frame[HTTP2_FRAME_HEADER_SIZE +
@@ -274,7 +464,9 @@ int send_settings_frame(struct http_client_ctx *client, bool ack)
 		      2 * sizeof(struct http2_settings_field);
 	}
 
+	http2_tx_lock(client);
 	ret = http_server_sendall(client, settings_frame, len);
+	http2_tx_unlock(client);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
 		return ret;
@@ -308,8 +500,32 @@ int send_window_update_frame(struct http_client_ctx *client,
 	sys_put_be32(window_update,
 		     window_update_frame + HTTP2_FRAME_HEADER_SIZE);
 
+	http2_tx_lock(client);
 	ret = http_server_sendall(client, window_update_frame,
 				  sizeof(window_update_frame));
+	http2_tx_unlock(client);
+	if (ret < 0) {
+		LOG_DBG("Cannot write to socket (%d)", ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+static int send_rst_stream_frame(struct http_client_ctx *client, uint32_t stream_id,
+				 uint32_t error_code)
+{
+	uint8_t rst_stream_frame[HTTP2_FRAME_HEADER_SIZE + HTTP2_RST_STREAM_FRAME_LEN];
+	int ret;
+
+	encode_frame_header(rst_stream_frame, HTTP2_RST_STREAM_FRAME_LEN,
+			    HTTP2_RST_STREAM_FRAME, 0, stream_id);
+	sys_put_be32(error_code, rst_stream_frame + HTTP2_FRAME_HEADER_SIZE);
+
+	http2_tx_lock(client);
+	ret = http_server_sendall(client, rst_stream_frame, sizeof(rst_stream_frame));
+	http2_tx_unlock(client);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
 		return ret;
@@ -318,12 +534,38 @@ int send_window_update_frame(struct http_client_ctx *client,
 	return 0;
 }
 
+static int send_goaway_frame(struct http_client_ctx *client, uint32_t error_code)
+{
+	uint8_t goaway_frame[HTTP2_FRAME_HEADER_SIZE + HTTP2_GOAWAY_FRAME_LEN];
+	uint32_t last_stream_id = 0;
+	int ret;
+
+	ARRAY_FOR_EACH(client->streams, i) {
+		last_stream_id = MAX(last_stream_id, client->streams[i].stream_id);
+	}
+
+	encode_frame_header(goaway_frame, HTTP2_GOAWAY_FRAME_LEN, HTTP2_GOAWAY_FRAME, 0, 0);
+	sys_put_be32(last_stream_id, goaway_frame + HTTP2_FRAME_HEADER_SIZE);
+	sys_put_be32(error_code, goaway_frame + HTTP2_FRAME_HEADER_SIZE + sizeof(uint32_t));
+
+	http2_tx_lock(client);
+	ret = http_server_sendall(client, goaway_frame, sizeof(goaway_frame));
+	http2_tx_unlock(client);
+	if (ret < 0) {
+		LOG_DBG("Cannot write to socket (%d)", ret);
+		return ret;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_SEND_WINDOW */
+
 static int send_http2_404(struct http_client_ctx *client,
 			  struct http2_frame *frame)
 {
 	int ret;
 
-	ret = send_headers_frame(client, HTTP_404_NOT_FOUND, frame->stream_identifier, NULL, 0,
+	ret = send_headers_frame(client, HTTP_404_NOT_FOUND, client->current_stream, NULL, 0,
 				 NULL, 0);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
@@ -346,7 +588,7 @@ static int send_http2_405(struct http_client_ctx *client,
 	int ret;
 
 	ret = send_headers_frame(client, HTTP_405_METHOD_NOT_ALLOWED,
-				 frame->stream_identifier, NULL,
+				 client->current_stream, NULL,
 				 HTTP2_FLAG_END_STREAM, NULL, 0);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
@@ -361,7 +603,7 @@ static int send_http2_409(struct http_client_ctx *client,
 {
 	int ret;
 
-	ret = send_headers_frame(client, HTTP_409_CONFLICT, frame->stream_identifier, NULL,
+	ret = send_headers_frame(client, HTTP_409_CONFLICT, client->current_stream, NULL,
 				 HTTP2_FLAG_END_STREAM, NULL, 0);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
@@ -371,7 +613,7 @@ static int send_http2_409(struct http_client_ctx *client,
 }
 
 static void send_http2_500(struct http_client_ctx *client,
-			   struct http2_frame *frame, int error_code)
+			   struct http2_stream_ctx *stream, int error_code)
 {
 #define HTTP_500_RESPONSE_TEMPLATE "Internal Server Error%s%s"
 #define MAX_ERROR_DESC_LEN 32
@@ -400,14 +642,14 @@ static void send_http2_500(struct http_client_ctx *client,
 	}
 
 	if (send_headers_frame(client, HTTP_500_INTERNAL_SERVER_ERROR,
-			       frame->stream_identifier, NULL, 0, NULL, 0) < 0) {
+			       stream, NULL, 0, NULL, 0) < 0) {
 		return;
 	}
 
 	(void)snprintk(http_response, sizeof(http_response),
 		       HTTP_500_RESPONSE_TEMPLATE, desc_separator, error_desc);
-	(void)send_data_frame(client, http_response, strlen(http_response),
-			      frame->stream_identifier, HTTP2_FLAG_END_STREAM);
+	(void)send_stream_data_frame(client, stream, http_response, strlen(http_response),
+				     HTTP2_FLAG_END_STREAM);
 }
 
 static int handle_http2_static_resource(
@@ -429,7 +671,7 @@ static int handle_http2_static_resource(
 	content_200 = static_detail->static_data;
 	content_len = static_detail->static_data_len;
 
-	ret = send_headers_frame(client, HTTP_200_OK, frame->stream_identifier,
+	ret = send_headers_frame(client, HTTP_200_OK, client->current_stream,
 				 &static_detail->common, 0, NULL, 0);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
@@ -451,6 +693,167 @@ out:
 }
 
 #if defined(CONFIG_FILE_SYSTEM)
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+static void release_cached_send(struct http2_stream_ctx *stream)
+{
+	if (stream->cache_entry != NULL) {
+		http_server_cache_put(stream->cache_entry);
+		stream->cache_entry = NULL;
+	}
+}
+
+/* Send as much of the cached file as the stream and connection send windows
+ * allow. The server thread cannot wait for the peer to open the windows, so
+ * the rest is sent when a WINDOW_UPDATE or SETTINGS frame arrives.
+ * Returns 1 once the whole file is sent.
+ */
+static int send_cached_data(struct http_client_ctx *client, struct http2_stream_ctx *stream)
+{
+	const uint8_t *data = stream->cache_entry->data;
+	size_t chunk;
+	int window;
+	int ret = 0;
+
+	http2_tx_lock(client);
+
+	do {
+		window = MIN(stream->send_window, client->send_window);
+		if (stream->cache_len > 0 && window <= 0) {
+			break;
+		}
+
+		chunk = MIN(stream->cache_len, HTTP2_DEFAULT_MAX_FRAME_SIZE);
+		if (chunk > 0) {
+			chunk = MIN(chunk, (size_t)window);
+		}
+
+		ret = send_data_frame(client, data + stream->cache_offset, chunk,
+				      stream->stream_id,
+				      chunk == stream->cache_len ? HTTP2_FLAG_END_STREAM : 0);
+		if (ret < 0) {
+			break;
+		}
+
+		stream->cache_offset += chunk;
+		stream->cache_len -= chunk;
+
+		if (stream->cache_len == 0) {
+			stream->end_stream_sent = true;
+			release_cached_send(stream);
+			ret = 1;
+			break;
+		}
+	} while (true);
+
+	http2_tx_unlock(client);
+
+	return ret;
+}
+
+static int resume_cached_send(struct http_client_ctx *client)
+{
+	int ret;
+
+	ARRAY_FOR_EACH_PTR(client->streams, stream) {
+		if (stream->cache_entry == NULL) {
+			continue;
+		}
+
+		ret = send_cached_data(client, stream);
+		if (ret < 0) {
+			LOG_DBG("Cannot write to socket (%d)", ret);
+			return ret;
+		}
+
+		if (ret > 0) {
+			release_http_stream_context(client, stream->stream_id);
+		}
+	}
+
+	return 0;
+}
+
+/* Serve the file from RAM, in frames as large as the peer accepts by
+ * default instead of the small chunks read from the file system.
+ */
+static int handle_http2_static_fs_cached(struct http_client_ctx *client,
+					 struct http_resource_detail *res_detail,
+					 struct http_static_fs_cache_entry *entry)
+{
+	struct http2_stream_ctx *stream = client->current_stream;
+	char etag[HTTP_SERVER_ETAG_LEN + 1];
+	char content_range[sizeof("bytes 01234567890123456789-01234567890123456789/"
+				  "01234567890123456789")];
+	/* All of these are in the HPACK static table, so only the values
+	 * take room in the header frame.
+	 */
+	const struct http_header headers[] = {
+		{ .name = "etag", .value = etag },
+		{ .name = "accept-ranges", .value = "bytes" },
+		{ .name = "content-range", .value = content_range },
+	};
+	enum http_status status = HTTP_200_OK;
+	size_t header_count = 2;
+	size_t offset;
+	size_t len;
+	int ret;
+
+	snprintk(etag, sizeof(etag), "\"%08x\"", entry->etag);
+
+	if (http_server_cache_not_modified(client, entry)) {
+		ret = send_headers_frame(client, HTTP_304_NOT_MODIFIED, stream, NULL,
+					 HTTP2_FLAG_END_STREAM, headers, 1);
+		goto out;
+	}
+
+	ret = http_server_cache_range(client, entry->size, &offset, &len);
+	if (ret == -ERANGE) {
+		snprintk(content_range, sizeof(content_range), "bytes */%zu", entry->size);
+		ret = send_headers_frame(client, HTTP_416_RANGE_NOT_SATISFIABLE, stream, NULL,
+					 HTTP2_FLAG_END_STREAM, &headers[2], 1);
+		goto out;
+	}
+
+	if (ret > 0) {
+		snprintk(content_range, sizeof(content_range), "bytes %zu-%zu/%zu", offset,
+			 offset + len - 1, entry->size);
+		status = HTTP_206_PARTIAL_CONTENT;
+		header_count = ARRAY_SIZE(headers);
+	}
+
+	ret = send_headers_frame(client, status, stream, res_detail, 0, headers, header_count);
+	if (ret < 0) {
+		goto out;
+	}
+
+	/* The stream holds on to the entry until the whole file is sent */
+	stream->cache_entry = entry;
+	stream->cache_offset = offset;
+	stream->cache_len = len;
+
+	ret = send_cached_data(client, stream);
+	if (ret < 0) {
+		LOG_DBG("Cannot write to socket (%d)", ret);
+		release_cached_send(stream);
+		return ret;
+	}
+
+	return 0;
+
+out:
+	http_server_cache_put(entry);
+
+	if (ret < 0) {
+		LOG_DBG("Cannot write to socket (%d)", ret);
+		return ret;
+	}
+
+	stream->end_stream_sent = true;
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS_CACHE */
+
 static int handle_http2_static_fs_resource(struct http_resource_detail_static_fs *static_fs_detail,
 					   struct http2_frame *frame,
 					   struct http_client_ctx *client)
@@ -470,6 +873,9 @@ static int handle_http2_static_fs_resource(struct http_resource_detail_static_fs
 	int len;
 	int remaining;
 	char tmp[64];
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	struct http_static_fs_cache_entry *entry;
+#endif
 
 	if (client->method != HTTP_GET) {
 		return send_http2_405(client, frame);
@@ -501,13 +907,25 @@ static int handle_http2_static_fs_resource(struct http_resource_detail_static_fs
 	if (ret < 0) {
 		LOG_ERR("fs_stat %s: %d", fname, ret);
 
-		ret = send_headers_frame(client, HTTP_404_NOT_FOUND, frame->stream_identifier, NULL,
+		ret = send_headers_frame(client, HTTP_404_NOT_FOUND, client->current_stream, NULL,
 					 0, NULL, 0);
 		if (ret < 0) {
 			LOG_DBG("Cannot write to socket (%d)", ret);
 		}
 		return ret;
 	}
+
+	if (IS_ENABLED(CONFIG_HTTP_SERVER_COMPRESSION)) {
+		res_detail.content_encoding = http_compression_text(chosen_compression);
+	}
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	entry = http_server_cache_get(fname, client->data_len);
+	if (entry != NULL) {
+		return handle_http2_static_fs_cached(client, &res_detail, entry);
+	}
+#endif
+
 	fs_file_t_init(&file);
 	ret = fs_open(&file, fname, FS_O_READ);
 	if (ret < 0) {
@@ -518,10 +936,7 @@ static int handle_http2_static_fs_resource(struct http_resource_detail_static_fs
 	}
 
 	/* send headers */
-	if (IS_ENABLED(CONFIG_HTTP_SERVER_COMPRESSION)) {
-		res_detail.content_encoding = http_compression_text(chosen_compression);
-	}
-	ret = send_headers_frame(client, HTTP_200_OK, frame->stream_identifier, &res_detail, 0,
+	ret = send_headers_frame(client, HTTP_200_OK, client->current_stream, &res_detail, 0,
 				 NULL, 0);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
@@ -556,7 +971,8 @@ out:
 }
 #endif /* CONFIG_FILE_SYSTEM */
 
-static int http2_dynamic_response(struct http_client_ctx *client, struct http2_frame *frame,
+static int http2_dynamic_response(struct http_client_ctx *client,
+				  struct http2_stream_ctx *stream,
 				  struct http_response_ctx *rsp,
 				  enum http_transaction_status status,
 				  struct http_resource_detail_dynamic *dynamic_detail)
@@ -565,12 +981,12 @@ static int http2_dynamic_response(struct http_client_ctx *client, struct http2_f
 	uint8_t flags = 0;
 	bool final_response = http_response_is_final(rsp, status);
 
-	if (client->current_stream->headers_sent && (rsp->header_count > 0 || rsp->status != 0)) {
+	if (stream->headers_sent && (rsp->header_count > 0 || rsp->status != 0)) {
 		LOG_WRN("Already sent headers, dropping new headers and/or response code");
 	}
 
 	/* Send headers and response code if not already sent */
-	if (!client->current_stream->headers_sent) {
+	if (!stream->headers_sent) {
 		/* Use '200 OK' status if not specified by application */
 		if (rsp->status == 0) {
 			rsp->status = 200;
@@ -589,10 +1005,10 @@ static int http2_dynamic_response(struct http_client_ctx *client, struct http2_f
 
 		if (final_response && rsp->body_len == 0) {
 			flags |= HTTP2_FLAG_END_STREAM;
-			client->current_stream->end_stream_sent = true;
+			stream->end_stream_sent = true;
 		}
 
-		ret = send_headers_frame(client, rsp->status, frame->stream_identifier,
+		ret = send_headers_frame(client, rsp->status, stream,
 					 (struct http_resource_detail *)dynamic_detail, flags,
 					 rsp->headers, rsp->header_count);
 		if (ret < 0) {
@@ -604,11 +1020,10 @@ static int http2_dynamic_response(struct http_client_ctx *client, struct http2_f
 	if (rsp->body != NULL && rsp->body_len > 0) {
 		if (final_response) {
 			flags |= HTTP2_FLAG_END_STREAM;
-			client->current_stream->end_stream_sent = true;
+			stream->end_stream_sent = true;
 		}
 
-		ret = send_data_frame(client, rsp->body, rsp->body_len, frame->stream_identifier,
-				      flags);
+		ret = send_stream_data_frame(client, stream, rsp->body, rsp->body_len, flags);
 		if (ret < 0) {
 			return ret;
 		}
@@ -617,28 +1032,22 @@ static int http2_dynamic_response(struct http_client_ctx *client, struct http2_f
 	return 0;
 }
 
-static int dynamic_get_del_opts_req_v2(struct http_resource_detail_dynamic *dynamic_detail,
-				       struct http_client_ctx *client)
+static int dynamic_get_del_opts_stream(struct http_resource_detail_dynamic *dynamic_detail,
+				       struct http_client_ctx *client,
+				       struct http2_stream_ctx *stream,
+				       uint8_t *params, size_t params_len,
+				       struct http_header_capture_ctx *headers_ctx)
 {
-	int ret, len;
-	char *ptr;
-	struct http2_frame *frame = &client->current_frame;
+	int ret;
 	enum http_transaction_status status;
 	struct http_request_ctx request_ctx;
 	struct http_response_ctx response_ctx;
 
-	if (client->current_stream == NULL) {
-		return -ENOENT;
-	}
-
-	/* Start of GET params */
-	ptr = &client->url_buffer[dynamic_detail->common.path_len];
-	len = strlen(ptr);
 	status = HTTP_SERVER_REQUEST_DATA_FINAL;
 
 	do {
 		memset(&response_ctx, 0, sizeof(response_ctx));
-		populate_request_ctx(&request_ctx, ptr, len, &client->header_capture_ctx);
+		populate_request_ctx(&request_ctx, params, params_len, headers_ctx);
 
 		ret = dynamic_detail->cb(client, status, &request_ctx, &response_ctx,
 					 dynamic_detail->user_data);
@@ -646,19 +1055,19 @@ static int dynamic_get_del_opts_req_v2(struct http_resource_detail_dynamic *dyna
 			return ret;
 		}
 
-		ret = http2_dynamic_response(client, frame, &response_ctx, status, dynamic_detail);
+		ret = http2_dynamic_response(client, stream, &response_ctx, status,
+					     dynamic_detail);
 		if (ret < 0) {
 			return ret;
 		}
 
 		/* URL params are passed in the first cb only */
-		len = 0;
+		params_len = 0;
 	} while (!http_response_is_final(&response_ctx, status));
 
-	if (!client->current_stream->end_stream_sent) {
-		client->current_stream->end_stream_sent = true;
-		ret = send_data_frame(client, NULL, 0, frame->stream_identifier,
-				      HTTP2_FLAG_END_STREAM);
+	if (!stream->end_stream_sent) {
+		stream->end_stream_sent = true;
+		ret = send_stream_data_frame(client, stream, NULL, 0, HTTP2_FLAG_END_STREAM);
 		if (ret < 0) {
 			LOG_DBG("Cannot send last frame (%d)", ret);
 			return ret;
@@ -676,6 +1085,116 @@ static int dynamic_get_del_opts_req_v2(struct http_resource_detail_dynamic *dyna
 	return ret;
 }
 
+static int dynamic_get_del_opts_req_v2(struct http_resource_detail_dynamic *dynamic_detail,
+				       struct http_client_ctx *client)
+{
+	char *ptr;
+
+	if (client->current_stream == NULL) {
+		return -ENOENT;
+	}
+
+	/* Start of GET params */
+	ptr = &client->url_buffer[dynamic_detail->common.path_len];
+
+	return dynamic_get_del_opts_stream(dynamic_detail, client, client->current_stream,
+					   ptr, strlen(ptr), &client->header_capture_ctx);
+}
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+static void dynamic_get_del_opts_job(struct k_work *work)
+{
+	struct http_server_job *job = CONTAINER_OF(work, struct http_server_job, work);
+	struct http_resource_detail_dynamic *dynamic_detail = job->detail;
+	struct http_client_ctx *client = job->client;
+	struct http2_stream_ctx *stream = job->stream;
+	struct http_header_capture_ctx *headers_ctx = NULL;
+	int ret;
+
+	IF_ENABLED(CONFIG_HTTP_SERVER_CAPTURE_HEADERS, (headers_ctx = &job->header_capture_ctx;))
+
+	ret = dynamic_get_del_opts_stream(dynamic_detail, client, stream, job->params,
+					  job->params_len, headers_ctx);
+	if (ret == -ECONNRESET) {
+		struct http_request_ctx request_ctx;
+		struct http_response_ctx response_ctx;
+
+		/* Only the stream was reset by the peer, the connection
+		 * goes on.
+		 */
+		populate_request_ctx(&request_ctx, NULL, 0, NULL);
+		dynamic_detail->cb(client, HTTP_SERVER_TRANSACTION_ABORTED, &request_ctx,
+				   &response_ctx, dynamic_detail->user_data);
+		dynamic_detail->holder = NULL;
+	} else if (ret < 0 && ret != -ECONNABORTED) {
+		LOG_DBG("Stream %d failed (%d)", stream->stream_id, ret);
+
+		if (!stream->headers_sent) {
+			send_http2_500(client, stream, -ret);
+		}
+
+		/* Let the server thread close the connection, like it does
+		 * when the handler fails in the server thread.
+		 */
+		(void)zsock_shutdown(client->fd, ZSOCK_SHUT_RD);
+	}
+
+	http2_tx_lock(client);
+	stream->job = NULL;
+	clear_http_stream_context(stream);
+	http2_tx_unlock(client);
+
+	http_server_job_free(job);
+}
+
+/* Hand the request over to a worker, the request data is copied as the
+ * client context is reused for the next frames meanwhile.
+ */
+static int dynamic_get_del_opts_dispatch(struct http_resource_detail_dynamic *dynamic_detail,
+					 struct http_client_ctx *client)
+{
+	struct http2_stream_ctx *stream = client->current_stream;
+	struct http_server_job *job;
+	char *ptr;
+
+	if (stream == NULL) {
+		return -ENOENT;
+	}
+
+	job = http_server_job_alloc(client);
+	if (job == NULL) {
+		return -ENOMEM;
+	}
+
+	ptr = &client->url_buffer[dynamic_detail->common.path_len];
+	job->params_len = strlen(ptr);
+	memcpy(job->params, ptr, job->params_len + 1);
+
+#if defined(CONFIG_HTTP_SERVER_CAPTURE_HEADERS)
+	struct http_header_capture_ctx *headers_ctx = &job->header_capture_ctx;
+
+	*headers_ctx = client->header_capture_ctx;
+
+	for (size_t i = 0; i < headers_ctx->count; i++) {
+		struct http_header *hdr = &headers_ctx->headers[i];
+
+		hdr->name = (const char *)headers_ctx->buffer +
+			    (hdr->name - (const char *)client->header_capture_ctx.buffer);
+		hdr->value = (const char *)headers_ctx->buffer +
+			     (hdr->value - (const char *)client->header_capture_ctx.buffer);
+	}
+#endif
+
+	job->detail = dynamic_detail;
+	job->stream = stream;
+	stream->job = job;
+
+	http_server_job_submit(job, dynamic_get_del_opts_job);
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_WORKERS */
+
 static int dynamic_post_put_req_v2(struct http_resource_detail_dynamic *dynamic_detail,
 				   struct http_client_ctx *client, bool headers_only)
 {
@@ -726,7 +1245,8 @@ static int dynamic_post_put_req_v2(struct http_resource_detail_dynamic *dynamic_
 	 * Don't send a default response until the application has had a chance to respond.
 	 */
 	if (http_response_is_provided(&response_ctx)) {
-		ret = http2_dynamic_response(client, frame, &response_ctx, status, dynamic_detail);
+		ret = http2_dynamic_response(client, client->current_stream, &response_ctx,
+					     status, dynamic_detail);
 		if (ret < 0) {
 			return ret;
 		}
@@ -744,7 +1264,8 @@ static int dynamic_post_put_req_v2(struct http_resource_detail_dynamic *dynamic_
 			return ret;
 		}
 
-		ret = http2_dynamic_response(client, frame, &response_ctx, status, dynamic_detail);
+		ret = http2_dynamic_response(client, client->current_stream, &response_ctx,
+					     status, dynamic_detail);
 		if (ret < 0) {
 			return ret;
 		}
@@ -759,7 +1280,8 @@ static int dynamic_post_put_req_v2(struct http_resource_detail_dynamic *dynamic_
 		} else {
 			memset(&response_ctx, 0, sizeof(response_ctx));
 			response_ctx.final_chunk = true;
-			ret = http2_dynamic_response(client, frame, &response_ctx,
+			ret = http2_dynamic_response(client, client->current_stream,
+						     &response_ctx,
 						     HTTP_SERVER_REQUEST_DATA_FINAL,
 						     dynamic_detail);
 		}
@@ -820,6 +1342,14 @@ static int handle_http2_dynamic_resource(
 	case HTTP_DELETE:
 	case HTTP_OPTIONS:
 		if (user_method & BIT(client->method)) {
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+			/* Served from the server thread if no worker job is
+			 * available.
+			 */
+			if (dynamic_get_del_opts_dispatch(dynamic_detail, client) == 0) {
+				return 0;
+			}
+#endif
 			return dynamic_get_del_opts_req_v2(dynamic_detail, client);
 		}
 
@@ -957,6 +1487,10 @@ static int enter_http_frame_headers_state(struct http_client_ctx *client)
 		client->header_capture_ctx.current_stream = stream;
 	}
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	http_server_cache_reset_request(client);
+#endif
+
 	client->server_state = HTTP_SERVER_FRAME_HEADERS_STATE;
 
 	return 0;
@@ -1176,7 +1710,7 @@ int handle_http1_to_http2_upgrade(struct http_client_ctx *client)
 error:
 	if (ret != -EAGAIN && client->current_stream &&
 	    !client->current_stream->headers_sent) {
-		send_http2_500(client, frame, -ret);
+		send_http2_500(client, client->current_stream, -ret);
 	}
 
 	return ret;
@@ -1308,7 +1842,7 @@ int handle_http_frame_data(struct http_client_ctx *client)
 error:
 	if (ret != -EAGAIN && client->current_stream &&
 	    !client->current_stream->headers_sent) {
-		send_http2_500(client, frame, -ret);
+		send_http2_500(client, client->current_stream, -ret);
 	}
 
 	return ret;
@@ -1428,6 +1962,15 @@ static int process_header(struct http_client_ctx *client,
 						       &client->supported_compression);
 	}
 #endif /* CONFIG_HTTP_SERVER_COMPRESSION */
+#ifdef CONFIG_HTTP_SERVER_STATIC_FS_CACHE
+	else if (header->name_len == (sizeof("if-none-match") - 1) &&
+		 memcmp(header->name, "if-none-match", header->name_len) == 0) {
+		http_server_cache_parse_if_none_match(client, header->value, header->value_len);
+	} else if (header->name_len == (sizeof("range") - 1) &&
+		   memcmp(header->name, "range", header->name_len) == 0) {
+		http_server_cache_parse_range(client, header->value, header->value_len);
+	}
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS_CACHE */
 	else {
 		/* Just ignore for now. */
 		LOG_DBG("Ignoring field %.*s", (int)header->name_len, header->name);
@@ -1525,7 +2068,7 @@ static int handle_http_frame_headers_end_stream(struct http_client_ctx *client)
 		/* Force end stream */
 		response_ctx.final_chunk = true;
 
-		ret = http2_dynamic_response(client, frame, &response_ctx,
+		ret = http2_dynamic_response(client, client->current_stream, &response_ctx,
 					     HTTP_SERVER_REQUEST_DATA_FINAL, dynamic_detail);
 
 		if (ret < 0) {
@@ -1544,7 +2087,7 @@ static int handle_http_frame_headers_end_stream(struct http_client_ctx *client)
 	}
 
 	if (!client->current_stream->headers_sent) {
-		ret = send_headers_frame(client, HTTP_200_OK, frame->stream_identifier,
+		ret = send_headers_frame(client, HTTP_200_OK, client->current_stream,
 					 client->current_stream->current_detail,
 					 HTTP2_FLAG_END_STREAM, NULL, 0);
 		if (ret < 0) {
@@ -1686,7 +2229,7 @@ int handle_http_frame_headers(struct http_client_ctx *client)
 error:
 	if (ret != -EAGAIN && client->current_stream &&
 	    !client->current_stream->headers_sent) {
-		send_http2_500(client, frame, -ret);
+		send_http2_500(client, client->current_stream, -ret);
 	}
 
 	return ret;
@@ -1717,6 +2260,25 @@ int handle_http_frame_priority(struct http_client_ctx *client)
 	return 0;
 }
 
+static void reset_http_stream(struct http_client_ctx *client,
+			      struct http2_stream_ctx *stream)
+{
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	/* Stop the worker serving the stream, if any */
+	http2_tx_lock(client);
+	stream->reset = true;
+	k_condvar_broadcast(&client->tx_cond);
+	http2_tx_unlock(client);
+#endif
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	/* Drop the rest of the cached file, if any */
+	release_cached_send(stream);
+#endif
+
+	release_http_stream_context(client, stream->stream_id);
+}
+
 int handle_http_frame_rst_stream(struct http_client_ctx *client)
 {
 	struct http2_frame *frame = &client->current_frame;
@@ -1747,7 +2309,7 @@ int handle_http_frame_rst_stream(struct http_client_ctx *client)
 	LOG_DBG("Stream %u reset with error code %u", stream_ctx->stream_id,
 		error_code);
 
-	release_http_stream_context(client, stream_ctx->stream_id);
+	reset_http_stream(client, stream_ctx);
 
 	client->data_len -= HTTP2_RST_STREAM_FRAME_LEN;
 	client->cursor += HTTP2_RST_STREAM_FRAME_LEN;
@@ -1757,6 +2319,78 @@ int handle_http_frame_rst_stream(struct http_client_ctx *client)
 	return 0;
 }
 
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW) || defined(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE)
+static int apply_peer_settings(struct http_client_ctx *client, const uint8_t *buf,
+			       size_t len)
+{
+	int ret = 0;
+
+	http2_tx_lock(client);
+
+	for (; ret == 0 && len >= sizeof(struct http2_settings_field);
+	     buf += sizeof(struct http2_settings_field),
+	     len -= sizeof(struct http2_settings_field)) {
+		uint16_t id = sys_get_be16(buf);
+		uint32_t value = sys_get_be32(buf + sizeof(uint16_t));
+
+		switch (id) {
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+		case HTTP2_SETTINGS_INITIAL_WINDOW_SIZE: {
+			int64_t delta;
+
+			if (value > INT32_MAX) {
+				ret = -EBADMSG;
+				break;
+			}
+
+			/* The change applies to the windows of the open streams too,
+			 * none of them may grow past the maximum window size.
+			 */
+			delta = (int64_t)value - client->peer_initial_window;
+
+			ARRAY_FOR_EACH(client->streams, i) {
+				if (client->streams[i].stream_state != HTTP2_STREAM_IDLE &&
+				    !IN_RANGE(client->streams[i].send_window + delta,
+					      INT32_MIN, INT32_MAX)) {
+					ret = -EBADMSG;
+					break;
+				}
+			}
+
+			if (ret < 0) {
+				break;
+			}
+
+			client->peer_initial_window = (int)value;
+
+			ARRAY_FOR_EACH(client->streams, i) {
+				if (client->streams[i].stream_state != HTTP2_STREAM_IDLE) {
+					client->streams[i].send_window += (int)delta;
+				}
+			}
+
+			break;
+		}
+#endif
+#if defined(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE)
+		case HTTP2_SETTINGS_HEADER_TABLE_SIZE:
+			http_hpack_encoder_set_max_size(&client->hpack_encoder, value);
+			break;
+#endif
+		default:
+			break;
+		}
+	}
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+	k_condvar_broadcast(&client->tx_cond);
+#endif
+	http2_tx_unlock(client);
+
+	return ret;
+}
+#endif /* CONFIG_HTTP_SERVER_SEND_WINDOW || CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE */
+
 int handle_http_frame_settings(struct http_client_ctx *client)
 {
 	struct http2_frame *frame = &client->current_frame;
@@ -1768,6 +2402,21 @@ int handle_http_frame_settings(struct http_client_ctx *client)
 		return -EAGAIN;
 	}
 
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW) || defined(CONFIG_HTTP_SERVER_HPACK_DYNAMIC_TABLE)
+	if (!is_header_flag_set(frame->flags, HTTP2_FLAG_SETTINGS_ACK)) {
+		int ret;
+
+		ret = apply_peer_settings(client, client->cursor, frame->length);
+		if (ret < 0) {
+			LOG_DBG("Invalid initial window size");
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+			(void)send_goaway_frame(client, HTTP2_FLOW_CONTROL_ERROR);
+#endif
+			return ret;
+		}
+	}
+#endif
+
 	bytes_consumed = client->current_frame.length;
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
@@ -1780,6 +2429,14 @@ int handle_http_frame_settings(struct http_client_ctx *client)
 			LOG_DBG("Cannot write to socket (%d)", ret);
 			return ret;
 		}
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+		/* The initial window size might have grown */
+		ret = resume_cached_send(client);
+		if (ret < 0) {
+			return ret;
+		}
+#endif
 	}
 
 	client->server_state = HTTP_SERVER_FRAME_HEADER_STATE;
@@ -1814,19 +2471,78 @@ int handle_http_frame_window_update(struct http_client_ctx *client)
 
 	LOG_DBG("HTTP_SERVER_FRAME_WINDOW_UPDATE");
 
-	/* TODO Implement flow control, for now just ignore. */
-
 	if (client->data_len < frame->length) {
 		return -EAGAIN;
 	}
 
+#if defined(CONFIG_HTTP_SERVER_SEND_WINDOW)
+	/* The server thread only keeps track of the send window, the workers
+	 * waiting for it are woken up, and the cached files are sent further.
+	 */
+	if (frame->length == sizeof(uint32_t)) {
+		uint32_t increment = sys_get_be32(client->cursor) & 0x7FFFFFFF;
+		struct http2_stream_ctx *stream = NULL;
+		uint32_t error_code = 0;
+		int *window = NULL;
+		int ret;
+
+		http2_tx_lock(client);
+
+		if (frame->stream_identifier == 0) {
+			window = &client->send_window;
+		} else {
+			stream = find_http_stream_context(client, frame->stream_identifier);
+			if (stream != NULL) {
+				window = &stream->send_window;
+			}
+		}
+
+		/* A window may not be opened past 2^31-1 (RFC 9113, 6.9.1) */
+		if (window != NULL) {
+			if (increment == 0) {
+				error_code = HTTP2_PROTOCOL_ERROR;
+			} else if ((int64_t)*window + increment > INT32_MAX) {
+				error_code = HTTP2_FLOW_CONTROL_ERROR;
+			} else {
+				*window += increment;
+			}
+		}
+
+#if defined(CONFIG_HTTP_SERVER_WORKERS)
+		k_condvar_broadcast(&client->tx_cond);
+#endif
+		http2_tx_unlock(client);
+
+		if (error_code != 0 && stream == NULL) {
+			LOG_DBG("Invalid connection window update (%u)", error_code);
+			(void)send_goaway_frame(client, error_code);
+			return -EBADMSG;
+		}
+
+		if (error_code != 0) {
+			LOG_DBG("Invalid stream %u window update (%u)", stream->stream_id,
+				error_code);
+
+			ret = send_rst_stream_frame(client, stream->stream_id, error_code);
+			reset_http_stream(client, stream);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+	}
+#endif
+
 	bytes_consumed = client->current_frame.length;
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
 
 	client->server_state = HTTP_SERVER_FRAME_HEADER_STATE;
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS_CACHE)
+	return resume_cached_send(client);
+#else
 	return 0;
+#endif
 }
 
 int handle_http_frame_continuation(struct http_client_ctx *client)
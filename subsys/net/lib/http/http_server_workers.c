@@ -0,0 +1,144 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/http/server.h>
+
+LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include "headers/server_internal.h"
+
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+/* Lowest priority cooperative thread, same as the server thread */
+#define THREAD_PRIORITY K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+#endif
+
+K_MEM_SLAB_DEFINE_STATIC(http_job_slab, sizeof(struct http_server_job),
+			 CONFIG_HTTP_SERVER_WORKER_JOB_COUNT, sizeof(void *));
+
+static struct k_work_q http_workers[CONFIG_HTTP_SERVER_WORKER_COUNT];
+static K_KERNEL_STACK_ARRAY_DEFINE(http_worker_stacks, CONFIG_HTTP_SERVER_WORKER_COUNT,
+				   CONFIG_HTTP_SERVER_WORKER_STACK_SIZE);
+
+void http_server_workers_client_init(struct http_client_ctx *client)
+{
+	k_mutex_init(&client->tx_lock);
+	k_condvar_init(&client->tx_cond);
+	client->jobs = 0;
+	client->closing = false;
+}
+
+bool http_server_workers_client_release(struct http_client_ctx *client)
+{
+	bool busy;
+
+	(void)k_mutex_lock(&client->tx_lock, K_FOREVER);
+
+	/* The jobs waiting for the send window give up right away, but a
+	 * resource callback that is running cannot be interrupted. The server
+	 * thread does not wait for it, the client context is cleared once the
+	 * last job is freed.
+	 */
+	client->closing = true;
+	k_condvar_broadcast(&client->tx_cond);
+	busy = client->jobs > 0;
+
+	k_mutex_unlock(&client->tx_lock);
+
+	return busy;
+}
+
+void http_server_workers_client_wait(struct http_client_ctx *client)
+{
+	(void)k_mutex_lock(&client->tx_lock, K_FOREVER);
+
+	client->closing = true;
+	k_condvar_broadcast(&client->tx_cond);
+
+	while (client->jobs > 0) {
+		(void)k_condvar_wait(&client->tx_cond, &client->tx_lock, K_FOREVER);
+	}
+
+	k_mutex_unlock(&client->tx_lock);
+}
+
+bool http_server_workers_client_busy(struct http_client_ctx *client)
+{
+	/* Stop reading from the clients keeping the workers busy until
+	 * there is room for new requests again.
+	 */
+	return client->jobs > 0 && k_mem_slab_num_free_get(&http_job_slab) == 0;
+}
+
+struct http_server_job *http_server_job_alloc(struct http_client_ctx *client)
+{
+	struct http_server_job *job;
+
+	if (k_mem_slab_alloc(&http_job_slab, (void **)&job, K_NO_WAIT) < 0) {
+		return NULL;
+	}
+
+	job->client = client;
+
+	(void)k_mutex_lock(&client->tx_lock, K_FOREVER);
+	client->jobs++;
+	k_mutex_unlock(&client->tx_lock);
+
+	return job;
+}
+
+void http_server_job_submit(struct http_server_job *job, k_work_handler_t handler)
+{
+	/* Pick the worker by resource, so that a resource callback is never
+	 * called from two workers at the same time.
+	 */
+	size_t idx = ((uintptr_t)job->detail / sizeof(*job->detail)) %
+		     ARRAY_SIZE(http_workers);
+
+	k_work_init(&job->work, handler);
+	(void)k_work_submit_to_queue(&http_workers[idx], &job->work);
+}
+
+void http_server_job_free(struct http_server_job *job)
+{
+	struct http_client_ctx *client = job->client;
+
+	(void)k_mutex_lock(&client->tx_lock, K_FOREVER);
+	client->jobs--;
+	k_condvar_broadcast(&client->tx_cond);
+	k_mutex_unlock(&client->tx_lock);
+
+	k_mem_slab_free(&http_job_slab, job);
+
+	/* The server thread might have stopped reading from some client
+	 * while no jobs were available, or be waiting for this job to finish
+	 * closing the client connection.
+	 */
+	http_server_wakeup();
+}
+
+static int http_server_workers_init(void)
+{
+	struct k_work_queue_config q_cfg = {
+		.name = "http_worker",
+		.no_yield = false,
+	};
+
+	ARRAY_FOR_EACH(http_workers, i) {
+		k_work_queue_init(&http_workers[i]);
+		k_work_queue_start(&http_workers[i], http_worker_stacks[i],
+				   K_KERNEL_STACK_SIZEOF(http_worker_stacks[i]),
+				   THREAD_PRIORITY, &q_cfg);
+	}
+
+	return 0;
+}
+
+SYS_INIT(http_server_workers_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -549,6 +549,9 @@ int lwm2m_socket_add(struct lwm2m_ctx *ctx)
 	sock_fds[sock_nfds].events = ZSOCK_POLLIN;
 	sock_nfds++;
 
+	/* Observers of the context are kept while its socket is closed */
+	lwm2m_engine_observers_changed();
+
 	lwm2m_engine_wake_up();
 
 	return 0;
@@ -408,6 +408,8 @@ struct lwm2m_engine_res {
 struct lwm2m_engine_obj_inst {
 	/* instance list */
 	sys_snode_t node;
+	/* path lookup hash bucket */
+	sys_snode_t hash_node;
 
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_res *resources;
@@ -65,6 +65,15 @@ static sys_slist_t obs_obj_path_list;
 
 static struct observe_node observe_node_data[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
 
+/* Filter of the paths observed by any observer, so that resource updates of
+ * unobserved resources do not scan all observation path lists. A bit is set
+ * for the object ID of every observed path, combined with the resource ID for
+ * resource level paths. It is rebuilt on the next lookup after any change of
+ * the observers.
+ */
+static uint64_t observed_filter;
+static bool observed_filter_valid;
+
 /* External resources */
 struct lwm2m_ctx **lwm2m_sock_ctx(void);
 
@@ -336,6 +345,61 @@ static bool lwm2m_notify_observer_list(sys_slist_t *path_list, const struct lwm2
 	return false;
 }
 
+static uint64_t observed_filter_bit(uint16_t obj_id, int32_t res_id)
+{
+	/* res_id is -1 for paths above the resource level */
+	return BIT64((obj_id * 31U + (uint32_t)(res_id + 1)) % 64U);
+}
+
+static void observed_filter_rebuild(void)
+{
+	struct lwm2m_ctx **sock_ctx = lwm2m_sock_ctx();
+	struct lwm2m_obj_path_list *o_p;
+	struct observe_node *obs;
+
+	observed_filter = 0;
+
+	for (int i = 0; i < lwm2m_sock_nfds(); ++i) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&sock_ctx[i]->observer, obs, node) {
+			SYS_SLIST_FOR_EACH_CONTAINER(&obs->path_list, o_p, node) {
+				if (o_p->path.level >= LWM2M_PATH_LEVEL_RESOURCE) {
+					observed_filter |= observed_filter_bit(o_p->path.obj_id,
+									       o_p->path.res_id);
+				} else {
+					observed_filter |= observed_filter_bit(o_p->path.obj_id,
+									       -1);
+				}
+			}
+		}
+	}
+
+	observed_filter_valid = true;
+}
+
+void lwm2m_engine_observers_changed(void)
+{
+	observed_filter_valid = false;
+}
+
+/* Return false if no observer can match the path */
+static bool observed_filter_match(const struct lwm2m_obj_path *path)
+{
+	uint64_t mask = observed_filter_bit(path->obj_id, -1);
+
+	if (!observed_filter_valid) {
+		observed_filter_rebuild();
+	}
+
+	if (path->level >= LWM2M_PATH_LEVEL_RESOURCE) {
+		mask |= observed_filter_bit(path->obj_id, path->res_id);
+	} else {
+		/* Any resource of the object may be observed */
+		return observed_filter != 0;
+	}
+
+	return (observed_filter & mask) != 0;
+}
+
 int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id)
 {
 	struct lwm2m_obj_path path;
@@ -637,6 +701,10 @@ int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path)
 		return 0;
 	}
 
+	if (!observed_filter_match(path)) {
+		return 0;
+	}
+
 	/* look for observers which match our resource */
 	for (i = 0; i < lwm2m_sock_nfds(); ++i) {
 		SYS_SLIST_FOR_EACH_CONTAINER(&sock_ctx[i]->observer, obs, node) {
@@ -753,6 +821,7 @@ static void engine_observe_node_init(struct observe_node *obs, const uint8_t *to
 	obs->format = format;
 	obs->counter = OBSERVE_COUNTER_START;
 	sys_slist_append(&ctx->observer, &obs->node);
+	lwm2m_engine_observers_changed();
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&obs->path_list, tmp, node) {
 		LOG_DBG("OBSERVER ADDED %u/%u/%u/%u(%u)", tmp->path.obj_id, tmp->path.obj_inst_id,
@@ -779,6 +848,7 @@ static void remove_observer_path_from_list(struct lwm2m_ctx *ctx, struct observe
 	/* Remove from the list and add to free list */
 	sys_slist_remove(&obs->path_list, prev_node, &o_p->node);
 	sys_slist_append(&obs_obj_path_list, &o_p->node);
+	lwm2m_engine_observers_changed();
 }
 
 static void engine_observe_single_path_id_remove(struct lwm2m_ctx *ctx, struct observe_node *obs,
@@ -1719,6 +1789,10 @@ bool lwm2m_path_is_observed(const struct lwm2m_obj_path *path)
 	struct observe_node *obs;
 	struct lwm2m_ctx **sock_ctx = lwm2m_sock_ctx();
 
+	if (path->level >= LWM2M_PATH_LEVEL_OBJECT && !observed_filter_match(path)) {
+		return false;
+	}
+
 	for (i = 0; i < lwm2m_sock_nfds(); ++i) {
 		SYS_SLIST_FOR_EACH_CONTAINER(&sock_ctx[i]->observer, obs, node) {
 
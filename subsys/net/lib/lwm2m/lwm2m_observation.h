@@ -10,6 +10,11 @@
 int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id);
 int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path);
 
+/* Invalidate the cached set of observed paths, e.g. when observers become
+ * visible again after their socket is re-added.
+ */
+void lwm2m_engine_observers_changed(void);
+
 #define MAX_TOKEN_LEN 8
 
 struct observe_node {
@@ -18,6 +18,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <inttypes.h>
 #include <ctype.h>
 #include <time.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/kernel.h>
 
@@ -35,13 +36,34 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #define SENML_MAX_NAME_SIZE sizeof("/65535/65535/")
 
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+/* Only the record being formed needs names: its basename and its name */
+#define SENML_CBOR_OUT_NAMES 2
+#define SENML_CBOR_OUT_OBJLNKS 1
+/* Room reserved for the array header, enough for up to UINT16_MAX records */
+#define SENML_CBOR_ARRAY_HDR_MAX 3
+#else
+#define SENML_CBOR_OUT_NAMES CONFIG_LWM2M_RW_SENML_CBOR_RECORDS
+#define SENML_CBOR_OUT_OBJLNKS CONFIG_LWM2M_RW_SENML_CBOR_RECORDS
+#endif
+
 struct cbor_out_fmt_data {
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+	/* Record being formed, encoded as soon as its value is known */
+	struct record rec;
+
+	/* Offset of the reserved array header and number of encoded records */
+	uint16_t array_start;
+	uint16_t rec_cnt;
+	bool array_started;
+#else
 	/* Data */
 	struct lwm2m_senml input;
+#endif
 
 	/* Storage for basenames and names ~ sizeof("/65535/65535/") */
 	struct {
-		char names[CONFIG_LWM2M_RW_SENML_CBOR_RECORDS][SENML_MAX_NAME_SIZE];
+		char names[SENML_CBOR_OUT_NAMES][SENML_MAX_NAME_SIZE];
 		size_t name_sz; /* Name buff size */
 		uint8_t name_cnt;
 	};
@@ -51,7 +73,7 @@ struct cbor_out_fmt_data {
 
 	/* Storage for object links */
 	struct {
-		char objlnk[CONFIG_LWM2M_RW_SENML_CBOR_RECORDS][sizeof("65535:65535")];
+		char objlnk[SENML_CBOR_OUT_OBJLNKS][sizeof("65535:65535")];
 		size_t objlnk_sz; /* Object link buff size */
 		uint8_t objlnk_cnt;
 	};
@@ -79,14 +101,21 @@ static int path_to_string(char *buf, size_t buf_size, const struct lwm2m_obj_pat
 K_MUTEX_DEFINE(fd_mtx);
 
 #define GET_CBOR_FD_NAME(fd) ((fd)->names[(fd)->name_cnt])
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+/* Get the current record */
+#define GET_CBOR_FD_REC(fd) (&(fd)->rec)
+/* Consume the current record, it is encoded by flush_record() */
+#define CONSUME_CBOR_FD_REC(fd) (&(fd)->rec)
+#else
 /* Get the current record */
 #define GET_CBOR_FD_REC(fd) \
 	&((fd)->input.lwm2m_senml_record_m[(fd)->input.lwm2m_senml_record_m_count])
-/* Get a record */
-#define GET_IN_FD_REC_I(fd, i) &((fd)->dcd.lwm2m_senml_record_m[i])
 /* Consume the current record */
 #define CONSUME_CBOR_FD_REC(fd) \
 	&((fd)->input.lwm2m_senml_record_m[(fd)->input.lwm2m_senml_record_m_count++])
+#endif
+/* Get a record */
+#define GET_IN_FD_REC_I(fd, i) &((fd)->dcd.lwm2m_senml_record_m[i])
 /* Get CBOR output formatter data */
 #define LWM2M_OFD_CBOR(octx) ((struct cbor_out_fmt_data *)engine_get_out_user_data(octx))
 
@@ -129,15 +158,123 @@ static void clear_in_fmt_data(struct lwm2m_message *msg)
 
 static int fmt_range_check(struct cbor_out_fmt_data *fd)
 {
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+	if (fd->name_cnt >= SENML_CBOR_OUT_NAMES || fd->objlnk_cnt >= SENML_CBOR_OUT_OBJLNKS) {
+		return -ENOMEM;
+	}
+#else
 	if (fd->name_cnt >= CONFIG_LWM2M_RW_SENML_CBOR_RECORDS ||
 	    fd->objlnk_cnt >= CONFIG_LWM2M_RW_SENML_CBOR_RECORDS ||
 	    fd->input.lwm2m_senml_record_m_count >= CONFIG_LWM2M_RW_SENML_CBOR_RECORDS) {
 		LOG_ERR("CONFIG_LWM2M_RW_SENML_CBOR_RECORDS too small");
 		return -ENOMEM;
 	}
+#endif
+
+	return 0;
+}
+
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+static bool encode_record(zcbor_state_t *state, const struct record *rec)
+{
+	const struct record_union_r *val = &rec->record_union;
+	size_t max_num = ZCBOR_ARRAY_SIZE(rec->record_key_value_pair_m);
+	bool ok;
+
+	ok = zcbor_map_start_encode(state, max_num);
+
+	if (ok && rec->record_bn_present) {
+		ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_bn) &&
+		     zcbor_tstr_encode(state, &rec->record_bn.record_bn);
+	}
+
+	if (ok && rec->record_bt_present) {
+		ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_bt) &&
+		     zcbor_int64_encode(state, &rec->record_bt.record_bt);
+	}
+
+	if (ok && rec->record_n_present) {
+		ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_n) &&
+		     zcbor_tstr_encode(state, &rec->record_n.record_n);
+	}
+
+	if (ok && rec->record_t_present) {
+		ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_t) &&
+		     zcbor_int64_encode(state, &rec->record_t.record_t);
+	}
+
+	if (ok && rec->record_union_present) {
+		switch (val->record_union_choice) {
+		case union_vi_c:
+			ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_vi) &&
+			     zcbor_int64_encode(state, &val->union_vi);
+			break;
+		case union_vf_c:
+			ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_vf) &&
+			     zcbor_float64_encode(state, &val->union_vf);
+			break;
+		case union_vs_c:
+			ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_vs) &&
+			     zcbor_tstr_encode(state, &val->union_vs);
+			break;
+		case union_vb_c:
+			ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_vb) &&
+			     zcbor_bool_encode(state, &val->union_vb);
+			break;
+		case union_vd_c:
+			ok = zcbor_int32_put(state, lwm2m_senml_cbor_key_vd) &&
+			     zcbor_bstr_encode(state, &val->union_vd);
+			break;
+		case union_vlo_c:
+			ok = zcbor_tstr_put_lit(state, "vlo") &&
+			     zcbor_tstr_encode(state, &val->union_vlo);
+			break;
+		default:
+			ok = false;
+			break;
+		}
+	}
+
+	return ok && zcbor_map_end_encode(state, max_num);
+}
+
+/* Encode the current record straight into the message buffer and start a new one */
+static int flush_record(struct lwm2m_output_context *out)
+{
+	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
+	zcbor_state_t states[3];
+	uint8_t *start = CPKT_BUF_W_PTR(out->out_cpkt);
+
+	if (!fd->array_started || fd->rec_cnt == UINT16_MAX) {
+		return -ENOMEM;
+	}
+
+	zcbor_new_encode_state(states, ARRAY_SIZE(states), start,
+			       CPKT_BUF_W_SIZE(out->out_cpkt), 1);
+
+	if (!encode_record(states, &fd->rec)) {
+		LOG_DBG("No room for SenML CBOR record");
+		return -ENOMEM;
+	}
+
+	out->out_cpkt->offset += states[0].payload - start;
+	fd->rec_cnt++;
+
+	/* Names and object links are only referenced by the encoded record */
+	(void)memset(&fd->rec, 0, sizeof(fd->rec));
+	fd->name_cnt = 0;
+	fd->objlnk_cnt = 0;
 
 	return 0;
 }
+#else
+static inline int flush_record(struct lwm2m_output_context *out)
+{
+	ARG_UNUSED(out);
+
+	return 0;
+}
+#endif
 
 static int put_basename(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
 {
@@ -150,6 +287,12 @@ static int put_basename(struct lwm2m_output_context *out, struct lwm2m_obj_path
 		return ret;
 	}
 
+	if (IS_ENABLED(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)) {
+		/* Supersedes the names of a record that did not get a value */
+		fd->name_cnt = 0;
+		GET_CBOR_FD_REC(fd)->record_n_present = false;
+	}
+
 	char *basename = GET_CBOR_FD_NAME(fd);
 
 	len = path_to_string(basename, fd->name_sz, path, LWM2M_PATH_LEVEL_OBJECT_INST);
@@ -175,6 +318,58 @@ static int put_basename(struct lwm2m_output_context *out, struct lwm2m_obj_path
 	return 0;
 }
 
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+static int put_begin(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
+{
+	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
+
+	/* The number of records is not known yet, leave room for the largest header */
+	if (CPKT_BUF_W_SIZE(out->out_cpkt) < SENML_CBOR_ARRAY_HDR_MAX) {
+		return -ENOMEM;
+	}
+
+	fd->array_start = out->out_cpkt->offset;
+	fd->array_started = true;
+	out->out_cpkt->offset += SENML_CBOR_ARRAY_HDR_MAX;
+
+	return 0;
+}
+
+static int put_end(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
+{
+	struct cbor_out_fmt_data *fd = LWM2M_OFD_CBOR(out);
+	uint8_t *start;
+	size_t payload_len;
+	size_t hdr_len;
+
+	if (!fd->array_started) {
+		return -ENOMEM;
+	}
+
+	start = out->out_cpkt->data + fd->array_start;
+	payload_len = out->out_cpkt->offset - fd->array_start - SENML_CBOR_ARRAY_HDR_MAX;
+
+	/* Write the shortest array header and move the records right after it */
+	if (fd->rec_cnt < 24) {
+		start[0] = 0x80 | fd->rec_cnt;
+		hdr_len = 1;
+	} else if (fd->rec_cnt <= UINT8_MAX) {
+		start[0] = 0x98;
+		start[1] = fd->rec_cnt;
+		hdr_len = 2;
+	} else {
+		start[0] = 0x99;
+		sys_put_be16(fd->rec_cnt, &start[1]);
+		hdr_len = 3;
+	}
+
+	memmove(start + hdr_len, start + SENML_CBOR_ARRAY_HDR_MAX, payload_len);
+	out->out_cpkt->offset -= SENML_CBOR_ARRAY_HDR_MAX - hdr_len;
+	fd->array_started = false;
+
+	return hdr_len + payload_len;
+}
+#else
 static int put_empty_array(struct lwm2m_output_context *out)
 {
 	int len = 1;
@@ -209,6 +404,7 @@ static int put_end(struct lwm2m_output_context *out, struct lwm2m_obj_path *path
 
 	return len;
 }
+#endif
 
 static int put_begin_oi(struct lwm2m_output_context *out, struct lwm2m_obj_path *path)
 {
@@ -263,9 +459,11 @@ static int put_begin_r(struct lwm2m_output_context *out, struct lwm2m_obj_path *
 	record->record_n_present = true;
 
 	/* Makes possible to use same slot for storing r/ri name combination.
-	 * No need to increase the name count if an existing name has been used
+	 * No need to increase the name count if an existing name has been used.
+	 * A streamed record only needs its latest name, so the slot is reused.
 	 */
-	if (path->level < LWM2M_PATH_LEVEL_RESOURCE_INST && name == GET_CBOR_FD_NAME(fd)) {
+	if (!IS_ENABLED(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING) &&
+	    path->level < LWM2M_PATH_LEVEL_RESOURCE_INST && name == GET_CBOR_FD_NAME(fd)) {
 		fd->name_cnt++;
 	}
 
@@ -337,7 +535,7 @@ static int put_begin_ri(struct lwm2m_output_context *out, struct lwm2m_obj_path
 	record->record_n_present = true;
 
 	/* No need to increase the name count if an existing name has been used */
-	if (name == GET_CBOR_FD_NAME(fd)) {
+	if (!IS_ENABLED(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING) && name == GET_CBOR_FD_NAME(fd)) {
 		fd->name_cnt++;
 	}
 
@@ -381,7 +579,7 @@ static int put_value(struct lwm2m_output_context *out, struct lwm2m_obj_path *pa
 	record->record_union.union_vi = value;
 	record->record_union_present = true;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int put_s8(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, int8_t value)
@@ -419,7 +617,7 @@ static int put_time(struct lwm2m_output_context *out, struct lwm2m_obj_path *pat
 	record->record_union.union_vi = (int64_t)value;
 	record->record_union_present = true;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int put_float(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, double *value)
@@ -437,7 +635,7 @@ static int put_float(struct lwm2m_output_context *out, struct lwm2m_obj_path *pa
 	record->record_union.union_vf = *value;
 	record->record_union_present = true;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int put_string(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, char *buf,
@@ -457,7 +655,7 @@ static int put_string(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 	record->record_union.union_vs.len = buflen;
 	record->record_union_present = true;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int put_bool(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, bool value)
@@ -475,7 +673,7 @@ static int put_bool(struct lwm2m_output_context *out, struct lwm2m_obj_path *pat
 	record->record_union.union_vb = value;
 	record->record_union_present = true;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int put_opaque(struct lwm2m_output_context *out, struct lwm2m_obj_path *path, char *buf,
@@ -495,7 +693,7 @@ static int put_opaque(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 	record->record_union.union_vd.len = buflen;
 	record->record_union_present = true;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int put_objlnk(struct lwm2m_output_context *out, struct lwm2m_obj_path *path,
@@ -534,7 +732,7 @@ static int put_objlnk(struct lwm2m_output_context *out, struct lwm2m_obj_path *p
 
 	fd->objlnk_cnt++;
 
-	return 0;
+	return flush_record(out);
 }
 
 static int get_opaque(struct lwm2m_input_context *in,
@@ -797,6 +995,9 @@ static int do_write_op_item(struct lwm2m_message *msg, struct record *rec)
 }
 
 const struct lwm2m_writer senml_cbor_writer = {
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+	.put_begin = put_begin,
+#endif
 	.put_end = put_end,
 	.put_begin_oi = put_begin_oi,
 	.put_begin_r = put_begin_r,
@@ -293,6 +293,440 @@ static int verify_tx_state(const struct mqtt_client *client)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+static void inflight_reset(struct mqtt_client *client)
+{
+	memset(client->internal.inflight, 0, sizeof(client->internal.inflight));
+	client->internal.inflight_count = 0U;
+}
+
+static struct mqtt_inflight *inflight_find(struct mqtt_client *client,
+					   uint16_t message_id)
+{
+	ARRAY_FOR_EACH_PTR(client->internal.inflight, entry) {
+		if (entry->used && entry->param.message_id == message_id) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static bool inflight_full(struct mqtt_client *client,
+			  const struct mqtt_publish_param *param)
+{
+	if (param->message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+		return false;
+	}
+
+	/* A message published again replaces its previous copy. */
+	if (inflight_find(client, param->message_id) != NULL) {
+		return false;
+	}
+
+	return client->internal.inflight_count >= client->internal.inflight_max;
+}
+
+static void inflight_add(struct mqtt_client *client,
+			 const struct mqtt_publish_param *param)
+{
+	struct mqtt_inflight *entry;
+
+	if (param->message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+		return;
+	}
+
+	entry = inflight_find(client, param->message_id);
+	if (entry == NULL) {
+		ARRAY_FOR_EACH_PTR(client->internal.inflight, free_entry) {
+			if (!free_entry->used) {
+				entry = free_entry;
+				break;
+			}
+		}
+
+		client->internal.inflight_count++;
+	}
+
+	entry->param = *param;
+	entry->sent = mqtt_sys_tick_in_ms_get();
+	entry->released = 0U;
+	entry->resend = 0U;
+	entry->used = 1U;
+}
+
+static void inflight_pubrel_sent(struct mqtt_client *client, uint16_t message_id)
+{
+	struct mqtt_inflight *entry = inflight_find(client, message_id);
+
+	if (entry != NULL) {
+		entry->released = 1U;
+		entry->resend = 0U;
+		entry->sent = mqtt_sys_tick_in_ms_get();
+	}
+}
+
+static bool inflight_due(const struct mqtt_client *client,
+			 const struct mqtt_inflight *entry)
+{
+	if (entry->resend) {
+		return true;
+	}
+
+	/* MQTT 5.0 only allows to resend messages on session resumption. */
+	if (CONFIG_MQTT_RETRANSMIT_TIMEOUT == 0 || mqtt_is_version_5_0(client)) {
+		return false;
+	}
+
+	return mqtt_elapsed_time_in_ms_get(entry->sent) >=
+	       CONFIG_MQTT_RETRANSMIT_TIMEOUT;
+}
+
+static int publish_iov_encode(struct mqtt_client *client,
+			      const struct mqtt_publish_param *param,
+			      struct buf_ctx *buf, struct net_iovec *io_vector,
+			      size_t *iovlen);
+
+static int inflight_send(struct mqtt_client *client,
+			 struct mqtt_inflight *entry)
+{
+	int err_code;
+	struct buf_ctx packet;
+	struct net_iovec io_vector[2];
+	struct net_msghdr msg;
+	size_t iovlen = 0;
+
+	tx_buf_init(client, &packet);
+
+	if (entry->released) {
+		const struct mqtt_pubrel_param param = {
+			.message_id = entry->param.message_id,
+		};
+
+		err_code = publish_release_encode(client, &param, &packet);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		err_code = client_write(client, packet.cur,
+					packet.end - packet.cur);
+		if (err_code == 0) {
+			entry->sent = mqtt_sys_tick_in_ms_get();
+			entry->resend = 0U;
+		}
+	} else {
+		/* The entry is refreshed when the message is encoded again. */
+		entry->param.dup_flag = 1U;
+
+		err_code = publish_iov_encode(client, &entry->param, &packet,
+					      io_vector, &iovlen);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		memset(&msg, 0, sizeof(msg));
+
+		msg.msg_iov = io_vector;
+		msg.msg_iovlen = iovlen;
+
+		err_code = client_write_msg(client, &msg);
+	}
+
+	return err_code;
+}
+
+static int inflight_retransmit(struct mqtt_client *client)
+{
+	int err_code;
+	int sent = 0;
+
+	if (!MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
+		return 0;
+	}
+
+	ARRAY_FOR_EACH_PTR(client->internal.inflight, entry) {
+		if (!entry->used || !inflight_due(client, entry)) {
+			continue;
+		}
+
+		NET_DBG("[CID %p]: Resending message id 0x%04x", client,
+			entry->param.message_id);
+
+		err_code = inflight_send(client, entry);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		sent++;
+	}
+
+	return sent;
+}
+
+static int inflight_time_left(const struct mqtt_client *client, int time_left)
+{
+	uint32_t elapsed_time;
+	int entry_time_left;
+
+	if (!MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
+		return time_left;
+	}
+
+	ARRAY_FOR_EACH_PTR(client->internal.inflight, entry) {
+		if (!entry->used) {
+			continue;
+		}
+
+		if (entry->resend) {
+			return 0;
+		}
+
+		if (CONFIG_MQTT_RETRANSMIT_TIMEOUT == 0 ||
+		    mqtt_is_version_5_0(client)) {
+			continue;
+		}
+
+		elapsed_time = mqtt_elapsed_time_in_ms_get(entry->sent);
+		entry_time_left = (elapsed_time >= CONFIG_MQTT_RETRANSMIT_TIMEOUT) ?
+				  0 : CONFIG_MQTT_RETRANSMIT_TIMEOUT - elapsed_time;
+
+		if (time_left < 0 || entry_time_left < time_left) {
+			time_left = entry_time_left;
+		}
+	}
+
+	return time_left;
+}
+#else
+static bool inflight_full(struct mqtt_client *client,
+			  const struct mqtt_publish_param *param)
+{
+	ARG_UNUSED(client);
+	ARG_UNUSED(param);
+
+	return false;
+}
+
+static void inflight_add(struct mqtt_client *client,
+			 const struct mqtt_publish_param *param)
+{
+	ARG_UNUSED(client);
+	ARG_UNUSED(param);
+}
+
+static void inflight_pubrel_sent(struct mqtt_client *client, uint16_t message_id)
+{
+	ARG_UNUSED(client);
+	ARG_UNUSED(message_id);
+}
+
+static int inflight_retransmit(struct mqtt_client *client)
+{
+	ARG_UNUSED(client);
+
+	return 0;
+}
+
+static int inflight_time_left(const struct mqtt_client *client, int time_left)
+{
+	ARG_UNUSED(client);
+
+	return time_left;
+}
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
+#if defined(CONFIG_MQTT_TOPIC_ALIAS_AUTO)
+static struct mqtt_tx_topic_alias *topic_alias_find(struct mqtt_client *client,
+						    const struct mqtt_utf8 *topic,
+						    bool *known)
+{
+	struct mqtt_tx_topic_alias *lru = NULL;
+	struct mqtt_tx_topic_alias *alias;
+
+	for (int i = 0; i < client->internal.tx_topic_alias_max; i++) {
+		alias = &client->internal.tx_topic_aliases[i];
+
+		if (alias->topic.topic_size == topic->size &&
+		    memcmp(alias->topic.topic_buf, topic->utf8, topic->size) == 0) {
+			*known = true;
+			return alias;
+		}
+
+		/* Unused aliases first, then the least recently used one. */
+		if (lru == NULL ||
+		    (lru->topic.topic_size != 0U &&
+		     (alias->topic.topic_size == 0U ||
+		      (int32_t)(alias->last_used - lru->last_used) < 0))) {
+			lru = alias;
+		}
+	}
+
+	*known = false;
+
+	return lru;
+}
+
+static int publish_alias_encode(struct mqtt_client *client,
+				const struct mqtt_publish_param *param,
+				struct buf_ctx *buf)
+{
+	const struct mqtt_utf8 *topic = &param->message.topic.topic;
+	struct mqtt_tx_topic_alias *alias = NULL;
+	struct mqtt_publish_param aliased;
+	bool known = false;
+	int err_code;
+
+	if (mqtt_is_version_5_0(client) && param->prop.topic_alias == 0U &&
+	    topic->size > 0U && topic->size <= CONFIG_MQTT_TOPIC_ALIAS_STRING_MAX) {
+		alias = topic_alias_find(client, topic, &known);
+	}
+
+	if (alias == NULL) {
+		return publish_encode(client, param, buf);
+	}
+
+	aliased = *param;
+	aliased.prop.topic_alias =
+		ARRAY_INDEX(client->internal.tx_topic_aliases, alias) + 1;
+
+	/* Once the broker knows the alias, an empty topic is sent. */
+	if (known) {
+		aliased.message.topic.topic.size = 0U;
+	}
+
+	err_code = publish_encode(client, &aliased, buf);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	if (!known) {
+		memcpy(alias->topic.topic_buf, topic->utf8, topic->size);
+		alias->topic.topic_size = topic->size;
+	}
+
+	alias->last_used = ++client->internal.tx_topic_alias_clock;
+
+	return 0;
+}
+#else
+static int publish_alias_encode(struct mqtt_client *client,
+				const struct mqtt_publish_param *param,
+				struct buf_ctx *buf)
+{
+	return publish_encode(client, param, buf);
+}
+#endif /* CONFIG_MQTT_TOPIC_ALIAS_AUTO */
+
+void mqtt_publish_session_init(struct mqtt_client *client,
+			       const struct mqtt_connack_param *param)
+{
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+	client->internal.inflight_max = CONFIG_MQTT_INFLIGHT_MAX;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5_0(client) && param->prop.rx.has_receive_maximum) {
+		client->internal.inflight_max = MIN(param->prop.receive_maximum,
+						    CONFIG_MQTT_INFLIGHT_MAX);
+	}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+	if (param->session_present_flag) {
+		/* Resend what was not acknowledged on the previous connection. */
+		ARRAY_FOR_EACH_PTR(client->internal.inflight, entry) {
+			entry->resend = entry->used;
+		}
+	} else {
+		inflight_reset(client);
+	}
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
+#if defined(CONFIG_MQTT_TOPIC_ALIAS_AUTO)
+	/* Topic aliases only last for a single network connection. */
+	memset(client->internal.tx_topic_aliases, 0,
+	       sizeof(client->internal.tx_topic_aliases));
+	client->internal.tx_topic_alias_max = 0U;
+
+	if (mqtt_is_version_5_0(client) && param->prop.rx.has_topic_alias_maximum) {
+		client->internal.tx_topic_alias_max =
+			MIN(param->prop.topic_alias_maximum,
+			    ARRAY_SIZE(client->internal.tx_topic_aliases));
+	}
+#endif /* CONFIG_MQTT_TOPIC_ALIAS_AUTO */
+
+	ARG_UNUSED(client);
+	ARG_UNUSED(param);
+}
+
+void mqtt_publish_ack_process(struct mqtt_client *client, uint8_t type,
+			      uint16_t message_id, bool failed)
+{
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+	struct mqtt_inflight *entry = inflight_find(client, message_id);
+
+	if (entry == NULL) {
+		NET_DBG("[CID %p]: Message id 0x%04x not in flight", client,
+			message_id);
+		return;
+	}
+
+	/* PUBREL is then sent by the application, the message stays in the
+	 * window until PUBCOMP.
+	 */
+	if (type == MQTT_PKT_TYPE_PUBREC && !failed) {
+		entry->released = 1U;
+		entry->resend = 0U;
+		entry->sent = mqtt_sys_tick_in_ms_get();
+		return;
+	}
+
+	memset(entry, 0, sizeof(*entry));
+	client->internal.inflight_count--;
+#else
+	ARG_UNUSED(client);
+	ARG_UNUSED(type);
+	ARG_UNUSED(message_id);
+	ARG_UNUSED(failed);
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+}
+
+/** @brief Encode a PUBLISH packet in the remaining space of the tx buffer,
+ *  and append the I/O vectors describing it, along with its payload.
+ */
+static int publish_iov_encode(struct mqtt_client *client,
+			      const struct mqtt_publish_param *param,
+			      struct buf_ctx *buf, struct net_iovec *io_vector,
+			      size_t *iovlen)
+{
+	int err_code;
+	struct buf_ctx packet = *buf;
+
+	if (inflight_full(client, param)) {
+		return -EAGAIN;
+	}
+
+	err_code = publish_alias_encode(client, param, &packet);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	inflight_add(client, param);
+
+	io_vector[*iovlen].iov_base = packet.cur;
+	io_vector[*iovlen].iov_len = packet.end - packet.cur;
+	(*iovlen)++;
+
+	if (param->message.payload.len > 0U) {
+		io_vector[*iovlen].iov_base = param->message.payload.data;
+		io_vector[*iovlen].iov_len = param->message.payload.len;
+		(*iovlen)++;
+	}
+
+	/* Next packet of a batch is encoded right after this one. */
+	buf->cur = packet.end;
+
+	return 0;
+}
+
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param)
 {
@@ -300,6 +734,7 @@ int mqtt_publish(struct mqtt_client *client,
 	struct buf_ctx packet;
 	struct net_iovec io_vector[2];
 	struct net_msghdr msg;
+	size_t iovlen = 0;
 
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
@@ -318,20 +753,16 @@ int mqtt_publish(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = publish_encode(client, param, &packet);
+	err_code = publish_iov_encode(client, param, &packet, io_vector,
+				      &iovlen);
 	if (err_code < 0) {
 		goto error;
 	}
 
-	io_vector[0].iov_base = packet.cur;
-	io_vector[0].iov_len = packet.end - packet.cur;
-	io_vector[1].iov_base = param->message.payload.data;
-	io_vector[1].iov_len = param->message.payload.len;
-
 	memset(&msg, 0, sizeof(msg));
 
 	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_iovlen = iovlen;
 
 	err_code = client_write_msg(client, &msg);
 
@@ -344,6 +775,67 @@ error:
 	return err_code;
 }
 
+int mqtt_publish_batch(struct mqtt_client *client,
+		       const struct mqtt_publish_param *params, size_t count)
+{
+	int err_code;
+	struct buf_ctx packet;
+	struct net_iovec io_vector[2 * CONFIG_MQTT_PUBLISH_BATCH_MAX];
+	struct net_msghdr msg;
+	size_t iovlen = 0;
+	size_t encoded;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(params);
+
+	NET_DBG("[CID %p]:[State 0x%02x]: >> Message count %zu",
+		 client, client->internal.state, count);
+
+	mqtt_mutex_lock(client);
+
+	tx_buf_init(client, &packet);
+
+	err_code = verify_tx_state(client);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	count = MIN(count, CONFIG_MQTT_PUBLISH_BATCH_MAX);
+
+	for (encoded = 0; encoded < count; encoded++) {
+		err_code = publish_iov_encode(client, &params[encoded], &packet,
+					      io_vector, &iovlen);
+		if (err_code < 0) {
+			break;
+		}
+	}
+
+	/* The messages encoded so far are sent anyway, the error is reported
+	 * when the first one failed already.
+	 */
+	if (encoded == 0) {
+		goto error;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = iovlen;
+
+	err_code = client_write_msg(client, &msg);
+	if (err_code == 0) {
+		err_code = encoded;
+	}
+
+error:
+	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
+		 client, client->internal.state, err_code);
+
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+
 int mqtt_publish_qos1_ack(struct mqtt_client *client,
 			  const struct mqtt_puback_param *param)
 {
@@ -445,6 +937,9 @@ int mqtt_publish_qos2_release(struct mqtt_client *client,
 	}
 
 	err_code = client_write(client, packet.cur, packet.end - packet.cur);
+	if (err_code == 0) {
+		inflight_pubrel_sent(client, param->message_id);
+	}
 
 error:
 	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
@@ -706,14 +1201,21 @@ int mqtt_live(struct mqtt_client *client)
 	int err_code = 0;
 	uint32_t elapsed_time;
 	bool ping_sent = false;
+	bool resent = false;
 
 	NULL_PARAM_CHECK(client);
 
 	mqtt_mutex_lock(client);
 
+	err_code = inflight_retransmit(client);
+	if (err_code > 0) {
+		resent = true;
+		err_code = 0;
+	}
+
 	elapsed_time = mqtt_elapsed_time_in_ms_get(
 				client->internal.last_activity);
-	if ((client->keepalive > 0) &&
+	if ((err_code == 0) && (client->keepalive > 0) &&
 	    (elapsed_time >= (client->keepalive * 1000))) {
 		err_code = mqtt_ping(client);
 		ping_sent = true;
@@ -721,7 +1223,7 @@ int mqtt_live(struct mqtt_client *client)
 
 	mqtt_mutex_unlock(client);
 
-	if (ping_sent) {
+	if (ping_sent || resent || (err_code < 0)) {
 		return err_code;
 	} else {
 		return -EAGAIN;
@@ -736,14 +1238,14 @@ int mqtt_keepalive_time_left(const struct mqtt_client *client)
 
 	if (client->keepalive == 0) {
 		/* Keep alive not enabled. */
-		return -1;
+		return inflight_time_left(client, -1);
 	}
 
 	if (keepalive_ms <= elapsed_time) {
 		return 0;
 	}
 
-	return keepalive_ms - elapsed_time;
+	return inflight_time_left(client, keepalive_ms - elapsed_time);
 }
 
 int mqtt_input(struct mqtt_client *client)
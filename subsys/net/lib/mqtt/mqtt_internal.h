@@ -208,6 +208,24 @@ int mqtt_handle_rx(struct mqtt_client *client);
  */
 void mqtt_client_disconnect(struct mqtt_client *client, int result, bool notify);
 
+/**@brief Set up the publish state of a connection accepted by the broker.
+ *
+ * @param[in] client Identifies the client which connected.
+ * @param[in] param CONNACK received from the broker.
+ */
+void mqtt_publish_session_init(struct mqtt_client *client,
+			       const struct mqtt_connack_param *param);
+
+/**@brief Update the in-flight window with an acknowledgment of the broker.
+ *
+ * @param[in] client Identifies the client for which the packet was received.
+ * @param[in] type Packet type, PUBACK, PUBREC or PUBCOMP.
+ * @param[in] message_id Message id of the acknowledged message.
+ * @param[in] failed Whether the broker reported a failure (MQTT 5.0).
+ */
+void mqtt_publish_ack_process(struct mqtt_client *client, uint8_t type,
+			      uint16_t message_id, bool failed);
+
 /**@brief Constructs/encodes Connect packet.
  *
  * @param[in] client Identifies the client for which the procedure is requested.
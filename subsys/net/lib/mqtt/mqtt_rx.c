@@ -16,6 +16,20 @@ LOG_MODULE_REGISTER(net_mqtt_rx, CONFIG_MQTT_LOG_LEVEL);
  * @brief MQTT Received data handling.
  */
 
+static bool pubrec_failed(const struct mqtt_client *client,
+			  const struct mqtt_pubrec_param *param)
+{
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/* Reason codes of 0x80 or greater indicate a failure. */
+	return mqtt_is_version_5_0(client) && param->reason_code >= 0x80;
+#else
+	ARG_UNUSED(client);
+	ARG_UNUSED(param);
+
+	return false;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+}
+
 static int mqtt_handle_packet(struct mqtt_client *client,
 			      uint8_t type_and_flags,
 			      uint32_t var_length,
@@ -45,6 +59,8 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 						MQTT_CONNECTION_ACCEPTED) {
 				/* Set state. */
 				MQTT_SET_STATE(client, MQTT_STATE_CONNECTED);
+				mqtt_publish_session_init(client,
+							  &evt.param.connack);
 			} else {
 				err_code = -ECONNREFUSED;
 			}
@@ -80,6 +96,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBACK;
 		err_code = publish_ack_decode(client, buf, &evt.param.puback);
 		evt.result = err_code;
+		if (err_code == 0) {
+			mqtt_publish_ack_process(client, MQTT_PKT_TYPE_PUBACK,
+						 evt.param.puback.message_id,
+						 false);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_PUBREC:
@@ -89,6 +110,12 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		err_code = publish_receive_decode(client, buf,
 						  &evt.param.pubrec);
 		evt.result = err_code;
+		if (err_code == 0) {
+			mqtt_publish_ack_process(client, MQTT_PKT_TYPE_PUBREC,
+						 evt.param.pubrec.message_id,
+						 pubrec_failed(client,
+							       &evt.param.pubrec));
+		}
 		break;
 
 	case MQTT_PKT_TYPE_PUBREL:
@@ -107,6 +134,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		err_code = publish_complete_decode(client, buf,
 						   &evt.param.pubcomp);
 		evt.result = err_code;
+		if (err_code == 0) {
+			mqtt_publish_ack_process(client, MQTT_PKT_TYPE_PUBCOMP,
+						 evt.param.pubcomp.message_id,
+						 false);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_SUBACK:
@@ -495,6 +495,31 @@ static void print_net_pm_stats(const struct shell *sh, struct net_if *iface)
 #endif
 }
 
+static void print_rx_pool_stats(const struct shell *sh, struct net_if *iface)
+{
+#if defined(CONFIG_NET_IF_RX_POOL)
+	struct net_pkt_rx_pool *pool = net_if_get_rx_pool(iface);
+
+	if (pool == NULL) {
+		return;
+	}
+
+	PR("RX pool pkts   free\t%u/%u\tmin free\t%u\tlow\t%u\n",
+	   k_mem_slab_num_free_get(pool->pkt_slab),
+	   pool->pkt_slab->info.num_blocks,
+	   pool->pkt_min_free, pool->low_threshold);
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	PR("RX pool bufs   free\t%ld/%d\tmax used\t%d\n",
+	   atomic_get(&pool->data_pool->avail_count),
+	   pool->data_pool->buf_count, pool->data_pool->max_used);
+#endif
+	PR("RX pool alloc failed %u\n", pool->alloc_failed);
+#else
+	ARG_UNUSED(sh);
+	ARG_UNUSED(iface);
+#endif
+}
+
 static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
@@ -681,6 +706,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 #endif /* CONFIG_NET_STATISTICS_PPP && CONFIG_NET_STATISTICS_USER_API */
 
 	print_net_pm_stats(sh, iface);
+	print_rx_pool_stats(sh, iface);
 }
 
 static void net_shell_print_statistics_all(struct net_shell_user_data *data)
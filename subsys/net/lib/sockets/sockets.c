@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <zephyr/kernel.h>
 #include <zephyr/tracing/tracing.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/net_buf.h>
 #include <zephyr/internal/syscall_handler.h>
 
 #include "sockets_internal.h"
@@ -711,6 +712,207 @@ fail:
 #include <zephyr/syscalls/zsock_recvmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+int z_impl_zsock_sendmmsg(int sock, struct net_mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int count;
+	ssize_t ret = 0;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (msgvec == NULL && vlen > 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (count = 0; count < vlen; count++) {
+		ret = vtable->sendmsg(obj, &msgvec[count].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+		sock_obj_core_update_send_stats(sock, ret);
+	}
+
+	k_mutex_unlock(lock);
+
+	/* Only report an error if nothing was sent */
+	if (count == 0 && ret < 0) {
+		return -1;
+	}
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct net_mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int count;
+	ssize_t ret;
+
+	K_OOPS(K_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen, sizeof(*msgvec)));
+
+	/* Each message is validated and copied by the single message
+	 * handler, so the batch is sent one message at a time.
+	 */
+	for (count = 0; count < vlen; count++) {
+		ret = z_vrfy_zsock_sendmsg(sock, &msgvec[count].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+	}
+
+	if (count == 0 && vlen > 0) {
+		return -1;
+	}
+
+	return count;
+}
+#include <zephyr/syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_recvmmsg(int sock, struct net_mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int count;
+	ssize_t ret = 0;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->recvmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (msgvec == NULL && vlen > 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (count = 0; count < vlen; count++) {
+		ret = vtable->recvmsg(obj, &msgvec[count].msg_hdr,
+				      flags & ~ZSOCK_MSG_WAITFORONE);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+		sock_obj_core_update_recv_stats(sock, ret);
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	k_mutex_unlock(lock);
+
+	/* Running out of queued data after the first message is not an
+	 * error, the caller just gets the messages received so far.
+	 */
+	if (count == 0 && ret < 0) {
+		return -1;
+	}
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct net_mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int count;
+	ssize_t ret;
+
+	K_OOPS(K_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen, sizeof(*msgvec)));
+
+	/* Each message is validated and copied by the single message
+	 * handler, so the batch is received one message at a time.
+	 */
+	for (count = 0; count < vlen; count++) {
+		ret = z_vrfy_zsock_recvmsg(sock, &msgvec[count].msg_hdr,
+					   flags & ~ZSOCK_MSG_WAITFORONE);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[count].msg_len = ret;
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	if (count == 0 && vlen > 0) {
+		return -1;
+	}
+
+	return count;
+}
+#include <zephyr/syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+ssize_t zsock_sendfile(int sock, struct fs_file_t *file, off_t *offset,
+		       size_t count)
+{
+	ssize_t bytes_sent;
+
+	bytes_sent = VTABLE_CALL(sendfile, sock, file, offset, count);
+
+	sock_obj_core_update_send_stats(sock, bytes_sent);
+
+	return bytes_sent;
+}
+#endif /* CONFIG_NET_SOCKETS_SENDFILE */
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY_RX)
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct net_sockaddr *src_addr, net_socklen_t *addrlen)
+{
+	ssize_t bytes_received;
+
+	bytes_received = VTABLE_CALL(recv_buf, sock, frags, flags, src_addr, addrlen);
+
+	sock_obj_core_update_recv_stats(sock, bytes_received);
+
+	return bytes_received;
+}
+
+void zsock_recv_buf_release(struct net_buf *frags)
+{
+	if (frags != NULL) {
+		net_buf_unref(frags);
+	}
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY_RX */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -30,6 +30,10 @@ LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <zephyr/net/igmp.h>
 #include "../../ip/ipv6.h"
 
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+#include <zephyr/fs/fs.h>
+#endif
+
 #include "../../ip/net_stats.h"
 
 #include "sockets_internal.h"
@@ -727,6 +731,103 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	return status;
 }
 
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+static int sendfile_fill_cb(void *dst, size_t len, void *user_data)
+{
+	return fs_read(user_data, dst, len);
+}
+
+static ssize_t zsock_sendfile_ctx(struct net_context *ctx,
+				  struct fs_file_t *file, off_t *offset,
+				  size_t count)
+{
+	k_timeout_t timeout = K_FOREVER;
+	uint32_t retry_timeout = WAIT_BUFS_INITIAL_MS;
+	k_timepoint_t buf_timeout, end;
+	size_t sent = 0;
+	int status;
+
+	if (file == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (net_context_get_type(ctx) != NET_SOCK_STREAM ||
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (offset != NULL) {
+		status = fs_seek(file, *offset, FS_SEEK_SET);
+		if (status < 0) {
+			errno = -status;
+			return -1;
+		}
+	}
+
+	if (sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+		buf_timeout = sys_timepoint_calc(K_NO_WAIT);
+	} else {
+		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
+		buf_timeout = sys_timepoint_calc(MAX_WAIT_BUFS);
+	}
+	end = sys_timepoint_calc(timeout);
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	if (!sock_is_eof(ctx)) {
+		status = net_context_recv(ctx, zsock_received_cb,
+					  K_NO_WAIT, ctx->user_data);
+		if (status < 0) {
+			errno = -status;
+			return -1;
+		}
+	}
+
+	while (sent < count) {
+		/* File data is read straight into the TCP send buffers */
+		status = net_tcp_queue_fill(ctx, count - sent,
+					    sendfile_fill_cb, file);
+		if (status == 0) {
+			/* End of file */
+			break;
+		}
+
+		if (status < 0) {
+			if (sent > 0 && K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+				break;
+			}
+
+			status = send_check_and_wait(ctx, status, buf_timeout,
+						     timeout, &retry_timeout);
+			if (status < 0) {
+				if (sent > 0) {
+					break;
+				}
+
+				return status;
+			}
+
+			/* Update the timeout value in case loop is repeated. */
+			timeout = sys_timepoint_timeout(end);
+
+			continue;
+		}
+
+		sent += status;
+	}
+
+	if (offset != NULL) {
+		*offset += sent;
+	}
+
+	return sent;
+}
+#endif /* CONFIG_NET_SOCKETS_SENDFILE */
+
 ssize_t zsock_sendmsg_ctx(struct net_context *ctx, const struct net_msghdr *msg,
 			  int flags)
 {
@@ -1166,6 +1267,43 @@ static int update_msg_controllen(struct net_msghdr *msg)
 	return 0;
 }
 
+static int sock_get_dgram_src_addr(struct net_context *ctx,
+				   struct net_pkt *pkt,
+				   struct net_sockaddr *src_addr,
+				   net_socklen_t *addrlen)
+{
+	int ret;
+
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		ret = sock_get_offload_pkt_src_addr(pkt, ctx, src_addr,
+						    *addrlen);
+		if (ret < 0) {
+			NET_DBG("sock_get_offload_pkt_src_addr %d", ret);
+			return ret;
+		}
+	} else {
+		ret = sock_get_pkt_src_addr(ctx, pkt, src_addr, *addrlen);
+		if (ret < 0) {
+			NET_DBG("sock_get_pkt_src_addr %d", ret);
+			return ret;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == NET_AF_INET) {
+		*addrlen = sizeof(struct net_sockaddr_in);
+	} else if (src_addr->sa_family == NET_AF_INET6) {
+		*addrlen = sizeof(struct net_sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static ssize_t zsock_recv_dgram(struct net_context *ctx,
 				struct net_msghdr *msg,
 				void *buf,
@@ -1217,37 +1355,11 @@ static ssize_t zsock_recv_dgram(struct net_context *ctx,
 	net_pkt_cursor_backup(pkt, &backup);
 
 	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			int ret;
-
-			ret  = sock_get_offload_pkt_src_addr(pkt, ctx, src_addr,
-								*addrlen);
-			if (ret < 0) {
-				errno = -ret;
-				NET_DBG("sock_get_offload_pkt_src_addr %d", ret);
-				goto fail;
-			}
-		} else {
-			int ret;
-
-			ret = sock_get_pkt_src_addr(ctx, pkt, src_addr, *addrlen);
-			if (ret < 0) {
-				errno = -ret;
-				NET_DBG("sock_get_pkt_src_addr %d", ret);
-				goto fail;
-			}
-		}
+		int ret;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == NET_AF_INET) {
-			*addrlen = sizeof(struct net_sockaddr_in);
-		} else if (src_addr->sa_family == NET_AF_INET6) {
-			*addrlen = sizeof(struct net_sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		ret = sock_get_dgram_src_addr(ctx, pkt, src_addr, addrlen);
+		if (ret < 0) {
+			errno = -ret;
 			goto fail;
 		}
 	}
@@ -1634,6 +1746,144 @@ ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct net_msghdr *msg,
 	return -1;
 }
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY_RX)
+/* Detach the unread part of pkt as a standalone fragment chain. Fragments
+ * holding already consumed headers are released together with the packet.
+ */
+static struct net_buf *zsock_pkt_detach_payload(struct net_pkt *pkt)
+{
+	struct net_buf *frags = pkt->buffer;
+
+	if (net_pkt_remaining_data(pkt) == 0) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	while (frags != pkt->cursor.buf) {
+		frags = net_buf_frag_del(NULL, frags);
+	}
+
+	net_buf_pull(frags, pkt->cursor.pos - frags->data);
+
+	pkt->buffer = NULL;
+	net_pkt_cursor_init(pkt);
+	net_pkt_unref(pkt);
+
+	return frags;
+}
+
+static ssize_t zsock_recv_buf_ctx(struct net_context *ctx,
+				  struct net_buf **frags, int flags,
+				  struct net_sockaddr *src_addr,
+				  net_socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	ssize_t len;
+	int ret;
+
+	if (frags == NULL || (flags & ZSOCK_MSG_PEEK)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	*frags = NULL;
+
+	if (sock_type == NET_SOCK_STREAM) {
+		if (!net_context_is_used(ctx)) {
+			errno = EBADF;
+			return -1;
+		}
+
+		if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+			errno = ENOTCONN;
+			return -1;
+		}
+	} else if (sock_type != NET_SOCK_DGRAM && sock_type != NET_SOCK_RAW) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else if (!sock_is_eof(ctx) && !sock_is_error(ctx)) {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	if (sock_type == NET_SOCK_STREAM) {
+		/* The stream may queue empty packets that only carry the EOF
+		 * indication, skip over them.
+		 */
+		while (true) {
+			pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+			if (pkt == NULL) {
+				if (sock_is_error(ctx)) {
+					errno = POINTER_TO_INT(ctx->user_data);
+					return -1;
+				}
+
+				if (sock_is_eof(ctx)) {
+					return 0;
+				}
+
+				errno = EAGAIN;
+				return -1;
+			}
+
+			if (net_pkt_eof(pkt)) {
+				sock_set_eof(ctx);
+			}
+
+			if (net_pkt_remaining_data(pkt) > 0) {
+				break;
+			}
+
+			net_pkt_unref(pkt);
+		}
+
+		ret = sock_get_stream_src_addr(ctx, src_addr, addrlen);
+	} else {
+		pkt = k_fifo_get(&ctx->recv_q, timeout);
+		if (pkt == NULL) {
+			errno = EAGAIN;
+			return -1;
+		}
+
+		ret = 0;
+		if (src_addr != NULL && addrlen != NULL) {
+			ret = sock_get_dgram_src_addr(ctx, pkt, src_addr, addrlen);
+		}
+	}
+
+	if (ret < 0) {
+		net_pkt_unref(pkt);
+		errno = -ret;
+		return -1;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) ||
+	    IS_ENABLED(CONFIG_TRACING_NET_CORE)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	len = net_pkt_remaining_data(pkt);
+	*frags = zsock_pkt_detach_payload(pkt);
+
+	if (sock_type == NET_SOCK_STREAM) {
+		net_context_update_recv_wnd(ctx, len);
+	}
+
+	return len;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY_RX */
+
 static int zsock_poll_prepare_ctx(struct net_context *ctx,
 				  struct zsock_pollfd *pfd,
 				  struct k_poll_event **pev,
@@ -3225,6 +3475,23 @@ static int sock_getsockname_vmeth(void *obj, struct net_sockaddr *addr,
 	return zsock_getsockname_ctx(obj, addr, addrlen);
 }
 
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+static ssize_t sock_sendfile_vmeth(void *obj, struct fs_file_t *file,
+				   off_t *offset, size_t count)
+{
+	return zsock_sendfile_ctx(obj, file, offset, count);
+}
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY_RX)
+static ssize_t sock_recv_buf_vmeth(void *obj, struct net_buf **frags, int flags,
+				   struct net_sockaddr *src_addr,
+				   net_socklen_t *addrlen)
+{
+	return zsock_recv_buf_ctx(obj, frags, flags, src_addr, addrlen);
+}
+#endif
+
 const struct socket_op_vtable sock_fd_op_vtable = {
 	.fd_vtable = {
 		.read = sock_read_vmeth,
@@ -3245,6 +3512,12 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.setsockopt = sock_setsockopt_vmeth,
 	.getpeername = sock_getpeername_vmeth,
 	.getsockname = sock_getsockname_vmeth,
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY_RX)
+	.recv_buf = sock_recv_buf_vmeth,
+#endif
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+	.sendfile = sock_sendfile_vmeth,
+#endif
 };
 
 static bool inet_is_supported(int family, int type, int proto)
@@ -7,6 +7,8 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(net_sock_svc, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/init.h>
 #include <zephyr/net/socket_service.h>
@@ -20,7 +22,6 @@ enum SOCKET_SERVICE_THREAD_STATUS {
 	SOCKET_SERVICE_THREAD_STOPPED,
 	SOCKET_SERVICE_THREAD_RUNNING,
 };
-static enum SOCKET_SERVICE_THREAD_STATUS thread_status;
 
 static K_MUTEX_DEFINE(lock);
 static K_CONDVAR_DEFINE(wait_start);
@@ -28,10 +29,25 @@ static K_CONDVAR_DEFINE(wait_start);
 STRUCT_SECTION_START_EXTERN(net_socket_service_desc);
 STRUCT_SECTION_END_EXTERN(net_socket_service_desc);
 
+#define EVENT_BUDGET CONFIG_NET_SOCKETS_SERVICE_EVENT_BUDGET
+
+/* One dispatcher thread, polling the sockets of the services assigned to it.
+ * Entry 0 of the poll array is the eventfd used to restart polling.
+ */
 static struct service {
 	struct zsock_pollfd events[CONFIG_ZVFS_POLL_MAX];
+	/* Service owning each poll entry */
+	struct net_socket_service_desc *owner[CONFIG_ZVFS_POLL_MAX];
+#if EVENT_BUDGET > 0
+	/* Events handled in the current round, indexed by the first entry of a service */
+	uint8_t handled[CONFIG_ZVFS_POLL_MAX];
+	/* Entry the next round starts from, so that deferred events go first */
+	int start;
+#endif
 	int count;
-} ctx;
+	enum SOCKET_SERVICE_THREAD_STATUS status;
+	uint8_t id;
+} dispatchers[CONFIG_NET_SOCKETS_SERVICE_THREADS];
 
 #define get_idx(svc) (*(svc->idx))
 
@@ -54,20 +70,25 @@ int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc
 				       struct zsock_pollfd *fds, int len,
 				       void *user_data)
 {
+	struct service *ctx;
 	int i, ret = -ENOENT;
 
 	k_mutex_lock(&lock, K_FOREVER);
 
-	if (thread_status == SOCKET_SERVICE_THREAD_UNINITIALIZED) {
-		(void)k_condvar_wait(&wait_start, &lock, K_FOREVER);
-	} else if (thread_status != SOCKET_SERVICE_THREAD_RUNNING) {
-		NET_ERR("Socket service thread not running, service %p register fails.", svc);
-		ret = -EIO;
+	if (STRUCT_SECTION_START(net_socket_service_desc) > svc ||
+	    STRUCT_SECTION_END(net_socket_service_desc) <= svc) {
 		goto out;
 	}
 
-	if (STRUCT_SECTION_START(net_socket_service_desc) > svc ||
-	    STRUCT_SECTION_END(net_socket_service_desc) <= svc) {
+	ctx = &dispatchers[svc->thread];
+
+	while (ctx->status == SOCKET_SERVICE_THREAD_UNINITIALIZED) {
+		(void)k_condvar_wait(&wait_start, &lock, K_FOREVER);
+	}
+
+	if (ctx->status != SOCKET_SERVICE_THREAD_RUNNING) {
+		NET_ERR("Socket service thread not running, service %p register fails.", svc);
+		ret = -EIO;
 		goto out;
 	}
 
@@ -89,7 +110,7 @@ int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc
 	}
 
 	/* Tell the thread to re-read the variables */
-	zvfs_eventfd_write(ctx.events[0].fd, 1);
+	zvfs_eventfd_write(ctx->events[0].fd, 1);
 	ret = 0;
 
 out:
@@ -99,19 +120,19 @@ out:
 }
 
 static struct net_socket_service_desc *find_svc_and_event(
-	struct zsock_pollfd *pev,
+	struct service *ctx, int i,
 	struct net_socket_service_event **event)
 {
-	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
-		for (int i = 0; i < svc->pev_len; i++) {
-			if (svc->pev[i].event.fd == pev->fd) {
-				*event = &svc->pev[i];
-				return svc;
-			}
-		}
+	struct net_socket_service_desc *svc = ctx->owner[i];
+
+	*event = &svc->pev[i - get_idx(svc)];
+
+	/* The service was registered again after the poll array was copied */
+	if ((*event)->event.fd != ctx->events[i].fd) {
+		return NULL;
 	}
 
-	return NULL;
+	return svc;
 }
 
 /* We do not set the user callback to our work struct because we need to
@@ -145,12 +166,13 @@ static int call_work(struct zsock_pollfd *pev, struct net_socket_service_event *
 	return ret;
 }
 
-static int trigger_work(struct zsock_pollfd *pev)
+static int trigger_work(struct service *ctx, int i)
 {
+	struct zsock_pollfd *pev = &ctx->events[i];
 	struct net_socket_service_event *event;
 	struct net_socket_service_desc *svc;
 
-	svc = find_svc_and_event(pev, &event);
+	svc = find_svc_and_event(ctx, i, &event);
 	if (svc == NULL) {
 		return -ENOENT;
 	}
@@ -165,43 +187,96 @@ static int trigger_work(struct zsock_pollfd *pev)
 	return call_work(pev, event);
 }
 
+#if EVENT_BUDGET > 0
+/* Returns true if the event of entry i may be handled in this round */
+static bool take_budget(struct service *ctx, int i)
+{
+	int first = get_idx(ctx->owner[i]);
+
+	if (ctx->handled[first] >= EVENT_BUDGET) {
+		return false;
+	}
+
+	ctx->handled[first]++;
+
+	return true;
+}
+#endif
+
+static void set_status(struct service *ctx, enum SOCKET_SERVICE_THREAD_STATUS status)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	ctx->status = status;
+	k_condvar_broadcast(&wait_start);
+	k_mutex_unlock(&lock);
+}
+
 static void socket_service_thread(void *p1, void *p2, void *p3)
 {
-	ARG_UNUSED(p1);
 	ARG_UNUSED(p2);
 	ARG_UNUSED(p3);
 
-	int ret, i, fd, count = 0;
+	struct service *ctx = p1;
+	int ret, i, n, fd, count = 0;
+#if EVENT_BUDGET > 0
+	int deferred;
+#endif
 	zvfs_eventfd_t value;
 
 	STRUCT_SECTION_COUNT(net_socket_service_desc, &ret);
 	if (ret == 0) {
-		NET_INFO("No socket services found, service disabled.");
+		if (ctx->id == 0) {
+			NET_INFO("No socket services found, service disabled.");
+		}
+
 		goto fail;
 	}
 
-	/* Create contiguous poll event array to enable socket polling */
+	/* Count the entries first, the owner table has the size of the poll array */
 	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
-		NET_DBG("Service %s has %d pollable sockets",
-			COND_CODE_1(CONFIG_NET_SOCKETS_LOG_LEVEL_DBG,
-				    (svc->owner), ("")),
-			svc->pev_len);
-		get_idx(svc) = count + 1;
-		count += svc->pev_len;
+		if (svc->thread == ctx->id) {
+			count += svc->pev_len;
+		}
 	}
 
-	if ((count + 1) > ARRAY_SIZE(ctx.events)) {
+	if (count == 0) {
+		NET_DBG("No socket services for thread %d", ctx->id);
+		goto fail;
+	}
+
+	if ((count + 1) > ARRAY_SIZE(ctx->events)) {
 		NET_ERR("You have %d services to monitor but "
 			"%zd poll entries configured.",
-			count + 1, ARRAY_SIZE(ctx.events));
+			count + 1, ARRAY_SIZE(ctx->events));
 		NET_ERR("Please increase value of %s to at least %d",
 			"CONFIG_ZVFS_POLL_MAX", count + 1);
 		goto fail;
 	}
 
+	count = 0;
+
+	/* Create contiguous poll event array to enable socket polling */
+	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
+		if (svc->thread != ctx->id) {
+			continue;
+		}
+
+		NET_DBG("Service %s has %d pollable sockets",
+			COND_CODE_1(CONFIG_NET_SOCKETS_LOG_LEVEL_DBG,
+				    (svc->owner), ("")),
+			svc->pev_len);
+		get_idx(svc) = count + 1;
+
+		for (int j = 0; j < svc->pev_len; j++) {
+			ctx->owner[get_idx(svc) + j] = svc;
+		}
+
+		count += svc->pev_len;
+	}
+
 	NET_DBG("Monitoring %d socket entries", count);
 
-	ctx.count = count + 1;
+	ctx->count = count + 1;
 
 	/* Create an zvfs_eventfd that can be used to trigger events during polling */
 	fd = zvfs_eventfd(0, 0);
@@ -211,28 +286,29 @@ static void socket_service_thread(void *p1, void *p2, void *p3)
 		goto out;
 	}
 
-	thread_status = SOCKET_SERVICE_THREAD_RUNNING;
-	k_condvar_broadcast(&wait_start);
+	ctx->events[0].fd = fd;
+	ctx->events[0].events = ZSOCK_POLLIN;
 
-	ctx.events[0].fd = fd;
-	ctx.events[0].events = ZSOCK_POLLIN;
+	set_status(ctx, SOCKET_SERVICE_THREAD_RUNNING);
 
 restart:
-	i = 1;
-
 	k_mutex_lock(&lock, K_FOREVER);
 
 	/* Copy individual events to the big array */
 	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
+		if (svc->thread != ctx->id) {
+			continue;
+		}
+
 		for (int j = 0; j < svc->pev_len; j++) {
-			ctx.events[get_idx(svc) + j] = svc->pev[j].event;
+			ctx->events[get_idx(svc) + j] = svc->pev[j].event;
 		}
 	}
 
 	k_mutex_unlock(&lock);
 
 	while (true) {
-		ret = zsock_poll(ctx.events, count + 1, -1);
+		ret = zsock_poll(ctx->events, count + 1, -1);
 		if (ret < 0) {
 			ret = -errno;
 			NET_ERR("poll failed (%d)", ret);
@@ -244,14 +320,34 @@ restart:
 			break;
 		}
 
+#if EVENT_BUDGET > 0
+		memset(ctx->handled, 0, sizeof(ctx->handled));
+		deferred = 0;
+#endif
+
 		/* Process work here */
-		for (i = 1; i < (count + 1); i++) {
-			if (ctx.events[i].fd < 0) {
+		for (n = 0; n < count; n++) {
+#if EVENT_BUDGET > 0
+			i = 1 + (ctx->start + n) % count;
+#else
+			i = 1 + n;
+#endif
+			if (ctx->events[i].fd < 0) {
 				continue;
 			}
 
-			if (ctx.events[i].revents > 0) {
-				ret = trigger_work(&ctx.events[i]);
+			if (ctx->events[i].revents > 0) {
+#if EVENT_BUDGET > 0
+				if (!take_budget(ctx, i)) {
+					/* Still pending, so the next poll returns at once */
+					if (deferred == 0) {
+						deferred = i;
+					}
+
+					continue;
+				}
+#endif
+				ret = trigger_work(ctx, i);
 				if (ret < 0) {
 					NET_DBG("Triggering work failed (%d)", ret);
 					goto restart;
@@ -259,10 +355,15 @@ restart:
 			}
 		}
 
+#if EVENT_BUDGET > 0
+		/* Start the next round from the first event that ran out of budget */
+		ctx->start = (deferred > 0) ? deferred - 1 : 0;
+#endif
+
 		/* Relocate after trigger work so the work gets done before restarting */
-		if (ctx.events[0].revents) {
-			zvfs_eventfd_read(ctx.events[0].fd, &value);
-			ctx.events[0].revents = 0;
+		if (ctx->events[0].revents) {
+			zvfs_eventfd_read(ctx->events[0].fd, &value);
+			ctx->events[0].revents = 0;
 			NET_DBG("Received restart event.");
 			goto restart;
 		}
@@ -270,32 +371,44 @@ restart:
 
 out:
 	NET_DBG("Socket service thread stopped");
-	thread_status = SOCKET_SERVICE_THREAD_STOPPED;
+	set_status(ctx, SOCKET_SERVICE_THREAD_STOPPED);
 
 	return;
 
 fail:
-	thread_status = SOCKET_SERVICE_THREAD_FAILED;
-	k_condvar_broadcast(&wait_start);
+	set_status(ctx, SOCKET_SERVICE_THREAD_FAILED);
 }
 
 static int init_socket_service(void)
 {
 	k_tid_t ssm;
-	static struct k_thread service_thread;
-
-	static K_THREAD_STACK_DEFINE(service_thread_stack,
-				     CONFIG_NET_SOCKETS_SERVICE_STACK_SIZE);
-
-	ssm = k_thread_create(&service_thread,
-			      service_thread_stack,
-			      K_THREAD_STACK_SIZEOF(service_thread_stack),
-			      (k_thread_entry_t)socket_service_thread, NULL, NULL, NULL,
-			      CLAMP(CONFIG_NET_SOCKETS_SERVICE_THREAD_PRIO,
-				    K_HIGHEST_APPLICATION_THREAD_PRIO,
-				    K_LOWEST_APPLICATION_THREAD_PRIO), 0, K_NO_WAIT);
-
-	k_thread_name_set(ssm, "net_socket_service");
+	static struct k_thread service_threads[CONFIG_NET_SOCKETS_SERVICE_THREADS];
+
+	static K_THREAD_STACK_ARRAY_DEFINE(service_thread_stacks,
+					   CONFIG_NET_SOCKETS_SERVICE_THREADS,
+					   CONFIG_NET_SOCKETS_SERVICE_STACK_SIZE);
+
+	for (int i = 0; i < CONFIG_NET_SOCKETS_SERVICE_THREADS; i++) {
+		char name[sizeof("net_socket_service_x")];
+
+		dispatchers[i].id = i;
+
+		ssm = k_thread_create(&service_threads[i],
+				      service_thread_stacks[i],
+				      K_THREAD_STACK_SIZEOF(service_thread_stacks[i]),
+				      (k_thread_entry_t)socket_service_thread,
+				      &dispatchers[i], NULL, NULL,
+				      CLAMP(CONFIG_NET_SOCKETS_SERVICE_THREAD_PRIO,
+					    K_HIGHEST_APPLICATION_THREAD_PRIO,
+					    K_LOWEST_APPLICATION_THREAD_PRIO), 0, K_NO_WAIT);
+
+		if (i == 0) {
+			k_thread_name_set(ssm, "net_socket_service");
+		} else {
+			snprintk(name, sizeof(name), "net_socket_service_%d", i);
+			k_thread_name_set(ssm, name);
+		}
+	}
 
 	return 0;
 }
@@ -46,6 +46,10 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/error.h>
 #include <mbedtls/platform.h>
 #include <mbedtls/ssl_cache.h>
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+#include <mbedtls/ssl_ticket.h>
+#include <mbedtls/platform_util.h>
+#endif
 #endif /* CONFIG_MBEDTLS */
 
 #include "sockets_internal.h"
@@ -264,8 +268,21 @@ __net_socket struct tls_context {
 #if defined(CONFIG_NET_SOCKETS_TLS_CERT_VERIFY_CALLBACK)
 		struct tls_cert_verify_cb cert_verify;
 #endif /* CONFIG_NET_SOCKETS_TLS_CERT_VERIFY_CALLBACK */
+
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+		/** Hold back the data sent until the socket is uncorked. */
+		bool cork;
+#endif /* CONFIG_NET_SOCKETS_TLS_CORK */
 	} options;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+	/** Data waiting to be sent in a single TLS record. */
+	uint8_t cork_buf[CONFIG_NET_SOCKETS_TLS_CORK_BUF_SIZE];
+
+	/** Length of the data in the cork buffer. */
+	size_t cork_len;
+#endif /* CONFIG_NET_SOCKETS_TLS_CORK */
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/** mbedTLS cookie context for DTLS */
 	mbedtls_ssl_cookie_ctx cookie;
@@ -310,6 +327,27 @@ static struct tls_session_cache client_cache[CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_S
 static mbedtls_ssl_cache_context server_cache;
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+#define TLS_TICKET_KEY_LEN 32
+
+static mbedtls_ssl_ticket_context ticket_ctx;
+static bool ticket_ctx_ready;
+static int64_t ticket_key_timestamp;
+
+/* The ticket keys are shared by all server sockets. */
+static K_MUTEX_DEFINE(ticket_lock);
+#endif
+
+/* Server-side session resumption statistics. */
+static struct {
+	atomic_t handshakes;
+	atomic_t cache_lookups;
+	atomic_t cache_hits;
+	atomic_t ticket_lookups;
+	atomic_t ticket_hits;
+	atomic_t ticket_key_rotations;
+} session_stats;
+
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
@@ -320,6 +358,10 @@ static struct k_mutex context_lock;
 
 static int tls_mbedtls_reset_session(struct tls_context *context);
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+static int tls_cork_flush(struct tls_context *ctx, int flags);
+#endif
+
 static void tls_session_cache_reset(void)
 {
 	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
@@ -831,6 +873,149 @@ exit:
 	mbedtls_ssl_session_free(&session);
 }
 
+#if defined(MBEDTLS_SSL_CACHE_C)
+static int tls_server_cache_get(void *data, unsigned char const *session_id,
+				size_t session_id_len,
+				mbedtls_ssl_session *session)
+{
+	int ret;
+
+	ret = mbedtls_ssl_cache_get(data, session_id, session_id_len, session);
+
+	atomic_inc(&session_stats.cache_lookups);
+	if (ret == 0) {
+		atomic_inc(&session_stats.cache_hits);
+	}
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+static int tls_ticket_key_rotate(void)
+{
+	uint8_t name[MBEDTLS_SSL_TICKET_KEY_NAME_BYTES];
+	uint8_t key[TLS_TICKET_KEY_LEN];
+	int ret;
+
+	ret = sys_csrand_get(name, sizeof(name));
+	if (ret == 0) {
+		ret = sys_csrand_get(key, sizeof(key));
+	}
+
+	if (ret < 0) {
+		NET_ERR("Failed to generate ticket key, err: %d", ret);
+		return ret;
+	}
+
+	ret = mbedtls_ssl_ticket_rotate(&ticket_ctx, name, sizeof(name),
+					key, sizeof(key),
+					CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME);
+	mbedtls_platform_zeroize(key, sizeof(key));
+	if (ret != 0) {
+		NET_ERR("Failed to rotate ticket key, err: -0x%x", -ret);
+		return -EIO;
+	}
+
+	ticket_key_timestamp = k_uptime_get();
+	atomic_inc(&session_stats.ticket_key_rotations);
+
+	NET_DBG("Session ticket key rotated");
+
+	return 0;
+}
+
+/* Set up the ticket keys on first use and rotate them once expired.
+ * Must be called with ticket_lock held.
+ */
+static int tls_ticket_keys_update(void)
+{
+	int ret;
+
+	if (!ticket_ctx_ready) {
+		mbedtls_ssl_ticket_init(&ticket_ctx);
+
+		ret = mbedtls_ssl_ticket_setup(&ticket_ctx, tls_ctr_drbg_random,
+					       NULL, MBEDTLS_CIPHER_AES_256_GCM,
+					       CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME);
+		if (ret != 0) {
+			NET_ERR("Failed to setup ticket keys, err: -0x%x", -ret);
+			mbedtls_ssl_ticket_free(&ticket_ctx);
+			return -ENOMEM;
+		}
+
+		ticket_ctx_ready = true;
+		ticket_key_timestamp = k_uptime_get();
+
+		return 0;
+	}
+
+	if (k_uptime_get() - ticket_key_timestamp <
+	    (int64_t)CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME * MSEC_PER_SEC) {
+		return 0;
+	}
+
+	return tls_ticket_key_rotate();
+}
+
+static int tls_ticket_write(void *p_ticket, const mbedtls_ssl_session *session,
+			    unsigned char *start, const unsigned char *end,
+			    size_t *tlen, uint32_t *lifetime)
+{
+	int ret;
+
+	k_mutex_lock(&ticket_lock, K_FOREVER);
+
+	/* On rotation failure, keep on using the current key. */
+	(void)tls_ticket_keys_update();
+
+	ret = mbedtls_ssl_ticket_write(p_ticket, session, start, end, tlen,
+				       lifetime);
+
+	k_mutex_unlock(&ticket_lock);
+
+	return ret;
+}
+
+static int tls_ticket_parse(void *p_ticket, mbedtls_ssl_session *session,
+			    unsigned char *buf, size_t len)
+{
+	int ret;
+
+	k_mutex_lock(&ticket_lock, K_FOREVER);
+
+	(void)tls_ticket_keys_update();
+
+	ret = mbedtls_ssl_ticket_parse(p_ticket, session, buf, len);
+
+	k_mutex_unlock(&ticket_lock);
+
+	atomic_inc(&session_stats.ticket_lookups);
+	if (ret == 0) {
+		atomic_inc(&session_stats.ticket_hits);
+	}
+
+	return ret;
+}
+
+static void tls_ticket_keys_purge(void)
+{
+	k_mutex_lock(&ticket_lock, K_FOREVER);
+
+	/* Replace both the active and the previous key, so that none of the
+	 * tickets issued so far can be decrypted anymore.
+	 */
+	if (ticket_ctx_ready) {
+		if (tls_ticket_key_rotate() < 0 || tls_ticket_key_rotate() < 0) {
+			mbedtls_ssl_ticket_free(&ticket_ctx);
+			ticket_ctx_ready = false;
+		}
+	}
+
+	k_mutex_unlock(&ticket_lock);
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS */
+
 static void tls_session_purge(void)
 {
 	tls_session_cache_reset();
@@ -839,6 +1024,10 @@ static void tls_session_purge(void)
 	mbedtls_ssl_cache_free(&server_cache);
 	mbedtls_ssl_cache_init(&server_cache);
 #endif
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+	tls_ticket_keys_purge();
+#endif
 }
 
 static inline int time_left(uint32_t start, uint32_t timeout)
@@ -1691,6 +1880,10 @@ static int tls_mbedtls_handshake(struct tls_context *context,
 	if (ret == 0) {
 		context->active_session->handshake_timestamp = k_uptime_get();
 		k_sem_give(&context->active_session->tls_established);
+
+		if (context->config.endpoint == MBEDTLS_SSL_IS_SERVER) {
+			atomic_inc(&session_stats.handshakes);
+		}
 	}
 
 	context->active_session->handshake_in_progress = false;
@@ -1881,11 +2074,27 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 #if defined(MBEDTLS_SSL_CACHE_C)
 	if (is_server && context->options.cache_enabled) {
 		mbedtls_ssl_conf_session_cache(&context->config, &server_cache,
-					       mbedtls_ssl_cache_get,
+					       tls_server_cache_get,
 					       mbedtls_ssl_cache_set);
 	}
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+	if (is_server && context->options.cache_enabled) {
+		k_mutex_lock(&ticket_lock, K_FOREVER);
+		ret = tls_ticket_keys_update();
+		k_mutex_unlock(&ticket_lock);
+		if (ret < 0) {
+			return ret;
+		}
+
+		mbedtls_ssl_conf_session_tickets_cb(&context->config,
+						    tls_ticket_write,
+						    tls_ticket_parse,
+						    &ticket_ctx);
+	}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS */
+
 #if defined(MBEDTLS_SSL_EARLY_DATA)
 	mbedtls_ssl_conf_early_data(&context->config, MBEDTLS_SSL_EARLY_DATA_ENABLED);
 #endif
@@ -2735,6 +2944,78 @@ static int tls_opt_cert_verify_callback_set(struct tls_context *context,
 }
 #endif /* CONFIG_NET_SOCKETS_TLS_CERT_VERIFY_CALLBACK */
 
+static int tls_opt_session_stats_get(struct tls_context *context,
+				     void *optval, net_socklen_t *optlen)
+{
+	struct zsock_tls_session_stats *stats = optval;
+
+	if (*optlen != sizeof(*stats)) {
+		return -EINVAL;
+	}
+
+	stats->handshakes = atomic_get(&session_stats.handshakes);
+	stats->cache_lookups = atomic_get(&session_stats.cache_lookups);
+	stats->cache_hits = atomic_get(&session_stats.cache_hits);
+	stats->ticket_lookups = atomic_get(&session_stats.ticket_lookups);
+	stats->ticket_hits = atomic_get(&session_stats.ticket_hits);
+	stats->ticket_key_rotations =
+		atomic_get(&session_stats.ticket_key_rotations);
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+static int tls_opt_cork_set(struct tls_context *context,
+			    const void *optval, net_socklen_t optlen)
+{
+	int *val = (int *)optval;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (sizeof(int) != optlen) {
+		return -EINVAL;
+	}
+
+	if (context->type != NET_SOCK_STREAM) {
+		return -ENOPROTOOPT;
+	}
+
+	context->options.cork = (bool)*val;
+
+	/* Uncorking sends the data held back. Should it not be sent right
+	 * away, it will be on the next socket call.
+	 */
+	if (!context->options.cork && context->cork_len > 0) {
+		(void)tls_cork_flush(context, ZSOCK_MSG_DONTWAIT);
+	}
+
+	return 0;
+}
+
+static int tls_opt_cork_get(struct tls_context *context,
+			    void *optval, net_socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.cork;
+
+	return 0;
+}
+#else /* CONFIG_NET_SOCKETS_TLS_CORK */
+static int tls_opt_cork_set(struct tls_context *context,
+			    const void *optval, net_socklen_t optlen)
+{
+	NET_ERR("TLS_CORK option requires "
+		"CONFIG_NET_SOCKETS_TLS_CORK enabled");
+
+	return -ENOPROTOOPT;
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_CORK */
+
 static int protocol_check(int family, int type, int *proto)
 {
 	if (family != NET_AF_INET && family != NET_AF_INET6) {
@@ -2819,6 +3100,12 @@ int ztls_close_ctx(struct tls_context *ctx, int sock)
 	/* Try to send close notification. */
 	ctx->flags = 0;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+	if (ctx->cork_len > 0) {
+		(void)tls_cork_flush(ctx, 0);
+	}
+#endif /* CONFIG_NET_SOCKETS_TLS_CORK */
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->sessions, session_ctx, node) {
 		(void)mbedtls_ssl_close_notify(&session_ctx->ssl);
 	}
@@ -3063,6 +3350,91 @@ static ssize_t send_tls(struct tls_context *ctx, const void *buf,
 	return -1;
 }
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+/* Send the data held in the cork buffer. On a partial send, the remaining data
+ * is moved to the front of the buffer, so that it is passed to mbedTLS again,
+ * as required after MBEDTLS_ERR_SSL_WANT_WRITE.
+ */
+static int tls_cork_flush(struct tls_context *ctx, int flags)
+{
+	size_t sent = 0;
+	ssize_t ret = 0;
+
+	while (sent < ctx->cork_len) {
+		ret = send_tls(ctx, ctx->cork_buf + sent, ctx->cork_len - sent,
+			       flags);
+		if (ret < 0) {
+			break;
+		}
+
+		sent += ret;
+	}
+
+	ctx->cork_len -= sent;
+	if (ctx->cork_len > 0 && sent > 0) {
+		memmove(ctx->cork_buf, ctx->cork_buf + sent, ctx->cork_len);
+	}
+
+	return (ret < 0) ? -1 : 0;
+}
+
+/* Flush the data left behind by a non-blocking send on an uncorked socket. */
+static void tls_cork_flush_pending(struct tls_context *ctx, int flags)
+{
+	if (ctx->type != NET_SOCK_STREAM || ctx->options.cork ||
+	    ctx->cork_len == 0) {
+		return;
+	}
+
+	(void)tls_cork_flush(ctx, flags);
+}
+
+static ssize_t send_tls_corked(struct tls_context *ctx, const void *buf,
+			       size_t len, int flags)
+{
+	const bool more = ctx->options.cork || (flags & ZSOCK_MSG_MORE);
+	size_t copied = 0;
+	size_t chunk;
+
+	flags &= ~ZSOCK_MSG_MORE;
+
+	/* Nothing to coalesce with, pass the data to mbedTLS directly. */
+	if (ctx->cork_len == 0 && (!more || len >= sizeof(ctx->cork_buf))) {
+		return send_tls(ctx, buf, len, flags);
+	}
+
+	while (copied < len) {
+		if (ctx->cork_len == sizeof(ctx->cork_buf)) {
+			if (tls_cork_flush(ctx, flags) < 0) {
+				break;
+			}
+		}
+
+		chunk = MIN(len - copied, sizeof(ctx->cork_buf) - ctx->cork_len);
+		memcpy(ctx->cork_buf + ctx->cork_len, (const uint8_t *)buf + copied,
+		       chunk);
+		ctx->cork_len += chunk;
+		copied += chunk;
+	}
+
+	if (copied == 0 && len > 0) {
+		return -1;
+	}
+
+	/* The data copied is accepted even if it could not be sent right away,
+	 * any error will be reported by the subsequent socket calls.
+	 */
+	if (!more && copied == len) {
+		(void)tls_cork_flush(ctx, flags);
+	}
+
+	return copied;
+}
+#else
+#define tls_cork_flush_pending(...)
+#define send_tls_corked(ctx, buf, len, flags) send_tls(ctx, buf, len, flags)
+#endif /* CONFIG_NET_SOCKETS_TLS_CORK */
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 static ssize_t sendto_dtls_client(struct tls_context *ctx, const void *buf,
 				  size_t len, int flags,
@@ -3167,7 +3539,7 @@ ssize_t ztls_sendto_ctx(struct tls_context *ctx, const void *buf, size_t len,
 
 	/* TLS */
 	if (ctx->type == NET_SOCK_STREAM) {
-		return send_tls(ctx, buf, len, flags);
+		return send_tls_corked(ctx, buf, len, flags);
 	}
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
@@ -3227,6 +3599,12 @@ static ssize_t tls_sendmsg_loop_and_send(struct tls_context *ctx,
 {
 	ssize_t len = 0;
 	ssize_t ret;
+	int vec_flags = flags;
+	int last = msg->msg_iovlen - 1;
+
+	while (last > 0 && msg->msg_iov[last].iov_len == 0) {
+		last--;
+	}
 
 	for (int i = 0; i < msg->msg_iovlen; i++) {
 		struct net_iovec *vec = msg->msg_iov + i;
@@ -3236,11 +3614,19 @@ static ssize_t tls_sendmsg_loop_and_send(struct tls_context *ctx,
 			continue;
 		}
 
+		/* Gather the buffers into as few TLS records as possible. */
+		if (IS_ENABLED(CONFIG_NET_SOCKETS_TLS_CORK) &&
+		    ctx->type == NET_SOCK_STREAM && i < last) {
+			vec_flags = flags | ZSOCK_MSG_MORE;
+		} else {
+			vec_flags = flags;
+		}
+
 		while (sent < vec->iov_len) {
 			uint8_t *ptr = (uint8_t *)vec->iov_base + sent;
 
 			ret = ztls_sendto_ctx(ctx, ptr, vec->iov_len - sent,
-					      flags, msg->msg_name,
+					      vec_flags, msg->msg_name,
 					      msg->msg_namelen);
 			if (ret < 0) {
 				return ret;
@@ -3723,6 +4109,8 @@ ssize_t ztls_recvfrom_ctx(struct tls_context *ctx, void *buf, size_t max_len,
 
 	/* TLS */
 	if (ctx->type == NET_SOCK_STREAM) {
+		tls_cork_flush_pending(ctx, flags & ZSOCK_MSG_DONTWAIT);
+
 		return recv_tls(ctx, buf, max_len, flags);
 	}
 
@@ -3785,6 +4173,13 @@ static int ztls_poll_prepare_ctx(struct tls_context *ctx,
 		pfd->events &= ~ZSOCK_POLLIN;
 	}
 
+	/* Data held back after a non-blocking send should not wait for
+	 * another send() call.
+	 */
+	if (ctx->is_initialized && !ctx->is_listening) {
+		tls_cork_flush_pending(ctx, ZSOCK_MSG_DONTWAIT);
+	}
+
 	obj = zvfs_get_fd_obj_and_vtable(
 		ctx->sock, (const struct fd_op_vtable **)&vtable, &lock);
 	if (obj == NULL) {
@@ -4380,6 +4775,16 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_cert_verify_result_get(ctx, optval, optlen);
 		break;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CORK)
+	case ZSOCK_TLS_CORK:
+		err = tls_opt_cork_get(ctx, optval, optlen);
+		break;
+#endif /* CONFIG_NET_SOCKETS_TLS_CORK */
+
+	case ZSOCK_TLS_SESSION_STATS:
+		err = tls_opt_session_stats_get(ctx, optval, optlen);
+		break;
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	case ZSOCK_TLS_DTLS_HANDSHAKE_TIMEOUT_MIN:
 		err = tls_opt_dtls_handshake_timeout_get(ctx, optval,
@@ -4506,6 +4911,10 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_cert_verify_callback_set(ctx, optval, optlen);
 		break;
 
+	case ZSOCK_TLS_CORK:
+		err = tls_opt_cork_set(ctx, optval, optlen);
+		break;
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	case ZSOCK_TLS_DTLS_HANDSHAKE_TIMEOUT_MIN:
 		err = tls_opt_dtls_handshake_timeout_set(ctx, optval,
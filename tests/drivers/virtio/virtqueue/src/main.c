@@ -0,0 +1,174 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/virtio/virtqueue.h>
+#include <zephyr/sys/byteorder.h>
+
+#define QUEUE_SIZE 8
+#define MAX_CALLS 8
+
+static struct virtq vq;
+static uint8_t bufs[QUEUE_SIZE][16];
+
+static struct {
+	int count;
+	uintptr_t opaque[MAX_CALLS];
+	uint32_t len[MAX_CALLS];
+} calls;
+
+static void record_cb(void *opaque, uint32_t used_len)
+{
+	zassert_true(calls.count < MAX_CALLS, "Too many callbacks");
+
+	calls.opaque[calls.count] = (uintptr_t)opaque;
+	calls.len[calls.count] = used_len;
+	calls.count++;
+}
+
+/* Queue a chain of @p n buffers and return the index of its head descriptor */
+static uint16_t add_chain(uint16_t n, virtq_receive_callback cb, uintptr_t opaque)
+{
+	struct virtq_buf chain[QUEUE_SIZE];
+	uint16_t avail_idx = sys_le16_to_cpu(vq.avail->idx);
+
+	for (uint16_t i = 0; i < n; i++) {
+		chain[i].addr = bufs[i];
+		chain[i].len = sizeof(bufs[i]);
+	}
+
+	zassert_ok(virtq_add_buffer_chain(&vq, chain, n, 0, cb, (void *)opaque,
+					  K_NO_WAIT),
+		   "Failed to add buffer chain");
+	zassert_equal(sys_le16_to_cpu(vq.avail->idx), avail_idx + 1,
+		      "Chain not made available");
+
+	return sys_le16_to_cpu(vq.avail->ring[avail_idx % QUEUE_SIZE]);
+}
+
+/* Return a chain to the driver as the device would */
+static void device_use(uint16_t head, uint32_t len)
+{
+	uint16_t used_idx = sys_le16_to_cpu(vq.used->idx);
+
+	vq.used->ring[used_idx % QUEUE_SIZE].id = sys_cpu_to_le16(head);
+	vq.used->ring[used_idx % QUEUE_SIZE].len = sys_cpu_to_le32(len);
+	vq.used->idx = sys_cpu_to_le16(used_idx + 1);
+}
+
+ZTEST(virtqueue, test_process_used_in_order)
+{
+	uint16_t heads[3];
+
+	heads[0] = add_chain(1, record_cb, 1);
+	heads[1] = add_chain(2, record_cb, 2);
+	heads[2] = add_chain(3, record_cb, 3);
+	zassert_equal(vq.free_desc_n, QUEUE_SIZE - 6, "Descriptors not taken");
+	zassert_false(virtq_has_used(&vq), "Nothing was used yet");
+
+	/* The device may return chains out of order (spec 2.7.9) */
+	device_use(heads[1], 20);
+	device_use(heads[2], 30);
+	device_use(heads[0], 10);
+	zassert_true(virtq_has_used(&vq), "Used chains not seen");
+
+	virtq_process_used(&vq);
+
+	zassert_equal(calls.count, 3, "Unexpected number of callbacks");
+	zassert_equal(calls.opaque[0], 2);
+	zassert_equal(calls.len[0], 20);
+	zassert_equal(calls.opaque[1], 3);
+	zassert_equal(calls.len[1], 30);
+	zassert_equal(calls.opaque[2], 1);
+	zassert_equal(calls.len[2], 10);
+
+	zassert_false(virtq_has_used(&vq), "Used chains left");
+	zassert_equal(vq.free_desc_n, QUEUE_SIZE, "Descriptors not freed");
+}
+
+static void requeue_cb(void *opaque, uint32_t used_len)
+{
+	record_cb(opaque, used_len);
+
+	/* Callbacks run without a lock held, so they may block. Waiting
+	 * while holding a spinlock would trip the spinlock validation.
+	 */
+	k_sleep(K_MSEC(1));
+
+	(void)add_chain(1, record_cb, (uintptr_t)opaque + 10);
+}
+
+ZTEST(virtqueue, test_callback_may_block)
+{
+	uint16_t head;
+
+	head = add_chain(1, requeue_cb, 1);
+	device_use(head, 5);
+
+	virtq_process_used(&vq);
+
+	zassert_equal(calls.count, 1, "Unexpected number of callbacks");
+	zassert_equal(vq.free_desc_n, QUEUE_SIZE - 1,
+		      "Chain added by the callback not queued");
+
+	head = sys_le16_to_cpu(vq.avail->ring[(sys_le16_to_cpu(vq.avail->idx) - 1) %
+					      QUEUE_SIZE]);
+	device_use(head, 6);
+
+	virtq_process_used(&vq);
+
+	zassert_equal(calls.count, 2, "Unexpected number of callbacks");
+	zassert_equal(calls.opaque[1], 11);
+	zassert_equal(calls.len[1], 6);
+}
+
+static void nested_cb(void *opaque, uint32_t used_len)
+{
+	record_cb(opaque, used_len);
+
+	/* The outer call is still processing, so this must not invoke the
+	 * callback of the next chain before this one returns.
+	 */
+	virtq_process_used(&vq);
+
+	zassert_equal(calls.count, 1, "Callbacks invoked out of order");
+}
+
+ZTEST(virtqueue, test_process_used_nested)
+{
+	uint16_t head0, head1;
+
+	head0 = add_chain(1, nested_cb, 1);
+	head1 = add_chain(1, record_cb, 2);
+
+	device_use(head0, 1);
+	device_use(head1, 2);
+
+	virtq_process_used(&vq);
+
+	zassert_equal(calls.count, 2, "Unexpected number of callbacks");
+	zassert_equal(calls.opaque[0], 1);
+	zassert_equal(calls.opaque[1], 2);
+	zassert_false(virtq_has_used(&vq), "Used chains left");
+}
+
+static void virtqueue_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&calls, 0, sizeof(calls));
+	zassert_ok(virtq_create(&vq, QUEUE_SIZE), "Failed to create virtqueue");
+}
+
+static void virtqueue_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	virtq_free(&vq);
+}
+
+ZTEST_SUITE(virtqueue, NULL, NULL, virtqueue_before, virtqueue_after, NULL);
@@ -1172,5 +1172,34 @@ ZTEST(t_6lo, test_loop)
 	net_pkt_print();
 }
 
+/* Same as test_loop, but every header is compressed twice in a row. With
+ * CONFIG_NET_6LO_IPHC_CACHE the second one is taken from the cache.
+ */
+ZTEST(t_6lo, test_loop_repeat)
+{
+	int count;
+
+	if (IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)) {
+		k_thread_priority_set(k_current_get(),
+				K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1));
+	} else {
+		k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(9));
+	}
+
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	net_6lo_set_context(net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY)),
+			    &ctx1);
+	net_6lo_set_context(net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY)),
+			    &ctx2);
+#endif
+
+	for (count = 0; count < ARRAY_SIZE(tests); count++) {
+		TC_PRINT("Starting %s twice\n", tests[count].name);
+
+		test_6lo(tests[count].data);
+		test_6lo(tests[count].data);
+	}
+}
+
 /*test case main entry*/
 ZTEST_SUITE(t_6lo, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,144 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/ethernet_poll.h>
+
+#define BUDGET CONFIG_NET_L2_ETHERNET_POLL_BUDGET
+
+/* Fake driver whose receive ring is just a count of pending frames */
+static struct fake_eth {
+	struct net_eth_poll poll;
+	int ring;
+	int slipped;
+	int processed;
+	int poll_calls;
+	int rearm_calls;
+	bool irq_masked;
+	struct k_sem rearmed;
+} fake;
+
+static int fake_poll(struct net_eth_poll *poll, int budget)
+{
+	struct fake_eth *eth = CONTAINER_OF(poll, struct fake_eth, poll);
+	int count = MIN(eth->ring, budget);
+
+	zassert_true(eth->irq_masked, "Polled with the interrupt unmasked");
+	zassert_equal(budget, BUDGET, "Unexpected budget");
+
+	eth->ring -= count;
+	eth->processed += count;
+	eth->poll_calls++;
+
+	return count;
+}
+
+static bool fake_rearm(struct net_eth_poll *poll)
+{
+	struct fake_eth *eth = CONTAINER_OF(poll, struct fake_eth, poll);
+
+	zassert_equal(eth->ring, 0, "Rearmed with frames left in the ring");
+
+	eth->rearm_calls++;
+
+	/* Frames that arrived while the interrupt was masked */
+	if (eth->slipped > 0) {
+		eth->ring += eth->slipped;
+		eth->slipped = 0;
+		return true;
+	}
+
+	eth->irq_masked = false;
+	k_sem_give(&eth->rearmed);
+
+	return false;
+}
+
+/* What the interrupt handler of the driver would do */
+static void fake_rx_irq(int frames)
+{
+	fake.ring += frames;
+	fake.irq_masked = true;
+	net_eth_poll_schedule(&fake.poll);
+}
+
+static void wait_rearmed(void)
+{
+	zassert_ok(k_sem_take(&fake.rearmed, K_SECONDS(1)), "Poll never finished");
+
+	/* Make sure that nothing is resubmitted after the rearm */
+	k_sleep(K_MSEC(10));
+	zassert_false(fake.irq_masked, "Interrupt left masked");
+}
+
+ZTEST(net_eth_poll, test_poll_budget)
+{
+	fake_rx_irq(2 * BUDGET + 1);
+	wait_rearmed();
+
+	zassert_equal(fake.processed, 2 * BUDGET + 1, "Frames not processed");
+	zassert_equal(fake.poll_calls, 3, "Budget not applied (%d polls)",
+		      fake.poll_calls);
+	zassert_equal(fake.rearm_calls, 1, "Unexpected rearm count %d",
+		      fake.rearm_calls);
+}
+
+ZTEST(net_eth_poll, test_poll_exact_budget)
+{
+	/* A full budget means the ring may not be empty, so the driver
+	 * is polled once more before the interrupt is unmasked.
+	 */
+	fake_rx_irq(BUDGET);
+	wait_rearmed();
+
+	zassert_equal(fake.processed, BUDGET, "Frames not processed");
+	zassert_equal(fake.poll_calls, 2, "Unexpected poll count %d",
+		      fake.poll_calls);
+	zassert_equal(fake.rearm_calls, 1, "Unexpected rearm count %d",
+		      fake.rearm_calls);
+}
+
+ZTEST(net_eth_poll, test_poll_rearm_race)
+{
+	fake.slipped = 3;
+
+	fake_rx_irq(2);
+	wait_rearmed();
+
+	zassert_equal(fake.processed, 5, "Slipped in frames not processed");
+	zassert_equal(fake.poll_calls, 2, "Unexpected poll count %d",
+		      fake.poll_calls);
+	zassert_equal(fake.rearm_calls, 2, "Unexpected rearm count %d",
+		      fake.rearm_calls);
+}
+
+ZTEST(net_eth_poll, test_poll_schedule_twice)
+{
+	/* Keep the poll work queue from running until both are scheduled */
+	k_sched_lock();
+	fake_rx_irq(1);
+	fake_rx_irq(1);
+	k_sched_unlock();
+
+	wait_rearmed();
+
+	zassert_equal(fake.processed, 2, "Frames not processed");
+	zassert_equal(fake.poll_calls, 1, "Poll scheduled twice");
+	zassert_equal(fake.rearm_calls, 1, "Unexpected rearm count %d",
+		      fake.rearm_calls);
+}
+
+static void eth_poll_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&fake, 0, sizeof(fake));
+	k_sem_init(&fake.rearmed, 0, 1);
+	net_eth_poll_init(&fake.poll, fake_poll, fake_rearm);
+}
+
+ZTEST_SUITE(net_eth_poll, NULL, NULL, eth_poll_before, NULL, NULL);
@@ -29,6 +29,9 @@ LOG_MODULE_REGISTER(net_ipv4_test, CONFIG_NET_IPV4_LOG_LEVEL);
 /* Packet size for tests, excluding headers */
 #define IPV4_TEST_PACKET_SIZE 2048
 
+/* Fragment payload size for the reassembly memory limit test */
+#define IPV4_FRAGMENT_MEM_TEST_SIZE 1024
+
 /* Wait times for semaphores and buffers */
 #define WAIT_TIME K_MSEC(1100)
 #define ALLOC_TIMEOUT K_MSEC(500)
@@ -196,6 +199,14 @@ static void reassembly_foreach_cb(struct net_ipv4_reassembly *reassembly, void *
 	++*packets;
 }
 
+/* Callback function for checking that a reassembly has been evicted */
+static void reassembly_evicted_cb(struct net_ipv4_reassembly *reassembly, void *data)
+{
+	uint16_t *evicted_id = (uint16_t *)data;
+
+	zassert_not_equal(reassembly->id, *evicted_id, "Expected oldest reassembly to be evicted");
+}
+
 /* Checks all IPv4 headers against expected values */
 static void check_ipv4_fragment_header(struct net_pkt *pkt, const uint8_t *orig_hdr, uint16_t id,
 				       uint16_t current_length, bool final)
@@ -803,6 +814,124 @@ ZTEST(net_ipv4_fragment, test_fragment_timeout)
 		      "Packet size mismatch");
 }
 
+/* Receive a UDP fragment of the given identification, offset and payload length */
+static void recv_ipv4_fragment(uint16_t id, uint16_t offset, uint16_t len, bool more)
+{
+	struct net_pkt *pkt;
+	uint16_t val;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, NET_IPV4H_LEN + len, NET_AF_INET,
+					NET_IPPROTO_UDP, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "Packet creation failure");
+
+	net_pkt_set_family(pkt, NET_AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv4_hdr));
+
+	net_pkt_cursor_init(pkt);
+	ret = net_pkt_write(pkt, ipv4_udp_frag, NET_IPV4H_LEN);
+	zassert_equal(ret, 0, "IPv4 header append failed");
+
+	ret = net_pkt_memset(pkt, 0, len);
+	zassert_equal(ret, 0, "IPv4 payload append failed");
+
+	NET_IPV4_HDR(pkt)->len = net_htons(NET_IPV4H_LEN + len);
+
+	val = net_htons(id);
+	memcpy(NET_IPV4_HDR(pkt)->id, &val, sizeof(val));
+
+	val = net_htons((more ? NET_IPV4_MORE_FRAG_MASK : 0) | (offset / 8));
+	memcpy(NET_IPV4_HDR(pkt)->offset, &val, sizeof(val));
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	NET_IPV4_HDR(pkt)->chksum = net_calc_chksum_ipv4(pkt);
+	net_pkt_set_overwrite(pkt, false);
+
+	net_pkt_set_iface(pkt, iface1);
+	ret = net_recv_data(net_pkt_iface(pkt), pkt);
+	zassert_equal(ret, 0, "Cannot receive data (%d)", ret);
+
+	k_sleep(K_MSEC(10));
+}
+
+/* Test that the oldest reassembly is dropped when all the slots are in use */
+ZTEST(net_ipv4_fragment, test_fragment_evict)
+{
+	uint16_t evicted_id;
+	uint8_t packets;
+	int i;
+
+	/* Use a different identification for each packet */
+	for (i = 0; i <= CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		recv_ipv4_fragment(0x1234 + i, 0, sizeof(ipv4_udp_frag) - NET_IPV4H_LEN, true);
+	}
+
+	/* The first packet has been dropped to make room for the last one */
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT,
+		      "Expected all reassembly slots to be in use");
+
+	evicted_id = 0x1234;
+	net_ipv4_frag_foreach(reassembly_evicted_cb, &evicted_id);
+
+	/* Let the remaining reassemblies time out */
+	k_sleep(K_MSEC(1100));
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, 0, "Expected fragments to be dropped after timeout");
+}
+
+/* Test that the oldest reassemblies are dropped when the fragments would use
+ * more memory than allowed.
+ */
+ZTEST(net_ipv4_fragment, test_fragment_max_mem)
+{
+	uint16_t evicted_id;
+	uint8_t packets;
+
+	/* Needs room for two fragments but not three, and a free slot for a third packet */
+	if (!IN_RANGE(CONFIG_NET_IPV4_FRAGMENT_MAX_MEM, 2 * IPV4_FRAGMENT_MEM_TEST_SIZE,
+		      3 * IPV4_FRAGMENT_MEM_TEST_SIZE - 1) ||
+	    CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT < 3) {
+		ztest_test_skip();
+	}
+
+	/* Two fragments fit, a third one of a new packet evicts the first
+	 * packet although a reassembly slot is still free.
+	 */
+	recv_ipv4_fragment(0x2234, 0, IPV4_FRAGMENT_MEM_TEST_SIZE, true);
+	recv_ipv4_fragment(0x2235, 0, IPV4_FRAGMENT_MEM_TEST_SIZE, true);
+	recv_ipv4_fragment(0x2236, 0, IPV4_FRAGMENT_MEM_TEST_SIZE, true);
+
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, 2, "Expected the oldest reassembly to be dropped");
+
+	evicted_id = 0x2234;
+	net_ipv4_frag_foreach(reassembly_evicted_cb, &evicted_id);
+
+	/* The next fragment of the last packet evicts the other packet */
+	recv_ipv4_fragment(0x2236, IPV4_FRAGMENT_MEM_TEST_SIZE, IPV4_FRAGMENT_MEM_TEST_SIZE,
+			   true);
+
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, 1, "Expected the other reassembly to be dropped");
+
+	evicted_id = 0x2235;
+	net_ipv4_frag_foreach(reassembly_evicted_cb, &evicted_id);
+
+	/* Nothing else can be evicted for a third fragment, so the packet is dropped */
+	recv_ipv4_fragment(0x2236, 2 * IPV4_FRAGMENT_MEM_TEST_SIZE, IPV4_FRAGMENT_MEM_TEST_SIZE,
+			   false);
+
+	packets = 0;
+	net_ipv4_frag_foreach(reassembly_foreach_cb, &packets);
+	zassert_equal(packets, 0, "Expected the reassembly over the limit to be dropped");
+}
+
 /* Test inserting large packet with do not fragment bit set */
 ZTEST(net_ipv4_fragment, test_do_not_fragment)
 {
@@ -2394,4 +2394,198 @@ ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment)
 	net_icmp_cleanup_ctx(&ctx);
 }
 
+/* Fragment payload size for the reassembly memory limit test */
+#define RECV_FRAGMENT_MEM_TEST_SIZE 1024
+
+/* Byte of the echo reply split in ipv6_reass_frag1 and ipv6_reass_frag2,
+ * at the given offset from the start of the fragmentable part.
+ */
+static uint8_t recv_payload_byte(uint16_t pos)
+{
+	if (pos < ECHO_REPLY_H_LEN) {
+		return ipv6_reass_frag1[NET_IPV6H_LEN + NET_IPV6_FRAGH_LEN + pos];
+	}
+
+	return (uint8_t)(pos - ECHO_REPLY_H_LEN);
+}
+
+/* Handle a fragment of that echo reply, with any identification, offset and length */
+static void recv_ipv6_fragment(uint32_t id, uint16_t offset, uint16_t len, bool more)
+{
+	struct net_ipv6_hdr ipv6_hdr;
+	struct net_pkt_cursor backup;
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, NET_IPV6H_LEN + NET_IPV6_FRAGH_LEN + len,
+					NET_AF_UNSPEC, 0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "packet");
+
+	net_pkt_set_family(pkt, NET_AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_cursor_init(pkt);
+
+	memcpy(&ipv6_hdr, ipv6_reass_frag1, sizeof(struct net_ipv6_hdr));
+	ipv6_hdr.len = net_htons(NET_IPV6_FRAGH_LEN + len);
+
+	ret = net_pkt_write(pkt, &ipv6_hdr, sizeof(struct net_ipv6_hdr));
+	zassert_true(ret == 0, "IPv6 header append failed");
+
+	ret = net_pkt_write_u8(pkt, NET_IPPROTO_ICMPV6);
+	zassert_true(ret == 0, "IPv6 fragment header append failed");
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	/* The offset is a multiple of 8, so it is already in place */
+	ret = net_pkt_write_u8(pkt, 0U);
+	ret |= net_pkt_write_be16(pkt, offset | (more ? 0x01 : 0x00));
+	ret |= net_pkt_write_be32(pkt, id);
+	zassert_true(ret == 0, "IPv6 fragment header append failed");
+
+	for (uint16_t i = 0; i < len; i++) {
+		ret = net_pkt_write_u8(pkt, recv_payload_byte(offset + i));
+		zassert_true(ret == 0, "IPv6 payload append failed");
+	}
+
+	net_pkt_set_ipv6_hdr_prev(pkt, offsetof(struct net_ipv6_hdr, nexthdr));
+	net_pkt_set_ipv6_fragment_start(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_overwrite(pkt, true);
+
+	net_pkt_cursor_restore(pkt, &backup);
+
+	ret = net_ipv6_handle_fragment_hdr(pkt, &ipv6_hdr, NET_IPV6_NEXTHDR_FRAG);
+	zassert_true(ret == NET_OK, "IPv6 fragment reassembly failed");
+}
+
+static void reassembly_foreach_cb(struct net_ipv6_reassembly *reass, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+static int reassembly_count(void)
+{
+	int count = 0;
+
+	net_ipv6_frag_foreach(reassembly_foreach_cb, &count);
+
+	return count;
+}
+
+static void reassembly_evicted_cb(struct net_ipv6_reassembly *reass, void *user_data)
+{
+	uint32_t *evicted_id = user_data;
+
+	zassert_not_equal(reass->id, *evicted_id, "Expected reassembly 0x%x to be evicted",
+			  *evicted_id);
+}
+
+ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment_out_of_order)
+{
+	uint16_t total_len = ECHO_REPLY_H_LEN + test_recv_payload_len;
+	struct net_icmp_ctx ctx;
+	int ret;
+
+	ret = net_icmp_init_ctx(&ctx, NET_AF_INET6, NET_ICMPV6_ECHO_REPLY,
+				0, handle_ipv6_echo_reply);
+	zassert_equal(ret, 0, "Cannot register %s handler (%d)",
+		      STRINGIFY(NET_ICMPV6_ECHO_REPLY), ret);
+
+	k_sem_reset(&wait_data);
+
+	/* The last fragment first, then the first and the middle ones */
+	recv_ipv6_fragment(0x1001, 1024, total_len - 1024, false);
+	recv_ipv6_fragment(0x1001, 0, 512, true);
+	zassert_equal(reassembly_count(), 1, "Expected a pending reassembly");
+	zassert_equal(k_sem_count_get(&wait_data), 0, "Reassembled with a hole");
+
+	recv_ipv6_fragment(0x1001, 512, 512, true);
+
+	if (k_sem_take(&wait_data, WAIT_TIME)) {
+		NET_DBG("Timeout while waiting interface data");
+		zassert_true(false, "Timeout");
+	}
+
+	zassert_equal(reassembly_count(), 0, "Expected the reassembly to be done");
+
+	net_icmp_cleanup_ctx(&ctx);
+}
+
+ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment_overlap)
+{
+	uint16_t total_len = ECHO_REPLY_H_LEN + test_recv_payload_len;
+
+	/* Overlapping the previous fragment drops the whole packet */
+	recv_ipv6_fragment(0x2001, 0, 512, true);
+	zassert_equal(reassembly_count(), 1, "Expected a pending reassembly");
+	recv_ipv6_fragment(0x2001, 504, 512, true);
+	zassert_equal(reassembly_count(), 0, "Overlapping fragment not dropped");
+
+	/* Overlapping the next fragment too */
+	recv_ipv6_fragment(0x2002, 512, 512, true);
+	recv_ipv6_fragment(0x2002, 0, 520, true);
+	zassert_equal(reassembly_count(), 0, "Overlapping fragment not dropped");
+
+	/* And so does a duplicate */
+	recv_ipv6_fragment(0x2003, 0, 512, true);
+	recv_ipv6_fragment(0x2003, 0, 512, true);
+	zassert_equal(reassembly_count(), 0, "Duplicated fragment not dropped");
+
+	/* Nothing can be past the last fragment */
+	recv_ipv6_fragment(0x2004, 1024, total_len - 1024, false);
+	recv_ipv6_fragment(0x2004, 1312, 8, true);
+	zassert_equal(reassembly_count(), 0, "Fragment past the last one not dropped");
+
+	/* Nor can the last fragment be before another one */
+	recv_ipv6_fragment(0x2005, 512, 512, true);
+	recv_ipv6_fragment(0x2005, 0, 8, false);
+	zassert_equal(reassembly_count(), 0, "Last fragment before another one not dropped");
+
+	/* There is only one last fragment */
+	recv_ipv6_fragment(0x2006, 1024, total_len - 1024, false);
+	recv_ipv6_fragment(0x2006, 0, 8, false);
+	zassert_equal(reassembly_count(), 0, "Second last fragment not dropped");
+}
+
+/* Test that the oldest reassemblies are dropped when the fragments would use
+ * more memory than allowed.
+ */
+ZTEST(net_ipv6_fragment, test_recv_ipv6_fragment_max_mem)
+{
+	uint32_t evicted_id;
+
+	/* Needs room for two fragments but not three, and a free slot for a third packet */
+	if (!IN_RANGE(CONFIG_NET_IPV6_FRAGMENT_MAX_MEM, 2 * RECV_FRAGMENT_MEM_TEST_SIZE,
+		      3 * RECV_FRAGMENT_MEM_TEST_SIZE - 1) ||
+	    CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT < 3) {
+		ztest_test_skip();
+	}
+
+	/* Two fragments fit, a third one of a new packet evicts the first
+	 * packet although a reassembly slot is still free.
+	 */
+	recv_ipv6_fragment(0x3001, 0, RECV_FRAGMENT_MEM_TEST_SIZE, true);
+	recv_ipv6_fragment(0x3002, 0, RECV_FRAGMENT_MEM_TEST_SIZE, true);
+	recv_ipv6_fragment(0x3003, 0, RECV_FRAGMENT_MEM_TEST_SIZE, true);
+	zassert_equal(reassembly_count(), 2, "Expected the oldest reassembly to be dropped");
+
+	evicted_id = 0x3001;
+	net_ipv6_frag_foreach(reassembly_evicted_cb, &evicted_id);
+
+	/* The next fragment of the last packet evicts the other packet */
+	recv_ipv6_fragment(0x3003, RECV_FRAGMENT_MEM_TEST_SIZE, RECV_FRAGMENT_MEM_TEST_SIZE,
+			   true);
+	zassert_equal(reassembly_count(), 1, "Expected the other reassembly to be dropped");
+
+	evicted_id = 0x3002;
+	net_ipv6_frag_foreach(reassembly_evicted_cb, &evicted_id);
+
+	/* Nothing else can be evicted for a third fragment, so the packet is dropped */
+	recv_ipv6_fragment(0x3003, 2 * RECV_FRAGMENT_MEM_TEST_SIZE, RECV_FRAGMENT_MEM_TEST_SIZE,
+			   false);
+	zassert_equal(reassembly_count(), 0,
+		      "Expected the reassembly over the limit to be dropped");
+}
+
 ZTEST_SUITE(net_ipv6_fragment, NULL, test_setup, NULL, NULL, NULL);
@@ -0,0 +1,376 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/capture.h>
+
+#define ETHERTYPE_OFFSET 12
+#define ETHERTYPE_IPV4 0x0800
+#define ETHERTYPE_ARP 0x0806
+
+static int capture_test_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static void capture_test_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static struct dummy_api capture_test_api = {
+	.iface_api.init = capture_test_iface_init,
+	.send = capture_test_send,
+};
+
+NET_DEVICE_INIT(capture_test, "capture_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &capture_test_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static struct net_if *test_iface;
+
+/* Build a packet of len bytes, data[i] = i + seed, split over several
+ * buffers so that loads may span buffer boundaries.
+ */
+static struct net_pkt *test_pkt(size_t len, uint8_t seed, uint16_t ethertype)
+{
+	struct net_pkt *pkt;
+	uint8_t data[200];
+
+	zassert_true(len <= sizeof(data) && len > ETHERTYPE_OFFSET + 1);
+
+	for (size_t i = 0; i < len; i++) {
+		data[i] = (uint8_t)(i + seed);
+	}
+
+	data[ETHERTYPE_OFFSET] = ethertype >> 8;
+	data[ETHERTYPE_OFFSET + 1] = ethertype & 0xff;
+
+	pkt = net_pkt_alloc_with_buffer(test_iface, len, NET_AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	zassert_ok(net_pkt_write(pkt, data, len));
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+/* "ether proto \\ip", snap the first 64 bytes */
+static const struct net_capture_bpf_insn ipv4_filter[] = {
+	NET_BPF_STMT(NET_BPF_LD | NET_BPF_H | NET_BPF_ABS, ETHERTYPE_OFFSET),
+	NET_BPF_JUMP(NET_BPF_JMP | NET_BPF_JEQ | NET_BPF_K, ETHERTYPE_IPV4, 0, 1),
+	NET_BPF_STMT(NET_BPF_RET | NET_BPF_K, 64),
+	NET_BPF_STMT(NET_BPF_RET | NET_BPF_K, 0),
+};
+
+ZTEST(net_capture_filter, test_check_valid)
+{
+	zassert_ok(net_capture_bpf_check(ipv4_filter, ARRAY_SIZE(ipv4_filter)));
+}
+
+ZTEST(net_capture_filter, test_check_no_return)
+{
+	const struct net_capture_bpf_insn prog[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_IMM, 1),
+	};
+
+	zassert_equal(net_capture_bpf_check(prog, ARRAY_SIZE(prog)), -EINVAL);
+	zassert_equal(net_capture_bpf_check(prog, 0), -EINVAL);
+	zassert_equal(net_capture_bpf_check(NULL, 1), -EINVAL);
+}
+
+ZTEST(net_capture_filter, test_check_backward_jump)
+{
+	/* Jump offsets are unsigned, a huge one wraps around to go back */
+	const struct net_capture_bpf_insn ja_back[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_IMM, 1),
+		NET_BPF_STMT(NET_BPF_JMP | NET_BPF_JA, UINT32_MAX),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+	/* Conditional jump past the end of the program */
+	const struct net_capture_bpf_insn jeq_out[] = {
+		NET_BPF_JUMP(NET_BPF_JMP | NET_BPF_JEQ | NET_BPF_K, 0, 2, 0),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_K, 0),
+	};
+
+	zassert_equal(net_capture_bpf_check(ja_back, ARRAY_SIZE(ja_back)), -EINVAL);
+	zassert_equal(net_capture_bpf_check(jeq_out, ARRAY_SIZE(jeq_out)), -EINVAL);
+}
+
+ZTEST(net_capture_filter, test_check_out_of_range)
+{
+	const struct net_capture_bpf_insn ld_mem[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_MEM, NET_BPF_MEMWORDS),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+	const struct net_capture_bpf_insn st_mem[] = {
+		NET_BPF_STMT(NET_BPF_ST, NET_BPF_MEMWORDS),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+	const struct net_capture_bpf_insn bad_size[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_B | NET_BPF_IMM, 1),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+
+	zassert_equal(net_capture_bpf_check(ld_mem, ARRAY_SIZE(ld_mem)), -EINVAL);
+	zassert_equal(net_capture_bpf_check(st_mem, ARRAY_SIZE(st_mem)), -EINVAL);
+	zassert_equal(net_capture_bpf_check(bad_size, ARRAY_SIZE(bad_size)), -EINVAL);
+}
+
+ZTEST(net_capture_filter, test_check_div_by_zero)
+{
+	const struct net_capture_bpf_insn div_k[] = {
+		NET_BPF_STMT(NET_BPF_ALU | NET_BPF_DIV | NET_BPF_K, 0),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+	const struct net_capture_bpf_insn mod_k[] = {
+		NET_BPF_STMT(NET_BPF_ALU | NET_BPF_MOD | NET_BPF_K, 0),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+
+	zassert_equal(net_capture_bpf_check(div_k, ARRAY_SIZE(div_k)), -EINVAL);
+	zassert_equal(net_capture_bpf_check(mod_k, ARRAY_SIZE(mod_k)), -EINVAL);
+}
+
+ZTEST(net_capture_filter, test_run_accept_reject)
+{
+	struct net_pkt *ipv4 = test_pkt(150, 0, ETHERTYPE_IPV4);
+	struct net_pkt *arp = test_pkt(42, 0, ETHERTYPE_ARP);
+
+	zassert_equal(net_capture_bpf_run(ipv4_filter, ARRAY_SIZE(ipv4_filter), ipv4), 64);
+	zassert_equal(net_capture_bpf_run(ipv4_filter, ARRAY_SIZE(ipv4_filter), arp), 0);
+
+	/* The cursor of the packet is left alone */
+	zassert_equal(net_pkt_get_current_offset(ipv4), 0);
+
+	net_pkt_unref(ipv4);
+	net_pkt_unref(arp);
+}
+
+ZTEST(net_capture_filter, test_run_load_across_buffers)
+{
+	/* Return the word at offset 126, which spans the first two buffers
+	 * with the default 128 byte data buffers.
+	 */
+	const struct net_capture_bpf_insn prog[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_W | NET_BPF_ABS, 126),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+	struct net_pkt *pkt = test_pkt(200, 0, ETHERTYPE_IPV4);
+
+	zassert_ok(net_capture_bpf_check(prog, ARRAY_SIZE(prog)));
+	zassert_equal(net_capture_bpf_run(prog, ARRAY_SIZE(prog), pkt),
+		      (126U << 24) | (127U << 16) | (128U << 8) | 129U);
+
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_capture_filter, test_run_out_of_bounds_load)
+{
+	const struct net_capture_bpf_insn abs[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_H | NET_BPF_ABS, 99),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_K, UINT32_MAX),
+	};
+	/* Indexed load with an offset that overflows */
+	const struct net_capture_bpf_insn ind[] = {
+		NET_BPF_STMT(NET_BPF_LDX | NET_BPF_W | NET_BPF_IMM, 2),
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_B | NET_BPF_IND, UINT32_MAX),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_K, UINT32_MAX),
+	};
+	struct net_pkt *pkt = test_pkt(100, 0, ETHERTYPE_IPV4);
+
+	zassert_ok(net_capture_bpf_check(abs, ARRAY_SIZE(abs)));
+	zassert_ok(net_capture_bpf_check(ind, ARRAY_SIZE(ind)));
+
+	zassert_equal(net_capture_bpf_run(abs, ARRAY_SIZE(abs), pkt), 0,
+		      "Load past the end accepted");
+	zassert_equal(net_capture_bpf_run(ind, ARRAY_SIZE(ind), pkt), 0,
+		      "Overflowing load accepted");
+
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_capture_filter, test_run_div_by_zero_x)
+{
+	/* Division by X can't be checked in advance, it rejects the packet */
+	const struct net_capture_bpf_insn prog[] = {
+		NET_BPF_STMT(NET_BPF_LD | NET_BPF_IMM, 10),
+		NET_BPF_STMT(NET_BPF_LDX | NET_BPF_W | NET_BPF_IMM, 0),
+		NET_BPF_STMT(NET_BPF_ALU | NET_BPF_DIV | NET_BPF_X, 0),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_K, UINT32_MAX),
+	};
+	struct net_pkt *pkt = test_pkt(60, 0, ETHERTYPE_IPV4);
+
+	zassert_ok(net_capture_bpf_check(prog, ARRAY_SIZE(prog)));
+	zassert_equal(net_capture_bpf_run(prog, ARRAY_SIZE(prog), pkt), 0);
+
+	net_pkt_unref(pkt);
+}
+
+/* Read exactly len bytes from the ring, across the wrap point if needed */
+static void ring_read(uint8_t *out, uint32_t len)
+{
+	while (len > 0U) {
+		uint8_t *data;
+		uint32_t claimed;
+
+		claimed = net_capture_ring_get_claim(&data, len);
+		zassert_true(claimed > 0U, "Ring is empty");
+
+		memcpy(out, data, claimed);
+		zassert_ok(net_capture_ring_get_finish(claimed));
+
+		out += claimed;
+		len -= claimed;
+	}
+}
+
+static void ring_check_record(uint32_t incl_len, uint32_t orig_len, uint8_t seed)
+{
+	struct net_capture_pcap_rec_hdr rec;
+	uint8_t data[200];
+
+	ring_read((uint8_t *)&rec, sizeof(rec));
+	zassert_equal(rec.incl_len, incl_len, "Unexpected incl_len %u", rec.incl_len);
+	zassert_equal(rec.orig_len, orig_len, "Unexpected orig_len %u", rec.orig_len);
+
+	ring_read(data, rec.incl_len);
+
+	for (uint32_t i = 0; i < rec.incl_len; i++) {
+		if (i == ETHERTYPE_OFFSET || i == ETHERTYPE_OFFSET + 1) {
+			continue;
+		}
+
+		zassert_equal(data[i], (uint8_t)(i + seed), "Data mismatch at %u", i);
+	}
+}
+
+static void ring_capture(size_t len, uint8_t seed, uint16_t ethertype)
+{
+	struct net_pkt *pkt = test_pkt(len, seed, ethertype);
+
+	net_capture_ring_pkt(test_iface, pkt);
+	net_pkt_unref(pkt);
+}
+
+static void ring_assert_empty(void)
+{
+	uint8_t *data;
+
+	zassert_equal(net_capture_ring_get_claim(&data, 1), 0, "Ring not empty");
+}
+
+ZTEST(net_capture_ring, test_ring_snaplen)
+{
+	struct net_capture_pcap_hdr hdr;
+
+	zassert_ok(net_capture_ring_start(test_iface, NULL, 0, 48));
+
+	net_capture_ring_pcap_header(&hdr);
+	zassert_equal(hdr.snaplen, 48);
+	zassert_equal(hdr.magic, 0xa1b2c3d4);
+	zassert_equal(hdr.linktype, 101);
+
+	ring_capture(100, 1, ETHERTYPE_IPV4);
+	ring_capture(20, 2, ETHERTYPE_IPV4);
+
+	ring_check_record(48, 100, 1);
+	ring_check_record(20, 20, 2);
+	ring_assert_empty();
+}
+
+ZTEST(net_capture_ring, test_ring_filter)
+{
+	/* The filter snaps 64 bytes, the smaller snap length wins */
+	zassert_ok(net_capture_ring_start(test_iface, ipv4_filter, ARRAY_SIZE(ipv4_filter),
+					  32));
+
+	ring_capture(100, 3, ETHERTYPE_ARP);
+	ring_capture(100, 4, ETHERTYPE_IPV4);
+
+	ring_check_record(32, 100, 4);
+	ring_assert_empty();
+}
+
+ZTEST(net_capture_ring, test_ring_wraparound)
+{
+	/* 16 byte header + 64 bytes of data, so three records fit in the
+	 * 256 byte ring but a fourth one does not.
+	 */
+	zassert_ok(net_capture_ring_start(test_iface, NULL, 0, 64));
+
+	ring_capture(100, 10, ETHERTYPE_IPV4);
+	ring_capture(100, 11, ETHERTYPE_IPV4);
+	ring_capture(100, 12, ETHERTYPE_IPV4);
+	ring_capture(100, 13, ETHERTYPE_IPV4);
+	zassert_equal(net_capture_ring_dropped(), 1, "Full ring did not drop");
+
+	ring_check_record(64, 100, 10);
+	ring_check_record(64, 100, 11);
+
+	/* These are split at the end of the ring */
+	ring_capture(100, 14, ETHERTYPE_IPV4);
+	ring_capture(100, 15, ETHERTYPE_IPV4);
+	zassert_equal(net_capture_ring_dropped(), 1, "Record dropped after wrapping");
+
+	ring_check_record(64, 100, 12);
+	ring_check_record(64, 100, 14);
+	ring_check_record(64, 100, 15);
+	ring_assert_empty();
+}
+
+ZTEST(net_capture_ring, test_ring_stopped)
+{
+	zassert_ok(net_capture_ring_start(test_iface, NULL, 0, 64));
+	zassert_equal(net_capture_ring_start(test_iface, NULL, 0, 64), -EALREADY);
+	zassert_ok(net_capture_ring_stop());
+
+	ring_capture(100, 20, ETHERTYPE_IPV4);
+	ring_assert_empty();
+
+	zassert_equal(net_capture_ring_stop(), -EALREADY);
+}
+
+ZTEST(net_capture_ring, test_ring_invalid_filter)
+{
+	const struct net_capture_bpf_insn prog[] = {
+		NET_BPF_STMT(NET_BPF_ALU | NET_BPF_DIV | NET_BPF_K, 0),
+		NET_BPF_STMT(NET_BPF_RET | NET_BPF_A, 0),
+	};
+
+	zassert_equal(net_capture_ring_start(test_iface, prog, ARRAY_SIZE(prog), 64),
+		      -EINVAL);
+	zassert_equal(net_capture_ring_start(test_iface, NULL, 0, 0), -EINVAL);
+}
+
+static void *capture_setup(void)
+{
+	test_iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(test_iface, "No test interface");
+
+	return NULL;
+}
+
+static void ring_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)net_capture_ring_stop();
+}
+
+ZTEST_SUITE(net_capture_filter, NULL, capture_setup, NULL, NULL, NULL);
+ZTEST_SUITE(net_capture_ring, NULL, capture_setup, NULL, ring_after, NULL);
@@ -456,6 +456,89 @@ static ssize_t z_impl_zsock_recvfrom_custom_fake_observe(int sock, void *buf, si
 	return ret;
 }
 
+#define BLOCKS_BLOCK_LEN  64
+#define BLOCKS_LAST_LEN   20
+#define BLOCKS_NUM        5
+#define BLOCKS_TOTAL_LEN  ((BLOCKS_NUM - 1) * BLOCKS_BLOCK_LEN + BLOCKS_LAST_LEN)
+
+struct block_request {
+	uint16_t id;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint32_t num;
+};
+
+static struct block_request block_requests[8];
+static int block_requests_count;
+static int block_requests_max;
+static size_t blocks_received;
+
+static ssize_t z_impl_zsock_sendto_custom_fake_blocks(int sock, void *buf, size_t len, int flags,
+						      const struct net_sockaddr *dest_addr,
+						      net_socklen_t addrlen)
+{
+	struct coap_packet request = {0};
+	struct block_request *req;
+	int block2;
+
+	zassert_ok(coap_packet_parse(&request, buf, len, NULL, 0));
+	zassert_true(block_requests_count < ARRAY_SIZE(block_requests));
+
+	block2 = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+
+	req = &block_requests[block_requests_count++];
+	req->id = coap_header_get_id(&request);
+	coap_header_get_token(&request, req->token);
+	req->num = block2 < 0 ? 0 : GET_BLOCK_NUM(block2);
+
+	if (req->num == 0 && IS_ENABLED(CONFIG_COAP_CLIENT_BLOCK_PIPELINING)) {
+		zassert_equal(coap_get_option_int(&request, COAP_OPTION_SIZE2), 0,
+			      "Size2 not requested");
+	}
+
+	block_requests_max = MAX(block_requests_max, block_requests_count);
+	LOG_INF("Request for block %u, %d outstanding", req->num, block_requests_count);
+
+	set_socket_events(sock, ZSOCK_POLLIN);
+
+	return len;
+}
+
+/* Answer the most recent block request first, so pipelined blocks arrive out of order */
+static ssize_t z_impl_zsock_recvfrom_custom_fake_blocks(int sock, void *buf, size_t max_len,
+							int flags, struct net_sockaddr *src_addr,
+							net_socklen_t *addrlen)
+{
+	struct coap_packet response;
+	struct block_request *req;
+	uint8_t payload[BLOCKS_BLOCK_LEN];
+	bool more;
+
+	zassert_true(block_requests_count > 0);
+	req = &block_requests[--block_requests_count];
+	more = req->num < BLOCKS_NUM - 1;
+
+	memset(payload, 'a' + req->num, sizeof(payload));
+
+	zassert_ok(coap_packet_init(&response, buf, max_len, COAP_VERSION_1, COAP_TYPE_ACK,
+				    COAP_TOKEN_MAX_LEN, req->token, COAP_RESPONSE_CODE_CONTENT,
+				    req->id));
+	zassert_ok(coap_append_option_int(&response, COAP_OPTION_BLOCK2,
+					  (req->num << 4) | (more << 3) | COAP_BLOCK_64));
+	if (req->num == 0) {
+		zassert_ok(coap_append_option_int(&response, COAP_OPTION_SIZE2,
+						  BLOCKS_TOTAL_LEN));
+	}
+	zassert_ok(coap_packet_append_payload_marker(&response));
+	zassert_ok(coap_packet_append_payload(&response, payload,
+					      more ? BLOCKS_BLOCK_LEN : BLOCKS_LAST_LEN));
+
+	if (block_requests_count == 0) {
+		clear_socket_events(sock, ZSOCK_POLLIN);
+	}
+
+	return response.offset;
+}
+
 void coap_callback(const struct coap_client_response_data *data, void *user_data)
 {
 	LOG_INF("CoAP response callback, %d", data->result_code);
@@ -465,6 +548,21 @@ void coap_callback(const struct coap_client_response_data *data, void *user_data
 	}
 }
 
+static void coap_callback_blocks(const struct coap_client_response_data *data, void *user_data)
+{
+	last_response_code = data->result_code;
+
+	zassert_equal(data->offset, blocks_received, "Unexpected offset %zu", data->offset);
+	for (size_t i = 0; i < data->payload_len; i++) {
+		zassert_equal(data->payload[i], 'a' + (data->offset + i) / BLOCKS_BLOCK_LEN);
+	}
+	blocks_received += data->payload_len;
+
+	if (data->last_block) {
+		k_sem_give((struct k_sem *)user_data);
+	}
+}
+
 extern void net_coap_init(void);
 
 static void *suite_setup(void)
@@ -505,6 +603,9 @@ static void test_setup(void *data)
 
 	memset(&client.requests, 0, sizeof(client.requests));
 	memset(last_token, 0, sizeof(last_token));
+	block_requests_count = 0;
+	block_requests_max = 0;
+	blocks_received = 0;
 	last_response_code = 0;
 	k_sem_reset(&sem1);
 	k_sem_reset(&sem2);
@@ -940,3 +1041,28 @@ ZTEST(coap_client, test_non_confirmable)
 	/* No callbacks from non-confirmable */
 	zassert_not_ok(k_sem_take(&sem1, K_MSEC(MORE_THAN_EXCHANGE_LIFETIME_MS)));
 }
+
+ZTEST(coap_client, test_block2_download)
+{
+	struct coap_client_request req = {
+		.method = COAP_METHOD_GET,
+		.confirmable = true,
+		.path = TEST_PATH,
+		.cb = coap_callback_blocks,
+		.user_data = &sem1,
+	};
+	int expected_max = IS_ENABLED(CONFIG_COAP_CLIENT_BLOCK_PIPELINING) ?
+			   MIN(CONFIG_COAP_CLIENT_BLOCK_WINDOW, BLOCKS_NUM - 1) : 1;
+
+	z_impl_zsock_sendto_fake.custom_fake = z_impl_zsock_sendto_custom_fake_blocks;
+	z_impl_zsock_recvfrom_fake.custom_fake = z_impl_zsock_recvfrom_custom_fake_blocks;
+
+	zassert_ok(coap_client_req(&client, 0, &dst_address, &req, NULL));
+	zassert_ok(k_sem_take(&sem1, K_MSEC(MORE_THAN_EXCHANGE_LIFETIME_MS)));
+
+	zassert_equal(last_response_code, COAP_RESPONSE_CODE_CONTENT, "Unexpected response");
+	zassert_equal(blocks_received, BLOCKS_TOTAL_LEN, "Unexpected length %zu", blocks_received);
+	zassert_equal(block_requests_max, expected_max, "Unexpected window %d",
+		      block_requests_max);
+	zassert_equal(z_impl_zsock_sendto_fake.call_count, BLOCKS_NUM);
+}
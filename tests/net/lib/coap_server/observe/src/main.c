@@ -0,0 +1,309 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/coap_service.h>
+#include <zephyr/net/socket.h>
+
+#define SERVER_PORT 5683
+#define CLIENT_COUNT 3
+#define MSG_BUF_SIZE 64
+#define NOTIFY_PAYLOAD "42"
+
+static const uint16_t test_service_port = SERVER_PORT;
+COAP_SERVICE_DEFINE(test_service, "127.0.0.1", &test_service_port, COAP_SERVICE_AUTOSTART);
+
+static int obs_get(struct coap_resource *resource, struct coap_packet *request,
+		   struct net_sockaddr *addr, net_socklen_t addr_len)
+{
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet response;
+	int ret;
+
+	ret = coap_resource_parse_observe(resource, request, addr);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = coap_ack_init(&response, request, buf, sizeof(buf), COAP_RESPONSE_CODE_CONTENT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return coap_resource_send(resource, &response, addr, addr_len, NULL);
+}
+
+static const char * const obs_path[] = { "obs", NULL };
+COAP_RESOURCE_DEFINE(obs_resource, test_service, {
+	.path = obs_path,
+	.get = obs_get,
+});
+
+static int clients[CLIENT_COUNT];
+static struct net_sockaddr_in client_addrs[CLIENT_COUNT];
+static uint8_t client_tokens[CLIENT_COUNT][COAP_TOKEN_MAX_LEN];
+
+static const struct net_sockaddr_in server_addr = {
+	.sin_family = NET_AF_INET,
+	.sin_port = net_htons(SERVER_PORT),
+	.sin_addr = { { { 127, 0, 0, 1 } } },
+};
+
+static int client_open(struct net_sockaddr_in *addr)
+{
+	struct zsock_timeval tv = { .tv_usec = 200 * USEC_PER_MSEC };
+	net_socklen_t addr_len = sizeof(*addr);
+	int sock;
+
+	sock = zsock_socket(NET_AF_INET, NET_SOCK_DGRAM, NET_IPPROTO_UDP);
+	zassert_true(sock >= 0, "Failed to create client socket (%d)", errno);
+
+	zassert_ok(zsock_connect(sock, (struct net_sockaddr *)&server_addr,
+				 sizeof(server_addr)),
+		   "Failed to connect client socket (%d)", errno);
+	zassert_ok(zsock_setsockopt(sock, ZSOCK_SOL_SOCKET, ZSOCK_SO_RCVTIMEO, &tv,
+				    sizeof(tv)),
+		   "Failed to set receive timeout (%d)", errno);
+	zassert_ok(zsock_getsockname(sock, (struct net_sockaddr *)addr, &addr_len),
+		   "Failed to get client address (%d)", errno);
+
+	return sock;
+}
+
+/* Receive one CoAP message, returns false on timeout */
+static bool client_recv(int sock, struct coap_packet *cpkt, uint8_t *buf, size_t len)
+{
+	ssize_t received;
+
+	received = zsock_recv(sock, buf, len, 0);
+	if (received < 0) {
+		zassert_equal(errno, EAGAIN, "Failed to receive (%d)", errno);
+		return false;
+	}
+
+	zassert_ok(coap_packet_parse(cpkt, buf, received, NULL, 0), "Invalid CoAP message");
+
+	return true;
+}
+
+static void client_send_ack(int sock, uint16_t id)
+{
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet ack;
+
+	zassert_ok(coap_packet_init(&ack, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_ACK, 0,
+				    NULL, COAP_CODE_EMPTY, id));
+	zassert_equal(zsock_send(sock, ack.data, ack.offset, 0), ack.offset,
+		      "Failed to send ACK (%d)", errno);
+}
+
+static void client_observe(int idx)
+{
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet request, response;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+
+	memcpy(client_tokens[idx], coap_next_token(), COAP_TOKEN_MAX_LEN);
+
+	zassert_ok(coap_packet_init(&request, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_CON,
+				    COAP_TOKEN_MAX_LEN, client_tokens[idx], COAP_METHOD_GET,
+				    coap_next_id()));
+	zassert_ok(coap_append_option_int(&request, COAP_OPTION_OBSERVE, 0));
+	zassert_ok(coap_packet_append_option(&request, COAP_OPTION_URI_PATH, "obs",
+					     strlen("obs")));
+
+	zassert_equal(zsock_send(clients[idx], request.data, request.offset, 0), request.offset,
+		      "Failed to send request (%d)", errno);
+
+	zassert_true(client_recv(clients[idx], &response, buf, sizeof(buf)), "No response");
+	zassert_equal(coap_header_get_type(&response), COAP_TYPE_ACK);
+	zassert_equal(coap_header_get_code(&response), COAP_RESPONSE_CODE_CONTENT);
+	zassert_equal(coap_header_get_token(&response, token), COAP_TOKEN_MAX_LEN);
+	zassert_mem_equal(token, client_tokens[idx], COAP_TOKEN_MAX_LEN);
+}
+
+static void build_notification(struct coap_packet *cpkt, uint8_t *buf, size_t len,
+			       uint8_t type)
+{
+	zassert_ok(coap_packet_init(cpkt, buf, len, COAP_VERSION_1, type, 0, NULL,
+				    COAP_RESPONSE_CODE_CONTENT, 0));
+	zassert_ok(coap_append_option_int(cpkt, COAP_OPTION_OBSERVE, ++obs_resource.age));
+	zassert_ok(coap_packet_append_payload_marker(cpkt));
+	zassert_ok(coap_packet_append_payload(cpkt, (const uint8_t *)NOTIFY_PAYLOAD,
+					      strlen(NOTIFY_PAYLOAD)));
+}
+
+/* Check the notification received by every client, returns the message IDs */
+static void check_notifications(uint8_t type, uint16_t *ids)
+{
+	for (int i = 0; i < CLIENT_COUNT; i++) {
+		uint8_t buf[MSG_BUF_SIZE];
+		uint8_t token[COAP_TOKEN_MAX_LEN];
+		struct coap_packet cpkt;
+		const uint8_t *payload;
+		uint16_t payload_len;
+
+		zassert_true(client_recv(clients[i], &cpkt, buf, sizeof(buf)),
+			     "Client %d not notified", i);
+		zassert_equal(coap_header_get_type(&cpkt), type);
+		zassert_equal(coap_header_get_code(&cpkt), COAP_RESPONSE_CODE_CONTENT);
+		zassert_equal(coap_header_get_token(&cpkt, token), COAP_TOKEN_MAX_LEN);
+		zassert_mem_equal(token, client_tokens[i], COAP_TOKEN_MAX_LEN,
+				  "Client %d got another observer's token", i);
+		zassert_true(coap_get_option_int(&cpkt, COAP_OPTION_OBSERVE) > 0);
+
+		payload = coap_packet_get_payload(&cpkt, &payload_len);
+		zassert_equal(payload_len, strlen(NOTIFY_PAYLOAD));
+		zassert_mem_equal(payload, NOTIFY_PAYLOAD, payload_len);
+
+		ids[i] = coap_header_get_id(&cpkt);
+		for (int j = 0; j < i; j++) {
+			zassert_not_equal(ids[i], ids[j], "Message ID reused");
+		}
+	}
+}
+
+ZTEST(coap_server_observe, test_notify_non)
+{
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet cpkt;
+	uint16_t ids[CLIENT_COUNT];
+	int ret;
+
+	build_notification(&cpkt, buf, sizeof(buf), COAP_TYPE_NON_CON);
+
+	ret = coap_resource_send_observers(&obs_resource, &cpkt, NULL);
+	zassert_equal(ret, CLIENT_COUNT, "Notified %d observers", ret);
+
+	check_notifications(COAP_TYPE_NON_CON, ids);
+}
+
+ZTEST(coap_server_observe, test_notify_con)
+{
+	const struct coap_transmission_parameters params = {
+		.ack_timeout = 100,
+		.coap_backoff_percent = 200,
+		.max_retransmission = 2,
+	};
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet cpkt;
+	uint16_t ids[CLIENT_COUNT];
+	int ret;
+
+	build_notification(&cpkt, buf, sizeof(buf), COAP_TYPE_CON);
+
+	ret = coap_resource_send_observers(&obs_resource, &cpkt, &params);
+	zassert_equal(ret, CLIENT_COUNT, "Notified %d observers", ret);
+
+	check_notifications(COAP_TYPE_CON, ids);
+
+	for (int i = 0; i < CLIENT_COUNT; i++) {
+		client_send_ack(clients[i], ids[i]);
+	}
+
+	/* Acknowledged notifications must not be retransmitted */
+	k_sleep(K_MSEC(2 * params.ack_timeout));
+
+	for (int i = 0; i < CLIENT_COUNT; i++) {
+		uint8_t rx_buf[MSG_BUF_SIZE];
+		struct coap_packet rx;
+
+		zassert_false(client_recv(clients[i], &rx, rx_buf, sizeof(rx_buf)),
+			      "Client %d got a retransmission", i);
+	}
+}
+
+static uint16_t send_con(int idx, uint32_t ack_timeout)
+{
+	const struct coap_transmission_parameters params = {
+		.ack_timeout = ack_timeout,
+		.coap_backoff_percent = 200,
+		.max_retransmission = 3,
+	};
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet cpkt;
+	uint16_t id = coap_next_id();
+
+	zassert_ok(coap_packet_init(&cpkt, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_CON,
+				    COAP_TOKEN_MAX_LEN, client_tokens[idx],
+				    COAP_RESPONSE_CODE_CONTENT, id));
+	zassert_ok(coap_resource_send(&obs_resource, &cpkt,
+				      (struct net_sockaddr *)&client_addrs[idx],
+				      sizeof(client_addrs[idx]), &params));
+
+	return id;
+}
+
+ZTEST(coap_server_observe, test_retransmit_order)
+{
+	/* Retransmissions are expected at:
+	 *   slow: 400 ms
+	 *   fast: 100 ms, 300 ms, 700 ms
+	 * so the pending message queued last must be retransmitted first.
+	 */
+	uint16_t slow = send_con(0, 400);
+	uint16_t fast = send_con(0, 100);
+	const uint16_t expected[] = { slow, fast, fast, fast, slow };
+	uint8_t buf[MSG_BUF_SIZE];
+	struct coap_packet cpkt;
+
+	for (int i = 0; i < ARRAY_SIZE(expected); i++) {
+		int64_t timeout = k_uptime_get() + 500;
+
+		/* The receive timeout is shorter than the retransmission intervals */
+		while (!client_recv(clients[0], &cpkt, buf, sizeof(buf))) {
+			zassert_true(k_uptime_get() < timeout, "Message %d not received", i);
+		}
+
+		zassert_equal(coap_header_get_id(&cpkt), expected[i],
+			      "Message %d has ID %u, expected %u", i,
+			      coap_header_get_id(&cpkt), expected[i]);
+	}
+
+	client_send_ack(clients[0], slow);
+	client_send_ack(clients[0], fast);
+
+	/* Both pending messages are released, otherwise they would be
+	 * retransmitted again at 700 ms and 1200 ms.
+	 */
+	k_sleep(K_MSEC(800));
+
+	zassert_false(client_recv(clients[0], &cpkt, buf, sizeof(buf)),
+		      "Retransmitted after ACK");
+}
+
+static void *coap_server_observe_setup(void)
+{
+	/* Let the server thread start the service */
+	for (int i = 0; i < 10 && coap_service_is_running(&test_service) != 1; i++) {
+		k_sleep(K_MSEC(50));
+	}
+
+	zassert_equal(coap_service_is_running(&test_service), 1, "Service not running");
+
+	for (int i = 0; i < CLIENT_COUNT; i++) {
+		clients[i] = client_open(&client_addrs[i]);
+		client_observe(i);
+	}
+
+	return NULL;
+}
+
+static void coap_server_observe_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (int i = 0; i < CLIENT_COUNT; i++) {
+		zsock_close(clients[i]);
+	}
+}
+
+ZTEST_SUITE(coap_server_observe, NULL, coap_server_observe_setup, NULL, NULL,
+	    coap_server_observe_teardown);
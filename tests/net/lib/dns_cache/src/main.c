@@ -267,3 +267,128 @@ ZTEST(net_dns_cache_test, test_remove_null_parameters)
 	zassert_equal(-EINVAL, dns_cache_remove(&test_dns_cache, NULL),
 		      "NULL query should return error.");
 }
+
+ZTEST(net_dns_cache_test, test_case_insensitive)
+{
+	struct dns_addrinfo info_write = {.ai_family = NET_AF_INET};
+	struct dns_addrinfo info_read = {0};
+
+	zassert_ok(dns_cache_add(&test_dns_cache, "Example.COM", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "example.com", DNS_QUERY_TYPE_A,
+					&info_read, 1));
+	zassert_ok(dns_cache_remove(&test_dns_cache, "EXAMPLE.com"),
+		   "Cache entry removal should work.");
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "example.com", DNS_QUERY_TYPE_A,
+					&info_read, 1));
+}
+
+ZTEST(net_dns_cache_test, test_negative_entry)
+{
+	struct dns_addrinfo info_write = {.ai_family = NET_AF_INET};
+	struct dns_addrinfo info_read = {0};
+	const char *query = "example.com";
+
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_ok(dns_cache_add_negative(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA,
+					  TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Negative entry adding should work.");
+
+	/* Only the AAAA records are known not to exist */
+	zassert_equal(-ENODATA, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA,
+					       &info_read, 1));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+					&info_read, 1));
+
+	/* The negative entry replaces the cached addresses */
+	zassert_ok(dns_cache_add_negative(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+					  TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Negative entry adding should work.");
+	zassert_equal(-ENODATA, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+					       &info_read, 1));
+
+	/* And new addresses replace the negative entry */
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(1, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_A,
+					&info_read, 1));
+
+	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 + 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, query, DNS_QUERY_TYPE_AAAA,
+					&info_read, 1));
+	zassert_equal(-EINVAL, dns_cache_add_negative(&test_dns_cache, query,
+						      DNS_QUERY_TYPE_A, 0));
+}
+
+ZTEST(net_dns_cache_test, test_cname_chain)
+{
+	struct dns_addrinfo info_write = {.ai_family = NET_AF_INET};
+	struct dns_addrinfo info_read[2] = {0};
+
+	zassert_ok(dns_cache_add_cname(&test_dns_cache, "www.example.com", "cdn.example.net",
+				       TEST_DNS_CACHE_DEFAULT_TTL * 2),
+		   "CNAME entry adding should work.");
+	zassert_ok(dns_cache_add_cname(&test_dns_cache, "cdn.example.net", "edge.example.org",
+				       TEST_DNS_CACHE_DEFAULT_TTL * 2),
+		   "CNAME entry adding should work.");
+	zassert_ok(dns_cache_add_cname(&test_dns_cache, "img.example.com", "edge.example.org",
+				       TEST_DNS_CACHE_DEFAULT_TTL * 2),
+		   "CNAME entry adding should work.");
+
+	/* No addresses for the canonical name yet */
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "www.example.com", DNS_QUERY_TYPE_A,
+					info_read, 2));
+
+	zassert_ok(dns_cache_add(&test_dns_cache, "edge.example.org", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "www.example.com", DNS_QUERY_TYPE_A,
+					info_read, 2));
+	zassert_equal(NET_AF_INET, info_read[0].ai_family);
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "img.example.com", DNS_QUERY_TYPE_A,
+					info_read, 2));
+
+	/* A CNAME is never returned as an address */
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "www.example.com", DNS_QUERY_TYPE_AAAA,
+					info_read, 2));
+
+	/* The chain breaks when the addresses expire */
+	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 + 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "www.example.com", DNS_QUERY_TYPE_A,
+					info_read, 2));
+}
+
+ZTEST(net_dns_cache_test, test_prefetch)
+{
+	struct dns_addrinfo info_write = {.ai_family = NET_AF_INET};
+	struct dns_addrinfo info_read[2] = {0};
+	const char *query = "example.com";
+	bool refresh;
+
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(1, dns_cache_lookup(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 2,
+					  &refresh));
+	zassert_false(refresh, "Fresh entry should not be refreshed");
+
+	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 *
+		       (100 - CONFIG_DNS_RESOLVER_CACHE_PREFETCH_PERCENT) / 100 + 1));
+
+	zassert_equal(1, dns_cache_lookup(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 2,
+					  &refresh));
+	zassert_true(refresh, "Entry close to expiry should be refreshed");
+
+	/* Only one caller refreshes the entry */
+	zassert_equal(1, dns_cache_lookup(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 2,
+					  &refresh));
+	zassert_false(refresh, "Entry should be refreshed only once");
+
+	/* The answer to the refresh replaces the old entry */
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(1, dns_cache_lookup(&test_dns_cache, query, DNS_QUERY_TYPE_A, info_read, 2,
+					  &refresh));
+	zassert_false(refresh, "Refreshed entry should not be refreshed again");
+}
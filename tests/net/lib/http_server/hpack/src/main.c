@@ -494,4 +494,177 @@ ZTEST(http2_hpack, test_http2_hpack_literal_not_indexed_decode)
 				 ARRAY_SIZE(test_enc_literal_not_indexed_headers));
 }
 
+struct example_block {
+	const struct example_headers *headers;
+	size_t count;
+	uint32_t max_size;
+};
+
+static const struct example_headers test_enc_dynamic_block1[] = {
+	{ ":status", "200", { 0x88 }, 1 },
+	{ "content-type", "application/json",
+	  { 0x5f, 0x8b, 0x1d, 0x75, 0xd0, 0x62, 0x0d, 0x26,
+	    0x3d, 0x4c, 0x74, 0x41, 0xea },
+	  13 },
+	{ "server", "Zephyr",
+	  { 0x76, 0x85, 0xfd, 0x2d, 0x73, 0xfa, 0xb3 },
+	  7 },
+	/* Not indexed, changes with every response. */
+	{ "content-length", "42", { 0x1f, 0x0d, 0x02, 0x34, 0x32 }, 5 },
+};
+
+static const struct example_headers test_enc_dynamic_block2[] = {
+	{ ":status", "200", { 0x88 }, 1 },
+	{ "content-type", "application/json", { 0xbf }, 1 },
+	{ "server", "Zephyr", { 0xbe }, 1 },
+	{ "content-length", "128", { 0x1f, 0x0d, 0x82, 0x08, 0x9e }, 5 },
+};
+
+/* Dynamic table disabled by the peer, size update and no indexing. */
+static const struct example_headers test_enc_dynamic_block3[] = {
+	{ "content-type", "application/json",
+	  { 0x20, 0x1f, 0x10, 0x8b, 0x1d, 0x75, 0xd0, 0x62,
+	    0x0d, 0x26, 0x3d, 0x4c, 0x74, 0x41, 0xea },
+	  15 },
+};
+
+/* Dynamic table enabled again, limited to the configured size. */
+static const struct example_headers test_enc_dynamic_block4[] = {
+	{ "content-type", "application/json",
+	  { 0x3f, 0xe1, 0x01, 0x5f, 0x8b, 0x1d, 0x75, 0xd0,
+	    0x62, 0x0d, 0x26, 0x3d, 0x4c, 0x74, 0x41, 0xea },
+	  16 },
+	{ "content-type", "application/json", { 0xbe }, 1 },
+};
+
+static const struct example_block test_enc_dynamic_blocks[] = {
+	{ test_enc_dynamic_block1, ARRAY_SIZE(test_enc_dynamic_block1), 4096 },
+	{ test_enc_dynamic_block2, ARRAY_SIZE(test_enc_dynamic_block2), 4096 },
+	{ test_enc_dynamic_block3, ARRAY_SIZE(test_enc_dynamic_block3), 0 },
+	{ test_enc_dynamic_block4, ARRAY_SIZE(test_enc_dynamic_block4), 4096 },
+};
+
+static int test_hpack_encode(struct http_hpack_encoder *encoder,
+			     const struct example_headers *example)
+{
+	struct http_hpack_header_buf hdr = {
+		.name = example->name,
+		.value = example->value,
+		.name_len = strlen(example->name),
+		.value_len = strlen(example->value)
+	};
+
+	return http_hpack_encoder_encode_header(encoder, test_buf, sizeof(test_buf), &hdr);
+}
+
+ZTEST(http2_hpack, test_http2_hpack_dynamic_encode)
+{
+	static struct http_hpack_encoder encoder;
+
+	http_hpack_encoder_init(&encoder);
+
+	ARRAY_FOR_EACH(test_enc_dynamic_blocks, i) {
+		const struct example_block *block = &test_enc_dynamic_blocks[i];
+
+		http_hpack_encoder_set_max_size(&encoder, block->max_size);
+
+		for (int j = 0; j < block->count; j++) {
+			int ret;
+
+			ret = test_hpack_encode(&encoder, &block->headers[j]);
+			zassert_equal(ret, block->headers[j].encoded_len,
+				      "Wrong encoding length");
+			zassert_mem_equal(test_buf, block->headers[j].encoded, ret,
+					  "Header wrongly encoded");
+		}
+	}
+}
+
+/* Typical REST API responses, as sent one after another on a connection. */
+static const struct example_headers test_bench_response1[] = {
+	{ ":status", "200" },
+	{ "content-type", "application/json" },
+	{ "content-length", "187" },
+	{ "cache-control", "no-store" },
+	{ "server", "Zephyr" },
+	{ "access-control-allow-origin", "*" },
+};
+
+static const struct example_headers test_bench_response2[] = {
+	{ ":status", "201" },
+	{ "content-type", "application/json" },
+	{ "content-length", "32" },
+	{ "location", "/api/v1/sensors/17" },
+	{ "server", "Zephyr" },
+	{ "access-control-allow-origin", "*" },
+};
+
+static const struct example_headers test_bench_response3[] = {
+	{ ":status", "204" },
+	{ "server", "Zephyr" },
+	{ "access-control-allow-origin", "*" },
+};
+
+static const struct example_headers test_bench_response4[] = {
+	{ ":status", "404" },
+	{ "content-type", "application/problem+json" },
+	{ "content-length", "64" },
+	{ "server", "Zephyr" },
+	{ "access-control-allow-origin", "*" },
+};
+
+static const struct example_block test_bench_responses[] = {
+	{ test_bench_response1, ARRAY_SIZE(test_bench_response1) },
+	{ test_bench_response2, ARRAY_SIZE(test_bench_response2) },
+	{ test_bench_response1, ARRAY_SIZE(test_bench_response1) },
+	{ test_bench_response3, ARRAY_SIZE(test_bench_response3) },
+	{ test_bench_response1, ARRAY_SIZE(test_bench_response1) },
+	{ test_bench_response4, ARRAY_SIZE(test_bench_response4) },
+};
+
+#define BENCH_CONNECTIONS 50
+
+static size_t test_hpack_bench(struct http_hpack_encoder *encoder, const char *name)
+{
+	size_t responses = BENCH_CONNECTIONS * ARRAY_SIZE(test_bench_responses);
+	uint64_t cycles = 0;
+	size_t bytes = 0;
+
+	for (int i = 0; i < BENCH_CONNECTIONS; i++) {
+		if (encoder != NULL) {
+			http_hpack_encoder_init(encoder);
+		}
+
+		ARRAY_FOR_EACH(test_bench_responses, j) {
+			const struct example_block *block = &test_bench_responses[j];
+			uint32_t start = k_cycle_get_32();
+
+			for (int k = 0; k < block->count; k++) {
+				int ret;
+
+				ret = test_hpack_encode(encoder, &block->headers[k]);
+				zassert_true(ret > 0, "Failed to encode header (%d)", ret);
+				bytes += ret;
+			}
+
+			cycles += k_cycle_get_32() - start;
+		}
+	}
+
+	TC_PRINT("%s: %zu header bytes, %llu ns per response\n", name, bytes / responses,
+		 k_cyc_to_ns_floor64(cycles) / responses);
+
+	return bytes;
+}
+
+ZTEST(http2_hpack, test_http2_hpack_encode_benchmark)
+{
+	static struct http_hpack_encoder encoder;
+
+	size_t static_bytes = test_hpack_bench(NULL, "static table");
+	size_t dynamic_bytes = test_hpack_bench(&encoder, "dynamic table");
+
+	zassert_true(dynamic_bytes < static_bytes, "Dynamic table does not save any bytes");
+}
+
 ZTEST_SUITE(http2_hpack, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,516 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "server_internal.h"
+
+#include <string.h>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/net/http/service.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#define BUFFER_SIZE                    1024
+#define SERVER_IPV4_ADDR               "127.0.0.1"
+#define SERVER_PORT                    8080
+#define TIMEOUT_S                      1
+
+#define TEST_STREAM_ID_1               1
+
+#define TEST_PARTITION		storage_partition
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(TEST_PARTITION)
+
+#define LFS_MNTP		"/littlefs"
+#define TEST_DIR		"/files"
+#define TEST_DIR_PATH		LFS_MNTP TEST_DIR
+
+#define TEST_FILE_A		TEST_DIR "/a.html"
+#define TEST_FILE_B		TEST_DIR "/b.html"
+#define TEST_FILE_C		TEST_DIR "/c.html"
+#define TEST_FILE_BIG		TEST_DIR "/big.html"
+
+#define TEST_PAYLOAD		"Hello, World from static file!"
+#define TEST_PAYLOAD_UPDATED	"Bye bye, World from the file!!"
+
+/* The files are rewritten in place with the same size, which the cache
+ * does not notice until it reads the file again.
+ */
+BUILD_ASSERT(sizeof(TEST_PAYLOAD) == sizeof(TEST_PAYLOAD_UPDATED));
+
+/* HTTP2 frames, see tests/net/lib/http_server/core for how they were
+ * composed.
+ */
+#define TEST_HTTP2_MAGIC \
+	0x50, 0x52, 0x49, 0x20, 0x2a, 0x20, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x32, \
+	0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a
+#define TEST_HTTP2_SETTINGS_INITIAL_WINDOW(_size) \
+	0x00, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00,	0x00, \
+	0x00, 0x04, 0x00, 0x00, 0x00, (_size)
+#define TEST_HTTP2_SETTINGS_ACK \
+	0x00, 0x00, 0x00, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00
+#define TEST_HTTP2_WINDOW_UPDATE(_stream_id, _increment) \
+	0x00, 0x00, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, (_stream_id), \
+	0x00, 0x00, 0x00, (_increment)
+/* HEADERS frame with END_STREAM and END_HEADERS flags, :method GET and
+ * :scheme http from the static table, followed by a literal :path of
+ * (_path_len) bytes.
+ */
+#define TEST_HTTP2_HEADERS_GET_PATH(_stream_id, _path_len) \
+	0x00, 0x00, (_path_len) + 4, 0x01, 0x05, 0x00, 0x00, 0x00, (_stream_id), \
+	0x82, 0x86, 0x04, (_path_len)
+
+static uint16_t test_http_service_port = SERVER_PORT;
+HTTP_SERVICE_DEFINE(test_http_service, SERVER_IPV4_ADDR,
+		    &test_http_service_port, 1, 10, NULL, NULL, NULL);
+
+static struct http_resource_detail_static_fs static_fs_resource_detail = {
+	.common = {
+			.type = HTTP_RESOURCE_TYPE_STATIC_FS,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+			.content_type = "text/html",
+		},
+	.fs_path = LFS_MNTP,
+};
+
+HTTP_RESOURCE_DEFINE(static_fs_resource, test_http_service, TEST_DIR "/*",
+		     &static_fs_resource_detail);
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+
+static struct fs_mount_t littlefs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)TEST_PARTITION_ID,
+	.mnt_point = LFS_MNTP,
+};
+
+static int client_fd = -1;
+static uint8_t buf[BUFFER_SIZE];
+
+/* Larger than the file the cache can hold once the heap bookkeeping is
+ * taken into account, but smaller than the configured cache size.
+ */
+static char big_payload[CONFIG_HTTP_SERVER_STATIC_FS_CACHE_SIZE - 1];
+
+static void test_write_file(const char *path, const char *data, size_t len)
+{
+	char fname[32];
+	struct fs_file_t file;
+	ssize_t written;
+	int ret;
+
+	snprintk(fname, sizeof(fname), LFS_MNTP "%s", path);
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, fname, FS_O_CREATE | FS_O_WRITE);
+	zassert_ok(ret, "Failed to open %s (%d)", fname, ret);
+
+	/* Overwrite the content in place, keeping the size of the file */
+	ret = fs_seek(&file, 0, FS_SEEK_SET);
+	zassert_ok(ret, "Failed to seek %s (%d)", fname, ret);
+
+	written = fs_write(&file, data, len);
+	zassert_equal(written, len, "Failed to write %s (%zd)", fname, written);
+
+	ret = fs_close(&file);
+	zassert_ok(ret, "Failed to close %s (%d)", fname, ret);
+}
+
+static void test_connect(void)
+{
+	struct net_sockaddr_in sa;
+	struct timeval optval = {
+		.tv_sec = TIMEOUT_S,
+		.tv_usec = 0,
+	};
+	int ret;
+
+	ret = zsock_socket(NET_AF_INET, NET_SOCK_STREAM, NET_IPPROTO_TCP);
+	zassert_true(ret >= 0, "Failed to create client socket (%d)", errno);
+	client_fd = ret;
+
+	ret = zsock_setsockopt(client_fd, ZSOCK_SOL_SOCKET, ZSOCK_SO_RCVTIMEO, &optval,
+			       sizeof(optval));
+	zassert_ok(ret, "Failed to set timeout (%d)", errno);
+
+	sa.sin_family = NET_AF_INET;
+	sa.sin_port = net_htons(SERVER_PORT);
+
+	ret = zsock_inet_pton(NET_AF_INET, SERVER_IPV4_ADDR, &sa.sin_addr.s_addr);
+	zassert_equal(ret, 1, "inet_pton() failed to convert %s", SERVER_IPV4_ADDR);
+
+	ret = zsock_connect(client_fd, (struct net_sockaddr *)&sa, sizeof(sa));
+	zassert_ok(ret, "Failed to connect (%d)", errno);
+}
+
+static void test_disconnect(void)
+{
+	if (client_fd >= 0) {
+		(void)zsock_close(client_fd);
+		client_fd = -1;
+	}
+}
+
+static void test_send(const void *data, size_t len)
+{
+	int ret;
+
+	ret = zsock_send(client_fd, data, len, 0);
+	zassert_equal(ret, len, "send() failed (%d)", errno);
+}
+
+/* This function ensures that there's at least as much data as requested in
+ * the buffer.
+ */
+static void test_read_data(size_t *offset, size_t need)
+{
+	int ret;
+
+	while (*offset < need) {
+		ret = zsock_recv(client_fd, buf + *offset, sizeof(buf) - *offset, 0);
+		zassert_not_equal(ret, -1, "recv() failed (%d)", errno);
+		*offset += ret;
+		if (ret == 0) {
+			break;
+		}
+	};
+
+	zassert_true(*offset >= need, "Not all requested data received");
+}
+
+/* This function moves the remaining data in the buffer to the beginning. */
+static void test_consume_data(size_t *offset, size_t consume)
+{
+	zassert_true(*offset >= consume, "Cannot consume more data than received");
+	*offset -= consume;
+	memmove(buf, buf + consume, *offset);
+}
+
+/* Send an HTTP/1.0 request, the server closes the connection once the
+ * response is sent. Returns the response body, the response is kept in
+ * the buffer as a string.
+ */
+static const char *test_http1_get(const char *path, const char *headers, size_t *body_len)
+{
+	char request[192];
+	size_t offset = 0;
+	const char *body;
+	int len;
+	int ret;
+
+	len = snprintk(request, sizeof(request), "GET %s HTTP/1.0\r\n%s\r\n", path, headers);
+	zassert_true(len < sizeof(request), "Request too long");
+
+	test_connect();
+	test_send(request, len);
+
+	do {
+		ret = zsock_recv(client_fd, buf + offset, sizeof(buf) - 1 - offset, 0);
+		zassert_not_equal(ret, -1, "recv() failed (%d)", errno);
+		offset += ret;
+	} while (ret > 0 && offset < sizeof(buf) - 1);
+
+	test_disconnect();
+
+	buf[offset] = '\0';
+
+	body = strstr((const char *)buf, "\r\n\r\n");
+	zassert_not_null(body, "No end of headers in the response");
+	body += 4;
+
+	*body_len = offset - (body - (const char *)buf);
+
+	return body;
+}
+
+static void expect_status(const char *status_line)
+{
+	zassert_mem_equal(buf, status_line, strlen(status_line),
+			  "Unexpected response status: %.*s", 32, (const char *)buf);
+}
+
+static void expect_header(const char *header)
+{
+	zassert_not_null(strstr((const char *)buf, header), "No %s header in the response",
+			 header);
+}
+
+static void expect_file(const char *path, const char *payload, size_t payload_len)
+{
+	const char *body;
+	size_t body_len;
+
+	body = test_http1_get(path, "", &body_len);
+
+	expect_status("HTTP/1.1 200 OK\r\n");
+	zassert_true(body_len >= payload_len, "Response body too short");
+	zassert_mem_equal(body, payload, payload_len, "Unexpected content of %s", path);
+}
+
+static void get_etag(char *etag, size_t etag_len)
+{
+	const char *pos;
+
+	pos = strstr((const char *)buf, "ETag: ");
+	zassert_not_null(pos, "No ETag in the response");
+	pos += sizeof("ETag: ") - 1;
+
+	zassert_true(etag_len > HTTP_SERVER_ETAG_LEN, "ETag buffer too small");
+	memcpy(etag, pos, HTTP_SERVER_ETAG_LEN);
+	etag[HTTP_SERVER_ETAG_LEN] = '\0';
+}
+
+ZTEST(server_static_fs_cache_tests, test_etag)
+{
+	char etag[HTTP_SERVER_ETAG_LEN + 1];
+	char headers[128];
+	const char *body;
+	size_t body_len;
+
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+
+	expect_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	expect_header("Accept-Ranges: bytes\r\n");
+	get_etag(etag, sizeof(etag));
+	zassert_not_equal(strcmp(etag, "\"00000000\""), 0, "Unlucky ETag");
+
+	/* The ETag of the file is not the first one of the list, and a comma
+	 * within the other entity tags does not split them.
+	 */
+	snprintk(headers, sizeof(headers), "If-None-Match: \"abc,def\", W/%s\r\n", etag);
+	body = test_http1_get(TEST_FILE_A, headers, &body_len);
+	expect_status("HTTP/1.1 304 Not Modified\r\n");
+	expect_header(etag);
+	zassert_equal(body_len, 0, "Unexpected body in the response");
+
+	body = test_http1_get(TEST_FILE_A, "If-None-Match: \"abc,def\", \"00000000\"\r\n",
+			      &body_len);
+	expect_status("HTTP/1.1 200 OK\r\n");
+	zassert_mem_equal(body, TEST_PAYLOAD, strlen(TEST_PAYLOAD), "Unexpected content");
+
+	body = test_http1_get(TEST_FILE_A, "If-None-Match: *\r\n", &body_len);
+	expect_status("HTTP/1.1 304 Not Modified\r\n");
+	zassert_equal(body_len, 0, "Unexpected body in the response");
+}
+
+ZTEST(server_static_fs_cache_tests, test_range)
+{
+	const char *body;
+	size_t body_len;
+
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+
+	body = test_http1_get(TEST_FILE_A, "Range: bytes=0-4\r\n", &body_len);
+	expect_status("HTTP/1.1 206 Partial Content\r\n");
+	expect_header("Content-Length: 5\r\n");
+	expect_header("Content-Range: bytes 0-4/30\r\n");
+	zassert_equal(body_len, 5, "Unexpected body length %zu", body_len);
+	zassert_mem_equal(body, TEST_PAYLOAD, 5, "Unexpected content");
+
+	body = test_http1_get(TEST_FILE_A, "Range: bytes=-6\r\n", &body_len);
+	expect_status("HTTP/1.1 206 Partial Content\r\n");
+	expect_header("Content-Range: bytes 24-29/30\r\n");
+	zassert_equal(body_len, 6, "Unexpected body length %zu", body_len);
+	zassert_mem_equal(body, TEST_PAYLOAD + 24, 6, "Unexpected content");
+
+	body = test_http1_get(TEST_FILE_A, "Range: bytes=25-100\r\n", &body_len);
+	expect_status("HTTP/1.1 206 Partial Content\r\n");
+	expect_header("Content-Range: bytes 25-29/30\r\n");
+	zassert_equal(body_len, 5, "Unexpected body length %zu", body_len);
+	zassert_mem_equal(body, TEST_PAYLOAD + 25, 5, "Unexpected content");
+
+	body = test_http1_get(TEST_FILE_A, "Range: bytes=100-\r\n", &body_len);
+	expect_status("HTTP/1.1 416 Range Not Satisfiable\r\n");
+	expect_header("Content-Range: bytes */30\r\n");
+	zassert_equal(body_len, 0, "Unexpected body in the response");
+}
+
+ZTEST(server_static_fs_cache_tests, test_eviction)
+{
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	test_write_file(TEST_FILE_B, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	test_write_file(TEST_FILE_C, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+
+	expect_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	expect_file(TEST_FILE_B, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+
+	/* Both files are served from the cache */
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD_UPDATED, strlen(TEST_PAYLOAD_UPDATED));
+	test_write_file(TEST_FILE_B, TEST_PAYLOAD_UPDATED, strlen(TEST_PAYLOAD_UPDATED));
+	expect_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+
+	/* The least recently used file makes room for the new one */
+	expect_file(TEST_FILE_C, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	expect_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	expect_file(TEST_FILE_B, TEST_PAYLOAD_UPDATED, strlen(TEST_PAYLOAD_UPDATED));
+
+	/* The cache does not notice in place updates until flushed */
+	http_server_static_fs_cache_flush();
+	expect_file(TEST_FILE_A, TEST_PAYLOAD_UPDATED, strlen(TEST_PAYLOAD_UPDATED));
+}
+
+ZTEST(server_static_fs_cache_tests, test_file_too_large)
+{
+	memset(big_payload, 'x', sizeof(big_payload));
+
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	test_write_file(TEST_FILE_BIG, big_payload, sizeof(big_payload));
+
+	expect_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD_UPDATED, strlen(TEST_PAYLOAD_UPDATED));
+
+	/* The file does not fit in the cache even once it is emptied, so it
+	 * is served from the file system without evicting the other files.
+	 */
+	expect_file(TEST_FILE_BIG, big_payload, sizeof(big_payload));
+	expect_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+}
+
+static void test_get_frame_header(size_t *offset, struct http2_frame *frame)
+{
+	test_read_data(offset, HTTP2_FRAME_HEADER_SIZE);
+
+	frame->length = sys_get_be24(&buf[HTTP2_FRAME_LENGTH_OFFSET]);
+	frame->type = buf[HTTP2_FRAME_TYPE_OFFSET];
+	frame->flags = buf[HTTP2_FRAME_FLAGS_OFFSET];
+	frame->stream_identifier = sys_get_be32(
+				&buf[HTTP2_FRAME_STREAM_ID_OFFSET]);
+	frame->stream_identifier &= HTTP2_FRAME_STREAM_ID_MASK;
+
+	test_consume_data(offset, HTTP2_FRAME_HEADER_SIZE);
+}
+
+static void expect_http2_frame(size_t *offset, uint8_t type, uint8_t flags)
+{
+	struct http2_frame frame;
+
+	test_get_frame_header(offset, &frame);
+
+	zassert_equal(frame.type, type, "Expected frame type %u, got %u", type, frame.type);
+	zassert_equal(frame.flags, flags, "Unexpected flags received");
+
+	test_read_data(offset, frame.length);
+	test_consume_data(offset, frame.length);
+}
+
+static void expect_http2_data_frame(size_t *offset, int stream_id,
+				    const char *payload, size_t payload_len,
+				    uint8_t flags)
+{
+	struct http2_frame frame;
+
+	test_get_frame_header(offset, &frame);
+
+	zassert_equal(frame.type, HTTP2_DATA_FRAME, "Expected data frame, got frame type %u",
+		      frame.type);
+	zassert_equal(frame.stream_identifier, stream_id, "Invalid data frame stream ID");
+	zassert_equal(frame.flags, flags, "Unexpected flags received");
+	zassert_equal(frame.length, payload_len, "Unexpected data frame length");
+
+	test_read_data(offset, frame.length);
+	zassert_mem_equal(buf, payload, payload_len, "Unexpected data payload");
+	test_consume_data(offset, frame.length);
+}
+
+static void expect_no_data(size_t offset)
+{
+	int ret;
+
+	zassert_equal(offset, 0, "Unexpected data received");
+
+	k_msleep(100);
+
+	ret = zsock_recv(client_fd, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Unexpected data received");
+	zassert_equal(errno, EAGAIN, "recv() failed (%d)", errno);
+}
+
+ZTEST(server_static_fs_cache_tests, test_http2_send_window)
+{
+	static const uint8_t preface[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS_INITIAL_WINDOW(8),
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_PATH(TEST_STREAM_ID_1, sizeof(TEST_FILE_A) - 1),
+		/* The path follows */
+	};
+	static const uint8_t connection_window_update[] = {
+		TEST_HTTP2_WINDOW_UPDATE(0, 100),
+	};
+	static const uint8_t stream_window_update[] = {
+		TEST_HTTP2_WINDOW_UPDATE(TEST_STREAM_ID_1, 100),
+	};
+	size_t offset = 0;
+
+	test_write_file(TEST_FILE_A, TEST_PAYLOAD, strlen(TEST_PAYLOAD));
+
+	test_connect();
+	test_send(preface, sizeof(preface));
+	test_send(TEST_FILE_A, sizeof(TEST_FILE_A) - 1);
+
+	/* Server settings, then the ACK of the client settings */
+	expect_http2_frame(&offset, HTTP2_SETTINGS_FRAME, 0);
+	expect_http2_frame(&offset, HTTP2_SETTINGS_FRAME, HTTP2_FLAG_SETTINGS_ACK);
+	expect_http2_frame(&offset, HTTP2_HEADERS_FRAME, HTTP2_FLAG_END_HEADERS);
+
+	/* Only as much of the cached file as the stream window allows is sent */
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_1, TEST_PAYLOAD, 8, 0);
+	expect_no_data(offset);
+
+	/* Opening the connection window does not open the stream window */
+	test_send(connection_window_update, sizeof(connection_window_update));
+	expect_no_data(offset);
+
+	test_send(stream_window_update, sizeof(stream_window_update));
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_1, TEST_PAYLOAD + 8,
+				strlen(TEST_PAYLOAD) - 8, HTTP2_FLAG_END_STREAM);
+}
+
+static void server_static_fs_cache_tests_before(void *fixture)
+{
+	const struct flash_area *fap;
+	int ret;
+
+	ARG_UNUSED(fixture);
+
+	ret = flash_area_open(TEST_PARTITION_ID, &fap);
+	zassert_ok(ret, "Opening flash area for erase [%d]", ret);
+
+	ret = flash_area_flatten(fap, 0, fap->fa_size);
+	zassert_ok(ret, "Erasing flash area [%d]", ret);
+
+	ret = fs_unmount(&littlefs_mnt);
+	zassert_true(ret == 0 || ret == -EINVAL, "Failed to unmount fs [%d]", ret);
+
+	ret = fs_mount(&littlefs_mnt);
+	zassert_ok(ret, "Failed to mount fs [%d]", ret);
+
+	ret = fs_mkdir(TEST_DIR_PATH);
+	zassert_ok(ret, "Failed to create dir [%d]", ret);
+
+	/* Start from an empty cache */
+	http_server_static_fs_cache_flush();
+
+	ret = http_server_start();
+	zassert_ok(ret, "Failed to start the server [%d]", ret);
+}
+
+static void server_static_fs_cache_tests_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	test_disconnect();
+
+	(void)http_server_stop();
+
+	k_yield();
+}
+
+ZTEST_SUITE(server_static_fs_cache_tests, NULL, NULL, server_static_fs_cache_tests_before,
+	    server_static_fs_cache_tests_after, NULL);
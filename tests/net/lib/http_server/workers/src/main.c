@@ -0,0 +1,630 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "server_internal.h"
+
+#include <string.h>
+
+#include <zephyr/net/http/service.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/ztest.h>
+
+#define BUFFER_SIZE                    1024
+#define SERVER_IPV4_ADDR               "127.0.0.1"
+#define SERVER_PORT                    8080
+#define TIMEOUT_S                      1
+
+#define TEST_STREAM_ID_1               3
+#define TEST_STREAM_ID_2               5
+
+#define TEST_DYNAMIC_GET_PAYLOAD "Test dynamic GET"
+#define TEST_STATIC_PAYLOAD "Hello, World!"
+
+/* Random base64 encoded data, sent in several DATA frames */
+static const char long_payload[] =
+	"Z3479c2x8gXgzvDpvt4YuQePsvmsur1J1U+lLKzkyGCQgtWEysRjnO63iZvN/Zaag5YlliAkcaWi"
+	"Alb8zI4SxK+JB3kfpkcAA6c8m2PfkP6D5+Vrcy9O6ituR8gb0tm8o9CwTeUhf8H6q2kB5BO1ZZxm"
+	"G9c3VO9BLLTC8LMG8isyzB1wT+EB8YTv4YaNc9mXJmXNt3pycZ4Thg20rPfhZsvleIeUYZZQJArx"
+	"ufSBYR4v6mAEm/qdFqIwe9k6dtJEfR5guFoAWbR4jMrJreshyvByrZSy+aP1S93Fvob9hNn6ouSc"
+	"a0UIx0JKhFKvnM23kcavlMzwD+MerSiPUDYKSjtnjhhZmW3GonTpUWMEuDGZNkbrAZ3fbuWRbHi0";
+
+/* HTTP2 frames, see tests/net/lib/http_server/core for how they were
+ * composed.
+ */
+#define TEST_HTTP2_MAGIC \
+	0x50, 0x52, 0x49, 0x20, 0x2a, 0x20, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x32, \
+	0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a
+#define TEST_HTTP2_SETTINGS \
+	0x00, 0x00, 0x0c, 0x04, 0x00, 0x00, 0x00, 0x00,	0x00, \
+	0x00, 0x03, 0x00, 0x00, 0x00, 0x64, 0x00, 0x04, 0x00, 0x00, 0xff, 0xff
+#define TEST_HTTP2_SETTINGS_INITIAL_WINDOW(_size) \
+	0x00, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00,	0x00, \
+	0x00, 0x04, 0x00, 0x00, 0x00, (_size)
+#define TEST_HTTP2_SETTINGS_ACK \
+	0x00, 0x00, 0x00, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00
+#define TEST_HTTP2_WINDOW_UPDATE(_stream_id, _increment) \
+	0x00, 0x00, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, (_stream_id), \
+	0x00, 0x00, 0x00, (_increment)
+#define TEST_HTTP2_WINDOW_UPDATE_MAX(_stream_id) \
+	0x00, 0x00, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, (_stream_id), \
+	0x7f, 0xff, 0xff, 0xff
+#define TEST_HTTP2_HEADERS_GET_ROOT(_stream_id) \
+	0x00, 0x00, 0x21, 0x01, 0x05, 0x00, 0x00, 0x00, (_stream_id), \
+	0x82, 0x84, 0x86, 0x41, 0x8a, 0x0b, 0xe2, 0x5c, 0x0b, 0x89, 0x70, 0xdc, \
+	0x78, 0x0f, 0x03, 0x53, 0x03, 0x2a, 0x2f, 0x2a, 0x90, 0x7a, 0x8a, 0xaa, \
+	0x69, 0xd2, 0x9a, 0xc4, 0xc0, 0x57, 0x68, 0x0b, 0x83
+#define TEST_HTTP2_HEADERS_GET_DYNAMIC_STREAM_1 \
+	0x00, 0x00, 0x2b, 0x01, 0x05, 0x00, 0x00, 0x00, TEST_STREAM_ID_1, \
+	0x82, 0x86, 0x41, 0x87, 0x0b, 0xe2, 0x5c, 0x0b, 0x89, 0x70, 0xff, 0x04, \
+	0x86, 0x62, 0x4f, 0x55, 0x0e, 0x93, 0x13, 0x7a, 0x88, 0x25, 0xb6, 0x50, \
+	0xc3, 0xcb, 0xbc, 0xb8, 0x3f, 0x53, 0x03, 0x2a, 0x2f, 0x2a, 0x5f, 0x87, \
+	0x49, 0x7c, 0xa5, 0x8a, 0xe8, 0x19, 0xaa
+
+static uint16_t test_http_service_port = SERVER_PORT;
+HTTP_SERVICE_DEFINE(test_http_service, SERVER_IPV4_ADDR,
+		    &test_http_service_port, 2, 10, NULL, NULL, NULL);
+
+static const char static_resource_payload[] = TEST_STATIC_PAYLOAD;
+struct http_resource_detail_static static_resource_detail = {
+	.common = {
+			.type = HTTP_RESOURCE_TYPE_STATIC,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		},
+	.static_data = static_resource_payload,
+	.static_data_len = sizeof(static_resource_payload) - 1,
+};
+
+HTTP_RESOURCE_DEFINE(static_resource, test_http_service, "/",
+		     &static_resource_detail);
+
+static K_SEM_DEFINE(dynamic_entered, 0, 1);
+static K_SEM_DEFINE(dynamic_release, 0, 1);
+static const char *dynamic_payload;
+static bool dynamic_block;
+static bool dynamic_in_worker;
+
+static int dynamic_cb(struct http_client_ctx *client, enum http_transaction_status status,
+		      const struct http_request_ctx *request_ctx,
+		      struct http_response_ctx *response_ctx, void *user_data)
+{
+	if (status == HTTP_SERVER_TRANSACTION_ABORTED ||
+	    status == HTTP_SERVER_TRANSACTION_COMPLETE) {
+		return 0;
+	}
+
+	dynamic_in_worker = strcmp(k_thread_name_get(k_current_get()), "http_worker") == 0;
+
+	if (dynamic_block) {
+		k_sem_give(&dynamic_entered);
+		(void)k_sem_take(&dynamic_release, K_SECONDS(2 * TIMEOUT_S));
+	}
+
+	response_ctx->body = dynamic_payload;
+	response_ctx->body_len = strlen(dynamic_payload);
+	response_ctx->final_chunk = true;
+
+	return 0;
+}
+
+struct http_resource_detail_dynamic dynamic_detail = {
+	.common = {
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		.content_type = "text/plain",
+	},
+	.cb = dynamic_cb,
+	.user_data = NULL,
+};
+
+HTTP_RESOURCE_DEFINE(dynamic_resource, test_http_service, "/dynamic",
+		     &dynamic_detail);
+
+static int client_fd = -1;
+static uint8_t buf[BUFFER_SIZE];
+
+static int test_connect(void)
+{
+	struct net_sockaddr_in sa;
+	struct timeval optval = {
+		.tv_sec = TIMEOUT_S,
+		.tv_usec = 0,
+	};
+	int ret;
+	int fd;
+
+	fd = zsock_socket(NET_AF_INET, NET_SOCK_STREAM, NET_IPPROTO_TCP);
+	zassert_true(fd >= 0, "Failed to create client socket (%d)", errno);
+
+	ret = zsock_setsockopt(fd, ZSOCK_SOL_SOCKET, ZSOCK_SO_RCVTIMEO, &optval,
+			       sizeof(optval));
+	zassert_ok(ret, "Failed to set timeout (%d)", errno);
+
+	sa.sin_family = NET_AF_INET;
+	sa.sin_port = net_htons(SERVER_PORT);
+
+	ret = zsock_inet_pton(NET_AF_INET, SERVER_IPV4_ADDR, &sa.sin_addr.s_addr);
+	zassert_equal(ret, 1, "inet_pton() failed to convert %s", SERVER_IPV4_ADDR);
+
+	ret = zsock_connect(fd, (struct net_sockaddr *)&sa, sizeof(sa));
+	zassert_ok(ret, "Failed to connect (%d)", errno);
+
+	return fd;
+}
+
+static void test_send(const void *data, size_t len)
+{
+	int ret;
+
+	ret = zsock_send(client_fd, data, len, 0);
+	zassert_equal(ret, len, "send() failed (%d)", errno);
+}
+
+/* This function ensures that there's at least as much data as requested in
+ * the buffer.
+ */
+static void test_read_data(size_t *offset, size_t need)
+{
+	int ret;
+
+	while (*offset < need) {
+		ret = zsock_recv(client_fd, buf + *offset, sizeof(buf) - *offset, 0);
+		zassert_not_equal(ret, -1, "recv() failed (%d)", errno);
+		*offset += ret;
+		if (ret == 0) {
+			break;
+		}
+	};
+
+	zassert_true(*offset >= need, "Not all requested data received");
+}
+
+/* This function moves the remaining data in the buffer to the beginning. */
+static void test_consume_data(size_t *offset, size_t consume)
+{
+	zassert_true(*offset >= consume, "Cannot consume more data than received");
+	*offset -= consume;
+	memmove(buf, buf + consume, *offset);
+}
+
+static void test_get_frame_header(size_t *offset, struct http2_frame *frame)
+{
+	test_read_data(offset, HTTP2_FRAME_HEADER_SIZE);
+
+	frame->length = sys_get_be24(&buf[HTTP2_FRAME_LENGTH_OFFSET]);
+	frame->type = buf[HTTP2_FRAME_TYPE_OFFSET];
+	frame->flags = buf[HTTP2_FRAME_FLAGS_OFFSET];
+	frame->stream_identifier = sys_get_be32(
+				&buf[HTTP2_FRAME_STREAM_ID_OFFSET]);
+	frame->stream_identifier &= HTTP2_FRAME_STREAM_ID_MASK;
+
+	test_consume_data(offset, HTTP2_FRAME_HEADER_SIZE);
+}
+
+static void expect_http2_settings_frames(size_t *offset)
+{
+	struct http2_frame frame;
+
+	/* Server settings, then the ACK of the client settings */
+	test_get_frame_header(offset, &frame);
+	zassert_equal(frame.type, HTTP2_SETTINGS_FRAME, "Expected settings frame");
+	zassert_equal(frame.flags, 0, "Expected no settings flags");
+	test_read_data(offset, frame.length);
+	test_consume_data(offset, frame.length);
+
+	test_get_frame_header(offset, &frame);
+	zassert_equal(frame.type, HTTP2_SETTINGS_FRAME, "Expected settings frame");
+	zassert_equal(frame.flags, HTTP2_FLAG_SETTINGS_ACK, "Expected settings ACK flag");
+	zassert_equal(frame.length, 0, "Invalid settings frame length");
+}
+
+static void expect_http2_headers_frame(size_t *offset, int stream_id)
+{
+	struct http2_frame frame;
+
+	test_get_frame_header(offset, &frame);
+
+	zassert_equal(frame.type, HTTP2_HEADERS_FRAME, "Expected headers frame, got frame type %u",
+		      frame.type);
+	zassert_equal(frame.stream_identifier, stream_id, "Invalid headers frame stream ID");
+	zassert_equal(frame.flags, HTTP2_FLAG_END_HEADERS, "Unexpected flags received");
+
+	test_read_data(offset, frame.length);
+	test_consume_data(offset, frame.length);
+}
+
+static void expect_http2_data_frame(size_t *offset, int stream_id,
+				    const char *payload, size_t payload_len,
+				    uint8_t flags)
+{
+	struct http2_frame frame;
+
+	test_get_frame_header(offset, &frame);
+
+	zassert_equal(frame.type, HTTP2_DATA_FRAME, "Expected data frame, got frame type %u",
+		      frame.type);
+	zassert_equal(frame.stream_identifier, stream_id, "Invalid data frame stream ID");
+	zassert_equal(frame.flags, flags, "Unexpected flags received");
+	zassert_equal(frame.length, payload_len, "Unexpected data frame length");
+
+	test_read_data(offset, frame.length);
+	zassert_mem_equal(buf, payload, payload_len, "Unexpected data payload");
+	test_consume_data(offset, frame.length);
+}
+
+static void expect_no_data(size_t offset)
+{
+	int ret;
+
+	zassert_equal(offset, 0, "Unexpected data received");
+
+	k_msleep(100);
+
+	ret = zsock_recv(client_fd, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Unexpected data received");
+	zassert_equal(errno, EAGAIN, "recv() failed (%d)", errno);
+}
+
+ZTEST(server_workers_tests, test_dispatch)
+{
+	static const uint8_t request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS,
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_DYNAMIC_STREAM_1,
+		TEST_HTTP2_HEADERS_GET_ROOT(TEST_STREAM_ID_2),
+	};
+	size_t offset = 0;
+
+	dynamic_block = true;
+
+	test_send(request, sizeof(request));
+
+	expect_http2_settings_frames(&offset);
+	zassert_ok(k_sem_take(&dynamic_entered, K_SECONDS(TIMEOUT_S)),
+		   "Dynamic resource callback not called");
+	zassert_true(dynamic_in_worker, "Callback not called from a worker");
+
+	/* The server thread serves the next stream while the callback of
+	 * the first one is still running.
+	 */
+	expect_http2_headers_frame(&offset, TEST_STREAM_ID_2);
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_2, TEST_STATIC_PAYLOAD,
+				strlen(TEST_STATIC_PAYLOAD), HTTP2_FLAG_END_STREAM);
+
+	k_sem_give(&dynamic_release);
+
+	expect_http2_headers_frame(&offset, TEST_STREAM_ID_1);
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_1, TEST_DYNAMIC_GET_PAYLOAD,
+				strlen(TEST_DYNAMIC_GET_PAYLOAD), HTTP2_FLAG_END_STREAM);
+}
+
+ZTEST(server_workers_tests, test_send_window)
+{
+	static const uint8_t request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS_INITIAL_WINDOW(4),
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_DYNAMIC_STREAM_1,
+	};
+	static const uint8_t connection_window_update[] = {
+		TEST_HTTP2_WINDOW_UPDATE(0, 100),
+	};
+	static const uint8_t stream_window_update[] = {
+		TEST_HTTP2_WINDOW_UPDATE(TEST_STREAM_ID_1, 12),
+	};
+	size_t offset = 0;
+
+	test_send(request, sizeof(request));
+
+	expect_http2_settings_frames(&offset);
+	expect_http2_headers_frame(&offset, TEST_STREAM_ID_1);
+
+	/* Only as much as the stream window allows is sent */
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_1, TEST_DYNAMIC_GET_PAYLOAD, 4, 0);
+	expect_no_data(offset);
+
+	/* Opening the connection window does not open the stream window */
+	test_send(connection_window_update, sizeof(connection_window_update));
+	expect_no_data(offset);
+
+	test_send(stream_window_update, sizeof(stream_window_update));
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_1, TEST_DYNAMIC_GET_PAYLOAD + 4,
+				strlen(TEST_DYNAMIC_GET_PAYLOAD) - 4, HTTP2_FLAG_END_STREAM);
+}
+
+ZTEST(server_workers_tests, test_tx_lock)
+{
+	static const uint8_t request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS_INITIAL_WINDOW(64),
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_DYNAMIC_STREAM_1,
+	};
+	size_t dynamic_len = strlen(long_payload);
+	size_t dynamic_received = 0;
+	int next_stream_id = TEST_STREAM_ID_2;
+	int static_pending = 0;
+	struct http2_frame frame;
+	size_t offset = 0;
+
+	dynamic_payload = long_payload;
+
+	test_send(request, sizeof(request));
+
+	expect_http2_settings_frames(&offset);
+
+	/* Each time the worker runs out of send window, open it again along
+	 * with a request served by the server thread, so that both send
+	 * frames at the same time. The frames must not interleave.
+	 */
+	while (dynamic_received < dynamic_len || static_pending > 0) {
+		test_get_frame_header(&offset, &frame);
+		test_read_data(&offset, frame.length);
+
+		if (frame.stream_identifier != TEST_STREAM_ID_1) {
+			zassert_true(frame.stream_identifier >= TEST_STREAM_ID_2 &&
+				     frame.stream_identifier < next_stream_id,
+				     "Invalid frame stream ID %u", frame.stream_identifier);
+
+			if (frame.type == HTTP2_DATA_FRAME) {
+				zassert_equal(frame.length, strlen(TEST_STATIC_PAYLOAD),
+					      "Unexpected data frame length");
+				zassert_mem_equal(buf, TEST_STATIC_PAYLOAD, frame.length,
+						  "Unexpected data payload");
+				static_pending--;
+			} else {
+				zassert_equal(frame.type, HTTP2_HEADERS_FRAME,
+					      "Unexpected frame type %u", frame.type);
+			}
+
+			test_consume_data(&offset, frame.length);
+			continue;
+		}
+
+		if (frame.type == HTTP2_HEADERS_FRAME) {
+			zassert_equal(dynamic_received, 0, "Headers frame after data");
+			test_consume_data(&offset, frame.length);
+			continue;
+		}
+
+		zassert_equal(frame.type, HTTP2_DATA_FRAME, "Unexpected frame type %u",
+			      frame.type);
+		zassert_true(frame.length <= 64, "Send window exceeded");
+		zassert_true(dynamic_received + frame.length <= dynamic_len,
+			     "Too much data received");
+		zassert_mem_equal(buf, long_payload + dynamic_received, frame.length,
+				  "Unexpected data payload");
+
+		dynamic_received += frame.length;
+		test_consume_data(&offset, frame.length);
+
+		if (dynamic_received < dynamic_len) {
+			uint8_t update[] = {
+				TEST_HTTP2_WINDOW_UPDATE(TEST_STREAM_ID_1, frame.length),
+				TEST_HTTP2_HEADERS_GET_ROOT(next_stream_id),
+			};
+
+			test_send(update, sizeof(update));
+			next_stream_id += 2;
+			static_pending++;
+		} else {
+			zassert_equal(frame.flags, HTTP2_FLAG_END_STREAM,
+				      "Expected end stream flag");
+		}
+	}
+}
+
+ZTEST(server_workers_tests, test_close_while_busy)
+{
+	static const uint8_t dynamic_request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS,
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_DYNAMIC_STREAM_1,
+	};
+	static const uint8_t static_request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS,
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_ROOT(TEST_STREAM_ID_1),
+	};
+	size_t offset = 0;
+	int i;
+
+	dynamic_block = true;
+
+	test_send(dynamic_request, sizeof(dynamic_request));
+
+	expect_http2_settings_frames(&offset);
+	zassert_ok(k_sem_take(&dynamic_entered, K_SECONDS(TIMEOUT_S)),
+		   "Dynamic resource callback not called");
+
+	/* Close the connection while the callback is running, and let the
+	 * server thread notice it.
+	 */
+	(void)zsock_close(client_fd);
+	client_fd = test_connect();
+	k_msleep(100);
+
+	zassert_equal(test_http_service.data->num_clients, 2,
+		      "The closing client should still hold its slot");
+
+	/* The server thread is not waiting for the worker */
+	offset = 0;
+	test_send(static_request, sizeof(static_request));
+
+	expect_http2_settings_frames(&offset);
+	expect_http2_headers_frame(&offset, TEST_STREAM_ID_1);
+	expect_http2_data_frame(&offset, TEST_STREAM_ID_1, TEST_STATIC_PAYLOAD,
+				strlen(TEST_STATIC_PAYLOAD), HTTP2_FLAG_END_STREAM);
+
+	/* The closing client is released once the callback returns */
+	k_sem_give(&dynamic_release);
+
+	for (i = 0; i < 10 * TIMEOUT_S; i++) {
+		if (test_http_service.data->num_clients == 1) {
+			break;
+		}
+
+		k_msleep(100);
+	}
+
+	zassert_equal(test_http_service.data->num_clients, 1,
+		      "The closing client was not released");
+}
+
+static void expect_http2_error_frame(size_t *offset, uint8_t type, int stream_id,
+				     uint32_t error_code)
+{
+	struct http2_frame frame;
+	size_t error_offset;
+
+	test_get_frame_header(offset, &frame);
+
+	zassert_equal(frame.type, type, "Expected frame type %u, got %u", type, frame.type);
+	zassert_equal(frame.stream_identifier, stream_id, "Invalid frame stream ID");
+
+	/* The error code is the last field of both RST_STREAM and GOAWAY */
+	zassert_true(frame.length >= sizeof(uint32_t), "Frame too short");
+	error_offset = frame.length - sizeof(uint32_t);
+
+	test_read_data(offset, frame.length);
+	zassert_equal(sys_get_be32(&buf[error_offset]), error_code,
+		      "Unexpected error code %u", sys_get_be32(&buf[error_offset]));
+	test_consume_data(offset, frame.length);
+}
+
+static void expect_closed(size_t offset)
+{
+	int ret;
+
+	zassert_equal(offset, 0, "Unexpected data received");
+
+	ret = zsock_recv(client_fd, buf, sizeof(buf), 0);
+	zassert_equal(ret, 0, "Connection not closed");
+}
+
+ZTEST(server_workers_tests, test_window_update_overflow)
+{
+	static const uint8_t request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS,
+		TEST_HTTP2_SETTINGS_ACK,
+		/* On top of the default window of 65535 bytes */
+		TEST_HTTP2_WINDOW_UPDATE_MAX(0),
+	};
+	size_t offset = 0;
+
+	test_send(request, sizeof(request));
+
+	expect_http2_settings_frames(&offset);
+	expect_http2_error_frame(&offset, HTTP2_GOAWAY_FRAME, 0, HTTP2_FLOW_CONTROL_ERROR);
+	expect_closed(offset);
+}
+
+ZTEST(server_workers_tests, test_window_update_zero)
+{
+	static const uint8_t request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS,
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_WINDOW_UPDATE(0, 0),
+	};
+	size_t offset = 0;
+
+	test_send(request, sizeof(request));
+
+	expect_http2_settings_frames(&offset);
+	expect_http2_error_frame(&offset, HTTP2_GOAWAY_FRAME, 0, HTTP2_PROTOCOL_ERROR);
+	expect_closed(offset);
+}
+
+ZTEST(server_workers_tests, test_stream_window_update_overflow)
+{
+	static const uint8_t request[] = {
+		TEST_HTTP2_MAGIC,
+		TEST_HTTP2_SETTINGS,
+		TEST_HTTP2_SETTINGS_ACK,
+		TEST_HTTP2_HEADERS_GET_DYNAMIC_STREAM_1,
+	};
+	static const uint8_t window_update[] = {
+		TEST_HTTP2_WINDOW_UPDATE_MAX(TEST_STREAM_ID_1),
+	};
+	static const uint8_t static_request[] = {
+		TEST_HTTP2_HEADERS_GET_ROOT(TEST_STREAM_ID_2),
+	};
+	struct http2_frame frame;
+	size_t offset = 0;
+
+	dynamic_block = true;
+
+	test_send(request, sizeof(request));
+
+	expect_http2_settings_frames(&offset);
+	zassert_ok(k_sem_take(&dynamic_entered, K_SECONDS(TIMEOUT_S)),
+		   "Dynamic resource callback not called");
+
+	/* Only the stream is reset */
+	test_send(window_update, sizeof(window_update));
+	expect_http2_error_frame(&offset, HTTP2_RST_STREAM_FRAME, TEST_STREAM_ID_1,
+				 HTTP2_FLOW_CONTROL_ERROR);
+
+	k_sem_give(&dynamic_release);
+
+	/* The connection is still usable, skip whatever the worker sent for
+	 * the reset stream before noticing the reset.
+	 */
+	test_send(static_request, sizeof(static_request));
+
+	do {
+		test_get_frame_header(&offset, &frame);
+		test_read_data(&offset, frame.length);
+		test_consume_data(&offset, frame.length);
+
+		zassert_not_equal(frame.type, HTTP2_GOAWAY_FRAME, "Connection closed");
+	} while (frame.stream_identifier != TEST_STREAM_ID_2 ||
+		 frame.type != HTTP2_DATA_FRAME);
+
+	zassert_equal(frame.flags, HTTP2_FLAG_END_STREAM, "Expected end stream flag");
+}
+
+static void http_server_tests_before(void *fixture)
+{
+	int ret;
+
+	ARG_UNUSED(fixture);
+
+	dynamic_payload = TEST_DYNAMIC_GET_PAYLOAD;
+	dynamic_block = false;
+	dynamic_in_worker = false;
+	k_sem_reset(&dynamic_entered);
+	k_sem_reset(&dynamic_release);
+
+	ret = http_server_start();
+	zassert_ok(ret, "Failed to start the server");
+
+	client_fd = test_connect();
+}
+
+static void http_server_tests_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Do not leave a callback blocked */
+	k_sem_give(&dynamic_release);
+
+	if (client_fd >= 0) {
+		(void)zsock_close(client_fd);
+		client_fd = -1;
+	}
+
+	(void)http_server_stop();
+
+	k_yield();
+}
+
+ZTEST_SUITE(server_workers_tests, NULL, NULL, http_server_tests_before,
+	    http_server_tests_after, NULL);
@@ -1078,6 +1078,61 @@ ZTEST(net_content_senml_cbor, test_put_composite_res_inst)
 			  expected_payload.len, "Invalid payload format");
 }
 
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_STREAMING)
+ZTEST(net_content_senml_cbor, test_put_composite_streaming)
+{
+	int ret;
+	struct lwm2m_obj_path_list lwm2m_obj_path_list_buf[1];
+	sys_slist_t lwm2m_path_list;
+	sys_slist_t lwm2m_path_free_list;
+	/* More records than the record array of the non-streaming encoder holds */
+	struct lwm2m_time_series_elem test_time_series_cache[CONFIG_LWM2M_RW_SENML_CBOR_RECORDS +
+							      10];
+	struct lwm2m_cache_read_info cache_temp_info = {
+		.entry_limit = ARRAY_SIZE(test_time_series_cache)
+	};
+
+	test_msg.path.res_id = TEST_RES_S64;
+	test_msg.cache_info = &cache_temp_info;
+
+	ret = lwm2m_enable_cache(&test_msg.path, test_time_series_cache,
+				 ARRAY_SIZE(test_time_series_cache));
+	zassert_equal(ret, 0, "Failed to enable cache");
+
+	struct lwm2m_time_series_elem test_time_series_temp;
+	struct lwm2m_time_series_resource *cache_entry =
+		lwm2m_cache_entry_get_by_object(&test_msg.path);
+
+	zassert_not_null(cache_entry, "Failed to get cache entry");
+
+	for (int i = 0; i < ARRAY_SIZE(test_time_series_cache); i++) {
+		test_time_series_temp.t = 1761226500 + i * 60;
+		test_time_series_temp.i64 = i;
+		zassert_true(lwm2m_cache_write(cache_entry, &test_time_series_temp));
+	}
+
+	lwm2m_engine_path_list_init(&lwm2m_path_list, &lwm2m_path_free_list,
+				    lwm2m_obj_path_list_buf, 1);
+
+	lwm2m_engine_add_path_to_list(&lwm2m_path_list, &lwm2m_path_free_list, &test_msg.path);
+
+	ret = do_send_op_senml_cbor(&test_msg, &lwm2m_path_list);
+	zassert_true(ret >= 0, "Error reported");
+
+	/* array(N) with a one byte length, followed by the first record */
+	zassert_equal(test_msg.msg_data[TEST_PAYLOAD_OFFSET], 0x98, "Invalid array header");
+	zassert_equal(test_msg.msg_data[TEST_PAYLOAD_OFFSET + 1],
+		      ARRAY_SIZE(test_time_series_cache), "Invalid record count");
+	zassert_equal(test_msg.msg_data[TEST_PAYLOAD_OFFSET + 2], 0xA4, "Invalid first record");
+
+	/* Last record: n = "3", t = 60 * (N - 1), v = N - 1 */
+	zassert_equal(test_msg.msg_data[test_msg.cpkt.offset - 1],
+		      ARRAY_SIZE(test_time_series_cache) - 1, "Invalid last value");
+	zassert_equal(test_msg.msg_data[test_msg.cpkt.offset - 2], 0x18, "Invalid last value");
+	zassert_equal(test_msg.msg_data[test_msg.cpkt.offset - 3], 0x02, "Invalid last key");
+}
+#endif
+
 ZTEST(net_content_senml_cbor, test_get_s32)
 {
 	int ret;
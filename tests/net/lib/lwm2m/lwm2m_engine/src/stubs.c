@@ -46,6 +46,7 @@ DEFINE_FAKE_VOID_FUNC(engine_update_tx_time);
 DEFINE_FAKE_VALUE_FUNC(bool, coap_block_has_more, struct coap_packet *);
 DEFINE_FAKE_VOID_FUNC(lwm2m_rd_client_hint_socket_state, struct lwm2m_ctx *,
 		      enum lwm2m_socket_states);
+DEFINE_FAKE_VOID_FUNC(lwm2m_engine_observers_changed);
 
 static sys_slist_t obs_obj_path_list = SYS_SLIST_STATIC_INIT(&obs_obj_path_list);
 sys_slist_t *lwm2m_obs_obj_path_list(void)
@@ -61,6 +61,7 @@ DECLARE_FAKE_VOID_FUNC(engine_update_tx_time);
 DECLARE_FAKE_VALUE_FUNC(bool, coap_block_has_more, struct coap_packet *);
 DECLARE_FAKE_VOID_FUNC(lwm2m_rd_client_hint_socket_state, struct lwm2m_ctx *,
 		       enum lwm2m_socket_states);
+DECLARE_FAKE_VOID_FUNC(lwm2m_engine_observers_changed);
 
 #define DO_FOREACH_FAKE(FUNC)                                                                      \
 	do {                                                                                       \
@@ -94,6 +95,7 @@ DECLARE_FAKE_VOID_FUNC(lwm2m_rd_client_hint_socket_state, struct lwm2m_ctx *,
 		FUNC(engine_update_tx_time)                                                        \
 		FUNC(coap_block_has_more)							   \
 		FUNC(lwm2m_rd_client_hint_socket_state)                                            \
+		FUNC(lwm2m_engine_observers_changed)                                               \
 	} while (0)
 
 #endif /* STUBS_H */
@@ -571,6 +571,38 @@ ZTEST(lwm2m_registry, test_next_engine_obj_inst)
 	zassert_is_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, 1)));
 }
 
+ZTEST(lwm2m_registry, test_obj_inst_lookup)
+{
+	struct lwm2m_engine_obj_inst *oi;
+
+	for (uint16_t i = 0; i < 4; i++) {
+		zassert_equal(lwm2m_create_object_inst(&LWM2M_OBJ(3303, i)), 0);
+	}
+
+	for (uint16_t i = 0; i < 4; i++) {
+		oi = lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, i));
+		zassert_not_null(oi);
+		zassert_equal(oi->obj->obj_id, 3303);
+		zassert_equal(oi->obj_inst_id, i);
+	}
+
+	zassert_is_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, 4)));
+	zassert_is_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3304, 0)));
+
+	zassert_equal(lwm2m_delete_object_inst(&LWM2M_OBJ(3303, 1)), 0);
+	zassert_is_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, 1)));
+	zassert_not_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, 2)));
+	zassert_not_null(lwm2m_engine_get_res(&LWM2M_OBJ(3303, 2, 5700)));
+
+	zassert_equal(lwm2m_create_object_inst(&LWM2M_OBJ(3303, 1)), 0);
+	zassert_not_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, 1)));
+
+	for (uint16_t i = 0; i < 4; i++) {
+		zassert_equal(lwm2m_delete_object_inst(&LWM2M_OBJ(3303, i)), 0);
+		zassert_is_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, i)));
+	}
+}
+
 ZTEST(lwm2m_registry, test_null_strings)
 {
 	int ret;
@@ -601,6 +601,22 @@ static void test_pingreq(void)
 	zassert_ok(ret, "MQTT client input processing failed (%d)", ret);
 }
 
+static void publish_param_init(struct mqtt_publish_param *param,
+			       enum mqtt_qos qos)
+{
+	memset(param, 0, sizeof(*param));
+
+	param->message.topic.qos = qos;
+	param->message.topic.topic.utf8 = (uint8_t *)get_mqtt_topic();
+	param->message.topic.topic.size =
+			strlen(param->message.topic.topic.utf8);
+	param->message.payload.data = (uint8_t *)test_ctx.payload;
+	param->message.payload.len = strlen(test_ctx.payload);
+	param->message_id = test_ctx.msg_id;
+	param->dup_flag = 0U;
+	param->retain_flag = 0U;
+}
+
 static void test_publish(enum mqtt_qos qos)
 {
 	int ret;
@@ -611,15 +627,7 @@ static void test_publish(enum mqtt_qos qos)
 		test_ctx.msg_id = sys_rand16_get();
 	}
 
-	param.message.topic.qos = qos;
-	param.message.topic.topic.utf8 = (uint8_t *)get_mqtt_topic();
-	param.message.topic.topic.size =
-			strlen(param.message.topic.topic.utf8);
-	param.message.payload.data = (uint8_t *)test_ctx.payload;
-	param.message.payload.len = test_ctx.payload_left;
-	param.message_id = test_ctx.msg_id;
-	param.dup_flag = 0U;
-	param.retain_flag = 0U;
+	publish_param_init(&param, qos);
 
 	ret = mqtt_publish(&client_ctx, &param);
 	zassert_ok(ret, "MQTT client failed to publish (%d)", ret);
@@ -768,6 +776,70 @@ ZTEST(mqtt_client, test_mqtt_publish_qos2)
 	test_disconnect();
 }
 
+ZTEST(mqtt_client, test_mqtt_publish_batch)
+{
+	struct mqtt_publish_param params[3];
+	int ret;
+
+	test_ctx.payload = payload_short;
+
+	test_connect();
+
+	ARRAY_FOR_EACH(params, i) {
+		publish_param_init(&params[i], MQTT_QOS_0_AT_MOST_ONCE);
+	}
+
+	ret = mqtt_publish_batch(&client_ctx, params, ARRAY_SIZE(params));
+	zassert_equal(ret, MIN(ARRAY_SIZE(params), CONFIG_MQTT_PUBLISH_BATCH_MAX),
+		      "MQTT client failed to publish batch (%d)", ret);
+
+	for (int i = 0; i < ret; i++) {
+		broker_process(MQTT_PKT_TYPE_PUBLISH);
+	}
+
+	test_disconnect();
+}
+
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+ZTEST(mqtt_client, test_mqtt_publish_inflight_window)
+{
+	struct mqtt_publish_param param;
+	int ret;
+
+	test_ctx.payload = payload_short;
+
+	test_connect();
+
+	publish_param_init(&param, MQTT_QOS_1_AT_LEAST_ONCE);
+
+	for (int i = 1; i <= CONFIG_MQTT_INFLIGHT_MAX; i++) {
+		param.message_id = i;
+		ret = mqtt_publish(&client_ctx, &param);
+		zassert_ok(ret, "MQTT client failed to publish (%d)", ret);
+		broker_process(MQTT_PKT_TYPE_PUBLISH);
+	}
+
+	param.message_id = CONFIG_MQTT_INFLIGHT_MAX + 1;
+	ret = mqtt_publish(&client_ctx, &param);
+	zassert_equal(ret, -EAGAIN, "In-flight window should be full (%d)", ret);
+
+	for (int i = 1; i <= CONFIG_MQTT_INFLIGHT_MAX; i++) {
+		test_ctx.msg_id = i;
+		client_wait(false);
+		ret = mqtt_input(&client_ctx);
+		zassert_ok(ret, "MQTT client input processing failed (%d)", ret);
+	}
+
+	zassert_true(test_ctx.puback_handled, "MQTT client should receive puback");
+
+	ret = mqtt_publish(&client_ctx, &param);
+	zassert_ok(ret, "In-flight window should have room (%d)", ret);
+	broker_process(MQTT_PKT_TYPE_PUBLISH);
+
+	test_disconnect();
+}
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
 ZTEST(mqtt_client, test_mqtt_subscribe)
 {
 	test_connect();
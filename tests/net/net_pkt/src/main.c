@@ -1291,4 +1291,45 @@ ZTEST(net_pkt_test_suite, test_net_pkt_shallow_clone_append_buf_2)
 	test_net_pkt_shallow_clone_append_buf(2);
 }
 
+#if defined(CONFIG_NET_IF_RX_POOL)
+NET_PKT_RX_POOL_DEFINE(test_rx_pool, 2, 4, 1);
+
+ZTEST(net_pkt_test_suite, test_net_pkt_rx_pool)
+{
+	struct net_pkt *pkt1, *pkt2, *pkt3;
+
+	net_if_set_rx_pool(eth_if, &test_rx_pool);
+
+	pkt1 = net_pkt_rx_alloc_with_buffer(eth_if, 64, NET_AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt1, "Pkt not allocated");
+	zassert_equal_ptr(pkt1->slab, &test_rx_pool_pkts, "Pkt not from the iface pool");
+	zassert_equal(pkt1->buffer->pool_id, net_buf_pool_id(&test_rx_pool_bufs),
+		      "Buffer not from the iface pool");
+	zassert_false(net_pkt_rx_pool_is_low(eth_if), "Pool should not be low");
+
+	pkt2 = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_not_null(pkt2, "Pkt not allocated");
+	zassert_true(net_pkt_rx_pool_is_low(eth_if), "Pool should be low");
+
+	/* The pool is exhausted, the global RX pool is not used instead */
+	pkt3 = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_is_null(pkt3, "Pkt allocated from an empty pool");
+
+	zassert_equal(test_rx_pool.pkt_min_free, 0, "Wrong watermark");
+	zassert_equal(test_rx_pool.alloc_failed, 1, "Wrong failure count");
+
+	net_pkt_unref(pkt1);
+	net_pkt_unref(pkt2);
+
+	zassert_equal(k_mem_slab_num_free_get(&test_rx_pool_pkts), 2, "Leak detected");
+
+	net_if_set_rx_pool(eth_if, NULL);
+
+	pkt1 = net_pkt_rx_alloc_on_iface(eth_if, K_NO_WAIT);
+	zassert_not_null(pkt1, "Pkt not allocated");
+	zassert_not_equal(pkt1->slab, &test_rx_pool_pkts, "Pkt from the iface pool");
+	net_pkt_unref(pkt1);
+}
+#endif /* CONFIG_NET_IF_RX_POOL */
+
 ZTEST_SUITE(net_pkt_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -492,6 +492,55 @@ static void test_route_del_many(void)
 	}
 }
 
+static void test_route_longest_prefix(void)
+{
+	struct net_in6_addr other_addr = { { { 0x20, 0x01, 0x0d, 0xb9, 0, 0, 0, 0,
+					      0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+	struct net_route_entry *route_32, *route_64, *route_128;
+	struct net_route_entry *entry;
+
+	route_32 = net_route_add(my_iface, &generic_addr, 32, &peer_addr,
+				 NET_IPV6_ND_INFINITE_LIFETIME,
+				 NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_32, "Route /32 add failed");
+
+	route_64 = net_route_add(my_iface, &generic_addr, 64, &peer_addr_alt,
+				 NET_IPV6_ND_INFINITE_LIFETIME,
+				 NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_64, "Route /64 add failed");
+	zassert_not_equal(route_64, route_32, "Route /64 replaced /32 route");
+
+	route_128 = net_route_add(my_iface, &dest_addr, 128, &peer_addr,
+				  NET_IPV6_ND_INFINITE_LIFETIME,
+				  NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(route_128, "Route /128 add failed");
+	zassert_not_equal(route_128, route_32, "Route /128 replaced /32 route");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, route_128, "Host route not selected");
+
+	entry = net_route_lookup(NULL, &peer_addr);
+	zassert_equal_ptr(entry, route_64, "/64 route not selected");
+
+	entry = net_route_lookup(my_iface, &other_addr);
+	zassert_is_null(entry, "Route found for unrelated prefix");
+
+	zassert_equal(net_route_del(route_128), 0, "Route /128 del failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, route_64, "Fallback to /64 route failed");
+
+	zassert_equal(net_route_del(route_64), 0, "Route /64 del failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, route_32, "Fallback to /32 route failed");
+
+	zassert_equal(net_route_del(route_32), 0, "Route /32 del failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_is_null(entry, "Route found after all routes were deleted");
+}
+
 static void test_route_lifetime(void)
 {
 	route_entry = net_route_add(my_iface,
@@ -564,6 +613,7 @@ ZTEST(route_test_suite, test_route)
 	test_populate_nbr_cache();
 	test_route_add_many();
 	test_route_del_many();
+	test_route_longest_prefix();
 	test_route_lifetime();
 	test_route_preference();
 }
@@ -0,0 +1,286 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#include "../../socket_helpers.h"
+
+#define MY_IPV4_ADDR "127.0.0.1"
+#define SERVER_PORT 4242
+
+#define TIMEOUT_S 1
+
+#define TEST_PARTITION		storage_partition
+#define TEST_PARTITION_ID	FIXED_PARTITION_ID(TEST_PARTITION)
+
+#define LFS_MNTP		"/littlefs"
+#define TEST_FILE		LFS_MNTP "/sendfile.bin"
+
+/* Several times the MSS of the loopback interface, and not a multiple of
+ * it nor of the network buffer size.
+ */
+#define TEST_FILE_SIZE 5000
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+
+static struct fs_mount_t littlefs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)TEST_PARTITION_ID,
+	.mnt_point = LFS_MNTP,
+};
+
+static uint8_t file_data[TEST_FILE_SIZE];
+static uint8_t rx_buf[TEST_FILE_SIZE];
+
+static struct fs_file_t file;
+static int s_sock = -1;
+static int c_sock = -1;
+static int new_sock = -1;
+
+static void expect_data(off_t offset, size_t len)
+{
+	size_t received = 0;
+	ssize_t ret;
+
+	zassert_true(offset + len <= sizeof(file_data), "Invalid file range");
+
+	while (received < len) {
+		ret = zsock_recv(c_sock, rx_buf + received, len - received, 0);
+		zassert_true(ret > 0, "recv failed (%d)", errno);
+		received += ret;
+	}
+
+	zassert_mem_equal(rx_buf, file_data + offset, len,
+			  "Unexpected data from offset %d", (int)offset);
+}
+
+static void expect_no_data(void)
+{
+	ssize_t ret;
+
+	/* Let anything sent by mistake reach the peer */
+	k_msleep(50);
+
+	ret = zsock_recv(c_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Unexpected data received");
+	zassert_equal(errno, EAGAIN, "recv failed (%d)", errno);
+}
+
+static void sendfile_and_check(off_t *offset, size_t count, size_t expected)
+{
+	off_t start = *offset;
+	ssize_t ret;
+
+	ret = zsock_sendfile(new_sock, &file, offset, count);
+	zassert_equal(ret, expected, "sendfile of %zu bytes from %d returned %zd (%d)",
+		      count, (int)start, ret, errno);
+	zassert_equal(*offset, start + expected, "Offset not updated");
+
+	if (expected > 0) {
+		expect_data(start, expected);
+	}
+}
+
+ZTEST(net_socket_sendfile, test_sendfile_chunks)
+{
+	/* Chunks of one byte, just under a segment, several segments and the
+	 * rest of the file.
+	 */
+	static const size_t chunks[] = { 1, 1239, 2500, TEST_FILE_SIZE - 1 - 1239 - 2500 };
+	off_t offset = 0;
+
+	ARRAY_FOR_EACH(chunks, i) {
+		sendfile_and_check(&offset, chunks[i], chunks[i]);
+	}
+
+	zassert_equal(offset, TEST_FILE_SIZE, "Whole file not sent");
+
+	/* Nothing left to send at the end of the file */
+	sendfile_and_check(&offset, 100, 0);
+	expect_no_data();
+}
+
+ZTEST(net_socket_sendfile, test_sendfile_offset)
+{
+	off_t offset;
+
+	/* Nothing is sent for a zero count */
+	offset = 100;
+	sendfile_and_check(&offset, 0, 0);
+
+	/* Unaligned range in the middle of the file */
+	offset = 4095;
+	sendfile_and_check(&offset, 3, 3);
+
+	/* The count is capped to the end of the file */
+	offset = TEST_FILE_SIZE - 10;
+	sendfile_and_check(&offset, 100, 10);
+
+	/* An offset at or past the end of the file is the end of the file */
+	offset = TEST_FILE_SIZE;
+	sendfile_and_check(&offset, 100, 0);
+
+	offset = TEST_FILE_SIZE + 100;
+	sendfile_and_check(&offset, 100, 0);
+
+	/* The whole file at once, from the start again */
+	offset = 0;
+	sendfile_and_check(&offset, TEST_FILE_SIZE, TEST_FILE_SIZE);
+
+	expect_no_data();
+}
+
+ZTEST(net_socket_sendfile, test_sendfile_file_position)
+{
+	ssize_t ret;
+
+	zassert_ok(fs_seek(&file, 100, FS_SEEK_SET), "seek failed");
+
+	/* Without an offset the data is read from the file position, which
+	 * moves past the data sent.
+	 */
+	ret = zsock_sendfile(new_sock, &file, NULL, 300);
+	zassert_equal(ret, 300, "sendfile returned %zd (%d)", ret, errno);
+	zassert_equal(fs_tell(&file), 400, "File position not updated");
+	expect_data(100, 300);
+
+	zassert_ok(fs_seek(&file, TEST_FILE_SIZE - 200, FS_SEEK_SET), "seek failed");
+
+	ret = zsock_sendfile(new_sock, &file, NULL, 1000);
+	zassert_equal(ret, 200, "sendfile returned %zd (%d)", ret, errno);
+	expect_data(TEST_FILE_SIZE - 200, 200);
+
+	ret = zsock_sendfile(new_sock, &file, NULL, 1000);
+	zassert_equal(ret, 0, "sendfile returned %zd (%d)", ret, errno);
+
+	expect_no_data();
+}
+
+ZTEST(net_socket_sendfile, test_sendfile_errors)
+{
+	struct net_sockaddr_in addr;
+	off_t offset = 0;
+	int sock;
+	ssize_t ret;
+
+	ret = zsock_sendfile(new_sock, NULL, &offset, 100);
+	zassert_equal(ret, -1, "sendfile without a file succeeded");
+	zassert_equal(errno, EINVAL, "Unexpected errno %d", errno);
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &sock, &addr);
+
+	ret = zsock_sendfile(sock, &file, &offset, 100);
+	zassert_equal(ret, -1, "sendfile on a datagram socket succeeded");
+	zassert_equal(errno, EOPNOTSUPP, "Unexpected errno %d", errno);
+	zassert_equal(offset, 0, "Offset updated on error");
+
+	zassert_ok(zsock_close(sock), "close failed");
+
+	expect_no_data();
+}
+
+static void *setup(void)
+{
+	const struct flash_area *fap;
+	ssize_t written;
+	int ret;
+
+	for (size_t i = 0; i < sizeof(file_data); i++) {
+		file_data[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+
+	ret = flash_area_open(TEST_PARTITION_ID, &fap);
+	zassert_ok(ret, "Opening flash area for erase [%d]", ret);
+
+	ret = flash_area_flatten(fap, 0, fap->fa_size);
+	zassert_ok(ret, "Erasing flash area [%d]", ret);
+
+	ret = fs_mount(&littlefs_mnt);
+	zassert_ok(ret, "Failed to mount fs [%d]", ret);
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, TEST_FILE, FS_O_CREATE | FS_O_WRITE);
+	zassert_ok(ret, "Failed to create file [%d]", ret);
+
+	written = fs_write(&file, file_data, sizeof(file_data));
+	zassert_equal(written, sizeof(file_data), "Failed to write file [%zd]", written);
+
+	ret = fs_close(&file);
+	zassert_ok(ret, "Failed to close file [%d]", ret);
+
+	return NULL;
+}
+
+static void before(void *arg)
+{
+	struct net_sockaddr_in c_saddr;
+	struct net_sockaddr_in s_saddr;
+	struct timeval optval = {
+		.tv_sec = TIMEOUT_S,
+		.tv_usec = 0,
+	};
+	int ret;
+
+	ARG_UNUSED(arg);
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, TEST_FILE, FS_O_READ);
+	zassert_ok(ret, "Failed to open file [%d]", ret);
+
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, 0, &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, SERVER_PORT, &s_sock, &s_saddr);
+
+	zassert_ok(zsock_bind(s_sock, (struct net_sockaddr *)&s_saddr, sizeof(s_saddr)),
+		   "bind failed (%d)", errno);
+	zassert_ok(zsock_listen(s_sock, 1), "listen failed (%d)", errno);
+
+	zassert_ok(zsock_setsockopt(c_sock, ZSOCK_SOL_SOCKET, ZSOCK_SO_RCVTIMEO, &optval,
+				    sizeof(optval)),
+		   "setsockopt failed (%d)", errno);
+
+	zassert_ok(zsock_connect(c_sock, (struct net_sockaddr *)&s_saddr, sizeof(s_saddr)),
+		   "connect failed (%d)", errno);
+
+	new_sock = zsock_accept(s_sock, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed (%d)", errno);
+}
+
+static void after(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (new_sock >= 0) {
+		(void)zsock_close(new_sock);
+		new_sock = -1;
+	}
+
+	if (c_sock >= 0) {
+		(void)zsock_close(c_sock);
+		c_sock = -1;
+	}
+
+	if (s_sock >= 0) {
+		(void)zsock_close(s_sock);
+		s_sock = -1;
+	}
+
+	(void)fs_close(&file);
+
+	/* Let the connections close before the port is bound again */
+	k_msleep(100);
+}
+
+ZTEST_SUITE(net_socket_sendfile, NULL, setup, before, after, NULL);
@@ -53,6 +53,12 @@ NET_SOCKET_SERVICE_SYNC_DEFINE(udp_service_sync, server_handler, 2);
 NET_SOCKET_SERVICE_SYNC_DEFINE(tcp_service_small_sync, tcp_server_handler, 1);
 NET_SOCKET_SERVICE_SYNC_DEFINE_STATIC(tcp_service_sync, tcp_server_handler, 2);
 
+/* Served by the last dispatcher thread, which is thread 0 unless more are configured */
+NET_SOCKET_SERVICE_SYNC_DEFINE_THREAD(udp_service_thread, server_handler, 2,
+				      CONFIG_NET_SOCKETS_SERVICE_THREADS - 1);
+NET_SOCKET_SERVICE_SYNC_DEFINE_THREAD_STATIC(tcp_service_thread, tcp_server_handler, 2,
+					     CONFIG_NET_SOCKETS_SERVICE_THREADS - 1);
+
 
 void run_test_service(const struct net_socket_service_desc *udp_service,
 		      const struct net_socket_service_desc *tcp_service_small,
@@ -180,4 +186,10 @@ ZTEST(net_socket_service, test_service_sync)
 			 &tcp_service_sync);
 }
 
+ZTEST(net_socket_service, test_service_thread)
+{
+	run_test_service(&udp_service_thread, &tcp_service_small_sync,
+			 &tcp_service_thread);
+}
+
 ZTEST_SUITE(net_socket_service, NULL, NULL, NULL, NULL, NULL);
@@ -531,6 +531,203 @@ ZTEST(net_socket_tls, test_v6_msg_waitall)
 	k_sleep(TCP_TEARDOWN_TIMEOUT);
 }
 
+ZTEST(net_socket_tls, test_tls_session_stats)
+{
+	struct zsock_tls_session_stats before;
+	struct zsock_tls_session_stats after;
+	net_socklen_t optlen = sizeof(before);
+	int ret;
+
+	test_prepare_tls_connection(NET_AF_INET);
+
+	ret = zsock_getsockopt(new_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_STATS,
+			       &before, &optlen);
+	zassert_equal(ret, 0, "zsock_getsockopt() failed (%d)", errno);
+	zassert_equal(optlen, sizeof(before), "Invalid optlen");
+	zassert_true(before.handshakes > 0, "Server handshake not counted");
+
+	optlen = sizeof(before) - 1;
+	ret = zsock_getsockopt(new_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_STATS,
+			       &after, &optlen);
+	zassert_equal(ret, -1, "zsock_getsockopt() should've failed");
+	zassert_equal(errno, EINVAL, "Unexpected errno value: %d", errno);
+
+	test_sockets_close();
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+
+	/* The statistics are shared by all the sockets. */
+	test_prepare_tls_connection(NET_AF_INET);
+
+	optlen = sizeof(after);
+	ret = zsock_getsockopt(c_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_STATS,
+			       &after, &optlen);
+	zassert_equal(ret, 0, "zsock_getsockopt() failed (%d)", errno);
+	zassert_equal(after.handshakes, before.handshakes + 1,
+		      "Server handshake not counted");
+
+	test_sockets_close();
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+static void test_tls_resumption_connect(struct net_sockaddr_in *s_saddr)
+{
+	int cache = ZSOCK_TLS_SESSION_CACHE_ENABLED;
+	struct net_sockaddr_in c_saddr;
+	struct net_sockaddr addr;
+	net_socklen_t addrlen = sizeof(addr);
+	struct connect_data test_data;
+
+	prepare_sock_tls_v4(MY_IPV4_ADDR, ANY_PORT, &c_sock, &c_saddr,
+			    NET_IPPROTO_TLS_1_2);
+	test_config_psk(-1, c_sock);
+
+	/* The client stores the session (ticket) and offers it on reconnect */
+	zassert_equal(zsock_setsockopt(c_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_CACHE,
+				       &cache, sizeof(cache)),
+		      0, "Failed to enable session cache on client socket");
+
+	test_data.sock = c_sock;
+	test_data.addr = (struct net_sockaddr *)s_saddr;
+	k_work_init_delayable(&test_data.work, client_connect_work_handler);
+	test_work_reschedule(&test_data.work, K_NO_WAIT);
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+	zassert_equal(addrlen, sizeof(struct net_sockaddr_in), "Wrong addrlen");
+
+	test_work_wait(&test_data.work);
+}
+
+static void test_tls_resumption_stats_get(struct zsock_tls_session_stats *stats)
+{
+	net_socklen_t optlen = sizeof(*stats);
+
+	zassert_equal(zsock_getsockopt(new_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_STATS,
+				       stats, &optlen),
+		      0, "zsock_getsockopt() failed (%d)", errno);
+}
+
+ZTEST(net_socket_tls, test_tls_session_resumption)
+{
+	int cache = ZSOCK_TLS_SESSION_CACHE_ENABLED;
+	struct zsock_tls_session_stats before;
+	struct zsock_tls_session_stats after;
+	struct net_sockaddr_in s_saddr;
+
+	if (!IS_ENABLED(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS) &&
+	    !IS_ENABLED(CONFIG_MBEDTLS_SSL_CACHE_C)) {
+		ztest_test_skip();
+	}
+
+	prepare_sock_tls_v4(MY_IPV4_ADDR, SERVER_PORT, &s_sock, &s_saddr,
+			    NET_IPPROTO_TLS_1_2);
+	test_config_psk(s_sock, -1);
+	zassert_equal(zsock_setsockopt(s_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_CACHE,
+				       &cache, sizeof(cache)),
+		      0, "Failed to enable session cache on server socket");
+
+	test_bind(s_sock, (struct net_sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	/* Full handshake */
+	test_tls_resumption_connect(&s_saddr);
+	test_tls_resumption_stats_get(&before);
+
+	test_close(c_sock);
+	c_sock = -1;
+	test_close(new_sock);
+	new_sock = -1;
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+
+	/* Reconnect to the same server, the session is resumed */
+	test_tls_resumption_connect(&s_saddr);
+	test_tls_resumption_stats_get(&after);
+
+	zassert_equal(after.handshakes, before.handshakes + 1,
+		      "Server handshake not counted");
+
+	if (IS_ENABLED(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)) {
+		zassert_equal(after.ticket_lookups, before.ticket_lookups + 1,
+			      "Session ticket not offered by the client");
+		zassert_equal(after.ticket_hits, before.ticket_hits + 1,
+			      "Session not resumed from the ticket");
+	} else {
+		zassert_equal(after.cache_hits, before.cache_hits + 1,
+			      "Session not resumed from the cache");
+	}
+
+	/* Do not let the stored client session affect the other tests */
+	zassert_equal(zsock_setsockopt(s_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_SESSION_CACHE_PURGE,
+				       NULL, 0),
+		      0, "Failed to purge session cache");
+
+	test_sockets_close();
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+ZTEST(net_socket_tls, test_tls_cork)
+{
+	uint8_t rx_buf[sizeof(TEST_STR_SMALL) - 1] = { 0 };
+	size_t half = sizeof(rx_buf) / 2;
+	int optval;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_SOCKETS_TLS_CORK)) {
+		ztest_test_skip();
+	}
+
+	test_prepare_tls_connection(NET_AF_INET);
+
+	/* Data sent on a corked socket is held back until uncorked. */
+	optval = 1;
+	ret = zsock_setsockopt(c_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_CORK, &optval,
+			       sizeof(optval));
+	zassert_equal(ret, 0, "zsock_setsockopt() failed (%d)", errno);
+
+	test_send(c_sock, TEST_STR_SMALL, half, 0);
+	test_send(c_sock, TEST_STR_SMALL + half, sizeof(rx_buf) - half, 0);
+
+	k_msleep(10);
+
+	ret = zsock_recv(new_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, -1, "zsock_recv() should've failed");
+	zassert_equal(errno, EAGAIN, "Unexpected errno value: %d", errno);
+
+	optval = 0;
+	ret = zsock_setsockopt(c_sock, ZSOCK_SOL_TLS, ZSOCK_TLS_CORK, &optval,
+			       sizeof(optval));
+	zassert_equal(ret, 0, "zsock_setsockopt() failed (%d)", errno);
+
+	ret = zsock_recv(new_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_WAITALL);
+	zassert_equal(ret, sizeof(rx_buf), "Invalid length received");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+			  "Invalid data received");
+
+	/* MSG_MORE holds back the data until the next send without it. */
+	memset(rx_buf, 0, sizeof(rx_buf));
+	test_send(c_sock, TEST_STR_SMALL, half, ZSOCK_MSG_MORE);
+
+	k_msleep(10);
+
+	ret = zsock_recv(new_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, -1, "zsock_recv() should've failed");
+	zassert_equal(errno, EAGAIN, "Unexpected errno value: %d", errno);
+
+	test_send(c_sock, TEST_STR_SMALL + half, sizeof(rx_buf) - half, 0);
+
+	ret = zsock_recv(new_sock, rx_buf, sizeof(rx_buf), ZSOCK_MSG_WAITALL);
+	zassert_equal(ret, sizeof(rx_buf), "Invalid length received");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+			  "Invalid data received");
+
+	test_sockets_close();
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 struct send_data {
 	struct k_work_delayable tx_work;
 	int sock;
@@ -3758,6 +3758,129 @@ ZTEST(net_socket_udp, test_v6_rebinding)
 	test_rebinding_common(NET_AF_INET6);
 }
 
+#define MMSG_COUNT 4
+
+ZTEST(net_socket_udp, test_v4_sendmmsg_recvmmsg)
+{
+	static char rx_bufs[MMSG_COUNT + 1][sizeof(TEST_STR_SMALL)];
+	struct net_iovec rx_iov[MMSG_COUNT + 1];
+	struct net_iovec tx_iov[MMSG_COUNT];
+	struct net_mmsghdr rx_msgs[MMSG_COUNT + 1] = { 0 };
+	struct net_mmsghdr tx_msgs[MMSG_COUNT] = { 0 };
+	struct net_sockaddr_in client_addr;
+	struct net_sockaddr_in server_addr;
+	int client_sock;
+	int server_sock;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = zsock_bind(server_sock, (struct net_sockaddr *)&server_addr,
+			sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		tx_iov[i].iov_base = TEST_STR_SMALL;
+		tx_iov[i].iov_len = STRLEN(TEST_STR_SMALL);
+		tx_msgs[i].msg_hdr.msg_name = &server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	for (int i = 0; i < MMSG_COUNT + 1; i++) {
+		rx_iov[i].iov_base = rx_bufs[i];
+		rx_iov[i].iov_len = sizeof(rx_bufs[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = zsock_sendmmsg(client_sock, tx_msgs, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg failed (%d)", rv);
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(tx_msgs[i].msg_len, STRLEN(TEST_STR_SMALL),
+			      "unexpected sent length");
+	}
+
+	k_msleep(100);
+
+	/* Ask for one message more than was sent, the call must not block */
+	rv = zsock_recvmmsg(server_sock, rx_msgs, MMSG_COUNT + 1,
+			    ZSOCK_MSG_WAITFORONE);
+	zassert_equal(rv, MMSG_COUNT, "recvmmsg failed (%d)", rv);
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(rx_msgs[i].msg_len, STRLEN(TEST_STR_SMALL),
+			      "unexpected received length");
+		zassert_mem_equal(rx_bufs[i], BUF_AND_SIZE(TEST_STR_SMALL),
+				  "wrong data");
+	}
+
+	/* Nothing left, so a non-blocking call must fail */
+	rv = zsock_recvmmsg(server_sock, rx_msgs, MMSG_COUNT, ZSOCK_MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg succeeded");
+	zassert_equal(errno, EAGAIN, "unexpected errno (%d)", errno);
+
+	rv = zsock_close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = zsock_close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY_RX)
+ZTEST(net_socket_udp, test_v4_recv_buf)
+{
+	struct net_sockaddr_in client_addr;
+	struct net_sockaddr_in server_addr;
+	struct net_sockaddr_in addr;
+	net_socklen_t addrlen = sizeof(addr);
+	struct net_buf *frags;
+	int client_sock;
+	int server_sock;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = zsock_bind(server_sock, (struct net_sockaddr *)&server_addr,
+			sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	rv = zsock_sendto(client_sock, TEST_STR_SMALL, STRLEN(TEST_STR_SMALL), 0,
+			  (struct net_sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	rv = zsock_recv_buf(server_sock, &frags, ZSOCK_MSG_PEEK, NULL, NULL);
+	zassert_equal(rv, -1, "peek should not be supported");
+	zassert_equal(errno, EINVAL, "unexpected errno (%d)", errno);
+
+	rv = zsock_recv_buf(server_sock, &frags, 0,
+			    (struct net_sockaddr *)&addr, &addrlen);
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "recv_buf failed (%d)", rv);
+	zassert_not_null(frags, "no buffers received");
+	zassert_equal(net_buf_frags_len(frags), rv, "unexpected buffer length");
+	zassert_equal(addrlen, sizeof(struct net_sockaddr_in), "wrong addrlen");
+	zassert_equal(addr.sin_family, NET_AF_INET, "wrong address family");
+
+	/* The payload must start at the first fragment, headers stripped */
+	zassert_mem_equal(frags->data, TEST_STR_SMALL,
+			  MIN(frags->len, STRLEN(TEST_STR_SMALL)), "wrong data");
+
+	zsock_recv_buf_release(frags);
+
+	rv = zsock_recv_buf(server_sock, &frags, ZSOCK_MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(rv, -1, "recv_buf succeeded");
+	zassert_equal(errno, EAGAIN, "unexpected errno (%d)", errno);
+
+	rv = zsock_close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = zsock_close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY_RX */
+
 static void after(void *arg)
 {
 	ARG_UNUSED(arg);
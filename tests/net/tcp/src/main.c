@@ -116,6 +116,7 @@ static enum test_case_no {
 	TEST_CLIENT_SEQ_VALIDATION = 19,
 	TEST_SERVER_ACK_VALIDATION = 20,
 	TEST_SERVER_FIN_ACK_AFTER_DATA = 21,
+	TEST_CLIENT_GSO_SEND_IPV4 = 22,
 } test_case_no;
 
 static enum test_state t_state;
@@ -143,6 +144,9 @@ static void handle_client_fin_ack_with_data_test(net_sa_family_t af, struct tcph
 static void handle_client_seq_validation_test(net_sa_family_t af, struct tcphdr *th);
 static void handle_server_ack_validation_test(struct net_pkt *pkt);
 static void handle_server_fin_ack_after_data_test(net_sa_family_t af, struct tcphdr *th);
+#if defined(CONFIG_NET_TCP_GSO)
+static void handle_client_gso_send_test(struct net_pkt *pkt, struct tcphdr *th);
+#endif
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -200,12 +204,59 @@ static struct dummy_api net_tcp_if_api = {
 	.send = tester_send,
 };
 
+#if defined(CONFIG_NET_TCP_GSO)
+/* Same as the dummy L2, but advertises GSO support so that TCP hands
+ * super-segments to the test interface.
+ */
+static enum net_verdict tcp_gso_l2_recv(struct net_if *iface,
+					struct net_pkt *pkt)
+{
+	return NET_CONTINUE;
+}
+
+static int tcp_gso_l2_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	const struct dummy_api *api = net_if_get_device(iface)->api;
+	int ret;
+
+	ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
+	if (ret == 0) {
+		ret = (int)net_pkt_get_len(pkt);
+		net_pkt_unref(pkt);
+	}
+
+	return ret;
+}
+
+static int tcp_gso_l2_enable(struct net_if *iface, bool state)
+{
+	return 0;
+}
+
+static enum net_l2_flags tcp_gso_l2_flags(struct net_if *iface)
+{
+	return NET_L2_MULTICAST | NET_L2_GSO;
+}
+
+#define TCP_GSO_TEST_L2_CTX_TYPE void *
+
+NET_L2_INIT(TCP_GSO_TEST_L2, tcp_gso_l2_recv, tcp_gso_l2_send,
+	    tcp_gso_l2_enable, tcp_gso_l2_flags);
+
+NET_DEVICE_INIT(net_tcp_test, "net_tcp_test",
+		net_tcp_dev_init, NULL,
+		&net_tcp_context_data, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_tcp_if_api, TCP_GSO_TEST_L2,
+		NET_L2_GET_CTX_TYPE(TCP_GSO_TEST_L2), 127);
+#else
 NET_DEVICE_INIT(net_tcp_test, "net_tcp_test",
 		net_tcp_dev_init, NULL,
 		&net_tcp_context_data, NULL,
 		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
 		&net_tcp_if_api, DUMMY_L2,
 		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+#endif /* CONFIG_NET_TCP_GSO */
 
 static void test_sem_give(void)
 {
@@ -496,6 +547,11 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case TEST_SERVER_FIN_ACK_AFTER_DATA:
 		handle_server_fin_ack_after_data_test(net_pkt_family(pkt), &th);
 		break;
+#if defined(CONFIG_NET_TCP_GSO)
+	case TEST_CLIENT_GSO_SEND_IPV4:
+		handle_client_gso_send_test(pkt, &th);
+		break;
+#endif
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -514,7 +570,11 @@ static void *presetup(void)
 {
 	struct net_if_addr *ifaddr;
 
+#if defined(CONFIG_NET_TCP_GSO)
+	net_iface = net_if_get_first_by_type(&NET_L2_GET_NAME(TCP_GSO_TEST_L2));
+#else
 	net_iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+#endif
 	if (!net_iface) {
 		zassert_true(false, "Interface not available");
 	}
@@ -3207,4 +3267,204 @@ ZTEST(net_tcp, test_server_fin_ack_after_data)
 	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+#define GSO_TEST_MSS 536
+
+struct gso_test_ctx {
+	uint16_t mss;
+	size_t total;
+	size_t payload;
+	uint32_t next_seq;
+	int count;
+};
+
+static int gso_test_segment_cb(struct net_pkt *seg, void *user_data)
+{
+	struct gso_test_ctx *ctx = user_data;
+	size_t hdr_len = net_pkt_ip_hdr_len(seg) + sizeof(struct tcphdr);
+	size_t seg_len = net_pkt_get_len(seg) - hdr_len;
+	struct tcphdr th;
+
+	zassert_ok(read_tcp_header(seg, &th), "Failed to read TCP header");
+	zassert_true(seg_len > 0 && seg_len <= ctx->mss,
+		     "Invalid segment length %zu", seg_len);
+	zassert_equal(net_ntohs(NET_IPV4_HDR(seg)->len), net_pkt_get_len(seg),
+		      "Invalid IPv4 length");
+	zassert_equal(net_ntohl(th.th_seq), ctx->next_seq,
+		      "Invalid sequence number");
+
+	ctx->payload += seg_len;
+	ctx->next_seq += seg_len;
+	ctx->count++;
+
+	if (ctx->payload < ctx->total) {
+		test_verify_flags(&th, ACK);
+	} else {
+		test_verify_flags(&th, PSH | ACK);
+	}
+
+	return 0;
+}
+
+ZTEST(net_tcp, test_gso_segment_ipv4)
+{
+	struct gso_test_ctx ctx = {
+		.mss = GSO_TEST_MSS,
+		.total = sizeof(lorem_ipsum) - 1,
+		.next_seq = seq,
+	};
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = prepare_data_packet(NET_AF_INET, net_htons(MY_PORT),
+				  net_htons(PEER_PORT), (const uint8_t *)lorem_ipsum,
+				  sizeof(lorem_ipsum) - 1);
+	zassert_not_null(pkt, "Cannot create super-segment");
+
+	net_pkt_set_gso_size(pkt, GSO_TEST_MSS);
+
+	ret = net_tcp_gso_segment(pkt, gso_test_segment_cb, &ctx);
+	zassert_ok(ret, "Segmentation failed (%d)", ret);
+	zassert_equal(ctx.payload, ctx.total, "Payload length mismatch");
+	zassert_equal(ctx.count, DIV_ROUND_UP(ctx.total, GSO_TEST_MSS),
+		      "Invalid number of segments (%d)", ctx.count);
+
+	net_pkt_unref(pkt);
+}
+
+static size_t gso_send_received;
+static int gso_send_super_segments;
+
+static void handle_client_gso_send_test(struct net_pkt *pkt, struct tcphdr *th)
+{
+	size_t hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+			 th->th_off * 4U;
+	size_t payload_len = net_pkt_get_len(pkt) - hdr_len;
+	uint16_t mss = net_pkt_gso_size(pkt);
+	struct net_pkt *reply;
+	int ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = net_ntohl(th->th_seq) + 1U;
+		reply = prepare_syn_ack_packet(NET_AF_INET, net_htons(MY_PORT),
+					       th->th_sport);
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		zassert_true(payload_len > 0, "Expected data");
+		zassert_equal(net_ntohl(th->th_seq), ack,
+			      "Invalid sequence number");
+
+		if (mss > 0U) {
+			struct gso_test_ctx ctx = {
+				.mss = mss,
+				.total = payload_len,
+				.next_seq = ack,
+			};
+
+			/* Full sized segments only, the remainder is
+			 * sent separately.
+			 */
+			zassert_true(payload_len > mss, "Needless super-segment");
+			zassert_equal(payload_len % mss, 0U,
+				      "Partial segment in super-segment");
+
+			ret = net_tcp_gso_segment(pkt, gso_test_segment_cb,
+						  &ctx);
+			zassert_ok(ret, "Segmentation failed (%d)", ret);
+			zassert_equal(ctx.payload, payload_len,
+				      "Payload length mismatch");
+
+			gso_send_super_segments++;
+		} else {
+			test_verify_flags(th, PSH | ACK);
+		}
+
+		ack += payload_len;
+		gso_send_received += payload_len;
+
+		reply = prepare_ack_packet(NET_AF_INET, net_htons(MY_PORT),
+					   th->th_sport);
+
+		if (gso_send_received == sizeof(lorem_ipsum) - 1) {
+			t_state = T_FIN;
+			test_sem_give();
+		}
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ack + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(NET_AF_INET, net_htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(net_iface, reply);
+	zassert_ok(ret, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   connect to peer,
+ *   send more than one MSS of data in one go,
+ *   expect a super-segment carrying the full sized segments and a
+ *   separate segment carrying the remainder,
+ *   close the connection.
+ */
+ZTEST(net_tcp, test_client_gso_send_ipv4)
+{
+	struct net_context *ctx;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = TEST_CLIENT_GSO_SEND_IPV4;
+	seq = ack = 0;
+	gso_send_received = 0;
+	gso_send_super_segments = 0;
+
+	ret = net_context_get(NET_AF_INET, NET_SOCK_STREAM, NET_IPPROTO_TCP, &ctx);
+	zassert_ok(ret, "Failed to get net_context");
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct net_sockaddr *)&peer_addr_s,
+				  sizeof(struct net_sockaddr_in),
+				  NULL, K_MSEC(100), NULL);
+	zassert_ok(ret, "Failed to connect to peer");
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	ret = net_context_send(ctx, lorem_ipsum, sizeof(lorem_ipsum) - 1,
+			       NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, sizeof(lorem_ipsum) - 1,
+		      "Failed to send data to peer (%d)", ret);
+
+	/* Peer will release the semaphore after all data is acknowledged */
+	test_sem_take(K_MSEC(500), __LINE__);
+
+	zassert_true(gso_send_super_segments > 0, "No super-segment sent");
+
+	net_context_put(ctx);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 ZTEST_SUITE(net_tcp, NULL, presetup, NULL, NULL, NULL);
@@ -1051,6 +1051,113 @@ ZTEST(net_traffic_class, test_mix_all_2)
 	test_traffic_class_recv_data_mix_all_2();
 }
 
+#if defined(CONFIG_NET_TC_RX_FLOW_STEERING)
+#define FLOW_COUNT 12
+#define FLOW_PKT_COUNT 4
+#define FLOW_PORT_BASE 5000
+
+static struct net_context *flow_ctxs[FLOW_COUNT];
+static k_tid_t flow_threads[FLOW_COUNT];
+static bool flow_moved;
+static struct k_sem flow_wait;
+
+static void flow_recv_cb(struct net_context *context,
+			 struct net_pkt *pkt,
+			 union net_ip_header *ip_hdr,
+			 union net_proto_header *proto_hdr,
+			 int status,
+			 void *user_data)
+{
+	int flow = POINTER_TO_INT(user_data);
+	k_tid_t thread = k_current_get();
+
+	/* Remember the RX queue thread that handled the first packet */
+	if (flow_threads[flow] == NULL) {
+		flow_threads[flow] = thread;
+	} else if (flow_threads[flow] != thread) {
+		flow_moved = true;
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&flow_wait);
+}
+
+ZTEST(net_traffic_class, test_rx_flow_steering)
+{
+	struct net_sockaddr_in6 src_addr6 = {
+		.sin6_family = NET_AF_INET6,
+	};
+	uint8_t priority = NET_PRIORITY_BE;
+	int queues = 0;
+	int i, j, ret;
+
+	memcpy(&src_addr6.sin6_addr, &my_addr1, sizeof(struct net_in6_addr));
+	(void)memset(flow_threads, 0, sizeof(flow_threads));
+	k_sem_init(&flow_wait, 0, UINT_MAX);
+	flow_moved = false;
+
+	/* Each context is a flow of its own as it has its own port */
+	for (i = 0; i < FLOW_COUNT; i++) {
+		ret = net_context_get(NET_AF_INET6, NET_SOCK_DGRAM, NET_IPPROTO_UDP,
+				      &flow_ctxs[i]);
+		zassert_equal(ret, 0, "[%d] Create IPv6 UDP context failed (%d)", i, ret);
+
+		src_addr6.sin6_port = net_htons(FLOW_PORT_BASE + i);
+		ret = net_context_bind(flow_ctxs[i], (struct net_sockaddr *)&src_addr6,
+				       sizeof(struct net_sockaddr_in6));
+		zassert_equal(ret, 0, "[%d] Context bind failed (%d)", i, ret);
+
+		ret = net_context_set_option(flow_ctxs[i], NET_OPT_PRIORITY,
+					     &priority, sizeof(priority));
+		zassert_equal(ret, 0, "[%d] Cannot set priority (%d)", i, ret);
+
+		ret = net_context_recv(flow_ctxs[i], flow_recv_cb, K_NO_WAIT,
+				       INT_TO_POINTER(i));
+		zassert_equal(ret, 0, "[%d] Context recv UDP setup failed (%d)", i, ret);
+	}
+
+	test_started = true;
+	start_receiving = true;
+
+	/* Interleave the flows, waiting for each packet so that the RX
+	 * queues never run out of slots.
+	 */
+	for (j = 0; j < FLOW_PKT_COUNT; j++) {
+		for (i = 0; i < FLOW_COUNT; i++) {
+			ret = net_context_sendto(flow_ctxs[i], test_data, strlen(test_data),
+						 (struct net_sockaddr *)&dst_addr6,
+						 sizeof(struct net_sockaddr_in6),
+						 NULL, K_NO_WAIT, NULL);
+			zassert_true(ret > 0, "[%d] Send UDP pkt failed", i);
+
+			zassert_equal(k_sem_take(&flow_wait, WAIT_TIME), 0,
+				      "[%d] Timeout while waiting for packet", i);
+		}
+	}
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		net_context_unref(flow_ctxs[i]);
+		flow_ctxs[i] = NULL;
+	}
+
+	zassert_false(flow_moved, "Packets of a flow were handled by several RX queues");
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		for (j = 0; j < i; j++) {
+			if (flow_threads[j] == flow_threads[i]) {
+				break;
+			}
+		}
+
+		if (j == i) {
+			queues++;
+		}
+	}
+
+	zassert_true(queues > 1, "All flows were handled by the same RX queue");
+}
+#endif /* CONFIG_NET_TC_RX_FLOW_STEERING */
+
 static void run_before(void *dummy)
 {
 	ARG_UNUSED(dummy);
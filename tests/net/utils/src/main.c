@@ -1365,6 +1365,75 @@ ZTEST(test_utils_fn, test_ip_checksum)
 	}
 }
 
+ZTEST(test_utils_fn, test_ip_checksum_alignment)
+{
+	uint16_t sum_got;
+	uint16_t sum_exp;
+
+	for (int i = 0; i < CHECKSUM_TEST_LENGTH; i++) {
+		testdata[i] = (uint8_t)(i * 31 + 7);
+	}
+
+	/* Cover every start alignment of the widest words summed, and lengths
+	 * going through the unrolled loop plus every possible tail.
+	 */
+	for (int offset = 0; offset < 16; offset++) {
+		for (int length = 0; length < 96; length++) {
+			sum_got = calc_chksum_ref(offset ^ 0x3a5c, testdata + offset, length);
+			sum_exp = calc_chksum(offset ^ 0x3a5c, testdata + offset, length);
+
+			zassert_equal(sum_got, sum_exp,
+				      "Mismatch at offset %d length %d\n", offset, length);
+		}
+	}
+
+	/* Values that make the accumulator wrap around */
+	memset(testdata, 0xff, sizeof(testdata));
+
+	for (int offset = 0; offset < 8; offset++) {
+		sum_got = calc_chksum_ref(0xffff, testdata + offset,
+					  CHECKSUM_TEST_LENGTH - offset);
+		sum_exp = calc_chksum(0xffff, testdata + offset,
+				      CHECKSUM_TEST_LENGTH - offset);
+
+		zassert_equal(sum_got, sum_exp,
+			      "Mismatch with all ones data at offset %d\n", offset);
+	}
+}
+
+#define CHECKSUM_BENCH_ROUNDS 1000
+
+ZTEST(test_utils_fn, test_ip_checksum_benchmark)
+{
+	volatile uint16_t ref_sum = 0;
+	volatile uint16_t opt_sum = 0;
+	uint32_t start;
+	uint64_t ref_ns;
+	uint64_t opt_ns;
+
+	for (int i = 0; i < CHECKSUM_TEST_LENGTH; i++) {
+		testdata[i] = (uint8_t)i;
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < CHECKSUM_BENCH_ROUNDS; i++) {
+		ref_sum = calc_chksum_ref(ref_sum, testdata, CHECKSUM_TEST_LENGTH);
+	}
+	ref_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < CHECKSUM_BENCH_ROUNDS; i++) {
+		opt_sum = calc_chksum(opt_sum, testdata, CHECKSUM_TEST_LENGTH);
+	}
+	opt_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+
+	TC_PRINT("%d x %d bytes checksum: reference %llu ns, calc_chksum %llu ns\n",
+		 CHECKSUM_BENCH_ROUNDS, CHECKSUM_TEST_LENGTH,
+		 (unsigned long long)ref_ns, (unsigned long long)opt_ns);
+
+	zassert_equal(ref_sum, opt_sum, "Mismatch between reference and calculated checksum");
+}
+
 /* Verify that the net_pkt pointer to the received link layer address
  * is correct.
  */
@@ -575,6 +575,50 @@ ZTEST(modem_ppp, test_ip_frame_send_large)
 		     "Incorrect data received");
 }
 
+ZTEST(modem_ppp, test_ip_frame_send_large_no_accm)
+{
+	const uint8_t addr_ctrl[] = {0xFF, 0x03};
+	struct net_pkt *pkt;
+	size_t size;
+	uint16_t fcs;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(&test_iface, TEST_MODEM_PPP_IP_FRAME_SEND_LARGE_N,
+					NET_AF_UNSPEC, 0, K_NO_WAIT);
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_family(pkt, NET_AF_INET);
+	size = test_modem_ppp_fill_net_pkt(pkt, TEST_MODEM_PPP_IP_FRAME_SEND_LARGE_N);
+	zassert_true(size == TEST_MODEM_PPP_IP_FRAME_SEND_LARGE_N, "Failed to fill net pkt");
+
+	/* Only the delimiter and escape bytes are escaped */
+	test_net_l2_data.lcp.peer_options.async_map = 0;
+
+	test_net_send(pkt);
+	k_msleep(TEST_MODEM_PPP_IP_FRAME_SEND_LARGE_N * 2);
+
+	ret = modem_backend_mock_get(&mock, buffer, TEST_MODEM_PPP_MOCK_PIPE_RX_BUF_SIZE);
+	zassert_true(ret < (TEST_MODEM_PPP_IP_FRAME_SEND_LARGE_N + 64),
+		     "Control characters should not be escaped");
+
+	for (int i = 4; i < (ret - 1); i++) {
+		zassert_true(buffer[i] != 0x7E, "Unescaped delimiter in frame");
+	}
+
+	size = test_modem_ppp_unwrap(unwrapped_buffer, buffer, ret);
+	zassert_true(size == (TEST_MODEM_PPP_IP_FRAME_SEND_LARGE_N + 2),
+		     "Incorrect data amount received");
+
+	/* Validate data */
+	zassert_true(test_modem_ppp_validate_fill(&unwrapped_buffer[2], (size - 2)) == true,
+		     "Incorrect data received");
+
+	/* FCS over address, control, protocol, data and FCS yields the good FCS value */
+	fcs = crc16_ccitt(0xFFFF, addr_ctrl, sizeof(addr_ctrl));
+	fcs = crc16_ccitt(fcs, unwrapped_buffer, size + 2);
+	zassert_true(fcs == 0xF0B8, "Incorrect FCS");
+}
+
 ZTEST(modem_ppp, test_ip_frame_receive_large)
 {
 	struct net_pkt *pkt;